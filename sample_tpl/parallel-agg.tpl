@@ -1,5 +1,8 @@
-// Perform parallel aggregation
-// This will be supported after the parallel scans are added
+// Perform a parallel aggregation for:
+//
+// SELECT colB, COUNT(*) FROM test_1 GROUP BY colB
+//
+// Should return 10 (number of output rows)
 
 struct State {
   table: AggregationHashTable
@@ -72,15 +75,14 @@ fun p1_worker(queryState: *State, state: *ThreadState_1, tvi: *TableVectorIterat
   var ht: *AggregationHashTable = &state.table
 
   for (@tableIterAdvance(tvi)) {
-    var vec = @tableIterGetVPI(tvi)
+    var vec = @tableIterGetPCI(tvi)
     iters[0] = vec
-    @aggHTProcessBatch(ht, &iters, hashFn, keyCheck, constructAgg, updateAgg)
+    @aggHTProcessBatch(ht, &iters, hashFn, keyCheck, constructAgg, updateAgg, true)
   }
   return
 }
 
 fun p1_mergePartitions(qs: *State, table: *AggregationHashTable, iter: *AggOverflowPartIter) -> nil {
-  var x = 0
   for (; @aggPartIterHasNext(iter); @aggPartIterNext(iter)) {
     var partial_hash = @aggPartIterGetHash(iter)
     var partial = @ptrCast(*Agg, @aggPartIterGetRow(iter))
@@ -98,7 +100,7 @@ fun p2_worker_initThreadState(execCtx: *ExecutionContext, ts: *ThreadState_2) ->
   ts.count = 0
 }
 
-fun p2_worker_tearDownThreadState(execCtx: *ExecutionContext, ts: *ThreadState_1) -> nil {
+fun p2_worker_tearDownThreadState(execCtx: *ExecutionContext, ts: *ThreadState_2) -> nil {
 }
 
 fun p2_finalize(qs: *State, ts: *ThreadState_2) -> nil {
@@ -130,7 +132,10 @@ fun main(execCtx: *ExecutionContext) -> int {
   @tlsReset(&tls, @sizeOf(ThreadState_1), p1_worker_initThreadState, p1_worker_tearDownThreadState, execCtx)
 
   // Parallel Scan
-  @iterateTableParallel("test_1", &state, &tls, p1_worker)
+  var col_oids: [2]uint32
+  col_oids[0] = 1 // colA
+  col_oids[1] = 2 // colB
+  @iterateTableParallel("test_1", col_oids, &state, &tls, execCtx, p1_worker)
 
   // ---- Pipeline 1 End ---- // 
 
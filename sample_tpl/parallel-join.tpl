@@ -1,8 +1,12 @@
-// Perform parallel join
-// This will be supported after the parallel scans are added
+// Perform a hash join with a parallel build and a parallel probe:
+//
+// SELECT * FROM test_1 AS t1, test_1 AS t1' WHERE t1.colA = t1'.colA AND t1.colA < 500
+//
+// Should return 500 (number of output rows)
 
 struct State {
   jht: JoinHashTable
+  num_matches: int32
 }
 
 struct ThreadState_1 {
@@ -10,18 +14,30 @@ struct ThreadState_1 {
   filter: FilterManager
 }
 
+struct ThreadState_2 {
+  num_matches: int32
+}
+
 struct BuildRow {
   key: Integer
 }
 
 fun setUpState(execCtx: *ExecutionContext, state: *State) -> nil {
   @joinHTInit(&state.jht, @execCtxGetMem(execCtx), @sizeOf(BuildRow))
+  state.num_matches = 0
 }
 
 fun tearDownState(state: *State) -> nil {
   @joinHTFree(&state.jht)
 }
 
+fun checkKey(queryState: *State, pci: *ProjectedColumnsIterator, row: *BuildRow) -> bool {
+  if (@pciGetInt(pci, 0) == row.key) {
+    return true
+  }
+  return false
+}
+
 fun _1_Lt500(pci: *ProjectedColumnsIterator) -> int32 {
   var param: Integer = @intToSql(500)
   var cola: Integer
@@ -41,7 +57,7 @@ fun _1_Lt500(pci: *ProjectedColumnsIterator) -> int32 {
 }
 
 fun _1_Lt500_Vec(pci: *ProjectedColumnsIterator) -> int32 {
-  return @filterLt(pci, "colA", 500)
+  return @filterLt(pci, 0, 4, 500)
 }
 
 fun _1_pipelineWorker_InitThreadState(execCtx: *ExecutionContext, state: *ThreadState_1) -> nil {
@@ -76,6 +92,32 @@ fun _1_pipelineWorker(queryState: *State, state: *ThreadState_1, tvi: *TableVect
   return
 }
 
+fun _2_pipelineWorker_InitThreadState(execCtx: *ExecutionContext, state: *ThreadState_2) -> nil {
+  state.num_matches = 0
+}
+
+fun _2_pipelineWorker_TearDownThreadState(execCtx: *ExecutionContext, state: *ThreadState_2) -> nil {
+}
+
+fun _2_pipelineWorker(queryState: *State, state: *ThreadState_2, tvi: *TableVectorIterator) -> nil {
+  // Probe with every row of the outer table. The hash table is only read here, so threads can share it.
+  for (@tableIterAdvance(tvi)) {
+    var vec = @tableIterGetPCI(tvi)
+    for (; @pciHasNext(vec); @pciAdvance(vec)) {
+      var hti: JoinHashTableIterator
+      for (@joinHTIterInit(&hti, &queryState.jht, @hash(@pciGetInt(vec, 0))); @joinHTIterHasNext(&hti, checkKey, queryState, vec); ) {
+        state.num_matches = state.num_matches + 1
+      }
+      @joinHTIterClose(&hti)
+    }
+  }
+  return
+}
+
+fun _2_finalize(queryState: *State, state: *ThreadState_2) -> nil {
+  queryState.num_matches = queryState.num_matches + state.num_matches
+}
+
 fun main(execCtx: *ExecutionContext) -> int {
   var state: State
   setUpState(execCtx, &state)
@@ -88,7 +130,9 @@ fun main(execCtx: *ExecutionContext) -> int {
   @tlsReset(&tls, @sizeOf(ThreadState_1), _1_pipelineWorker_InitThreadState, _1_pipelineWorker_TearDownThreadState, execCtx)
 
   // Parallel scan
- @iterateTableParallel("test_1", &state, &tls, _1_pipelineWorker)
+  var col_oids: [1]uint32
+  col_oids[0] = 1 // colA
+  @iterateTableParallel("test_1", col_oids, &state, &tls, execCtx, _1_pipelineWorker)
 
   // ---- Pipeline 1 End ---- //
   var off: uint32 = 0
@@ -96,11 +140,22 @@ fun main(execCtx: *ExecutionContext) -> int {
 
   // ---- Pipeline 2 Begin ---- //
 
+  // The global hash table owns the build rows now, so the thread-local ones can be torn down
+  @tlsReset(&tls, @sizeOf(ThreadState_2), _2_pipelineWorker_InitThreadState, _2_pipelineWorker_TearDownThreadState, execCtx)
+
+  // Parallel probe
+  @iterateTableParallel("test_1", col_oids, &state, &tls, execCtx, _2_pipelineWorker)
+
+  // Sum up the matches of every thread
+  @tlsIterate(&tls, &state, _2_finalize)
+
   // ---- Pipeline 2 End ---- //
 
+  var ret = state.num_matches
+
   // Cleanup
   @tlsFree(&tls)
   tearDownState(&state)
 
-  return 0
+  return ret
 }
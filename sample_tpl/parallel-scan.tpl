@@ -1,12 +1,16 @@
-// Perform parallel scan
-// This is not yet supported with the current SQL table API.
+// Perform a parallel vectorized scan for:
+//
+// SELECT * FROM test_1 WHERE cola < 500
+//
+// Should return 500 (number of output rows)
 
 struct State {
+  count: int32
 }
 
-
 struct ThreadState_1 {
   filter: FilterManager
+  count : int32
 }
 
 fun _1_Lt500(pci: *ProjectedColumnsIterator) -> int32 {
@@ -28,10 +32,11 @@ fun _1_Lt500(pci: *ProjectedColumnsIterator) -> int32 {
 }
 
 fun _1_Lt500_Vec(pci: *ProjectedColumnsIterator) -> int32 {
-  return @filterLt(pci, "colA", 500)
+  return @filterLt(pci, 0, 4, 500)
 }
 
 fun _1_pipelineWorker_InitThreadState(execCtx: *ExecutionContext, state: *ThreadState_1) -> nil {
+  state.count = 0
   @filterManagerInit(&state.filter)
   @filterManagerInsertFilter(&state.filter, _1_Lt500, _1_Lt500_Vec)
   @filterManagerFinalize(&state.filter)
@@ -46,11 +51,22 @@ fun _1_pipelineWorker(query_state: *State, state: *ThreadState_1, tvi: *TableVec
   for (@tableIterAdvance(tvi)) {
     var pci = @tableIterGetPCI(tvi)
     @filtersRun(filter, pci)
+    for (; @pciHasNextFiltered(pci); @pciAdvanceFiltered(pci)) {
+      state.count = state.count + 1
+    }
+    @pciResetFiltered(pci)
   }
   return
 }
 
+fun _1_gatherCounters(qs: *State, ts: *ThreadState_1) -> nil {
+  qs.count = qs.count + ts.count
+}
+
 fun main(execCtx: *ExecutionContext) -> int {
+  var state: State
+  state.count = 0
+
   // Pipeline 1 - parallel scan table
 
   // First the thread state container
@@ -59,12 +75,15 @@ fun main(execCtx: *ExecutionContext) -> int {
   @tlsReset(&tls, @sizeOf(ThreadState_1), _1_pipelineWorker_InitThreadState, _1_pipelineWorker_TearDownThreadState, execCtx)
 
   // Now scan
-  @iterateTableParallel("test_1", &state, &tls, _1_pipelineWorker)
+  var col_oids: [1]uint32
+  col_oids[0] = 1 // colA
+  @iterateTableParallel("test_1", col_oids, &state, &tls, execCtx, _1_pipelineWorker)
 
   // Pipeline 2
+  @tlsIterate(&tls, &state, _1_gatherCounters)
 
   // Cleanup
   @tlsFree(&tls)
 
-  return 0
+  return state.count
 }
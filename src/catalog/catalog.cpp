@@ -148,7 +148,7 @@ db_oid_t Catalog::GetDatabaseOid(transaction::TransactionContext *const txn, con
 
   // Clean up the varlen's buffer in the case it wasn't inlined.
   if (!name_varlen.IsInlined()) {
-    delete[] name_varlen.Content();
+    storage::VarlenArena::Free(name_varlen);
   }
 
   if (index_results.empty()) {
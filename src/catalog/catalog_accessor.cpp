@@ -82,6 +82,10 @@ bool CatalogAccessor::UpdateSchema(table_oid_t table, Schema *new_schema) const
 
 const Schema &CatalogAccessor::GetSchema(table_oid_t table) const { return dbc_->GetSchema(txn_, table); }
 
+storage::layout_version_t CatalogAccessor::GetLayoutVersion(table_oid_t table) const {
+  return dbc_->GetLayoutVersion(txn_, table);
+}
+
 std::vector<constraint_oid_t> CatalogAccessor::GetConstraints(table_oid_t table) const {
   return dbc_->GetConstraints(txn_, table);
 }
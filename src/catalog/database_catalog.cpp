@@ -1,5 +1,6 @@
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -253,6 +254,12 @@ void DatabaseCatalog::BootstrapPRIs() {
   const std::vector<col_oid_t> set_class_schema_oids{postgres::REL_SCHEMA_COL_OID};
   set_class_schema_pri_ = classes_->InitializerForProjectedRow(set_class_schema_oids);
 
+  const std::vector<col_oid_t> set_class_next_col_oid_oids{postgres::REL_NEXTCOLOID_COL_OID};
+  set_class_next_col_oid_pri_ = classes_->InitializerForProjectedRow(set_class_next_col_oid_oids);
+
+  const std::vector<col_oid_t> set_class_layout_version_oids{postgres::REL_LAYOUT_VERSION_COL_OID};
+  set_class_layout_version_pri_ = classes_->InitializerForProjectedRow(set_class_layout_version_oids);
+
   const std::vector<col_oid_t> get_class_pointer_kind_oids{postgres::REL_PTR_COL_OID, postgres::RELKIND_COL_OID};
   get_class_pointer_kind_pri_ = classes_->InitializerForProjectedRow(get_class_pointer_kind_oids);
 
@@ -399,7 +406,7 @@ namespace_oid_t DatabaseCatalog::GetNamespaceOid(transaction::TransactionContext
 
   // Clean up the varlen's buffer in the case it wasn't inlined.
   if (!name_varlen.IsInlined()) {
-    delete[] name_varlen.Content();
+    storage::VarlenArena::Free(name_varlen);
   }
 
   if (index_results.empty()) {
@@ -474,7 +481,7 @@ bool DatabaseCatalog::CreateColumn(transaction::TransactionContext *const txn, c
 
     // Clean up the varlen's buffer in the case it wasn't inlined.
     if (!name_varlen.IsInlined()) {
-      delete[] name_varlen.Content();
+      storage::VarlenArena::Free(name_varlen);
     }
 
     return false;
@@ -549,18 +556,14 @@ std::vector<Column> DatabaseCatalog::GetColumns(transaction::TransactionContext
   return std::move(cols);
 }
 
-// TODO(Matt): we need a DeleteColumn()
-
 template <typename Column, typename ClassOid>
 bool DatabaseCatalog::DeleteColumns(transaction::TransactionContext *const txn, const ClassOid class_oid) {
   // Step 1: Read Index
   const auto oid_pri = columns_oid_index_->GetProjectedRowInitializer();
   auto oid_prm = columns_oid_index_->GetKeyOidToOffsetMap();
-  const auto name_pri = columns_name_index_->GetProjectedRowInitializer();
 
-  // Buffer is large enough to hold all prs
-  byte *const buffer = common::AllocationUtil::AllocateAligned(delete_columns_pri_.ProjectedRowSize());
-  byte *const key_buffer = common::AllocationUtil::AllocateAligned(name_pri.ProjectedRowSize());
+  byte *const buffer = common::AllocationUtil::AllocateAligned(oid_pri.ProjectedRowSize());
+  byte *const key_buffer = common::AllocationUtil::AllocateAligned(oid_pri.ProjectedRowSize());
   // Scan the class index
   auto *pr = oid_pri.InitializeRow(buffer);
   auto *key_pr = oid_pri.InitializeRow(key_buffer);
@@ -576,18 +579,53 @@ bool DatabaseCatalog::DeleteColumns(transaction::TransactionContext *const txn,
   *(reinterpret_cast<uint32_t *>(key_pr->AccessForceNotNull(oid_prm[indexkeycol_oid_t(2)]))) = 0;
   std::vector<storage::TupleSlot> index_results;
   columns_oid_index_->ScanAscending(*txn, *pr, *key_pr, &index_results);
+  delete[] buffer;
+  delete[] key_buffer;
 
-  if (index_results.empty()) {
-    delete[] buffer;
-    return false;
-  }
+  if (index_results.empty()) return false;
 
   // TODO(Matt): do we have any way to assert that we got the number of attributes we expect? From another attribute in
   // another catalog table maybe?
 
-  // Step 2: Scan the table to get the columns
-  pr = delete_columns_pri_.InitializeRow(buffer);
-  for (const auto &slot : index_results) {
+  // Step 2: Delete the columns
+  return DeleteColumnEntries(txn, class_oid, index_results);
+}
+
+bool DatabaseCatalog::DeleteColumn(transaction::TransactionContext *const txn, const table_oid_t table,
+                                   const col_oid_t col) {
+  // Step 1: Read Index
+  const auto oid_pri = columns_oid_index_->GetProjectedRowInitializer();
+  auto oid_prm = columns_oid_index_->GetKeyOidToOffsetMap();
+  byte *const buffer = common::AllocationUtil::AllocateAligned(oid_pri.ProjectedRowSize());
+  auto *const pr = oid_pri.InitializeRow(buffer);
+  // Write the attributes in the ProjectedRow. These hardcoded indexkeycol_oids come from
+  // Builder::GetColumnOidIndexSchema()
+  *(reinterpret_cast<table_oid_t *>(pr->AccessForceNotNull(oid_prm[indexkeycol_oid_t(1)]))) = table;
+  *(reinterpret_cast<col_oid_t *>(pr->AccessForceNotNull(oid_prm[indexkeycol_oid_t(2)]))) = col;
+  std::vector<storage::TupleSlot> index_results;
+  columns_oid_index_->ScanKey(*txn, *pr, &index_results);
+  delete[] buffer;
+
+  if (index_results.empty()) return false;
+  TERRIER_ASSERT(index_results.size() == 1, "You got more than one result from a unique index. How did you do that?");
+
+  // Step 2: Delete the column
+  return DeleteColumnEntries(txn, table, index_results);
+}
+
+template <typename ClassOid>
+bool DatabaseCatalog::DeleteColumnEntries(transaction::TransactionContext *const txn, const ClassOid class_oid,
+                                          const std::vector<storage::TupleSlot> &slots) {
+  const auto oid_pri = columns_oid_index_->GetProjectedRowInitializer();
+  auto oid_prm = columns_oid_index_->GetKeyOidToOffsetMap();
+  const auto name_pri = columns_name_index_->GetProjectedRowInitializer();
+
+  // Buffer is large enough to hold all prs
+  byte *const buffer = common::AllocationUtil::AllocateAligned(delete_columns_pri_.ProjectedRowSize());
+  byte *const key_buffer = common::AllocationUtil::AllocateAligned(name_pri.ProjectedRowSize());
+  auto *pr = delete_columns_pri_.InitializeRow(buffer);
+  storage::ProjectedRow *key_pr;
+  for (const auto &slot : slots) {
     // 1. Extract attributes from the tuple for the index deletions
     auto UNUSED_ATTRIBUTE result = columns_->Select(txn, slot, pr);
     TERRIER_ASSERT(result, "Index scan did a visibility check, so Select shouldn't fail at this point.");
@@ -716,10 +754,13 @@ bool DatabaseCatalog::DeleteTable(transaction::TransactionContext *const txn, co
   txn->RegisterCommitAction([=](transaction::DeferredActionManager *deferred_action_manager) {
     deferred_action_manager->RegisterDeferredAction([=]() {
       deferred_action_manager->RegisterDeferredAction([=]() {
-        // Defer an action upon commit to delete the table. Delete table will need a double deferral because there could
-        // be transactions not yet unlinked by the GC that depend on the table
-        delete schema_ptr;
-        delete table_ptr;
+        deferred_action_manager->RegisterDeferredAction([=]() {
+          // Defer an action upon commit to delete the table. Delete table will need a double deferral because there
+          // could be transactions not yet unlinked by the GC that depend on the table, and a third one because the GC
+          // defers handing the slots of deleted tuples back to the table when it unlinks those transactions
+          delete schema_ptr;
+          delete table_ptr;
+        });
       });
     });
   });
@@ -747,7 +788,7 @@ std::pair<uint32_t, postgres::ClassKind> DatabaseCatalog::GetClassOidKind(transa
   classes_name_index_->ScanKey(*txn, *pr, &index_results);
   // Clean up the varlen's buffer in the case it wasn't inlined.
   if (!name_varlen.IsInlined()) {
-    delete[] name_varlen.Content();
+    storage::VarlenArena::Free(name_varlen);
   }
 
   if (index_results.empty()) {
@@ -817,9 +858,71 @@ bool DatabaseCatalog::RenameTable(transaction::TransactionContext *const txn, co
 
 bool DatabaseCatalog::UpdateSchema(transaction::TransactionContext *const txn, const table_oid_t table,
                                    Schema *const new_schema) {
-  // TODO(John): Implement
-  TERRIER_ASSERT(false, "Not implemented");
-  return false;
+  const auto oid_pri = classes_oid_index_->GetProjectedRowInitializer();
+
+  TERRIER_ASSERT(set_class_next_col_oid_pri_.ProjectedRowSize() >= oid_pri.ProjectedRowSize(),
+                 "Buffer must be allocated for largest ProjectedRow size");
+  auto *const buffer = common::AllocationUtil::AllocateAligned(set_class_next_col_oid_pri_.ProjectedRowSize());
+  auto *const key_pr = oid_pri.InitializeRow(buffer);
+
+  // Find the entry using the index
+  *(reinterpret_cast<table_oid_t *>(key_pr->AccessForceNotNull(0))) = table;
+  std::vector<storage::TupleSlot> index_results;
+  classes_oid_index_->ScanKey(*txn, *key_pr, &index_results);
+  if (index_results.empty()) {
+    delete[] buffer;
+    delete new_schema;
+    return false;
+  }
+  TERRIER_ASSERT(index_results.size() == 1, "You got more than one result from a unique index. How did you do that?");
+  const storage::TupleSlot class_slot = index_results[0];
+
+  auto *const select_pr = set_class_next_col_oid_pri_.InitializeRow(buffer);
+  const auto UNUSED_ATTRIBUTE select_result = classes_->Select(txn, class_slot, select_pr);
+  TERRIER_ASSERT(select_result, "Index already verified visibility. This shouldn't fail.");
+  col_oid_t next_col_oid = *(reinterpret_cast<const col_oid_t *>(select_pr->AccessForceNotNull(0)));
+  delete[] buffer;
+
+  // Columns that keep their oid, name and type keep their entry in pg_attribute, and with it their values in the table.
+  // Every other column of the new schema is added, and every other column of the old schema is dropped.
+  const Schema &old_schema = GetSchema(txn, table);
+  std::unordered_map<col_oid_t, const Schema::Column *> dropped_cols;
+  for (const auto &col : old_schema.GetColumns()) dropped_cols[col.Oid()] = &col;
+  std::vector<const Schema::Column *> added_cols;
+  for (const auto &col : new_schema->GetColumns()) {
+    const auto it = dropped_cols.find(col.Oid());
+    if (it != dropped_cols.end() && it->second->Name() == col.Name() && it->second->Type() == col.Type())
+      dropped_cols.erase(it);
+    else
+      added_cols.push_back(&col);
+  }
+
+  // Write the next column oid first, even if no column is added, so that a concurrent schema change conflicts on the
+  // entry before either of them adds a layout version to the table
+  auto *const next_col_oid_redo = txn->StageWrite(db_oid_, postgres::CLASS_TABLE_OID, set_class_next_col_oid_pri_);
+  next_col_oid_redo->SetTupleSlot(class_slot);
+  *reinterpret_cast<col_oid_t *>(next_col_oid_redo->Delta()->AccessForceNotNull(0)) =
+      col_oid_t(!next_col_oid + static_cast<uint32_t>(added_cols.size()));
+  bool result = classes_->Update(txn, next_col_oid_redo);
+
+  // Drop columns before adding any, as a modified column may keep its name
+  for (auto it = dropped_cols.cbegin(); result && it != dropped_cols.cend(); ++it)
+    result = DeleteColumn(txn, table, it->first);
+  for (auto it = added_cols.cbegin(); result && it != added_cols.cend(); ++it)
+    result = CreateColumn(txn, table, next_col_oid++, **it);
+  delete new_schema;
+  if (!result) return false;
+
+  auto *const schema = new Schema(GetColumns<Schema::Column, table_oid_t, col_oid_t>(txn, table));
+  storage::layout_version_t version;
+  try {
+    version = GetTable(txn, table)->UpdateSchema(*schema);
+  } catch (const std::runtime_error &) {
+    // The table has run out of layout versions
+    delete schema;
+    return false;
+  }
+  return SetTableSchema(txn, class_slot, &old_schema, schema, version);
 }
 
 const Schema &DatabaseCatalog::GetSchema(transaction::TransactionContext *const txn, const table_oid_t table) {
@@ -829,6 +932,38 @@ const Schema &DatabaseCatalog::GetSchema(transaction::TransactionContext *const
   return *reinterpret_cast<Schema *>(ptr_pair.first);
 }
 
+storage::layout_version_t DatabaseCatalog::GetLayoutVersion(transaction::TransactionContext *const txn,
+                                                            const table_oid_t table) {
+  const auto oid_pri = classes_oid_index_->GetProjectedRowInitializer();
+
+  TERRIER_ASSERT(oid_pri.ProjectedRowSize() >= set_class_layout_version_pri_.ProjectedRowSize(),
+                 "Buffer must be allocated for largest ProjectedRow size");
+  auto *const buffer = common::AllocationUtil::AllocateAligned(oid_pri.ProjectedRowSize());
+  auto *const key_pr = oid_pri.InitializeRow(buffer);
+
+  // Find the entry using the index
+  *(reinterpret_cast<table_oid_t *>(key_pr->AccessForceNotNull(0))) = table;
+  std::vector<storage::TupleSlot> index_results;
+  classes_oid_index_->ScanKey(*txn, *key_pr, &index_results);
+  if (index_results.empty()) {
+    // The table is not visible to txn, so there are no tuples of it to lay out projections for either
+    delete[] buffer;
+    return storage::layout_version_t(0);
+  }
+  TERRIER_ASSERT(index_results.size() == 1, "You got more than one result from a unique index. How did you do that?");
+
+  auto *const select_pr = set_class_layout_version_pri_.InitializeRow(buffer);
+  const auto result UNUSED_ATTRIBUTE = classes_->Select(txn, index_results[0], select_pr);
+  TERRIER_ASSERT(result, "Index already verified visibility. This shouldn't fail.");
+  const auto *const version_ptr =
+      reinterpret_cast<const storage::layout_version_t *>(select_pr->AccessWithNullCheck(0));
+  TERRIER_ASSERT(version_ptr != nullptr, "Requested a layout version for a non-table");
+  const storage::layout_version_t version = *version_ptr;
+
+  delete[] buffer;
+  return version;
+}
+
 std::vector<constraint_oid_t> DatabaseCatalog::GetConstraints(transaction::TransactionContext *txn, table_oid_t table) {
   // TODO(John): Implement
   TERRIER_ASSERT(false, "Not implemented");
@@ -1071,6 +1206,29 @@ bool DatabaseCatalog::SetClassPointer(transaction::TransactionContext *const txn
   return classes_->Update(txn, update_redo);
 }
 
+bool DatabaseCatalog::SetTableSchema(transaction::TransactionContext *const txn, const storage::TupleSlot class_slot,
+                                     const Schema *const old_schema, const Schema *const new_schema,
+                                     const storage::layout_version_t version) {
+  txn->RegisterAbortAction([=]() { delete new_schema; });
+
+  auto *update_redo = txn->StageWrite(db_oid_, postgres::CLASS_TABLE_OID, set_class_schema_pri_);
+  update_redo->SetTupleSlot(class_slot);
+  *reinterpret_cast<const Schema **>(update_redo->Delta()->AccessForceNotNull(0)) = new_schema;
+  if (!classes_->Update(txn, update_redo)) return false;
+
+  // Recovery takes an update to the layout version as a schema change, so it is written last
+  update_redo = txn->StageWrite(db_oid_, postgres::CLASS_TABLE_OID, set_class_layout_version_pri_);
+  update_redo->SetTupleSlot(class_slot);
+  *reinterpret_cast<storage::layout_version_t *>(update_redo->Delta()->AccessForceNotNull(0)) = version;
+  if (!classes_->Update(txn, update_redo)) return false;
+
+  // Transactions that started before this one committed may still be reading the old schema
+  txn->RegisterCommitAction([=](transaction::DeferredActionManager *deferred_action_manager) {
+    deferred_action_manager->RegisterDeferredAction([=]() { delete old_schema; });
+  });
+  return true;
+}
+
 bool DatabaseCatalog::SetIndexPointer(transaction::TransactionContext *const txn, const index_oid_t index,
                                       const storage::index::Index *const index_ptr) {
   // This needs to be deferred because if any items were subsequently inserted into this index, they will have deferred
@@ -1312,6 +1470,10 @@ bool DatabaseCatalog::CreateIndexEntry(transaction::TransactionContext *const tx
   const auto next_col_oid_offset = pg_class_all_cols_prm_[postgres::REL_NEXTCOLOID_COL_OID];
   class_insert_pr->SetNull(next_col_oid_offset);
 
+  // Set layout_version to NULL because indexes are not stored in a SqlTable
+  const auto layout_version_offset = pg_class_all_cols_prm_[postgres::REL_LAYOUT_VERSION_COL_OID];
+  class_insert_pr->SetNull(layout_version_offset);
+
   // Set index_ptr to NULL because it gets set by execution layer after instantiation
   const auto index_ptr_offset = pg_class_all_cols_prm_[postgres::REL_PTR_COL_OID];
   class_insert_pr->SetNull(index_ptr_offset);
@@ -1585,6 +1747,11 @@ bool DatabaseCatalog::CreateTableEntry(transaction::TransactionContext *const tx
   auto *const next_col_oid_ptr = insert_pr->AccessForceNotNull(next_col_oid_offset);
   *(reinterpret_cast<col_oid_t *>(next_col_oid_ptr)) = next_col_oid;
 
+  // Write the layout_version into the PR. A new table starts out with the first layout version of its SqlTable
+  const auto layout_version_offset = pg_class_all_cols_prm_[postgres::REL_LAYOUT_VERSION_COL_OID];
+  auto *const layout_version_ptr = insert_pr->AccessForceNotNull(layout_version_offset);
+  *(reinterpret_cast<storage::layout_version_t *>(layout_version_ptr)) = storage::layout_version_t(0);
+
   // Write the schema_ptr as nullptr into the PR (need to update once we've recreated the columns)
   const auto schema_ptr_offset = pg_class_all_cols_prm_[postgres::REL_SCHEMA_COL_OID];
   auto *const schema_ptr_ptr = insert_pr->AccessForceNotNull(schema_ptr_offset);
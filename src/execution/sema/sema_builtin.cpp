@@ -152,6 +152,36 @@ void Sema::CheckBuiltinFilterCall(ast::CallExpr *call) {
   call->SetType(GetBuiltinType(ast::BuiltinType::Int64));
 }
 
+void Sema::CheckBuiltinStringFilterCall(ast::CallExpr *call) {
+  if (!CheckArgCount(call, 3)) {
+    return;
+  }
+
+  const auto &args = call->Arguments();
+
+  // The first call argument must be a pointer to a ProjectedColumnsIterator
+  const auto pci_kind = ast::BuiltinType::ProjectedColumnsIterator;
+  if (!IsPointerToSpecificBuiltin(args[0]->GetType(), pci_kind)) {
+    ReportIncorrectCallArg(call, 0, GetBuiltinType(pci_kind)->PointerTo());
+    return;
+  }
+
+  // The second call argument must be an integer for the column index
+  if (!args[1]->IsIntegerLiteral()) {
+    ReportIncorrectCallArg(call, 1, GetBuiltinType(ast::BuiltinType::Int32));
+    return;
+  }
+
+  // The third call argument is the string to compare to, as a literal string
+  if (!args[2]->IsStringLiteral()) {
+    ReportIncorrectCallArg(call, 2, ast::StringType::Get(GetContext()));
+    return;
+  }
+
+  // Set return type
+  call->SetType(GetBuiltinType(ast::BuiltinType::Int64));
+}
+
 void Sema::CheckBuiltinAggHashTableCall(ast::CallExpr *call, ast::Builtin builtin) {
   if (!CheckArgCountAtLeast(call, 1)) {
     return;
@@ -904,11 +934,33 @@ void Sema::CheckBuiltinTableIterCall(ast::CallExpr *call, ast::Builtin builtin)
       call->SetType(GetBuiltinType(pci_kind)->PointerTo());
       break;
     }
-    case ast::Builtin::TableIterClose: {
+    case ast::Builtin::TableIterClose:
+    case ast::Builtin::TableIterInPlace: {
       // A single-arg builtin returning void
       call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
       break;
     }
+    case ast::Builtin::TableIterZoneMapEq:
+    case ast::Builtin::TableIterZoneMapGt:
+    case ast::Builtin::TableIterZoneMapGe:
+    case ast::Builtin::TableIterZoneMapLt:
+    case ast::Builtin::TableIterZoneMapLe:
+    case ast::Builtin::TableIterZoneMapNe: {
+      if (!CheckArgCount(call, 4)) {
+        return;
+      }
+      // The column index, the type of the column and the value to compare it to are all integer literals, like for
+      // the PCI filters
+      auto int32_kind = ast::BuiltinType::Int32;
+      for (uint32_t arg_idx = 1; arg_idx < 4; arg_idx++) {
+        if (!call_args[arg_idx]->IsIntegerLiteral()) {
+          ReportIncorrectCallArg(call, arg_idx, GetBuiltinType(int32_kind));
+          return;
+        }
+      }
+      call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
+      break;
+    }
     default: {
       UNREACHABLE("Impossible table iteration call");
     }
@@ -916,7 +968,7 @@ void Sema::CheckBuiltinTableIterCall(ast::CallExpr *call, ast::Builtin builtin)
 }
 
 void Sema::CheckBuiltinTableIterParCall(ast::CallExpr *call) {
-  if (!CheckArgCount(call, 4)) {
+  if (!CheckArgCount(call, 6)) {
     return;
   }
 
@@ -928,24 +980,43 @@ void Sema::CheckBuiltinTableIterParCall(ast::CallExpr *call) {
     return;
   }
 
-  // Second argument is an opaque query state. For now, check it's a pointer.
+  // Second argument is a uint32_t array of column oids
+  if (!call_args[1]->GetType()->IsArrayType()) {
+    ReportIncorrectCallArg(call, 1, "Second argument should be a fixed length uint32 array");
+    return;
+  }
+  auto *arr_type = call_args[1]->GetType()->SafeAs<ast::ArrayType>();
+  auto uint32_t_kind = ast::BuiltinType::Uint32;
+  if (!arr_type->ElementType()->IsSpecificBuiltin(uint32_t_kind) || !arr_type->HasKnownLength()) {
+    ReportIncorrectCallArg(call, 1, "Second argument should be a fixed length uint32 array");
+    return;
+  }
+
+  // Third argument is an opaque query state. For now, check it's a pointer.
   const auto void_kind = ast::BuiltinType::Nil;
-  if (!call_args[1]->GetType()->IsPointerType()) {
-    ReportIncorrectCallArg(call, 1, GetBuiltinType(void_kind)->PointerTo());
+  if (!call_args[2]->GetType()->IsPointerType()) {
+    ReportIncorrectCallArg(call, 2, GetBuiltinType(void_kind)->PointerTo());
     return;
   }
 
-  // Third argument is the thread state container
+  // Fourth argument is the thread state container
   const auto tls_kind = ast::BuiltinType::ThreadStateContainer;
-  if (!IsPointerToSpecificBuiltin(call_args[2]->GetType(), tls_kind)) {
-    ReportIncorrectCallArg(call, 2, GetBuiltinType(tls_kind)->PointerTo());
+  if (!IsPointerToSpecificBuiltin(call_args[3]->GetType(), tls_kind)) {
+    ReportIncorrectCallArg(call, 3, GetBuiltinType(tls_kind)->PointerTo());
     return;
   }
 
-  // Third argument is scanner function
-  auto *scan_fn_type = call_args[3]->GetType()->SafeAs<ast::FunctionType>();
+  // Fifth argument is the execution context
+  const auto exec_ctx_kind = ast::BuiltinType::ExecutionContext;
+  if (!IsPointerToSpecificBuiltin(call_args[4]->GetType(), exec_ctx_kind)) {
+    ReportIncorrectCallArg(call, 4, GetBuiltinType(exec_ctx_kind)->PointerTo());
+    return;
+  }
+
+  // Last argument is scanner function
+  auto *scan_fn_type = call_args[5]->GetType()->SafeAs<ast::FunctionType>();
   if (scan_fn_type == nullptr) {
-    GetErrorReporter()->Report(call->Position(), ErrorMessages::kBadParallelScanFunction, call_args[3]->GetType());
+    GetErrorReporter()->Report(call->Position(), ErrorMessages::kBadParallelScanFunction, call_args[5]->GetType());
     return;
   }
   // Check type
@@ -953,7 +1024,7 @@ void Sema::CheckBuiltinTableIterParCall(ast::CallExpr *call) {
   const auto &params = scan_fn_type->Params();
   if (params.size() != 3 || !params[0].type_->IsPointerType() || !params[1].type_->IsPointerType() ||
       !IsPointerToSpecificBuiltin(params[2].type_, tvi_kind)) {
-    GetErrorReporter()->Report(call->Position(), ErrorMessages::kBadParallelScanFunction, call_args[3]->GetType());
+    GetErrorReporter()->Report(call->Position(), ErrorMessages::kBadParallelScanFunction, call_args[5]->GetType());
     return;
   }
 
@@ -1662,6 +1733,16 @@ void Sema::CheckBuiltinCall(ast::CallExpr *call) {
       CheckBuiltinFilterCall(call);
       break;
     }
+    case ast::Builtin::FilterStringEq:
+    case ast::Builtin::FilterStringGe:
+    case ast::Builtin::FilterStringGt:
+    case ast::Builtin::FilterStringLe:
+    case ast::Builtin::FilterStringLt:
+    case ast::Builtin::FilterStringNe:
+    case ast::Builtin::FilterStringPrefix: {
+      CheckBuiltinStringFilterCall(call);
+      break;
+    }
     case ast::Builtin::ExecutionContextGetMemoryPool: {
       CheckBuiltinExecutionContextCall(call, builtin);
       break;
@@ -1677,7 +1758,14 @@ void Sema::CheckBuiltinCall(ast::CallExpr *call) {
     case ast::Builtin::TableIterInitBind:
     case ast::Builtin::TableIterAdvance:
     case ast::Builtin::TableIterGetPCI:
-    case ast::Builtin::TableIterClose: {
+    case ast::Builtin::TableIterClose:
+    case ast::Builtin::TableIterZoneMapEq:
+    case ast::Builtin::TableIterZoneMapGt:
+    case ast::Builtin::TableIterZoneMapGe:
+    case ast::Builtin::TableIterZoneMapLt:
+    case ast::Builtin::TableIterZoneMapLe:
+    case ast::Builtin::TableIterZoneMapNe:
+    case ast::Builtin::TableIterInPlace: {
       CheckBuiltinTableIterCall(call, builtin);
       break;
     }
@@ -1,10 +1,42 @@
 #include "execution/sql/projected_columns_iterator.h"
+#include <algorithm>
+#include <cstring>
 #include "execution/util/vector_util.h"
 #include "storage/projected_columns.h"
 #include "type/type_id.h"
 
 namespace terrier::execution::sql {
 
+namespace {
+// Compares two strings by their bytes, the shorter one first if one is a prefix of the other. This is the order
+// dictionaries are sorted in, see storage::VarlenContentCompare.
+int CompareStrings(const byte *const lhs, const uint32_t lhs_size, const byte *const rhs, const uint32_t rhs_size) {
+  const int res = std::memcmp(lhs, rhs, std::min(lhs_size, rhs_size));
+  if (res != 0) return res;
+  return lhs_size < rhs_size ? -1 : (lhs_size > rhs_size ? 1 : 0);
+}
+
+bool HasPrefix(const byte *const str, const uint32_t size, const storage::VarlenEntry &prefix) {
+  return size >= prefix.Size() && std::memcmp(str, prefix.Content(), prefix.Size()) == 0;
+}
+
+// Binary searches the sorted dictionary, starting at code lo, for the first word that does not satisfy the predicate.
+// The predicate must hold for every word before that one, and for none after.
+template <typename F>
+uint32_t PartitionPoint(const storage::ArrowVarlenColumn &dictionary, uint32_t lo, const F &pred) {
+  uint32_t hi = dictionary.OffsetsLength() - 1;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    const uint32_t offset = dictionary.Offsets()[mid];
+    if (pred(dictionary.Values() + offset, dictionary.Offsets()[mid + 1] - offset))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+}  // namespace
+
 ProjectedColumnsIterator::ProjectedColumnsIterator() : selection_vector_{0} {
   selection_vector_[0] = ProjectedColumnsIterator::K_INVALID_POS;
 }
@@ -15,8 +47,39 @@ ProjectedColumnsIterator::ProjectedColumnsIterator(storage::ProjectedColumns *pr
 }
 
 void ProjectedColumnsIterator::SetProjectedColumn(storage::ProjectedColumns *projected_column) {
-  projected_column_ = projected_column;
-  num_selected_ = projected_column_->NumTuples();
+  const uint16_t num_cols = projected_column->NumColumns();
+  col_data_.resize(num_cols);
+  col_nulls_.resize(num_cols);
+  for (uint16_t i = 0; i < num_cols; i++) {
+    col_data_[i] = projected_column->ColumnStart(i);
+    col_nulls_[i] = projected_column->ColumnNullBitmap(i);
+  }
+  // Projections hold plain values
+  col_codes_.assign(num_cols, nullptr);
+  col_dictionaries_.assign(num_cols, nullptr);
+  num_tuples_ = projected_column->NumTuples();
+  num_selected_ = num_tuples_;
+  curr_idx_ = 0;
+  selection_vector_[0] = K_INVALID_POS;
+  selection_vector_read_idx_ = 0;
+  selection_vector_write_idx_ = 0;
+}
+
+void ProjectedColumnsIterator::SetColumns(const uint16_t num_cols, byte *const *const col_data,
+                                          const common::RawBitmap *const *const col_nulls, const uint32_t num_tuples,
+                                          const uint32_t *const *const col_codes,
+                                          const storage::ArrowVarlenColumn *const *const col_dictionaries) {
+  col_data_.assign(col_data, col_data + num_cols);
+  col_nulls_.assign(col_nulls, col_nulls + num_cols);
+  if (col_codes != nullptr) {
+    col_codes_.assign(col_codes, col_codes + num_cols);
+    col_dictionaries_.assign(col_dictionaries, col_dictionaries + num_cols);
+  } else {
+    col_codes_.assign(num_cols, nullptr);
+    col_dictionaries_.assign(num_cols, nullptr);
+  }
+  num_tuples_ = num_tuples;
+  num_selected_ = num_tuples_;
   curr_idx_ = 0;
   selection_vector_[0] = K_INVALID_POS;
   selection_vector_read_idx_ = 0;
@@ -26,8 +89,8 @@ void ProjectedColumnsIterator::SetProjectedColumn(storage::ProjectedColumns *pro
 template <typename T, template <typename> typename Op>
 uint32_t ProjectedColumnsIterator::FilterColByColImpl(const uint32_t col_idx_1, const uint32_t col_idx_2) {
   // Get the input column's data
-  const auto *input_1 = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx_1)));
-  const auto *input_2 = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx_2)));
+  const auto *input_1 = reinterpret_cast<const T *>(col_data_[col_idx_1]);
+  const auto *input_2 = reinterpret_cast<const T *>(col_data_[col_idx_2]);
 
   // Use the existing selection vector if this PCI has been filtered
   const uint32_t *sel_vec = (IsFiltered() ? selection_vector_ : nullptr);
@@ -50,9 +113,11 @@ uint32_t ProjectedColumnsIterator::FilterColByColImpl(const uint32_t col_idx_1,
 // Filter an entire column's data by the provided constant value
 template <typename T, template <typename> typename Op>
 uint32_t ProjectedColumnsIterator::FilterColByValImpl(uint32_t col_idx, T val) {
-  // Get the input column's data
-  const auto *input = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx)));
+  return FilterValuesByVal<T, Op>(reinterpret_cast<const T *>(col_data_[col_idx]), val);
+}
 
+template <typename T, template <typename> typename Op>
+uint32_t ProjectedColumnsIterator::FilterValuesByVal(const T *const input, const T val) {
   // Use the existing selection vector if this PCI has been filtered
   const uint32_t *sel_vec = (IsFiltered() ? selection_vector_ : nullptr);
 
@@ -111,6 +176,114 @@ uint32_t ProjectedColumnsIterator::FilterColByCol(const uint32_t col_idx_1, type
   }
 }
 
+template <typename F>
+uint32_t ProjectedColumnsIterator::FilterByIndex(const F &pred) {
+  const uint32_t *sel_vec = (IsFiltered() ? selection_vector_ : nullptr);
+  uint32_t out_pos = 0;
+  if (sel_vec == nullptr) {
+    for (uint32_t in_pos = 0; in_pos < num_selected_; in_pos++) {
+      selection_vector_[out_pos] = in_pos;
+      out_pos += static_cast<uint32_t>(pred(in_pos));
+    }
+  } else {
+    // Never writes past the position it reads from, so the selection vector can be filtered in place
+    for (uint32_t in_pos = 0; in_pos < num_selected_; in_pos++) {
+      const uint32_t idx = sel_vec[in_pos];
+      selection_vector_[out_pos] = idx;
+      out_pos += static_cast<uint32_t>(pred(idx));
+    }
+  }
+  selection_vector_write_idx_ = out_pos;
+  ResetFiltered();
+  return NumSelected();
+}
+
+uint32_t ProjectedColumnsIterator::FilterCodesInRange(const uint32_t col_idx, const uint32_t lo, const uint32_t hi) {
+  // Codes are bounded by the number of slots in a block, so they compare the same as signed integers
+  const auto *codes = reinterpret_cast<const int32_t *>(col_codes_[col_idx]);
+  const uint32_t num_words = col_dictionaries_[col_idx]->OffsetsLength() - 1;
+  // Skip the comparisons that every code passes. An empty range needs at least one of them to filter everything out.
+  if (lo > 0 || lo >= hi) FilterValuesByVal<int32_t, std::greater_equal>(codes, static_cast<int32_t>(lo));
+  if (hi < num_words) FilterValuesByVal<int32_t, std::less>(codes, static_cast<int32_t>(hi));
+  return NumSelected();
+}
+
+uint32_t ProjectedColumnsIterator::FilterByNullBitmap(const uint32_t col_idx, const bool present) {
+  const auto *bits = reinterpret_cast<const uint8_t *>(col_nulls_[col_idx]);
+  if (!IsFiltered()) {
+    // If every tuple passes, as IS NOT NULL does on the many columns without NULLs, a popcount says so without building
+    // a selection vector
+    const uint32_t num_present = util::VectorUtil::CountBits(bits, num_selected_);
+    if (num_present == (present ? num_selected_ : 0)) return NumSelected();
+  }
+
+  // Use the existing selection vector if this PCI has been filtered
+  const uint32_t *sel_vec = (IsFiltered() ? selection_vector_ : nullptr);
+  selection_vector_write_idx_ =
+      util::VectorUtil::FilterBitVectorByVal(bits, num_selected_, present, selection_vector_, sel_vec);
+  ResetFiltered();
+  return NumSelected();
+}
+
+template <template <typename> typename Op>
+uint32_t ProjectedColumnsIterator::FilterStringColByVal(const uint32_t col_idx, const storage::VarlenEntry &val) {
+  // NULLs never pass, and the codes of NULL values are garbage anyway
+  FilterColIsNotNull(col_idx);
+
+  const storage::ArrowVarlenColumn *dictionary = col_dictionaries_[col_idx];
+  if (dictionary == nullptr) {
+    const auto *input = reinterpret_cast<const storage::VarlenEntry *>(col_data_[col_idx]);
+    return FilterByIndex([&](uint32_t idx) {
+      return Op<int>()(CompareStrings(input[idx].Content(), input[idx].Size(), val.Content(), val.Size()), 0);
+    });
+  }
+
+  // The words equal to val, if any, are the codes in [lower, upper) of the sorted dictionary
+  const uint32_t lower = PartitionPoint(*dictionary, 0, [&](const byte *word, uint32_t size) {
+    return CompareStrings(word, size, val.Content(), val.Size()) < 0;
+  });
+  const uint32_t upper = PartitionPoint(*dictionary, lower, [&](const byte *word, uint32_t size) {
+    return CompareStrings(word, size, val.Content(), val.Size()) <= 0;
+  });
+  const uint32_t num_words = dictionary->OffsetsLength() - 1;
+  if constexpr (std::is_same_v<Op<int>, std::equal_to<int>>) {
+    return FilterCodesInRange(col_idx, lower, upper);
+  } else if constexpr (std::is_same_v<Op<int>, std::not_equal_to<int>>) {  // NOLINT
+    if (lower == upper) return NumSelected();
+    return FilterValuesByVal<int32_t, std::not_equal_to>(reinterpret_cast<const int32_t *>(col_codes_[col_idx]),
+                                                         static_cast<int32_t>(lower));
+  } else if constexpr (std::is_same_v<Op<int>, std::less<int>>) {  // NOLINT
+    return FilterCodesInRange(col_idx, 0, lower);
+  } else if constexpr (std::is_same_v<Op<int>, std::less_equal<int>>) {  // NOLINT
+    return FilterCodesInRange(col_idx, 0, upper);
+  } else if constexpr (std::is_same_v<Op<int>, std::greater<int>>) {  // NOLINT
+    return FilterCodesInRange(col_idx, upper, num_words);
+  } else {  // NOLINT
+    static_assert(std::is_same_v<Op<int>, std::greater_equal<int>>, "Unsupported filter operator");
+    return FilterCodesInRange(col_idx, lower, num_words);
+  }
+}
+
+uint32_t ProjectedColumnsIterator::FilterStringColByPrefix(const uint32_t col_idx,
+                                                           const storage::VarlenEntry &prefix) {
+  FilterColIsNotNull(col_idx);
+
+  const storage::ArrowVarlenColumn *dictionary = col_dictionaries_[col_idx];
+  if (dictionary == nullptr) {
+    const auto *input = reinterpret_cast<const storage::VarlenEntry *>(col_data_[col_idx]);
+    return FilterByIndex(
+        [&](uint32_t idx) { return HasPrefix(input[idx].Content(), input[idx].Size(), prefix); });
+  }
+
+  // Every word with the prefix sorts after the prefix itself, and before every word without it that is not smaller
+  const uint32_t lower = PartitionPoint(*dictionary, 0, [&](const byte *word, uint32_t size) {
+    return CompareStrings(word, size, prefix.Content(), prefix.Size()) < 0;
+  });
+  const uint32_t upper = PartitionPoint(*dictionary, lower,
+                                        [&](const byte *word, uint32_t size) { return HasPrefix(word, size, prefix); });
+  return FilterCodesInRange(col_idx, lower, upper);
+}
+
 template uint32_t ProjectedColumnsIterator::FilterColByVal<std::equal_to>(uint32_t, type::TypeId, FilterVal);
 template uint32_t ProjectedColumnsIterator::FilterColByVal<std::greater>(uint32_t, type::TypeId, FilterVal);
 template uint32_t ProjectedColumnsIterator::FilterColByVal<std::greater_equal>(uint32_t, type::TypeId, FilterVal);
@@ -128,5 +301,14 @@ template uint32_t ProjectedColumnsIterator::FilterColByCol<std::less_equal>(uint
                                                                             type::TypeId);
 template uint32_t ProjectedColumnsIterator::FilterColByCol<std::not_equal_to>(uint32_t, type::TypeId, uint32_t,
                                                                               type::TypeId);
+template uint32_t ProjectedColumnsIterator::FilterStringColByVal<std::equal_to>(uint32_t, const storage::VarlenEntry &);
+template uint32_t ProjectedColumnsIterator::FilterStringColByVal<std::greater>(uint32_t, const storage::VarlenEntry &);
+template uint32_t ProjectedColumnsIterator::FilterStringColByVal<std::greater_equal>(uint32_t,
+                                                                                   const storage::VarlenEntry &);
+template uint32_t ProjectedColumnsIterator::FilterStringColByVal<std::less>(uint32_t, const storage::VarlenEntry &);
+template uint32_t ProjectedColumnsIterator::FilterStringColByVal<std::less_equal>(uint32_t,
+                                                                                const storage::VarlenEntry &);
+template uint32_t ProjectedColumnsIterator::FilterStringColByVal<std::not_equal_to>(uint32_t,
+                                                                                  const storage::VarlenEntry &);
 
 }  // namespace terrier::execution::sql
@@ -1,9 +1,14 @@
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "execution/exec/execution_context.h"
 #include "execution/sql/table_vector_iterator.h"
+#include "execution/sql/thread_state_container.h"
 #include "execution/util/timer.h"
+#include "loggers/execution_logger.h"
 #include "tbb/blocked_range.h"
 #include "tbb/parallel_for.h"
 #include "tbb/task_scheduler_init.h"
@@ -13,13 +18,32 @@ TableVectorIterator::TableVectorIterator(exec::ExecutionContext *exec_ctx, uint3
                                          uint32_t num_oids)
     : exec_ctx_(exec_ctx), table_oid_(table_oid), col_oids_(col_oids, col_oids + num_oids) {}
 
+TableVectorIterator::TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid, uint32_t *col_oids,
+                                         uint32_t num_oids, uint32_t start_block_idx, uint32_t end_block_idx)
+    : exec_ctx_(exec_ctx),
+      table_oid_(table_oid),
+      col_oids_(col_oids, col_oids + num_oids),
+      start_block_idx_(start_block_idx),
+      end_block_idx_(end_block_idx) {}
+
+TableVectorIterator::TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid,
+                                         common::ManagedPointer<storage::SqlTable> table, uint32_t *col_oids,
+                                         uint32_t num_oids, uint32_t start_block_idx, uint32_t end_block_idx)
+    : exec_ctx_(exec_ctx),
+      table_oid_(table_oid),
+      col_oids_(col_oids, col_oids + num_oids),
+      table_(table),
+      start_block_idx_(start_block_idx),
+      end_block_idx_(end_block_idx) {}
+
 TableVectorIterator::~TableVectorIterator() {
-  exec_ctx_->GetMemoryPool()->Deallocate(buffer_, projected_columns_->Size());
+  ReleaseInPlaceBlock();
+  if (initialized_) exec_ctx_->GetMemoryPool()->Deallocate(buffer_, projected_columns_->Size());
 }
 
 bool TableVectorIterator::Init() {
-  // Find the table
-  table_ = exec_ctx_->GetAccessor()->GetTable(table_oid_);
+  // Find the table, unless it has already been resolved
+  if (table_ == nullptr) table_ = exec_ctx_->GetAccessor()->GetTable(table_oid_);
   TERRIER_ASSERT(table_ != nullptr, "Table must exist!!");
 
   // Initialize the projected column
@@ -27,30 +51,137 @@ bool TableVectorIterator::Init() {
   auto pc_init = table_->InitializerForProjectedColumns(col_oids_, common::Constants::K_DEFAULT_VECTOR_SIZE);
   buffer_ = exec_ctx_->GetMemoryPool()->AllocateAligned(pc_init.ProjectedColumnsSize(), alignof(uint64_t), false);
   projected_columns_ = pc_init.Initialize(buffer_);
+  // In-place scans can still be turned on after this point, so always make room for what they hand to the PCI
+  in_place_columns_.resize(projected_columns_->NumColumns());
+  in_place_nulls_.resize(projected_columns_->NumColumns());
+  in_place_codes_.resize(projected_columns_->NumColumns());
+  in_place_dictionaries_.resize(projected_columns_->NumColumns());
   initialized_ = true;
 
   // Begin iterating
-  iter_ = std::make_unique<storage::DataTable::SlotIterator>(table_->begin());
+  iter_ = std::make_unique<storage::DataTable::SlotIterator>(table_->beginAt(start_block_idx_));
+  // A bounded block range has a fixed end. Otherwise, we scan up to the end of the table as of each Advance().
+  if (end_block_idx_ != std::numeric_limits<uint32_t>::max()) {
+    end_iter_ = std::make_unique<storage::DataTable::SlotIterator>(table_->endAt(end_block_idx_));
+  }
   return true;
 }
 
 bool TableVectorIterator::Advance() {
   if (!initialized_) return false;
-  // First check if the iterator ended.
-  if (*iter_ == table_->end()) {
-    return false;
+  // The PCI is about to move on, so it no longer needs the block it was reading in place
+  ReleaseInPlaceBlock();
+  const storage::DataTable::SlotIterator end = end_iter_ == nullptr ? table_->end() : *end_iter_;
+  while (true) {
+    // Skip over the frozen blocks that the zone maps rule out
+    while (*iter_ != end && (*iter_)->GetOffset() == 0 && ZoneMapsRuleOutBlock()) {
+      table_->SkipBlock(iter_.get(), end);
+      num_skipped_blocks_++;
+    }
+    // Then check if the iterator ended.
+    if (*iter_ == end) {
+      return false;
+    }
+    if (!in_place_scan_) break;
+    // Point the PCI straight at the next frozen block, if there is one.
+    uint32_t num_tuples = 0;
+    in_place_block_ = table_->ScanInPlace(iter_.get(), end, projected_columns_->ColumnIds(),
+                                          projected_columns_->NumColumns(), projected_columns_->MaxTuples(),
+                                          in_place_columns_.data(), in_place_nulls_.data(), &num_tuples,
+                                          in_place_codes_.data(), in_place_dictionaries_.data(), projected_columns_);
+    if (in_place_block_ == nullptr) break;
+    if (num_tuples != 0) {
+      pci_.SetColumns(projected_columns_->NumColumns(), in_place_columns_.data(), in_place_nulls_.data(), num_tuples,
+                      in_place_codes_.data(), in_place_dictionaries_.data());
+      return true;
+    }
+    // Nothing left to read in this frozen block. The iterator has moved past it, so try the next one.
+    ReleaseInPlaceBlock();
   }
   // Scan the table to set the projected column.
-  table_->Scan(exec_ctx_->GetTxn(), iter_.get(), projected_columns_);
+  table_->Scan(exec_ctx_->GetTxn(), iter_.get(), end, projected_columns_);
   pci_.SetProjectedColumn(projected_columns_);
   return true;
 }
 
-bool TableVectorIterator::ParallelScan(uint32_t db_oid, uint32_t table_oid, void *const query_state,
-                                       ThreadStateContainer *const thread_states, const ScanFn scan_fn,
-                                       const uint32_t min_grain_size) {
-  // TODO(Amadou): Implement Me!!
+template <template <typename> typename Op>
+void TableVectorIterator::AddZoneMapFilter(const uint32_t col_idx, const type::TypeId type, const int64_t val) {
+  switch (type) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      zone_map_filters_.push_back({static_cast<uint16_t>(col_idx), val, &ZoneMapMayMatch<Op>});
+      break;
+    default:
+      throw std::runtime_error("Filter not supported on type");
+  }
+}
+
+template <template <typename> typename Op>
+bool TableVectorIterator::ZoneMapMayMatch(const int64_t min, const int64_t max, const int64_t val) {
+  // Equality needs val to lie within the range. For the other comparisons, one of the ends of the range satisfies
+  // the predicate if any value in the range does.
+  if constexpr (std::is_same_v<Op<int64_t>, std::equal_to<int64_t>>) {
+    return min <= val && val <= max;
+  } else {  // NOLINT
+    return Op<int64_t>()(min, val) || Op<int64_t>()(max, val);
+  }
+}
+
+bool TableVectorIterator::ZoneMapsRuleOutBlock() const {
+  for (const auto &filter : zone_map_filters_) {
+    storage::ColumnZoneMap zone_map;
+    uint32_t num_values;
+    // Only frozen blocks have zone maps
+    if (!table_->ReadZoneMap(*iter_, projected_columns_->ColumnIds()[filter.col_idx_], &zone_map, &num_values))
+      return false;
+    // Nulls never satisfy a comparison
+    if (num_values == 0 || !filter.may_match_(zone_map.Min(), zone_map.Max(), filter.val_)) return true;
+  }
   return false;
 }
 
+template void TableVectorIterator::AddZoneMapFilter<std::equal_to>(uint32_t, type::TypeId, int64_t);
+template void TableVectorIterator::AddZoneMapFilter<std::greater>(uint32_t, type::TypeId, int64_t);
+template void TableVectorIterator::AddZoneMapFilter<std::greater_equal>(uint32_t, type::TypeId, int64_t);
+template void TableVectorIterator::AddZoneMapFilter<std::less>(uint32_t, type::TypeId, int64_t);
+template void TableVectorIterator::AddZoneMapFilter<std::less_equal>(uint32_t, type::TypeId, int64_t);
+template void TableVectorIterator::AddZoneMapFilter<std::not_equal_to>(uint32_t, type::TypeId, int64_t);
+
+void TableVectorIterator::ReleaseInPlaceBlock() {
+  if (in_place_block_ == nullptr) return;
+  in_place_block_->controller_.ReleaseInPlaceRead();
+  in_place_block_ = nullptr;
+}
+
+bool TableVectorIterator::ParallelScan(const uint32_t table_oid, uint32_t *const col_oids, const uint32_t num_oids,
+                                       void *const query_state, ThreadStateContainer *const thread_states,
+                                       exec::ExecutionContext *const exec_ctx, const ScanFn scan_fn,
+                                       const uint32_t min_grain_size) {
+  // Lookup the table once, so that workers do not have to go through the catalog
+  const auto table = exec_ctx->GetAccessor()->GetTable(catalog::table_oid_t(table_oid));
+  if (table == nullptr) return false;
+
+  util::Timer<std::milli> timer;
+  timer.Start();
+
+  // Blocks appended after this point hold tuples that are not visible to the scanning transaction anyway
+  const uint32_t num_blocks = table->GetNumBlocks();
+
+  // Split the table into block ranges. Each range gets its own iterator, and thus its own projected columns buffer,
+  // and is handed to the scan function along with the state of the executing thread.
+  tbb::task_scheduler_init scan_scheduler;
+  tbb::blocked_range<uint32_t> block_range(0, num_blocks, std::max(min_grain_size, K_MIN_BLOCK_RANGE_SIZE));
+  tbb::parallel_for(block_range, [&](const tbb::blocked_range<uint32_t> &range) {
+    TableVectorIterator iter(exec_ctx, table_oid, table, col_oids, num_oids, range.begin(), range.end());
+    iter.Init();
+    scan_fn(query_state, thread_states->AccessThreadStateOfCurrentThread(), &iter);
+  });
+
+  timer.Stop();
+  EXECUTION_LOG_DEBUG("Scanned {} blocks in parallel in {} ms", num_blocks, timer.Elapsed());
+  return true;
+}
+
 }  // namespace terrier::execution::sql
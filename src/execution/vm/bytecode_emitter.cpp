@@ -263,9 +263,15 @@ void BytecodeEmitter::EmitAddCol(Bytecode bytecode, LocalVar iter, uint32_t col_
   EmitAll(bytecode, iter, col_oid);
 }
 
-void BytecodeEmitter::EmitParallelTableScan(uint32_t db_oid, uint32_t table_oid, LocalVar ctx, LocalVar thread_states,
+void BytecodeEmitter::EmitParallelTableScan(uint32_t table_oid, LocalVar col_oids, uint32_t num_oids,
+                                            LocalVar query_state, LocalVar thread_states, LocalVar exec_ctx,
                                             FunctionId scan_fn) {
-  EmitAll(Bytecode::ParallelScanTable, db_oid, table_oid, ctx, thread_states, scan_fn);
+  EmitAll(Bytecode::ParallelScanTable, table_oid, col_oids, num_oids, query_state, thread_states, exec_ctx, scan_fn);
+}
+
+void BytecodeEmitter::EmitTableIterZoneMapFilter(Bytecode bytecode, LocalVar iter, uint32_t col_idx, int8_t type,
+                                                 int64_t val) {
+  EmitAll(bytecode, iter, col_idx, type, val);
 }
 
 void BytecodeEmitter::EmitPCIGet(Bytecode bytecode, LocalVar out, LocalVar pci, uint16_t col_idx) {
@@ -277,6 +283,11 @@ void BytecodeEmitter::EmitPCIVectorFilter(Bytecode bytecode, LocalVar selected,
   EmitAll(bytecode, selected, pci, col_idx, type, val);
 }
 
+void BytecodeEmitter::EmitPCIStringFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx,
+                                          uint64_t length, uintptr_t data) {
+  EmitAll(bytecode, selected, pci, col_idx, length, data);
+}
+
 void BytecodeEmitter::EmitFilterManagerInsertFlavor(LocalVar fmb, FunctionId func) {
   EmitAll(Bytecode::FilterManagerInsertFlavor, fmb, func);
 }
@@ -548,6 +548,46 @@ void BytecodeGenerator::VisitBuiltinTableIterCall(ast::CallExpr *call, ast::Buil
       Emitter()->Emit(Bytecode::TableVectorIteratorFree, iter);
       break;
     }
+    case ast::Builtin::TableIterZoneMapEq:
+    case ast::Builtin::TableIterZoneMapGt:
+    case ast::Builtin::TableIterZoneMapGe:
+    case ast::Builtin::TableIterZoneMapLt:
+    case ast::Builtin::TableIterZoneMapLe:
+    case ast::Builtin::TableIterZoneMapNe: {
+      // The column index, its type, and the value to compare it to
+      auto col_idx = static_cast<uint32_t>(call->Arguments()[1]->As<ast::LitExpr>()->Int64Val());
+      auto col_type = static_cast<int8_t>(call->Arguments()[2]->As<ast::LitExpr>()->Int64Val());
+      int64_t val = call->Arguments()[3]->As<ast::LitExpr>()->Int64Val();
+      Bytecode bytecode;
+      switch (builtin) {
+        case ast::Builtin::TableIterZoneMapEq:
+          bytecode = Bytecode::TableVectorIteratorZoneMapEqual;
+          break;
+        case ast::Builtin::TableIterZoneMapGt:
+          bytecode = Bytecode::TableVectorIteratorZoneMapGreaterThan;
+          break;
+        case ast::Builtin::TableIterZoneMapGe:
+          bytecode = Bytecode::TableVectorIteratorZoneMapGreaterThanEqual;
+          break;
+        case ast::Builtin::TableIterZoneMapLt:
+          bytecode = Bytecode::TableVectorIteratorZoneMapLessThan;
+          break;
+        case ast::Builtin::TableIterZoneMapLe:
+          bytecode = Bytecode::TableVectorIteratorZoneMapLessThanEqual;
+          break;
+        case ast::Builtin::TableIterZoneMapNe:
+          bytecode = Bytecode::TableVectorIteratorZoneMapNotEqual;
+          break;
+        default:
+          UNREACHABLE("Impossible zone map filter");
+      }
+      Emitter()->EmitTableIterZoneMapFilter(bytecode, iter, col_idx, col_type, val);
+      break;
+    }
+    case ast::Builtin::TableIterInPlace: {
+      Emitter()->Emit(Bytecode::TableVectorIteratorSetInPlaceScan, iter);
+      break;
+    }
     default: {
       UNREACHABLE("Impossible table iteration call");
     }
@@ -555,7 +595,25 @@ void BytecodeGenerator::VisitBuiltinTableIterCall(ast::CallExpr *call, ast::Buil
 }
 
 void BytecodeGenerator::VisitBuiltinTableIterParallelCall(ast::CallExpr *call) {
-  UNREACHABLE("Parallel scan is not implemented yet!");
+  // The first argument is the table name
+  ast::Identifier table_name = call->Arguments()[0]->As<ast::LitExpr>()->RawStringVal();
+  auto ns_oid = exec_ctx_->GetAccessor()->GetDefaultNamespace();
+  auto table_oid = exec_ctx_->GetAccessor()->GetTableOid(ns_oid, table_name.Data());
+  TERRIER_ASSERT(table_oid != terrier::catalog::INVALID_TABLE_OID, "Table does not exists");
+  // The second argument is the array of oids
+  auto *arr_type = call->Arguments()[1]->GetType()->As<ast::ArrayType>();
+  LocalVar col_oids = VisitExpressionForLValue(call->Arguments()[1]);
+  // The third argument is the opaque query state
+  LocalVar query_state = VisitExpressionForRValue(call->Arguments()[2]);
+  // The fourth argument is the thread state container
+  LocalVar thread_states = VisitExpressionForRValue(call->Arguments()[3]);
+  // The fifth argument is the execution context
+  LocalVar exec_ctx = VisitExpressionForRValue(call->Arguments()[4]);
+  // The last argument is the scan function
+  auto scan_fn = LookupFuncIdByName(call->Arguments()[5]->As<ast::IdentifierExpr>()->Name().Data());
+  // Emit the parallel scan
+  Emitter()->EmitParallelTableScan(!table_oid, col_oids, static_cast<uint32_t>(arr_type->Length()), query_state,
+                                   thread_states, exec_ctx, scan_fn);
 }
 
 void BytecodeGenerator::VisitBuiltinPCICall(ast::CallExpr *call, ast::Builtin builtin) {
@@ -830,6 +888,62 @@ void BytecodeGenerator::VisitBuiltinFilterCall(ast::CallExpr *call, ast::Builtin
   Emitter()->EmitPCIVectorFilter(bytecode, ret_val, pci, col_idx, col_type, val);
 }
 
+void BytecodeGenerator::VisitBuiltinStringFilterCall(ast::CallExpr *call, ast::Builtin builtin) {
+  LocalVar ret_val;
+  if (ExecutionResult() != nullptr) {
+    ret_val = ExecutionResult()->GetOrCreateDestination(call->GetType());
+    ExecutionResult()->SetDestination(ret_val.ValueOf());
+  } else {
+    ret_val = CurrentFunction()->NewLocal(call->GetType());
+  }
+
+  // Projected Column Iterator
+  LocalVar pci = VisitExpressionForRValue(call->Arguments()[0]);
+  // Column index
+  auto col_idx = static_cast<uint32_t>(call->Arguments()[1]->As<ast::LitExpr>()->Int64Val());
+  // Copy the string to compare to into the execution context's buffer, as for StringToSql
+  auto input = call->Arguments()[2]->As<ast::LitExpr>()->RawStringVal();
+  auto input_length = input.Length();
+  auto *data = exec_ctx_->GetStringAllocator()->Allocate(input_length);
+  std::memcpy(data, input.Data(), input_length);
+
+  Bytecode bytecode;
+  switch (builtin) {
+    case ast::Builtin::FilterStringEq: {
+      bytecode = Bytecode::PCIFilterStringEqual;
+      break;
+    }
+    case ast::Builtin::FilterStringGt: {
+      bytecode = Bytecode::PCIFilterStringGreaterThan;
+      break;
+    }
+    case ast::Builtin::FilterStringGe: {
+      bytecode = Bytecode::PCIFilterStringGreaterThanEqual;
+      break;
+    }
+    case ast::Builtin::FilterStringLt: {
+      bytecode = Bytecode::PCIFilterStringLessThan;
+      break;
+    }
+    case ast::Builtin::FilterStringLe: {
+      bytecode = Bytecode::PCIFilterStringLessThanEqual;
+      break;
+    }
+    case ast::Builtin::FilterStringNe: {
+      bytecode = Bytecode::PCIFilterStringNotEqual;
+      break;
+    }
+    case ast::Builtin::FilterStringPrefix: {
+      bytecode = Bytecode::PCIFilterStringPrefix;
+      break;
+    }
+    default: {
+      UNREACHABLE("Impossible bytecode");
+    }
+  }
+  Emitter()->EmitPCIStringFilter(bytecode, ret_val, pci, col_idx, input_length, reinterpret_cast<uintptr_t>(data));
+}
+
 void BytecodeGenerator::VisitBuiltinAggHashTableCall(ast::CallExpr *call, ast::Builtin builtin) {
   switch (builtin) {
     case ast::Builtin::AggHashTableInit: {
@@ -1625,6 +1739,16 @@ void BytecodeGenerator::VisitBuiltinCallExpr(ast::CallExpr *call) {
       VisitBuiltinFilterCall(call, builtin);
       break;
     }
+    case ast::Builtin::FilterStringEq:
+    case ast::Builtin::FilterStringGe:
+    case ast::Builtin::FilterStringGt:
+    case ast::Builtin::FilterStringLe:
+    case ast::Builtin::FilterStringLt:
+    case ast::Builtin::FilterStringNe:
+    case ast::Builtin::FilterStringPrefix: {
+      VisitBuiltinStringFilterCall(call, builtin);
+      break;
+    }
     case ast::Builtin::ExecutionContextGetMemoryPool: {
       VisitExecutionContextCall(call, builtin);
       break;
@@ -1640,7 +1764,14 @@ void BytecodeGenerator::VisitBuiltinCallExpr(ast::CallExpr *call) {
     case ast::Builtin::TableIterInitBind:
     case ast::Builtin::TableIterAdvance:
     case ast::Builtin::TableIterGetPCI:
-    case ast::Builtin::TableIterClose: {
+    case ast::Builtin::TableIterClose:
+    case ast::Builtin::TableIterZoneMapEq:
+    case ast::Builtin::TableIterZoneMapGt:
+    case ast::Builtin::TableIterZoneMapGe:
+    case ast::Builtin::TableIterZoneMapLt:
+    case ast::Builtin::TableIterZoneMapLe:
+    case ast::Builtin::TableIterZoneMapNe:
+    case ast::Builtin::TableIterInPlace: {
       VisitBuiltinTableIterCall(call, builtin);
       break;
     }
@@ -4,6 +4,17 @@
 #include "catalog/catalog_defs.h"
 #include "execution/exec/execution_context.h"
 
+namespace {
+// The string literal of a string filter, which lives as long as the query does
+terrier::storage::VarlenEntry MakeFilterString(const uint64_t length, const uintptr_t data) {
+  auto *content = reinterpret_cast<terrier::byte *>(data);
+  const auto size = static_cast<uint32_t>(length);
+  if (size <= terrier::storage::VarlenEntry::InlineThreshold())
+    return terrier::storage::VarlenEntry::CreateInline(content, size);
+  return terrier::storage::VarlenEntry::Create(content, size, false);
+}
+}  // namespace
+
 extern "C" {
 
 // ---------------------------------------------------------
@@ -37,6 +48,40 @@ void OpTableVectorIteratorFree(terrier::execution::sql::TableVectorIterator *ite
   iter->~TableVectorIterator();
 }
 
+void OpTableVectorIteratorZoneMapEqual(terrier::execution::sql::TableVectorIterator *iter, uint32_t col_idx,
+                                       int8_t type, int64_t val) {
+  iter->AddZoneMapFilter<std::equal_to>(col_idx, static_cast<terrier::type::TypeId>(type), val);
+}
+
+void OpTableVectorIteratorZoneMapGreaterThan(terrier::execution::sql::TableVectorIterator *iter, uint32_t col_idx,
+                                             int8_t type, int64_t val) {
+  iter->AddZoneMapFilter<std::greater>(col_idx, static_cast<terrier::type::TypeId>(type), val);
+}
+
+void OpTableVectorIteratorZoneMapGreaterThanEqual(terrier::execution::sql::TableVectorIterator *iter, uint32_t col_idx,
+                                                  int8_t type, int64_t val) {
+  iter->AddZoneMapFilter<std::greater_equal>(col_idx, static_cast<terrier::type::TypeId>(type), val);
+}
+
+void OpTableVectorIteratorZoneMapLessThan(terrier::execution::sql::TableVectorIterator *iter, uint32_t col_idx,
+                                          int8_t type, int64_t val) {
+  iter->AddZoneMapFilter<std::less>(col_idx, static_cast<terrier::type::TypeId>(type), val);
+}
+
+void OpTableVectorIteratorZoneMapLessThanEqual(terrier::execution::sql::TableVectorIterator *iter, uint32_t col_idx,
+                                               int8_t type, int64_t val) {
+  iter->AddZoneMapFilter<std::less_equal>(col_idx, static_cast<terrier::type::TypeId>(type), val);
+}
+
+void OpTableVectorIteratorZoneMapNotEqual(terrier::execution::sql::TableVectorIterator *iter, uint32_t col_idx,
+                                          int8_t type, int64_t val) {
+  iter->AddZoneMapFilter<std::not_equal_to>(col_idx, static_cast<terrier::type::TypeId>(type), val);
+}
+
+void OpTableVectorIteratorSetInPlaceScan(terrier::execution::sql::TableVectorIterator *iter) {
+  iter->SetInPlaceScan(true);
+}
+
 void OpPCIFilterEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
                       int8_t type, int64_t val) {
   auto sql_type = static_cast<terrier::type::TypeId>(type);
@@ -79,6 +124,41 @@ void OpPCIFilterNotEqual(uint64_t *size, terrier::execution::sql::ProjectedColum
   *size = iter->FilterColByVal<std::not_equal_to>(col_idx, sql_type, v);
 }
 
+void OpPCIFilterStringEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                            uint32_t col_idx, uint64_t length, uintptr_t data) {
+  *size = iter->FilterStringColByVal<std::equal_to>(col_idx, MakeFilterString(length, data));
+}
+
+void OpPCIFilterStringGreaterThan(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                  uint32_t col_idx, uint64_t length, uintptr_t data) {
+  *size = iter->FilterStringColByVal<std::greater>(col_idx, MakeFilterString(length, data));
+}
+
+void OpPCIFilterStringGreaterThanEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                       uint32_t col_idx, uint64_t length, uintptr_t data) {
+  *size = iter->FilterStringColByVal<std::greater_equal>(col_idx, MakeFilterString(length, data));
+}
+
+void OpPCIFilterStringLessThan(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                               uint32_t col_idx, uint64_t length, uintptr_t data) {
+  *size = iter->FilterStringColByVal<std::less>(col_idx, MakeFilterString(length, data));
+}
+
+void OpPCIFilterStringLessThanEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                    uint32_t col_idx, uint64_t length, uintptr_t data) {
+  *size = iter->FilterStringColByVal<std::less_equal>(col_idx, MakeFilterString(length, data));
+}
+
+void OpPCIFilterStringNotEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                               uint32_t col_idx, uint64_t length, uintptr_t data) {
+  *size = iter->FilterStringColByVal<std::not_equal_to>(col_idx, MakeFilterString(length, data));
+}
+
+void OpPCIFilterStringPrefix(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                             uint32_t col_idx, uint64_t length, uintptr_t data) {
+  *size = iter->FilterStringColByPrefix(col_idx, MakeFilterString(length, data));
+}
+
 // ---------------------------------------------------------
 // Filter Manager
 // ---------------------------------------------------------
@@ -526,15 +526,40 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
     DISPATCH_NEXT();
   }
 
+#define GEN_TABLE_ITER_ZONE_MAP(Op)                                           \
+  OP(TableVectorIteratorZoneMap##Op) : {                                      \
+    auto *iter = frame->LocalAt<sql::TableVectorIterator *>(READ_LOCAL_ID()); \
+    auto col_idx = READ_UIMM4();                                              \
+    auto type = READ_IMM1();                                                  \
+    auto val = READ_IMM8();                                                   \
+    OpTableVectorIteratorZoneMap##Op(iter, col_idx, type, val);               \
+    DISPATCH_NEXT();                                                          \
+  }
+  GEN_TABLE_ITER_ZONE_MAP(Equal)
+  GEN_TABLE_ITER_ZONE_MAP(GreaterThan)
+  GEN_TABLE_ITER_ZONE_MAP(GreaterThanEqual)
+  GEN_TABLE_ITER_ZONE_MAP(LessThan)
+  GEN_TABLE_ITER_ZONE_MAP(LessThanEqual)
+  GEN_TABLE_ITER_ZONE_MAP(NotEqual)
+#undef GEN_TABLE_ITER_ZONE_MAP
+
+  OP(TableVectorIteratorSetInPlaceScan) : {
+    auto *iter = frame->LocalAt<sql::TableVectorIterator *>(READ_LOCAL_ID());
+    OpTableVectorIteratorSetInPlaceScan(iter);
+    DISPATCH_NEXT();
+  }
+
   OP(ParallelScanTable) : {
-    auto db_oid = READ_UIMM4();
     auto table_oid = READ_UIMM4();
+    auto col_oids = frame->LocalAt<uint32_t *>(READ_LOCAL_ID());
+    auto num_oids = READ_UIMM4();
     auto query_state = frame->LocalAt<void *>(READ_LOCAL_ID());
     auto thread_state_container = frame->LocalAt<sql::ThreadStateContainer *>(READ_LOCAL_ID());
+    auto exec_ctx = frame->LocalAt<exec::ExecutionContext *>(READ_LOCAL_ID());
     auto scan_fn_id = READ_FUNC_ID();
 
     auto scan_fn = reinterpret_cast<sql::TableVectorIterator::ScanFn>(module_->GetRawFunctionImpl(scan_fn_id));
-    OpParallelScanTable(db_oid, table_oid, query_state, thread_state_container, scan_fn);
+    OpParallelScanTable(table_oid, col_oids, num_oids, query_state, thread_state_container, exec_ctx, scan_fn);
     DISPATCH_NEXT();
   }
 
@@ -642,6 +667,25 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
   GEN_PCI_FILTER(NotEqual)
 #undef GEN_PCI_FILTER
 
+#define GEN_PCI_STRING_FILTER(Op)                                                  \
+  OP(PCIFilterString##Op) : {                                                      \
+    auto *size = frame->LocalAt<uint64_t *>(READ_LOCAL_ID());                      \
+    auto *iter = frame->LocalAt<sql::ProjectedColumnsIterator *>(READ_LOCAL_ID()); \
+    auto col_idx = READ_UIMM4();                                                   \
+    auto length = static_cast<uint64_t>(READ_IMM8());                              \
+    auto data = static_cast<uintptr_t>(READ_IMM8());                               \
+    OpPCIFilterString##Op(size, iter, col_idx, length, data);                      \
+    DISPATCH_NEXT();                                                               \
+  }
+  GEN_PCI_STRING_FILTER(Equal)
+  GEN_PCI_STRING_FILTER(GreaterThan)
+  GEN_PCI_STRING_FILTER(GreaterThanEqual)
+  GEN_PCI_STRING_FILTER(LessThan)
+  GEN_PCI_STRING_FILTER(LessThanEqual)
+  GEN_PCI_STRING_FILTER(NotEqual)
+  GEN_PCI_STRING_FILTER(Prefix)
+#undef GEN_PCI_STRING_FILTER
+
   // ------------------------------------------------------
   // Hashing
   // ------------------------------------------------------
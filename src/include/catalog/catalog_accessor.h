@@ -181,6 +181,13 @@ class CatalogAccessor {
    */
   const Schema &GetSchema(table_oid_t table) const;
 
+  /**
+   * Get the visible layout version of the table, which projections on its SqlTable should be laid out for.
+   * @param table corresponding to the requested layout version
+   * @return the layout version of the table that goes with the visible schema
+   */
+  storage::layout_version_t GetLayoutVersion(table_oid_t table) const;
+
   /**
    * A list of all constraints on this table
    * @param table being queried
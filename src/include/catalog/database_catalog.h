@@ -132,6 +132,11 @@ class DatabaseCatalog {
    * Apply a new schema to the given table.  The changes should modify the latest
    * schema as provided by the catalog.  There is no guarantee that the OIDs for
    * modified columns will be stable across a schema change.
+   *
+   * Columns that keep their OID, name and type keep their values.  The table's
+   * SqlTable gets a new layout version, which GetLayoutVersion returns once the
+   * change is visible, and tuples written before the change have to be moved
+   * with SqlTable::Migrate before the columns added by it can be written.
    * @param txn for the operation
    * @param table OID of the modified table
    * @param new_schema object describing the table after modification
@@ -152,6 +157,14 @@ class DatabaseCatalog {
    */
   const Schema &GetSchema(transaction::TransactionContext *txn, table_oid_t table);
 
+  /**
+   * Get the visible layout version of the table, which projections on its SqlTable should be laid out for.
+   * @param txn for the operation
+   * @param table corresponding to the requested layout version
+   * @return the layout version of the table that goes with the schema visible to txn
+   */
+  storage::layout_version_t GetLayoutVersion(transaction::TransactionContext *txn, table_oid_t table);
+
   /**
    * A list of all constraints on this table
    * @param txn for the operation
@@ -278,6 +291,27 @@ class DatabaseCatalog {
   template <typename Column, typename ClassOid>
   bool DeleteColumns(transaction::TransactionContext *txn, ClassOid class_oid);
 
+  /**
+   * Delete a single entry from pg_attribute
+   * @param txn txn to use
+   * @param table oid of table
+   * @param col oid of the column to delete
+   * @return whether deletion is successful
+   */
+  bool DeleteColumn(transaction::TransactionContext *txn, table_oid_t table, col_oid_t col);
+
+  /**
+   * Delete the given entries from pg_attribute and their index entries
+   * @tparam ClassOid type of class oid
+   * @param txn txn to use
+   * @param class_oid oid of table or index the columns belong to
+   * @param slots tuple slots of the entries in pg_attribute
+   * @return whether deletion is successful
+   */
+  template <typename ClassOid>
+  bool DeleteColumnEntries(transaction::TransactionContext *txn, ClassOid class_oid,
+                           const std::vector<storage::TupleSlot> &slots);
+
   storage::SqlTable *namespaces_;
   storage::index::Index *namespaces_oid_index_;
   storage::index::Index *namespaces_name_index_;
@@ -295,6 +329,8 @@ class DatabaseCatalog {
   storage::ProjectedRowInitializer get_class_oid_kind_pri_;
   storage::ProjectedRowInitializer set_class_pointer_pri_;
   storage::ProjectedRowInitializer set_class_schema_pri_;
+  storage::ProjectedRowInitializer set_class_next_col_oid_pri_;
+  storage::ProjectedRowInitializer set_class_layout_version_pri_;
   storage::ProjectedRowInitializer get_class_pointer_kind_pri_;
   storage::ProjectedRowInitializer get_class_schema_pointer_kind_pri_;
   storage::ProjectedRowInitializer get_class_object_and_schema_pri_;
@@ -444,6 +480,19 @@ class DatabaseCatalog {
    */
   bool SetTableSchemaPointer(transaction::TransactionContext *txn, table_oid_t oid, const Schema *schema);
 
+  /**
+   * Sets a table's schema and layout version in pg_class after a schema change. The old schema is freed once no
+   * transaction can see it anymore if txn commits, and the new one is freed if txn aborts.
+   * @param txn transaction to query
+   * @param class_slot tuple slot of the table's entry in pg_class
+   * @param old_schema schema of the table before the change
+   * @param new_schema schema of the table after the change
+   * @param version layout version of the table's SqlTable that goes with new_schema
+   * @return true if successful
+   */
+  bool SetTableSchema(transaction::TransactionContext *txn, storage::TupleSlot class_slot, const Schema *old_schema,
+                      const Schema *new_schema, storage::layout_version_t version);
+
   /**
    * Sets an index's schema in pg_class
    * @warning Should only be used by recovery
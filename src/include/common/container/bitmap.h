@@ -111,6 +111,29 @@ class RawBitmap {
     std::memset(bits_, 0, size);
   }
 
+  /**
+   * Copies a range of bits from another bitmap into this one, 64 bits at a time. Neither range needs to start on a
+   * byte boundary, as the bits are shifted into place.
+   * @param pos position in this bitmap of the first bit to copy to
+   * @param src bitmap to copy from
+   * @param src_pos position in src of the first bit to copy
+   * @param num_bits number of bits to copy
+   */
+  void CopyFrom(uint32_t pos, const RawBitmap &src, uint32_t src_pos, uint32_t num_bits) {
+    // Go a bit at a time until the bits are written to whole bytes
+    for (; num_bits > 0 && pos % BYTE_SIZE != 0; pos++, src_pos++, num_bits--) Set(pos, src.Test(src_pos));
+    const uint32_t shift = src_pos % BYTE_SIZE;
+    for (; num_bits >= 64; pos += 64, src_pos += 64, num_bits -= 64) {
+      const uint8_t *const in = src.bits_ + src_pos / BYTE_SIZE;
+      uint64_t word;
+      std::memcpy(&word, in, sizeof(word));
+      // The 64 bits straddle a ninth byte unless they start on a byte boundary
+      if (shift != 0) word = (word >> shift) | (static_cast<uint64_t>(in[sizeof(word)]) << (64 - shift));
+      std::memcpy(bits_ + pos / BYTE_SIZE, &word, sizeof(word));
+    }
+    for (; num_bits > 0; pos++, src_pos++, num_bits--) Set(pos, src.Test(src_pos));
+  }
+
  private:
   uint8_t bits_[0];
 };
@@ -160,6 +160,19 @@ class RawConcurrentBitmap {
     return false;
   }
 
+  /**
+   * Reads the 64 bits starting at the given position at once, instead of testing them one at a time.
+   * Note that this result is immediately stale.
+   * Furthermore, this function assumes byte 0 is aligned to 64 bits, and that the bitmap is padded to a multiple of 64
+   * bits.
+   * @param pos position of the first bit to read, which must be a multiple of 64.
+   * @return the bits, with the one at pos as the least significant bit.
+   */
+  uint64_t WordAt(const uint32_t pos) const {
+    TERRIER_ASSERT(pos % 64 == 0, "Words need to be aligned.");
+    return reinterpret_cast<const std::atomic<uint64_t> *>(&bits_[pos / BYTE_SIZE])->load();
+  }
+
   /**
    * Clears the bitmap by setting bits to 0.
    * @param num_bits number of bits to clear. This should be equal to the number of elements of the entire bitmap or
@@ -171,8 +184,8 @@ class RawConcurrentBitmap {
     std::memset(bits_, 0, size);
   }
 
-  // TODO(Tianyu): We will eventually need optimization for bulk checks and
-  // bulk flips. This thing is embarrassingly easy to vectorize.
+  // TODO(Tianyu): We will eventually need optimization for bulk flips. This
+  // thing is embarrassingly easy to vectorize.
 
  private:
   std::atomic<uint8_t> bits_[0];
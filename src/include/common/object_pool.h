@@ -1,9 +1,11 @@
 #pragma once
 
-#include <queue>
+#include <atomic>
 #include <string>
 #include <utility>
+#include <vector>
 #include "common/allocator.h"
+#include "common/constants.h"
 #include "common/container/concurrent_queue.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
@@ -52,6 +54,11 @@ class AllocatorFailureException : public std::exception {
  *
  * This prevents liberal calls to malloc and new in the code and makes tracking
  * our memory performance easier.
+ *
+ * Released objects are cached in a number of shards, and every thread gets and releases objects through the shard it
+ * is assigned to, so threads do not fight over a single latch. A shard that fills up hands half of its objects to a
+ * lock-free depot shared by all shards, where threads with an empty shard pick them up. Only allocating new objects,
+ * deleting objects and changing the limits go through the pool-wide latch.
  * @tparam T the type of objects in the pool.
  * @tparam The allocator to use when constructing and destructing a new object.
  *         In most cases it can be left out and the default allocator will
@@ -59,7 +66,8 @@ class AllocatorFailureException : public std::exception {
  *         structure to return a pointer that the object pool will then take
  *         control over. The returned pointer will be eventually freed with the
  *         supplied Delete method, but its memory location will potentially be
- *         handed out multiple times before that happens.
+ *         handed out multiple times before that happens. New and Delete are
+ *         never called concurrently, but Reuse can be.
  */
 template <typename T, class Allocator = ByteAlignedAllocator<T>>
 class ObjectPool {
@@ -84,11 +92,9 @@ class ObjectPool {
    */
   ~ObjectPool() {
     T *result = nullptr;
-    while (!reuse_queue_.empty()) {
-      result = reuse_queue_.front();
-      alloc_.Delete(result);
-      reuse_queue_.pop();
-    }
+    while (depot_.Dequeue(&result)) alloc_.Delete(result);
+    for (auto &shard : shards_)
+      for (T *obj : shard.magazine_) alloc_.Delete(obj);
   }
 
   /**
@@ -98,20 +104,10 @@ class ObjectPool {
    * @return pointer to memory that can hold T
    */
   T *Get() {
-    SpinLatch::ScopedSpinLatch guard(&latch_);
-    if (reuse_queue_.empty() && current_size_ >= size_limit_) throw NoMoreObjectException(size_limit_);
-    T *result = nullptr;
-    if (reuse_queue_.empty()) {
-      result = alloc_.New();  // result could be null because the allocator may not find enough memory space
-      if (result != nullptr) current_size_++;
-    } else {
-      result = reuse_queue_.front();
-      reuse_queue_.pop();
-      alloc_.Reuse(result);
-    }
-    // If result is nullptr. The call to alloc_.New() failed (i.e. can't allocate more memory from the system).
-    if (result == nullptr) throw AllocatorFailureException();
-    TERRIER_ASSERT(current_size_ <= size_limit_, "Object pool has exceeded its size limit.");
+    T *result = TakeFromShard(&shards_[ShardIndex()]);
+    if (result == nullptr) result = TakeFromDepot();
+    if (result == nullptr) return Allocate();
+    alloc_.Reuse(result);
     return result;
   }
 
@@ -154,10 +150,12 @@ class ObjectPool {
     SpinLatch::ScopedSpinLatch guard(&latch_);
     reuse_limit_ = new_reuse_limit;
     T *obj = nullptr;
-    while (reuse_queue_.size() > reuse_limit_) {
-      obj = reuse_queue_.front();
+    while (num_reusable_.load() > reuse_limit_.load()) {
+      obj = TakeFromDepot();
+      if (obj == nullptr) obj = TakeFromAnyShard();
+      // The rest are objects being released concurrently that have not made it into a shard yet
+      if (obj == nullptr) break;
       alloc_.Delete(obj);
-      reuse_queue_.pop();
       current_size_--;
     }
   }
@@ -171,13 +169,18 @@ class ObjectPool {
    */
   void Release(T *obj) {
     TERRIER_ASSERT(obj != nullptr, "releasing a null pointer");
-    SpinLatch::ScopedSpinLatch guard(&latch_);
-    if (reuse_queue_.size() >= reuse_limit_) {
-      alloc_.Delete(obj);
-      current_size_--;
-    } else {
-      reuse_queue_.push(obj);
-    }
+    // Count the object as reusable before putting it anywhere, so that the number of reusable objects never goes
+    // above the reuse limit
+    uint64_t num_reusable = num_reusable_.load();
+    do {
+      if (num_reusable >= reuse_limit_.load()) {
+        SpinLatch::ScopedSpinLatch guard(&latch_);
+        alloc_.Delete(obj);
+        current_size_--;
+        return;
+      }
+    } while (!num_reusable_.compare_exchange_weak(num_reusable, num_reusable + 1));
+    PutInShard(&shards_[ShardIndex()], obj);
   }
 
   /**
@@ -186,15 +189,88 @@ class ObjectPool {
   uint64_t GetSizeLimit() const { return size_limit_; }
 
  private:
+  // Number of shards reusable objects are cached in. Threads are spread over them round-robin.
+  static constexpr uint32_t NUM_SHARDS = 16;
+  // Maximum number of reusable objects cached in one shard
+  static constexpr uint32_t MAGAZINE_SIZE = 32;
+
+  struct alignas(Constants::CACHELINE_SIZE) Shard {
+    SpinLatch latch_;
+    std::vector<T *> magazine_;
+  };
+
   Allocator alloc_;
+  // Protects the allocator, the limits and current_size_
   SpinLatch latch_;
-  // TODO(yangjuns): We don't need to reuse objects in a FIFO pattern. We could potentially pass a second template
-  // parameter to define the backing container for the std::queue. That way we can measure each backing container.
-  std::queue<T *> reuse_queue_;
-  uint64_t size_limit_;   // the maximum number of objects a object pool can have
-  uint64_t reuse_limit_;  // the maximum number of reusable objects in reuse_queue
+  Shard shards_[NUM_SHARDS];
+  // Reusable objects that overflowed from the shards
+  ConcurrentQueue<T *> depot_;
+  uint64_t size_limit_;                 // the maximum number of objects a object pool can have
+  std::atomic<uint64_t> reuse_limit_;   // the maximum number of reusable objects in the shards and the depot
+  std::atomic<uint64_t> num_reusable_ = 0;
   // current_size_ represents the number of objects the object pool has allocated,
-  // including objects that have been given out to callers and those reside in reuse_queue
+  // including objects that have been given out to callers and those cached for reuse
   uint64_t current_size_;
+
+  static uint32_t ShardIndex() {
+    static std::atomic<uint32_t> next_shard = 0;
+    thread_local const uint32_t shard = next_shard++ % NUM_SHARDS;
+    return shard;
+  }
+
+  T *TakeFromShard(Shard *const shard) {
+    SpinLatch::ScopedSpinLatch guard(&shard->latch_);
+    if (shard->magazine_.empty()) return nullptr;
+    T *result = shard->magazine_.back();
+    shard->magazine_.pop_back();
+    num_reusable_--;
+    return result;
+  }
+
+  T *TakeFromDepot() {
+    T *result = nullptr;
+    if (!depot_.Dequeue(&result)) return nullptr;
+    num_reusable_--;
+    return result;
+  }
+
+  T *TakeFromAnyShard() {
+    for (auto &shard : shards_) {
+      T *result = TakeFromShard(&shard);
+      if (result != nullptr) return result;
+    }
+    return nullptr;
+  }
+
+  void PutInShard(Shard *const shard, T *const obj) {
+    SpinLatch::ScopedSpinLatch guard(&shard->latch_);
+    if (shard->magazine_.size() >= MAGAZINE_SIZE) {
+      // Hand half of the shard over to threads that have run out
+      for (uint32_t i = 0; i < MAGAZINE_SIZE / 2; i++) {
+        depot_.Enqueue(shard->magazine_.back());
+        shard->magazine_.pop_back();
+      }
+    }
+    shard->magazine_.push_back(obj);
+  }
+
+  T *Allocate() {
+    SpinLatch::ScopedSpinLatch guard(&latch_);
+    T *result = nullptr;
+    // Other threads' shards might still have objects to reuse, so only allocate if there are none
+    if (num_reusable_.load() > 0) result = TakeFromDepot();
+    if (result == nullptr && num_reusable_.load() > 0) result = TakeFromAnyShard();
+    if (result != nullptr) {
+      alloc_.Reuse(result);
+      return result;
+    }
+    if (current_size_ >= size_limit_) throw NoMoreObjectException(size_limit_);
+    result = alloc_.New();  // result could be null because the allocator may not find enough memory space
+    // If result is nullptr. The call to alloc_.New() failed (i.e. can't allocate more memory from the system).
+    if (result == nullptr) throw AllocatorFailureException();
+    current_size_++;
+    TERRIER_ASSERT(current_size_ <= size_limit_, "Object pool has exceeded its size limit.");
+    return result;
+  }
 };
 }  // namespace terrier::common
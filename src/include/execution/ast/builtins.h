@@ -23,6 +23,13 @@ namespace terrier::execution::ast {
   F(FilterLe, filterLe)                                               \
   F(FilterLt, filterLt)                                               \
   F(FilterNe, filterNe)                                               \
+  F(FilterStringEq, filterStringEq)                                   \
+  F(FilterStringGe, filterStringGe)                                   \
+  F(FilterStringGt, filterStringGt)                                   \
+  F(FilterStringLe, filterStringLe)                                   \
+  F(FilterStringLt, filterStringLt)                                   \
+  F(FilterStringNe, filterStringNe)                                   \
+  F(FilterStringPrefix, filterStringPrefix)                           \
                                                                       \
   /* Thread State Container */                                        \
   F(ExecutionContextGetMemoryPool, execCtxGetMem)                     \
@@ -37,6 +44,13 @@ namespace terrier::execution::ast {
   F(TableIterAdvance, tableIterAdvance)                               \
   F(TableIterGetPCI, tableIterGetPCI)                                 \
   F(TableIterClose, tableIterClose)                                   \
+  F(TableIterZoneMapEq, tableIterZoneMapEq)                           \
+  F(TableIterZoneMapGt, tableIterZoneMapGt)                           \
+  F(TableIterZoneMapGe, tableIterZoneMapGe)                           \
+  F(TableIterZoneMapLt, tableIterZoneMapLt)                           \
+  F(TableIterZoneMapLe, tableIterZoneMapLe)                           \
+  F(TableIterZoneMapNe, tableIterZoneMapNe)                           \
+  F(TableIterInPlace, tableIterInPlace)                               \
   F(TableIterParallel, iterateTableParallel)                          \
                                                                       \
   /* PCI */                                                           \
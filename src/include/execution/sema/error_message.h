@@ -82,7 +82,7 @@ namespace sema {
   F(MissingArrayLength, "missing array length (either compile-time number or '*')", ())                               \
   F(NotASQLAggregate, "'%0' is not a SQL aggregator type", (ast::Type *))                                             \
   F(BadParallelScanFunction,                                                                                          \
-    "parallel scan function must have type (*ExecutionContext, "                                                      \
+    "parallel scan function must have type (*QueryState, *ThreadState, "                                              \
     "*TableVectorIterator)->nil, received '%0'",                                                                      \
     (ast::Type *))                                                                                                    \
   F(BadArgToOutputSetNull,                                                                                            \
@@ -2,6 +2,8 @@
 
 #include <limits>
 #include <type_traits>
+#include <vector>
+#include "storage/arrow_block_metadata.h"
 #include "storage/projected_columns.h"
 
 #include "common/macros.h"
@@ -50,6 +52,22 @@ class EXPORT ProjectedColumnsIterator {
    */
   void SetProjectedColumn(storage::ProjectedColumns *projected_column);
 
+  /**
+   * Reset this iterator to begin iteration over column data that does not live in a projection, e.g. data that is read
+   * in place from a frozen block. The data must stay valid until the iterator is reset again.
+   * @param num_cols The number of columns
+   * @param col_data The start of the values of each column
+   * @param col_nulls The null bitmap of each column. A set bit means the value is present.
+   * @param num_tuples The number of tuples in each column
+   * @param col_codes If not null, the dictionary codes of each dictionary-compressed string column, and nullptr for
+   *                  every other column
+   * @param col_dictionaries If not null, the sorted dictionary of each dictionary-compressed string column, and nullptr
+   *                         for every other column
+   */
+  void SetColumns(uint16_t num_cols, byte *const *col_data, const common::RawBitmap *const *col_nulls,
+                  uint32_t num_tuples, const uint32_t *const *col_codes = nullptr,
+                  const storage::ArrowVarlenColumn *const *col_dictionaries = nullptr);
+
   // -------------------------------------------------------
   // Tuple-at-a-time API
   // -------------------------------------------------------
@@ -208,6 +226,50 @@ class EXPORT ProjectedColumnsIterator {
   template <template <typename> typename Op>
   uint32_t FilterColByCol(uint32_t col_idx_1, type::TypeId type_1, uint32_t col_idx_2, type::TypeId type_2);
 
+  /**
+   * Filter the string column at index @em col_idx by the given constant string @em val. Strings are compared by
+   * their bytes, shorter strings first on a tie. If the column is dictionary-compressed, the predicate is translated
+   * into a range of codes in the sorted dictionary once, and the filter then compares integer codes instead of strings.
+   * NULL values never pass the filter.
+   * @tparam Op The filtering operator.
+   * @param col_idx The index of the column in the projection to filter.
+   * @param val The string to filter on.
+   * @return The number of selected elements.
+   */
+  template <template <typename> typename Op>
+  uint32_t FilterStringColByVal(uint32_t col_idx, const storage::VarlenEntry &val);
+
+  /**
+   * Filter the string column at index @em col_idx to the strings that start with @em prefix, i.e. the predicate
+   * "column LIKE 'prefix%'". Dictionary-compressed columns are filtered by their codes, as in FilterStringColByVal.
+   * @param col_idx The index of the column in the projection to filter.
+   * @param prefix The prefix to filter on.
+   * @return The number of selected elements.
+   */
+  uint32_t FilterStringColByPrefix(uint32_t col_idx, const storage::VarlenEntry &prefix);
+
+  /**
+   * Filter the column at index @em col_idx to the tuples whose value is NULL, i.e. the predicate "column IS NULL". The
+   * selection vector is built straight from the null bitmap of the column, a word at a time.
+   * @param col_idx The index of the column in the projection to filter.
+   * @return The number of selected elements.
+   */
+  uint32_t FilterColIsNull(uint32_t col_idx) { return FilterByNullBitmap(col_idx, false); }
+
+  /**
+   * Filter the column at index @em col_idx to the tuples whose value is not NULL, i.e. the predicate
+   * "column IS NOT NULL". The selection vector is built straight from the null bitmap of the column, a word at a time.
+   * @param col_idx The index of the column in the projection to filter.
+   * @return The number of selected elements.
+   */
+  uint32_t FilterColIsNotNull(uint32_t col_idx) { return FilterByNullBitmap(col_idx, true); }
+
+  /**
+   * @param col_idx The index of the column in the projection
+   * @return True if the column is dictionary-compressed, and string filters on it compare codes; false otherwise
+   */
+  bool IsDictionaryCompressed(uint32_t col_idx) const { return col_dictionaries_[col_idx] != nullptr; }
+
   /**
    * Return the number of selected tuples after any filters have been applied
    */
@@ -218,16 +280,39 @@ class EXPORT ProjectedColumnsIterator {
   template <typename T, template <typename> typename Op>
   uint32_t FilterColByValImpl(uint32_t col_idx, T val);
 
+  // Filter an array of values in the layout of the columns by a constant value
+  template <typename T, template <typename> typename Op>
+  uint32_t FilterValuesByVal(const T *input, T val);
+
   // Filter a column by a second column
   template <typename T, template <typename> typename Op>
   uint32_t FilterColByColImpl(uint32_t col_idx_1, uint32_t col_idx_2);
 
+  // Filter tuple-at-a-time by a predicate on the index of the tuple
+  template <typename F>
+  uint32_t FilterByIndex(const F &pred);
+
+  // Filter a dictionary-compressed column to the tuples whose code lies in [lo, hi)
+  uint32_t FilterCodesInRange(uint32_t col_idx, uint32_t lo, uint32_t hi);
+
+  // Filter a column to the tuples whose bit in its null bitmap is @em present, i.e. to the non-NULL tuples if true
+  uint32_t FilterByNullBitmap(uint32_t col_idx, bool present);
+
  private:
   // The selection vector used to filter the ProjectedColumns
   alignas(common::Constants::CACHELINE_SIZE) uint32_t selection_vector_[common::Constants::K_DEFAULT_VECTOR_SIZE];
 
-  // The projected column we are iterating over.
-  storage::ProjectedColumns *projected_column_{nullptr};
+  // The start of the values and the null bitmap of each column we are iterating over. These either point into a
+  // projection or directly into a frozen block.
+  std::vector<byte *> col_data_;
+  std::vector<const common::RawBitmap *> col_nulls_;
+
+  // The dictionary codes and the dictionary of each column that is dictionary-compressed, and nullptr otherwise
+  std::vector<const uint32_t *> col_codes_;
+  std::vector<const storage::ArrowVarlenColumn *> col_dictionaries_;
+
+  // The number of tuples in the columns we are iterating over
+  uint32_t num_tuples_{0};
 
   // The current raw position in the ProjectedColumns we're pointing to
   uint32_t curr_idx_{0};
@@ -256,9 +341,9 @@ inline const T *ProjectedColumnsIterator::Get(uint32_t col_idx, bool *null) cons
   // NOLINTNEXTLINE: bugprone-suspicious-semicolon: seems like a false positive because of constexpr
   if constexpr (Nullable) {
     TERRIER_ASSERT(null != nullptr, "Missing output variable for NULL indicator");
-    *null = !projected_column_->ColumnNullBitmap(static_cast<uint16_t>(col_idx))->Test(curr_idx_);
+    *null = !col_nulls_[col_idx]->Test(curr_idx_);
   }
-  const T *col_data = reinterpret_cast<T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx)));
+  const T *col_data = reinterpret_cast<const T *>(col_data_[col_idx]);
   return &col_data[curr_idx_];
 }
 
@@ -284,7 +369,7 @@ inline void ProjectedColumnsIterator::Match(bool matched) {
   selection_vector_write_idx_ += matched ? 1 : 0;
 }
 
-inline bool ProjectedColumnsIterator::HasNext() const { return curr_idx_ < projected_column_->NumTuples(); }
+inline bool ProjectedColumnsIterator::HasNext() const { return curr_idx_ < num_tuples_; }
 
 inline bool ProjectedColumnsIterator::HasNextFiltered() const { return selection_vector_read_idx_ < NumSelected(); }
 
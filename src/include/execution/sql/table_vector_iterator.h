@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <memory>
 #include <vector>
 #include "catalog/catalog.h"
@@ -31,6 +32,18 @@ class EXPORT TableVectorIterator {
   explicit TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid, uint32_t *col_oids,
                                uint32_t num_oids);
 
+  /**
+   * Create a new vectorized iterator over the blocks [start_block_idx, end_block_idx) of the given table
+   * @param exec_ctx execution context of the query
+   * @param table_oid oid of the table
+   * @param col_oids array column oids to scan
+   * @param num_oids length of the array
+   * @param start_block_idx index of the first block to scan
+   * @param end_block_idx index of one past the last block to scan
+   */
+  TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids,
+                      uint32_t start_block_idx, uint32_t end_block_idx);
+
   /**
    * Destructor
    */
@@ -41,6 +54,28 @@ class EXPORT TableVectorIterator {
    */
   DISALLOW_COPY_AND_MOVE(TableVectorIterator);
 
+  /**
+   * Read frozen blocks in place instead of copying them into the projection. Must be called before the first
+   * Advance(); TPL code asks for it with @tableIterInPlace. The data the PCI points to is then only valid until the
+   * next call to Advance(), and the frozen block it points into cannot be modified until then. Since the read is held
+   * while the consumer works on the vector, writers to that block wait on the consumer. Hence, this must not be enabled
+   * by callers that modify the table they are scanning, and is off unless asked for.
+   * @param in_place True if frozen blocks should be read in place; false otherwise
+   */
+  void SetInPlaceScan(bool in_place) { in_place_scan_ = in_place; }
+
+  /**
+   * Skip frozen blocks in which, according to their zone maps, no tuple can satisfy the predicate "column @em col_idx
+   * of the projection @em Op @em val". Must be called before the first Advance(). This only prunes whole blocks, so
+   * the tuples of the blocks that are scanned still need to be filtered.
+   * @tparam Op The comparison operator, e.g. std::less
+   * @param col_idx The index of the column in the projection. The column must be an integer column.
+   * @param type The type of the column
+   * @param val The value to compare the column to
+   */
+  template <template <typename> typename Op>
+  void AddZoneMapFilter(uint32_t col_idx, type::TypeId type, int64_t val);
+
   /**
    * Initialize the iterator, returning true if the initialization succeeded
    * @return True if the initialization succeeded; false otherwise
@@ -58,6 +93,11 @@ class EXPORT TableVectorIterator {
    */
   ProjectedColumnsIterator *GetProjectedColumnsIterator() { return &pci_; }
 
+  /**
+   * @return the number of blocks skipped so far because their zone maps ruled them out
+   */
+  uint32_t NumSkippedBlocks() const { return num_skipped_blocks_; }
+
   /**
    * Scan function callback used to scan a partition of the table.
    * Convention: First argument is the opaque query state, second argument is
@@ -73,17 +113,47 @@ class EXPORT TableVectorIterator {
    * callback function @em scanner on each input vector projection from the
    * source table. This call is blocking, meaning that it only returns after
    * the whole table has been scanned. Iteration order is non-deterministic.
-   * @param db_oid The ID of the database containing the table
+   * The table's blocks are split into ranges of at least @em min_grain_size
+   * blocks. Each range is scanned by its own iterator (and hence into its own
+   * ProjectedColumns buffer), using the thread state of the executing thread.
    * @param table_oid The ID of the table
+   * @param col_oids array of column oids to scan
+   * @param num_oids length of the array
    * @param query_state the query state
    * @param thread_states the thread state container
+   * @param exec_ctx execution context of the query
    * @param scan_fn The callback function invoked for vectors of table input
    * @param min_grain_size The minimum number of blocks to give a scan task
+   * @return True if the scan was performed; false if the table does not exist
    */
-  static bool ParallelScan(uint32_t db_oid, uint32_t table_oid, void *query_state, ThreadStateContainer *thread_states,
-                           ScanFn scan_fn, uint32_t min_grain_size = K_MIN_BLOCK_RANGE_SIZE);
+  static bool ParallelScan(uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids, void *query_state,
+                           ThreadStateContainer *thread_states, exec::ExecutionContext *exec_ctx, ScanFn scan_fn,
+                           uint32_t min_grain_size = K_MIN_BLOCK_RANGE_SIZE);
 
  private:
+  // Give up the in-place read on the frozen block the PCI currently points into, if any
+  void ReleaseInPlaceBlock();
+
+  // Check the block the iterator points to against the zone map filters. Returns true if it can be skipped.
+  bool ZoneMapsRuleOutBlock() const;
+
+  // Returns true if some value in [min, max] can satisfy "value Op val"
+  template <template <typename> typename Op>
+  static bool ZoneMapMayMatch(int64_t min, int64_t max, int64_t val);
+
+  // A predicate of the form "column Op value" that is checked against the zone maps of frozen blocks
+  struct ZoneMapFilter {
+    uint16_t col_idx_;
+    int64_t val_;
+    bool (*may_match_)(int64_t min, int64_t max, int64_t val);
+  };
+
+  // Create an iterator over a block range of an already resolved table. Used by the parallel scan so that workers do
+  // not have to go through the catalog.
+  TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid,
+                      common::ManagedPointer<storage::SqlTable> table, uint32_t *col_oids, uint32_t num_oids,
+                      uint32_t start_block_idx, uint32_t end_block_idx);
+
   exec::ExecutionContext *exec_ctx_;
   const catalog::table_oid_t table_oid_;
   std::vector<catalog::col_oid_t> col_oids_{};
@@ -94,8 +164,27 @@ class EXPORT TableVectorIterator {
   // A PC and its buffer.
   void *buffer_ = nullptr;
   storage::ProjectedColumns *projected_columns_ = nullptr;
+  // Range of blocks to scan. By default, the whole table is scanned.
+  uint32_t start_block_idx_ = 0;
+  uint32_t end_block_idx_ = std::numeric_limits<uint32_t>::max();
   // Iterator of the slots in the PC
   std::unique_ptr<storage::DataTable::SlotIterator> iter_ = nullptr;
+  // Iterator to one past the last slot of the block range. Null when scanning up to the end of the table.
+  std::unique_ptr<storage::DataTable::SlotIterator> end_iter_ = nullptr;
+
+  // Predicates used to skip frozen blocks, and the number of blocks they skipped
+  std::vector<ZoneMapFilter> zone_map_filters_{};
+  uint32_t num_skipped_blocks_ = 0;
+
+  // Whether frozen blocks are read in place, and the block currently being read in place
+  bool in_place_scan_ = false;
+  storage::RawBlock *in_place_block_ = nullptr;
+  // Column values and null bitmaps of the block read in place, handed to the PCI
+  std::vector<byte *> in_place_columns_{};
+  std::vector<const common::RawBitmap *> in_place_nulls_{};
+  // Dictionary codes and dictionaries of the dictionary-compressed columns of the block read in place
+  std::vector<const uint32_t *> in_place_codes_{};
+  std::vector<const storage::ArrowVarlenColumn *> in_place_dictionaries_{};
 
   bool initialized_ = false;
 };
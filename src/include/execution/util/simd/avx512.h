@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstring>
 #include <immintrin.h>
 
+#include "common/constants.h"
 #include "common/macros.h"
 #include "execution/util/execution_common.h"
 #include "execution/util/simd/types.h"
@@ -1042,4 +1044,58 @@ static inline uint32_t FilterVectorByVector(const T *RESTRICT in_1, const T *RES
   return out_pos;
 }
 
+// ---------------------------------------------------------
+// Bit Vectors
+// ---------------------------------------------------------
+
+/**
+ * Writes the positions of the set bits of one byte of a bit vector, plus an offset, into out. Eight positions are
+ * always written, so out needs room for them.
+ * @return the number of set bits in the byte
+ */
+ALWAYS_INLINE inline uint32_t BytePositions(const uint8_t byte, const uint32_t offset, uint32_t *RESTRICT out) {
+  // The lookup table holds the positions of the set bits of every byte, packed into its low bytes
+  __m128i match_pos = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&K8_BIT_MATCH_LUT[byte]));
+  __m256i pos_vec = _mm256_add_epi32(_mm256_set1_epi32(offset), _mm256_cvtepi8_epi32(match_pos));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), pos_vec);
+  return __builtin_popcount(byte);
+}
+
+static inline uint32_t FilterBitVectorByVal(const uint8_t *RESTRICT bits, const uint32_t in_count, const bool val,
+                                            uint32_t *RESTRICT out, uint32_t *RESTRICT in_pos) {
+  // Flipping every bit turns a search for unset bits into one for set bits
+  const uint64_t flip = val ? 0 : ~static_cast<uint64_t>(0);
+  uint32_t out_pos = 0;
+  // Words without a single selected bit, e.g. the NULL bits of a column that has few NULLs, are skipped whole
+  for (*in_pos = 0; *in_pos + 64 <= in_count; *in_pos += 64) {
+    uint64_t word;
+    std::memcpy(&word, bits + *in_pos / common::Constants::K_BITS_PER_BYTE, sizeof(word));
+    word ^= flip;
+    for (uint32_t offset = *in_pos; word != 0; offset += 8, word >>= 8)
+      out_pos += BytePositions(static_cast<uint8_t>(word), offset, out + out_pos);
+  }
+  for (; *in_pos + 8 <= in_count; *in_pos += 8) {
+    const auto byte = static_cast<uint8_t>(bits[*in_pos / common::Constants::K_BITS_PER_BYTE] ^ flip);
+    out_pos += BytePositions(byte, *in_pos, out + out_pos);
+  }
+  return out_pos;
+}
+
+static inline uint32_t CountBits(const uint8_t *RESTRICT bits, const uint32_t num_bits, uint32_t *RESTRICT in_pos) {
+  // Counts the set bits of every nibble with a lookup table, and sums up the counts of every 8 bytes
+  const __m256i nibble_counts =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+  __m256i sums = _mm256_setzero_si256();
+  for (*in_pos = 0; *in_pos + 256 <= num_bits; *in_pos += 256) {
+    const __m256i vec =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bits + *in_pos / common::Constants::K_BITS_PER_BYTE));
+    const __m256i lo = _mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(vec, low_nibbles));
+    const __m256i hi = _mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(_mm256_srli_epi16(vec, 4), low_nibbles));
+    sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+  }
+  return static_cast<uint32_t>(_mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+                               _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+}
+
 }  // namespace terrier::execution::util::simd
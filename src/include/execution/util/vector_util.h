@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstring>
 #include <functional>
 
+#include "common/constants.h"
 #include "execution/util/execution_common.h"
 #include "execution/util/simd.h"
 
@@ -104,6 +106,71 @@ class VectorUtil {
     return out_pos;
   }
 
+  /**
+   * Select the positions of the bits in a bit vector that are equal to a constant value, and store them in the output
+   * vector. Bit i of the bit vector is bit (i % 8) of byte (i / 8), as in the null bitmaps of the storage layer. If a
+   * selection vector is provided, only the bits whose positions are in the selection vector will be read.
+   * @param bits The input bit vector.
+   * @param in_count The number of bits in the bit vector (or elements in the selection vector).
+   * @param val The value of the bits to select.
+   * @param[out] out The vector storing the selected positions.
+   * @param sel The selection vector used to read bits.
+   * @return The number of selected positions.
+   */
+  static uint32_t FilterBitVectorByVal(const uint8_t *RESTRICT bits, const uint32_t in_count, const bool val,
+                                       uint32_t *RESTRICT out, const uint32_t *RESTRICT sel) {
+    uint32_t in_pos = 0;
+    uint32_t out_pos = 0;
+
+    if (sel == nullptr) {
+#if defined(__AVX2__) || defined(__AVX512F__)
+      out_pos = simd::FilterBitVectorByVal(bits, in_count, val, out, &in_pos);
+#endif
+      // Go a word at a time, jumping straight from one selected bit to the next
+      const uint64_t flip = val ? 0 : ~static_cast<uint64_t>(0);
+      for (; in_pos + 64 <= in_count; in_pos += 64) {
+        uint64_t word;
+        std::memcpy(&word, bits + in_pos / common::Constants::K_BITS_PER_BYTE, sizeof(word));
+        for (word ^= flip; word != 0; word &= word - 1) out[out_pos++] = in_pos + __builtin_ctzll(word);
+      }
+      for (; in_pos < in_count; in_pos++) {
+        out[out_pos] = in_pos;
+        out_pos += static_cast<uint32_t>(TestBit(bits, in_pos) == val);
+      }
+    } else {
+      for (; in_pos < in_count; in_pos++) {
+        out[out_pos] = sel[in_pos];
+        out_pos += static_cast<uint32_t>(TestBit(bits, sel[in_pos]) == val);
+      }
+    }
+
+    return out_pos;
+  }
+
+  /**
+   * Count the set bits in a bit vector laid out as in FilterBitVectorByVal().
+   * @param bits The input bit vector.
+   * @param num_bits The number of bits in the bit vector.
+   * @return The number of set bits.
+   */
+  static uint32_t CountBits(const uint8_t *RESTRICT bits, const uint32_t num_bits) {
+    uint32_t in_pos = 0;
+#if defined(__AVX2__) || defined(__AVX512F__)
+    uint32_t count = simd::CountBits(bits, num_bits, &in_pos);
+#else
+    uint32_t count = 0;
+#endif
+
+    for (; in_pos + 64 <= num_bits; in_pos += 64) {
+      uint64_t word;
+      std::memcpy(&word, bits + in_pos / common::Constants::K_BITS_PER_BYTE, sizeof(word));
+      count += __builtin_popcountll(word);
+    }
+    for (; in_pos < num_bits; in_pos++) count += static_cast<uint32_t>(TestBit(bits, in_pos));
+
+    return count;
+  }
+
   /**
    * Gather potentially non-contiguous indexes from an input vector and store
    * them into an output vector. Only elements whose indexes are stored in the
@@ -181,6 +248,13 @@ class VectorUtil {
                             uint32_t *RESTRICT sel) -> std::enable_if_t<std::is_pointer_v<T>, uint32_t> {
     return FilterNe(reinterpret_cast<const intptr_t *>(in), in_count, intptr_t(0), out, sel);
   }
+
+ private:
+  // Test a single bit of a bit vector laid out as in FilterBitVectorByVal()
+  ALWAYS_INLINE static bool TestBit(const uint8_t *bits, const uint32_t idx) {
+    constexpr uint32_t bits_per_byte = common::Constants::K_BITS_PER_BYTE;
+    return static_cast<bool>((bits[idx / bits_per_byte] >> (idx % bits_per_byte)) & 1);
+  }
 };
 
 }  // namespace terrier::execution::util
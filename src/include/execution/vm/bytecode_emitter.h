@@ -321,9 +321,26 @@ class BytecodeEmitter {
 
   /**
    * Emit a parallel table scan
+   * @param table_oid oid of the table to scan
+   * @param col_oids local holding the array of column oids to scan
+   * @param num_oids length of the array
+   * @param query_state the opaque query state
+   * @param thread_states the thread state container
+   * @param exec_ctx the execution context
+   * @param scan_fn the function invoked on each block range
    */
-  void EmitParallelTableScan(uint32_t db_oid, uint32_t table_oid, LocalVar ctx, LocalVar thread_states,
-                             FunctionId scan_fn);
+  void EmitParallelTableScan(uint32_t table_oid, LocalVar col_oids, uint32_t num_oids, LocalVar query_state,
+                             LocalVar thread_states, LocalVar exec_ctx, FunctionId scan_fn);
+
+  /**
+   * Emit bytecode to skip the frozen blocks of a TVI that cannot satisfy a predicate, according to their zone maps
+   * @param bytecode TableVectorIteratorZoneMap bytecode
+   * @param iter TVI to add the predicate to
+   * @param col_idx index of the column in the projection
+   * @param type type of the column
+   * @param val value to compare the column to
+   */
+  void EmitTableIterZoneMapFilter(Bytecode bytecode, LocalVar iter, uint32_t col_idx, int8_t type, int64_t val);
 
   // Reading integer values from an iterator
   /**
@@ -347,6 +364,18 @@ class BytecodeEmitter {
   void EmitPCIVectorFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx, int8_t type,
                            int64_t val);
 
+  /**
+   * Filter a string column in the iterator by a constant string
+   * @param bytecode string filter bytecode to emit
+   * @param selected output variable for the number of selected values
+   * @param pci PCI to filter
+   * @param col_idx index of the iterator to filter
+   * @param length length of the string
+   * @param data pointer to the string
+   */
+  void EmitPCIStringFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx, uint64_t length,
+                           uintptr_t data);
+
   /**
    * Insert a filter flavor into the filter manager builder
    */
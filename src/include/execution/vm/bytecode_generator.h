@@ -71,6 +71,7 @@ class BytecodeGenerator : public ast::AstVisitor<BytecodeGenerator> {
   void VisitBuiltinHashCall(ast::CallExpr *call, ast::Builtin builtin);
   void VisitBuiltinFilterManagerCall(ast::CallExpr *call, ast::Builtin builtin);
   void VisitBuiltinFilterCall(ast::CallExpr *call, ast::Builtin builtin);
+  void VisitBuiltinStringFilterCall(ast::CallExpr *call, ast::Builtin builtin);
   void VisitBuiltinAggHashTableCall(ast::CallExpr *call, ast::Builtin builtin);
   void VisitBuiltinAggHashTableIterCall(ast::CallExpr *call, ast::Builtin builtin);
   void VisitBuiltinAggPartIterCall(ast::CallExpr *call, ast::Builtin builtin);
@@ -222,10 +222,33 @@ VM_OP_HOT void OpTableVectorIteratorGetPCI(terrier::execution::sql::ProjectedCol
   *pci = iter->GetProjectedColumnsIterator();
 }
 
-VM_OP_HOT void OpParallelScanTable(const uint32_t db_oid, const uint32_t table_oid, void *const query_state,
+VM_OP void OpTableVectorIteratorZoneMapEqual(terrier::execution::sql::TableVectorIterator *iter,
+                                             uint32_t col_idx, int8_t type, int64_t val);
+
+VM_OP void OpTableVectorIteratorZoneMapGreaterThan(terrier::execution::sql::TableVectorIterator *iter,
+                                                   uint32_t col_idx, int8_t type, int64_t val);
+
+VM_OP void OpTableVectorIteratorZoneMapGreaterThanEqual(terrier::execution::sql::TableVectorIterator *iter,
+                                                        uint32_t col_idx, int8_t type, int64_t val);
+
+VM_OP void OpTableVectorIteratorZoneMapLessThan(terrier::execution::sql::TableVectorIterator *iter,
+                                                uint32_t col_idx, int8_t type, int64_t val);
+
+VM_OP void OpTableVectorIteratorZoneMapLessThanEqual(terrier::execution::sql::TableVectorIterator *iter,
+                                                     uint32_t col_idx, int8_t type, int64_t val);
+
+VM_OP void OpTableVectorIteratorZoneMapNotEqual(terrier::execution::sql::TableVectorIterator *iter,
+                                                uint32_t col_idx, int8_t type, int64_t val);
+
+VM_OP void OpTableVectorIteratorSetInPlaceScan(terrier::execution::sql::TableVectorIterator *iter);
+
+VM_OP_HOT void OpParallelScanTable(const uint32_t table_oid, uint32_t *const col_oids, const uint32_t num_oids,
+                                   void *const query_state,
                                    terrier::execution::sql::ThreadStateContainer *const thread_states,
+                                   terrier::execution::exec::ExecutionContext *const exec_ctx,
                                    const terrier::execution::sql::TableVectorIterator::ScanFn scanner) {
-  terrier::execution::sql::TableVectorIterator::ParallelScan(db_oid, table_oid, query_state, thread_states, scanner);
+  terrier::execution::sql::TableVectorIterator::ParallelScan(table_oid, col_oids, num_oids, query_state, thread_states,
+                                                             exec_ctx, scanner);
 }
 
 VM_OP_HOT void OpPCIIsFiltered(bool *is_filtered, terrier::execution::sql::ProjectedColumnsIterator *pci) {
@@ -470,6 +493,27 @@ VM_OP void OpPCIFilterLessThanEqual(uint64_t *size, terrier::execution::sql::Pro
 VM_OP void OpPCIFilterNotEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
                                uint32_t col_idx, int8_t type, int64_t val);
 
+VM_OP void OpPCIFilterStringEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                  uint32_t col_idx, uint64_t length, uintptr_t data);
+
+VM_OP void OpPCIFilterStringGreaterThan(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                        uint32_t col_idx, uint64_t length, uintptr_t data);
+
+VM_OP void OpPCIFilterStringGreaterThanEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                             uint32_t col_idx, uint64_t length, uintptr_t data);
+
+VM_OP void OpPCIFilterStringLessThan(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                     uint32_t col_idx, uint64_t length, uintptr_t data);
+
+VM_OP void OpPCIFilterStringLessThanEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                          uint32_t col_idx, uint64_t length, uintptr_t data);
+
+VM_OP void OpPCIFilterStringNotEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                     uint32_t col_idx, uint64_t length, uintptr_t data);
+
+VM_OP void OpPCIFilterStringPrefix(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                   uint32_t col_idx, uint64_t length, uintptr_t data);
+
 // ---------------------------------------------------------
 // Hashing
 // ---------------------------------------------------------
@@ -105,8 +105,20 @@ namespace terrier::execution::vm {
   F(TableVectorIteratorNext, OperandType::Local, OperandType::Local)                                                  \
   F(TableVectorIteratorFree, OperandType::Local)                                                                      \
   F(TableVectorIteratorGetPCI, OperandType::Local, OperandType::Local)                                                \
-  F(ParallelScanTable, OperandType::UImm4, OperandType::UImm4, OperandType::Local, OperandType::Local,                \
-    OperandType::FunctionId)                                                                                          \
+  F(TableVectorIteratorZoneMapEqual, OperandType::Local, OperandType::UImm4, OperandType::Imm1, OperandType::Imm8)    \
+  F(TableVectorIteratorZoneMapGreaterThan, OperandType::Local, OperandType::UImm4, OperandType::Imm1,                 \
+    OperandType::Imm8)                                                                                                \
+  F(TableVectorIteratorZoneMapGreaterThanEqual, OperandType::Local, OperandType::UImm4, OperandType::Imm1,            \
+    OperandType::Imm8)                                                                                                \
+  F(TableVectorIteratorZoneMapLessThan, OperandType::Local, OperandType::UImm4, OperandType::Imm1,                    \
+    OperandType::Imm8)                                                                                                \
+  F(TableVectorIteratorZoneMapLessThanEqual, OperandType::Local, OperandType::UImm4, OperandType::Imm1,               \
+    OperandType::Imm8)                                                                                                \
+  F(TableVectorIteratorZoneMapNotEqual, OperandType::Local, OperandType::UImm4, OperandType::Imm1,                    \
+    OperandType::Imm8)                                                                                                \
+  F(TableVectorIteratorSetInPlaceScan, OperandType::Local)                                                            \
+  F(ParallelScanTable, OperandType::UImm4, OperandType::Local, OperandType::UImm4, OperandType::Local,                \
+    OperandType::Local, OperandType::Local, OperandType::FunctionId)                                                  \
                                                                                                                       \
   /* ProjectedColumns Iterator (PCI) */                                                                               \
   F(PCIIsFiltered, OperandType::Local, OperandType::Local)                                                            \
@@ -145,6 +157,20 @@ namespace terrier::execution::vm {
   F(PCIFilterLessThanEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,            \
     OperandType::Imm8)                                                                                                \
   F(PCIFilterNotEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,                 \
+    OperandType::Imm8)                                                                                                \
+  F(PCIFilterStringEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,              \
+    OperandType::Imm8)                                                                                                \
+  F(PCIFilterStringGreaterThan, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,        \
+    OperandType::Imm8)                                                                                                \
+  F(PCIFilterStringGreaterThanEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,   \
+    OperandType::Imm8)                                                                                                \
+  F(PCIFilterStringLessThan, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,           \
+    OperandType::Imm8)                                                                                                \
+  F(PCIFilterStringLessThanEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,      \
+    OperandType::Imm8)                                                                                                \
+  F(PCIFilterStringNotEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,           \
+    OperandType::Imm8)                                                                                                \
+  F(PCIFilterStringPrefix, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,             \
     OperandType::Imm8)                                                                                                \
                                                                                                                       \
   /* Filter Manager */                                                                                                \
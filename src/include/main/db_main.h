@@ -10,7 +10,11 @@
 #include "network/terrier_server.h"
 #include "settings/settings_manager.h"
 #include "settings/settings_param.h"
+#include "storage/access_observer.h"
+#include "storage/block_compactor.h"
+#include "storage/block_evictor.h"
 #include "storage/garbage_collector_thread.h"
+#include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_manager.h"
 
 namespace terrier {
@@ -48,6 +52,7 @@ class DBMain {
    *    Stats registry (counters)
    *    Buffer segment pools
    *    Transaction manager
+   *    Block compactor, block evictor and access observer, if there are compactor workers
    *    Garbage collector thread
    *    Catalog
    *    Settings manager
@@ -64,8 +69,12 @@ class DBMain {
     delete gc_thread_;
     delete metrics_manager_;
     delete garbage_collector_;
+    delete access_observer_;
+    delete block_evictor_;
+    delete block_compactor_;
     delete settings_manager_;
     delete txn_manager_;
+    delete deferred_action_manager_;
     delete timestamp_manager_;
     delete buffer_segment_pool_;
     delete thread_pool_;
@@ -100,9 +109,13 @@ class DBMain {
   std::shared_ptr<common::StatisticsRegistry> main_stat_reg_;
   std::unordered_map<settings::Param, settings::ParamInfo> param_map_;
   transaction::TimestampManager *timestamp_manager_;
+  transaction::DeferredActionManager *deferred_action_manager_;
   transaction::TransactionManager *txn_manager_;
   settings::SettingsManager *settings_manager_;
   storage::LogManager *log_manager_;
+  storage::BlockCompactor *block_compactor_ = nullptr;
+  storage::BlockEvictor *block_evictor_ = nullptr;
+  storage::AccessObserver *access_observer_ = nullptr;
   storage::GarbageCollector *garbage_collector_;
   storage::GarbageCollectorThread *gc_thread_;
   network::TerrierServer *server_;
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>  //NOLINT
+#include <fstream>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "metrics/abstract_metric.h"
+#include "metrics/metrics_util.h"
+
+namespace terrier::metrics {
+
+/**
+ * Raw data object for holding stats collected by the block compactor workers
+ */
+class CompactionMetricRawData : public AbstractRawData {
+ public:
+  void Aggregate(AbstractRawData *const other) override {
+    auto other_db_metric = dynamic_cast<CompactionMetricRawData *>(other);
+    if (!other_db_metric->worker_data_.empty()) {
+      worker_data_.splice(worker_data_.cbegin(), other_db_metric->worker_data_);
+    }
+  }
+
+  /**
+   * @return the type of the metric this object is holding the data for
+   */
+  MetricsComponent GetMetricType() const override { return MetricsComponent::COMPACTION; }
+
+  /**
+   * Writes the data out to ofstreams
+   * @param outfiles vector of ofstreams to write to that have been opened by the MetricsManager
+   */
+  void ToCSV(std::vector<std::ofstream> *const outfiles) final {
+    TERRIER_ASSERT(outfiles->size() == FILES.size(), "Number of files passed to metric is wrong.");
+    TERRIER_ASSERT(std::count_if(outfiles->cbegin(), outfiles->cend(),
+                                 [](const std::ofstream &outfile) { return !outfile.is_open(); }) == 0,
+                   "Not all files are open.");
+
+    for (const auto &data : worker_data_) {
+      ((*outfiles)[0]) << data.now_ << "," << data.worker_id_ << "," << data.elapsed_us_ << "," << data.num_compacted_
+                       << "," << data.num_frozen_ << "," << data.num_aborted_ << std::endl;
+    }
+    worker_data_.clear();
+  }
+
+  /**
+   * Files to use for writing to CSV.
+   */
+  static constexpr std::array<std::string_view, 1> FILES = {"./block_compactor_task.csv"};
+  /**
+   * Columns to use for writing to CSV.
+   */
+  static constexpr std::array<std::string_view, 1> COLUMNS = {
+      "now,worker_id,elapsed_us,num_compacted,num_frozen,num_aborted"};
+
+ private:
+  friend class CompactionMetric;
+  FRIEND_TEST(MetricsTests, CompactionCSVTest);
+
+  void RecordWorkerData(const uint32_t worker_id, const uint64_t elapsed_us, const uint64_t num_compacted,
+                        const uint64_t num_frozen, const uint64_t num_aborted) {
+    worker_data_.emplace_front(worker_id, elapsed_us, num_compacted, num_frozen, num_aborted);
+  }
+
+  struct WorkerData {
+    WorkerData(const uint32_t worker_id, const uint64_t elapsed_us, const uint64_t num_compacted,
+               const uint64_t num_frozen, const uint64_t num_aborted)
+        : now_(MetricsUtil::Now()),
+          worker_id_(worker_id),
+          elapsed_us_(elapsed_us),
+          num_compacted_(num_compacted),
+          num_frozen_(num_frozen),
+          num_aborted_(num_aborted) {}
+    const uint64_t now_;
+    const uint32_t worker_id_;
+    const uint64_t elapsed_us_;
+    const uint64_t num_compacted_;
+    const uint64_t num_frozen_;
+    const uint64_t num_aborted_;
+  };
+
+  std::list<WorkerData> worker_data_;
+};
+
+/**
+ * Metrics for the block compactor: how many blocks every compactor worker moves along in each of its passes
+ */
+class CompactionMetric : public AbstractMetric<CompactionMetricRawData> {
+ private:
+  friend class MetricsStore;
+
+  void RecordWorkerData(const uint32_t worker_id, const uint64_t elapsed_us, const uint64_t num_compacted,
+                        const uint64_t num_frozen, const uint64_t num_aborted) {
+    GetRawData()->RecordWorkerData(worker_id, elapsed_us, num_compacted, num_frozen, num_aborted);
+  }
+};
+}  // namespace terrier::metrics
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>  //NOLINT
+#include <fstream>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "metrics/abstract_metric.h"
+#include "metrics/metrics_util.h"
+
+namespace terrier::metrics {
+
+/**
+ * Raw data object for holding stats collected by the garbage collector
+ */
+class GarbageCollectionMetricRawData : public AbstractRawData {
+ public:
+  void Aggregate(AbstractRawData *const other) override {
+    auto other_db_metric = dynamic_cast<GarbageCollectionMetricRawData *>(other);
+    if (!other_db_metric->pass_data_.empty()) {
+      pass_data_.splice(pass_data_.cbegin(), other_db_metric->pass_data_);
+    }
+  }
+
+  /**
+   * @return the type of the metric this object is holding the data for
+   */
+  MetricsComponent GetMetricType() const override { return MetricsComponent::GARBAGECOLLECTION; }
+
+  /**
+   * Writes the data out to ofstreams
+   * @param outfiles vector of ofstreams to write to that have been opened by the MetricsManager
+   */
+  void ToCSV(std::vector<std::ofstream> *const outfiles) final {
+    TERRIER_ASSERT(outfiles->size() == FILES.size(), "Number of files passed to metric is wrong.");
+    TERRIER_ASSERT(std::count_if(outfiles->cbegin(), outfiles->cend(),
+                                 [](const std::ofstream &outfile) { return !outfile.is_open(); }) == 0,
+                   "Not all files are open.");
+
+    for (const auto &data : pass_data_) {
+      ((*outfiles)[0]) << data.now_ << "," << data.elapsed_us_ << "," << data.num_workers_ << ","
+                       << data.txns_deallocated_ << "," << data.txns_unlinked_ << "," << data.unlink_queue_depth_
+                       << "," << data.deallocate_queue_depth_ << "," << data.lag_ << std::endl;
+    }
+    pass_data_.clear();
+  }
+
+  /**
+   * Files to use for writing to CSV.
+   */
+  static constexpr std::array<std::string_view, 1> FILES = {"./garbage_collector.csv"};
+  /**
+   * Columns to use for writing to CSV.
+   */
+  static constexpr std::array<std::string_view, 1> COLUMNS = {
+      "now,elapsed_us,num_workers,txns_deallocated,txns_unlinked,unlink_queue_depth,deallocate_queue_depth,lag"};
+
+ private:
+  friend class GarbageCollectionMetric;
+  FRIEND_TEST(MetricsTests, GarbageCollectionCSVTest);
+
+  void RecordPassData(const uint64_t elapsed_us, const uint32_t num_workers, const uint64_t txns_deallocated,
+                      const uint64_t txns_unlinked, const uint64_t unlink_queue_depth,
+                      const uint64_t deallocate_queue_depth, const uint64_t lag) {
+    pass_data_.emplace_front(elapsed_us, num_workers, txns_deallocated, txns_unlinked, unlink_queue_depth,
+                             deallocate_queue_depth, lag);
+  }
+
+  struct PassData {
+    PassData(const uint64_t elapsed_us, const uint32_t num_workers, const uint64_t txns_deallocated,
+             const uint64_t txns_unlinked, const uint64_t unlink_queue_depth, const uint64_t deallocate_queue_depth,
+             const uint64_t lag)
+        : now_(MetricsUtil::Now()),
+          elapsed_us_(elapsed_us),
+          num_workers_(num_workers),
+          txns_deallocated_(txns_deallocated),
+          txns_unlinked_(txns_unlinked),
+          unlink_queue_depth_(unlink_queue_depth),
+          deallocate_queue_depth_(deallocate_queue_depth),
+          lag_(lag) {}
+    const uint64_t now_;
+    const uint64_t elapsed_us_;
+    const uint32_t num_workers_;
+    const uint64_t txns_deallocated_;
+    const uint64_t txns_unlinked_;
+    const uint64_t unlink_queue_depth_;
+    const uint64_t deallocate_queue_depth_;
+    const uint64_t lag_;
+  };
+
+  std::list<PassData> pass_data_;
+};
+
+/**
+ * Metrics for the garbage collector: how much every pass collects, how much it leaves queued for later passes, and how
+ * far the oldest running transaction, which bounds what a pass can collect, trails the clock
+ */
+class GarbageCollectionMetric : public AbstractMetric<GarbageCollectionMetricRawData> {
+ private:
+  friend class MetricsStore;
+
+  void RecordPassData(const uint64_t elapsed_us, const uint32_t num_workers, const uint64_t txns_deallocated,
+                      const uint64_t txns_unlinked, const uint64_t unlink_queue_depth,
+                      const uint64_t deallocate_queue_depth, const uint64_t lag) {
+    GetRawData()->RecordPassData(elapsed_us, num_workers, txns_deallocated, txns_unlinked, unlink_queue_depth,
+                                 deallocate_queue_depth, lag);
+  }
+};
+}  // namespace terrier::metrics
@@ -8,6 +8,8 @@
 #include "common/managed_pointer.h"
 #include "metrics/abstract_metric.h"
 #include "metrics/abstract_raw_data.h"
+#include "metrics/compaction_metric.h"
+#include "metrics/garbage_collection_metric.h"
 #include "metrics/logging_metric.h"
 #include "metrics/metrics_defs.h"
 #include "metrics/transaction_metric.h"
@@ -74,6 +76,41 @@ class MetricsStore {
     txn_metric_->RecordCommitData(elapsed_us, txn_start);
   }
 
+  /**
+   * Record metrics from one pass of a block compactor worker
+   * @param worker_id id of the worker
+   * @param elapsed_us time spent in the pass
+   * @param num_compacted number of blocks compacted and marked cooling
+   * @param num_frozen number of blocks gathered and marked frozen
+   * @param num_aborted number of blocks whose compaction aborted
+   */
+  void RecordCompactionData(const uint32_t worker_id, const uint64_t elapsed_us, const uint64_t num_compacted,
+                            const uint64_t num_frozen, const uint64_t num_aborted) {
+    TERRIER_ASSERT(ComponentEnabled(MetricsComponent::COMPACTION), "CompactionMetric not enabled.");
+    TERRIER_ASSERT(compaction_metric_ != nullptr, "CompactionMetric not allocated. Check MetricsStore constructor.");
+    compaction_metric_->RecordWorkerData(worker_id, elapsed_us, num_compacted, num_frozen, num_aborted);
+  }
+
+  /**
+   * Record metrics from one garbage collection pass
+   * @param elapsed_us time spent in the pass
+   * @param num_workers number of workers the pass was spread across
+   * @param txns_deallocated number of transactions deallocated
+   * @param txns_unlinked number of transactions unlinked
+   * @param unlink_queue_depth number of transactions left to unlink in later passes
+   * @param deallocate_queue_depth number of transactions left to deallocate in later passes
+   * @param lag number of timestamps the oldest running transaction trails the clock by
+   */
+  void RecordGarbageCollectionData(const uint64_t elapsed_us, const uint32_t num_workers,
+                                   const uint64_t txns_deallocated, const uint64_t txns_unlinked,
+                                   const uint64_t unlink_queue_depth, const uint64_t deallocate_queue_depth,
+                                   const uint64_t lag) {
+    TERRIER_ASSERT(ComponentEnabled(MetricsComponent::GARBAGECOLLECTION), "GarbageCollectionMetric not enabled.");
+    TERRIER_ASSERT(gc_metric_ != nullptr, "GarbageCollectionMetric not allocated. Check MetricsStore constructor.");
+    gc_metric_->RecordPassData(elapsed_us, num_workers, txns_deallocated, txns_unlinked, unlink_queue_depth,
+                               deallocate_queue_depth, lag);
+  }
+
   /**
    * @param component metrics component to test
    * @return true if metrics enabled for this component, false otherwise
@@ -99,6 +136,8 @@ class MetricsStore {
 
   std::unique_ptr<LoggingMetric> logging_metric_;
   std::unique_ptr<TransactionMetric> txn_metric_;
+  std::unique_ptr<CompactionMetric> compaction_metric_;
+  std::unique_ptr<GarbageCollectionMetric> gc_metric_;
 
   const std::bitset<NUM_COMPONENTS> &enabled_metrics_;
 };
@@ -56,6 +56,16 @@ class Callbacks {
   static void WorkerPoolThreads(void *old_value, void *new_value, DBMain *db_main,
                                 const std::shared_ptr<common::ActionContext> &action_context);
 
+  /**
+   * Changes the number of workers the garbage collector uses.
+   * @param old_value old settings value
+   * @param new_value new settings value
+   * @param db_main pointer to db_main
+   * @param action_context pointer to the action context for this settings change
+   */
+  static void GCNumWorkers(void *old_value, void *new_value, DBMain *db_main,
+                           const std::shared_ptr<common::ActionContext> &action_context);
+
   /**
    * Changes the number of buffers the log manager uses.
    * @param old_value old settings value
@@ -85,5 +95,25 @@ class Callbacks {
    */
   static void MetricsTransaction(void *old_value, void *new_value, DBMain *db_main,
                                  const std::shared_ptr<common::ActionContext> &action_context);
+
+  /**
+   * Enable or disable metrics collection for BlockCompactor component
+   * @param old_value old settings value
+   * @param new_value new settings value
+   * @param db_main pointer to db_main
+   * @param action_context pointer to the action context for this settings change
+   */
+  static void MetricsCompaction(void *old_value, void *new_value, DBMain *db_main,
+                                const std::shared_ptr<common::ActionContext> &action_context);
+
+  /**
+   * Enable or disable metrics collection for GarbageCollector component
+   * @param old_value old settings value
+   * @param new_value new settings value
+   * @param db_main pointer to db_main
+   * @param action_context pointer to the action context for this settings change
+   */
+  static void MetricsGC(void *old_value, void *new_value, DBMain *db_main,
+                        const std::shared_ptr<common::ActionContext> &action_context);
 };
 }  // namespace terrier::settings
@@ -44,6 +44,17 @@ SETTING_int(
     terrier::settings::Callbacks::NoOp
 )
 
+// Number of garbage collector workers
+SETTING_int(
+    gc_num_workers,
+    "The number of workers garbage collection is spread across (default: 1)",
+    1,
+    1,
+    64,
+    true,
+    terrier::settings::Callbacks::GCNumWorkers
+)
+
 // Number of worker pool threads
 SETTING_int(
     num_worker_threads,
@@ -108,6 +119,70 @@ SETTING_int(
     terrier::settings::Callbacks::NoOp
 )
 
+// Number of GC invocations before a block without writes is considered cold
+SETTING_int(
+    cold_data_epoch_threshold,
+    "Number of GC invocations a block needs to go without writes before it is frozen (default: 10)",
+    10,
+    1,
+    10000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Number of block compactor workers
+SETTING_int(
+    compactor_num_workers,
+    "The number of threads that freeze cold blocks, or 0 to never freeze blocks (default: 0)",
+    0,
+    0,
+    64,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Block compactor interval
+SETTING_int(
+    compactor_interval,
+    "Time (ms) a block compactor thread sleeps after finding no cold blocks (default: 10)",
+    10,
+    1,
+    10000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Number of GC invocations before a frozen block that is not read is evicted
+SETTING_int(
+    block_evictor_idle_threshold,
+    "Number of GC invocations a frozen block needs to go unread before it is evicted, or 0 to never evict (default: 0)",
+    0,
+    0,
+    100000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Number of blocks the evictor writes out at most every time the GC runs
+SETTING_int(
+    block_evictor_max_evictions_per_pass,
+    "Maximum number of blocks evicted in one GC invocation (default: 4)",
+    4,
+    1,
+    10000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Path to the file that evicted blocks are written to
+SETTING_string(
+    block_file_path,
+    "The path to the file that evicted blocks are written to (default: terrier.blocks)",
+    "terrier.blocks",
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 SETTING_bool(
     metrics_logging,
     "Metrics collection for the Logging component.",
@@ -123,3 +198,19 @@ SETTING_bool(
     true,
     terrier::settings::Callbacks::MetricsTransaction
 )
+
+SETTING_bool(
+    metrics_compaction,
+    "Metrics collection for the BlockCompactor component.",
+    false,
+    true,
+    terrier::settings::Callbacks::MetricsCompaction
+)
+
+SETTING_bool(
+    metrics_gc,
+    "Metrics collection for the GarbageCollector component.",
+    false,
+    true,
+    terrier::settings::Callbacks::MetricsGC
+)
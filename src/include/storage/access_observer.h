@@ -1,11 +1,14 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
+#include "common/spin_latch.h"
+#include "storage/data_table.h"
 #include "storage/storage_defs.h"
 
 namespace terrier::storage {
-class DataTable;
 class BlockCompactor;
+class BlockEvictor;
 // TODO(Tianyu): Probably need to be smarter than this to identify true hot or cold data, but this
 // will do for now.
 // Specifically, when the system is under load, and the GC does not get its own dedicated physical core,
@@ -22,18 +25,58 @@ class BlockCompactor;
  * when relavent events fire. It is then free to make a decision whether to send a block into the compactor's queue
  * to freeze asynchronously.
  *
+ * A block is considered cold once no writes to it have been observed for the cold threshold of its table, and the
+ * decayed count of writes it received before then (its heat) has dropped low enough. Blocks that were written to
+ * heavily therefore need to stay idle for longer than blocks that saw a few stray updates. The statistics are kept in
+ * the block header, and the observer only keeps a list of the full blocks it is watching.
+ *
+ * The threshold adapts per table: when a block that was sent to the compactor is written to again before it could
+ * stay frozen, the freeze is considered wasted and the table's threshold doubles (up to a limit). The back-off is
+ * lifted gradually once the table goes long enough without another such thrash.
+ *
  * Notice that although the observation step is light weight, it does happen on the garbage collection thread and thus
  * has some minor performance impact on GC and consequently the rest of the system. Care should be taken to not do
  * any computationally-intensive work here to figure out whether a block is cold. The entire hot-cold mechanism is
  * designed to be lightweight on the cold->hot transition so we can afford to be wrong in the observation phase.
+ *
+ * The observer is driven by the GC thread, but tables can be dropped from any thread, so it listens for blocks being
+ * freed and stops watching them.
  */
-class AccessObserver {
+class AccessObserver : public BlockReleaseListener {
  public:
+  /**
+   * Number of GC invocations it takes for the heat of a block to halve
+   */
+  static constexpr uint32_t HEAT_HALF_LIFE = 4;
+  /**
+   * A block is not considered cold until its decayed heat is at most this value
+   */
+  static constexpr uint16_t COLD_HEAT_LIMIT = 1;
+  /**
+   * The most times the cold threshold of a table can be doubled because of thrashing
+   */
+  static constexpr uint8_t MAX_THRASH_BACKOFF = 4;
+
   /**
    * Constructs a new AccessObserver that will send its observations to the given block compactor
    * @param compactor the compactor to use after identifying a cold block
+   * @param cold_threshold number of GC invocations a block needs to go without writes before it is considered cold,
+   *                       unless overridden for its table (usually the cold_data_epoch_threshold setting)
+   * @param evictor the evictor to hand cold blocks to as well, so it can evict them once they are frozen, or nullptr
+   *                if blocks should stay in memory
+   */
+  explicit AccessObserver(BlockCompactor *compactor, uint32_t cold_threshold = COLD_DATA_EPOCH_THRESHOLD,
+                          BlockEvictor *evictor = nullptr)
+      : cold_threshold_(cold_threshold), compactor_(compactor), evictor_(evictor) {
+    DataTable::AddBlockReleaseListener(this);
+  }
+
+  /**
+   * Stops listening for freed blocks
    */
-  explicit AccessObserver(BlockCompactor *compactor) : compactor_(compactor) {}
+  ~AccessObserver() override { DataTable::RemoveBlockReleaseListener(this); }
+
+  DISALLOW_COPY_AND_MOVE(AccessObserver);
 
   /**
    * Signals to the AccessObserver that a new GC run has begun. This is useful as a measurement of time to the
@@ -49,12 +92,55 @@ class AccessObserver {
    */
   void ObserveWrite(RawBlock *block);
 
+  /**
+   * Overrides the cold threshold for the blocks of the given table. Tables that are updated in bursts benefit from a
+   * longer threshold, while append-only tables can be frozen sooner.
+   * @param table the table to tune
+   * @param cold_threshold number of GC invocations a block of the table needs to go without writes before it is
+   *                       considered cold, or 0 to go back to the default threshold
+   */
+  void SetTableColdThreshold(const DataTable *table, uint32_t cold_threshold);
+
+  /**
+   * @param table the table to look up
+   * @return number of GC invocations a block of the table currently needs to go without writes before it is
+   *         considered cold, including any back-off because of thrashing
+   */
+  uint32_t TableColdThreshold(const DataTable *table);
+
+  /**
+   * Stops watching the given block, which is about to be freed
+   * @param block the block about to be freed
+   */
+  void ForgetBlock(RawBlock *block) override;
+
  private:
+  // Flags kept in the access stats of a block
+  static constexpr uint16_t WATCHED = 1;  // the block is in watched_blocks_
+  static constexpr uint16_t QUEUED = 2;   // the block was sent to the compactor and not written to since
+
+  // Cold detection policy of one table
+  struct TablePolicy {
+    uint32_t threshold_override_ = 0;  // 0 if the table uses the default threshold
+    uint8_t backoff_ = 0;              // number of times the threshold is doubled
+    uint32_t last_thrash_epoch_ = 0;
+  };
+
+  TablePolicy &Policy(const DataTable *table) { return policies_[table]; }
+  uint32_t Threshold(TablePolicy *policy);
+  uint16_t DecayedHeat(const BlockAccessStats &stats) const;
+  uint32_t Epoch() const { return static_cast<uint32_t>(gc_epoch_); }
+
+  // Only contended when a table is dropped while the GC is running
+  common::SpinLatch latch_;
   uint64_t gc_epoch_ = 0;  // estimate time using the number of times GC has run
-  // Here RawBlock * should suffice as a unique identifier of the block. Although a block can be
-  // reused, that process should only be triggered through compaction, which happens only if the
-  // reference to said block is identified as cold and leaves the table.
-  std::unordered_map<RawBlock *, uint64_t> last_touched_;
+  uint32_t cold_threshold_;
+  // Full blocks that have been written to and not yet sent to the compactor. RawBlock * should suffice as a unique
+  // identifier of the block, because blocks are forgotten before they are freed and can be reused.
+  std::vector<RawBlock *> watched_blocks_;
+  // There are few tables compared to blocks, so a map is fine here
+  std::unordered_map<const DataTable *, TablePolicy> policies_;
   BlockCompactor *compactor_;
+  BlockEvictor *evictor_;
 };
 }  // namespace terrier::storage
@@ -1,7 +1,10 @@
 #pragma once
+#include <atomic>
 #include <map>
+#include <new>
 #include <unordered_set>
 #include <utility>
+#include "common/container/concurrent_bitmap.h"
 #include "storage/block_layout.h"
 #include "storage/storage_defs.h"
 #include "storage/storage_util.h"
@@ -115,32 +118,168 @@ class ArrowVarlenColumn {
   uint32_t *offsets_ = nullptr;
 };
 
+/**
+ * Stores the range of values of a fixed-length column in a frozen block, so scans can skip blocks that cannot
+ * satisfy a predicate without looking at their tuples. Values are interpreted as signed integers of the column's
+ * attribute size, so the range is only meaningful for integer columns. Null values are not part of the range, see
+ * ArrowBlockMetadata::NullCount for those.
+ */
+class ColumnZoneMap {
+ public:
+  /**
+   * @return reference to the smallest non-null value in the column
+   */
+  int64_t &Min() { return min_; }
+
+  /**
+   * @return the smallest non-null value in the column
+   */
+  int64_t Min() const { return min_; }
+
+  /**
+   * @return reference to the largest non-null value in the column
+   */
+  int64_t &Max() { return max_; }
+
+  /**
+   * @return the largest non-null value in the column
+   */
+  int64_t Max() const { return max_; }
+
+ private:
+  int64_t min_ = 0;
+  int64_t max_ = 0;
+};
+
+/**
+ * Lightweight encodings a frozen fixed-length column can be stored in
+ */
+enum class ArrowColumnEncoding : uint8_t { RUN_LENGTH = 0, FRAME_OF_REFERENCE, BIT_PACKED };
+
+/**
+ * Stores a fixed-length column of a frozen block in compressed form. Once the compactor has encoded a column, the
+ * column in the block is given back to the OS, and readers decode values from here instead. Values are treated as
+ * signed integers of the column's attribute size, which is lossless for any fixed-length type. Nulls are taken from
+ * the null bitmap in the block, which stays in place, and the values of null slots are not kept.
+ *
+ * Run-length encoded columns store an array of run values followed by an array of run ends, the same as Arrow's
+ * run-end encoding. Frame-of-reference columns store every value as its difference from the reference value, packed
+ * into bit_width bits. Bit-packed columns are frame-of-reference columns with a reference value of 0.
+ */
+class ArrowEncodedColumn {
+ public:
+  DISALLOW_COPY_AND_MOVE(ArrowEncodedColumn)
+
+  /**
+   * Destructs an ArrowEncodedColumn
+   */
+  ~ArrowEncodedColumn() { delete[] data_; }
+
+  /**
+   * Encodes the first num_values values of a fixed-length column with whichever encoding takes the least space.
+   * @param attr_size attribute size of the column. Must be 1, 2, 4 or 8.
+   * @param values start of the column
+   * @param nulls null bitmap of the column
+   * @param num_values number of values to encode
+   * @return the encoded column, or nullptr if no encoding takes less space than the plain column. The caller owns the
+   *         encoded column.
+   */
+  static ArrowEncodedColumn *Encode(uint8_t attr_size, const byte *values, const common::RawConcurrentBitmap *nulls,
+                                    uint32_t num_values);
+
+  /**
+   * Decodes a range of values into a plain array. Values of null slots are unspecified.
+   * @param start offset of the first value to decode
+   * @param num_values number of values to decode
+   * @param[out] out array of num_values * attribute size bytes to decode into
+   */
+  void Decode(uint32_t start, uint32_t num_values, byte *out) const;
+
+  /**
+   * @return encoding of the column
+   */
+  ArrowColumnEncoding Encoding() const { return encoding_; }
+
+  /**
+   * @return attribute size of the column
+   */
+  uint8_t AttrSize() const { return attr_size_; }
+
+  /**
+   * @return number of values encoded
+   */
+  uint32_t NumValues() const { return num_values_; }
+
+  /**
+   * @return number of bits every value takes up, for frame-of-reference and bit-packed columns
+   */
+  uint8_t BitWidth() const { return bit_width_; }
+
+  /**
+   * @return number of runs, for run-length encoded columns
+   */
+  uint32_t NumRuns() const { return num_runs_; }
+
+  /**
+   * @return value every packed value is relative to, for frame-of-reference and bit-packed columns
+   */
+  int64_t Reference() const { return reference_; }
+
+  /**
+   * @return size of the encoded data in bytes
+   */
+  uint32_t DataLength() const { return data_length_; }
+
+ private:
+  ArrowColumnEncoding encoding_;
+  uint8_t attr_size_;
+  uint8_t bit_width_ = 0;
+  uint32_t num_values_;
+  uint32_t num_runs_ = 0;
+  int64_t reference_ = 0;
+  uint32_t data_length_ = 0;
+  byte *data_ = nullptr;
+
+  ArrowEncodedColumn(ArrowColumnEncoding encoding, uint8_t attr_size, uint32_t num_values)
+      : encoding_(encoding), attr_size_(attr_size), num_values_(num_values) {}
+
+  template <class T>
+  static ArrowEncodedColumn *EncodeImpl(const T *values, const common::RawConcurrentBitmap *nulls,
+                                        uint32_t num_values);
+
+  template <class T>
+  void DecodeImpl(uint32_t start, uint32_t num_values, T *out) const;
+};
+
 /**
  * An ArrowColumnInfo object contains everything needed to reason about Arrow storage of a column in the block.
  *
  * All columns has a type associated with it. Gathered varlen columns has an ArrowVarlenColumn. If the column
  * is dictionary-compressed, it has an ArrowVarlenColumn that is the dictionary, and an indices array that encodes
  * the values. Notice here that the meaning of the ArrowVarlenColumn is different for dictionary-encoded columns
- * and simple gathered columns.
+ * and simple gathered columns. Fixed-length columns have no varlen buffers, and keep their zone map in that space
+ * instead, so that the block header does not grow with the zone maps and MAX_COL columns still fit in a block. For the
+ * same reason, the encoded copy of a fixed-length column takes the place of the indices array.
+ *
+ * The encoded copy is swapped in and out while the block is being read, so the pointer to it is atomic, and its two
+ * low bits are flags: one is a lock held while the column in the block is released or decoded back into, and the
+ * other marks the column in the block as released.
  */
 class ArrowColumnInfo {
  public:
   /**
-   * Default constructor for Arrow ColumnInfo
+   * Default constructor for Arrow ColumnInfo, with an empty ArrowVarlenColumn
    */
-  ArrowColumnInfo() = default;
+  ArrowColumnInfo() : varlen_column_() {}
 
   /**
    * Move constructor for ArrowColumnInfo
    * @param other the object to move from
    */
-  ArrowColumnInfo(ArrowColumnInfo &&other) noexcept
-      : type_(other.type_), varlen_column_(std::move(other.varlen_column_)), indices_(other.indices_) {
-    other.indices_ = nullptr;
-  }
+  ArrowColumnInfo(ArrowColumnInfo &&other) noexcept : type_(other.type_) { MoveFrom(&other); }
 
   /**
-   * Destructor for ArrowColumnInfo
+   * Destructor for ArrowColumnInfo. ArrowVarlenColumn has nothing left to free once deallocated.
    */
   ~ArrowColumnInfo() { Deallocate(); }
 
@@ -151,11 +290,9 @@ class ArrowColumnInfo {
    */
   ArrowColumnInfo &operator=(ArrowColumnInfo &&other) noexcept {
     if (this != &other) {
+      Deallocate();
       type_ = other.type_;
-      varlen_column_ = std::move(other.varlen_column_);
-      delete[] indices_;
-      indices_ = other.indices_;
-      other.indices_ = nullptr;
+      MoveFrom(&other);
     }
     return *this;
   }
@@ -164,10 +301,83 @@ class ArrowColumnInfo {
    * @return type of the Arrow Column
    */
   ArrowColumnType &Type() { return type_; }
+
+  /**
+   * @return type of the Arrow Column
+   */
+  ArrowColumnType Type() const { return type_; }
+
+  /**
+   * @return ArrowVarlenColumn object for the column
+   */
+  ArrowVarlenColumn &VarlenColumn() {
+    TERRIER_ASSERT(type_ != ArrowColumnType::FIXED_LENGTH, "fixed-length columns have no varlen buffers");
+    return varlen_column_;
+  }
+
   /**
    * @return ArrowVarlenColumn object for the column
    */
-  ArrowVarlenColumn &VarlenColumn() { return varlen_column_; }
+  const ArrowVarlenColumn &VarlenColumn() const {
+    TERRIER_ASSERT(type_ != ArrowColumnType::FIXED_LENGTH, "fixed-length columns have no varlen buffers");
+    return varlen_column_;
+  }
+
+  /**
+   * @return ColumnZoneMap object for the column. Only populated for fixed-length columns of frozen blocks.
+   */
+  ColumnZoneMap &ZoneMap() {
+    TERRIER_ASSERT(type_ == ArrowColumnType::FIXED_LENGTH, "zone maps are only kept for fixed-length columns");
+    return zone_map_;
+  }
+
+  /**
+   * @return ColumnZoneMap object for the column. Only populated for fixed-length columns of frozen blocks.
+   */
+  const ColumnZoneMap &ZoneMap() const {
+    TERRIER_ASSERT(type_ == ArrowColumnType::FIXED_LENGTH, "zone maps are only kept for fixed-length columns");
+    return zone_map_;
+  }
+
+  /**
+   * @return the encoded copy of the column, or nullptr if there is none. Only fixed-length columns of blocks that have
+   *         been frozen are encoded. While there is an encoded copy, the column in the block may have been released,
+   *         and values have to be decoded from the copy.
+   */
+  const ArrowEncodedColumn *EncodedColumn() const {
+    TERRIER_ASSERT(type_ == ArrowColumnType::FIXED_LENGTH, "only fixed-length columns are encoded");
+    return reinterpret_cast<const ArrowEncodedColumn *>(encoded_column_.load() & ~ENCODED_COLUMN_FLAGS);
+  }
+
+  /**
+   * Hands the column an encoded copy. The column in the block stays in place until ReleasePlainColumn is called. Only
+   * the compactor calls this, while the block is freezing and the column has no encoded copy.
+   * @param encoded the encoded copy, which the column takes ownership of
+   */
+  void SetEncodedColumn(ArrowEncodedColumn *encoded) {
+    TERRIER_ASSERT(type_ == ArrowColumnType::FIXED_LENGTH, "only fixed-length columns are encoded");
+    TERRIER_ASSERT(encoded_column_.load() == 0, "column already has an encoded copy");
+    encoded_column_.store(reinterpret_cast<uintptr_t>(encoded));
+  }
+
+  /**
+   * Gives the memory of the column in the block back to the OS, if the column still has the given encoded copy. This
+   * has to wait until nobody that may have seen the column without its encoded copy is still reading it.
+   * @param encoded the encoded copy the column was given
+   * @param values start of the column in the block
+   * @param size size of the column in the block in bytes
+   */
+  void ReleasePlainColumn(const ArrowEncodedColumn *encoded, byte *values, uint64_t size);
+
+  /**
+   * Takes the encoded copy away from the column, decoding it back into the block first if the column in the block was
+   * released. Writers call this before writing to the column, and the column can be read from the block again once
+   * this returns.
+   * @param values start of the column in the block
+   * @return the encoded copy that was taken away, or nullptr if the column had none. Readers may still be decoding from
+   *         it, so it can only be freed once they are done.
+   */
+  ArrowEncodedColumn *Thaw(byte *values);
 
   /**
    * Returns the indices array. This array is only meaningful if the column is dictionary compressed. The
@@ -181,21 +391,63 @@ class ArrowColumnInfo {
   }
 
   /**
-   * Deallocates all associated buffers in the ArrowVarlenColumn
+   * Returns the indices array. This array is only meaningful if the column is dictionary compressed.
+   * @return the indices array
+   */
+  const uint32_t *Indices() const {
+    TERRIER_ASSERT(type_ == ArrowColumnType::DICTIONARY_COMPRESSED,
+                   "this array is only meaningful if the column is dicationary compressed");
+    return indices_;
+  }
+
+  /**
+   * Deallocates all associated buffers in the ArrowVarlenColumn, or the encoded copy of a fixed-length column
    */
   void Deallocate() {
+    if (type_ == ArrowColumnType::FIXED_LENGTH) {
+      delete EncodedColumn();
+      encoded_column_.store(0);
+      return;
+    }
     delete[] indices_;
+    indices_ = nullptr;
     varlen_column_.Deallocate();
   }
 
  private:
+  // Low bits of encoded_column_ that are flags rather than part of the pointer
+  static constexpr uintptr_t ENCODED_COLUMN_LOCKED = 1, ENCODED_COLUMN_RELEASED = 2;
+  static constexpr uintptr_t ENCODED_COLUMN_FLAGS = ENCODED_COLUMN_LOCKED | ENCODED_COLUMN_RELEASED;
+
   /**
    * type of this Arrow column
    */
-  ArrowColumnType type_;
-  ArrowVarlenColumn varlen_column_;  // For varlen and dictionary
+  ArrowColumnType type_ = ArrowColumnType::GATHERED_VARLEN;
+  // Which one is in use depends on the type of the column. Metadata of a new block is zeroed out, which makes for an
+  // empty instance of either.
+  union {
+    ArrowVarlenColumn varlen_column_;  // For varlen and dictionary
+    ColumnZoneMap zone_map_;           // For fixed-length
+  };
   // TODO(Tianyu): Add null bitmap
-  uint32_t *indices_ = nullptr;  // for dictionary
+  union {
+    uint32_t *indices_ = nullptr;            // For dictionary
+    std::atomic<uintptr_t> encoded_column_;  // For fixed-length
+  };
+
+  void MoveFrom(ArrowColumnInfo *other) {
+    if (type_ == ArrowColumnType::FIXED_LENGTH) {
+      new (&zone_map_) ColumnZoneMap(other->zone_map_);
+      new (&encoded_column_) std::atomic<uintptr_t>(other->encoded_column_.exchange(0));
+      return;
+    }
+    new (&varlen_column_) ArrowVarlenColumn(std::move(other->varlen_column_));
+    indices_ = other->indices_;
+    other->indices_ = nullptr;
+  }
+
+  // Locks encoded_column_, and returns what it held before
+  uintptr_t LockEncodedColumn();
 };
 
 /**
@@ -216,7 +468,7 @@ class ArrowBlockMetadata {
    * @return size of the metadata object given the number of columns
    */
   static uint32_t Size(uint16_t num_cols) {
-    return StorageUtil::PadUpToSize(sizeof(uint64_t), static_cast<uint32_t>(sizeof(uint32_t)) * (num_cols + 1)) +
+    return StorageUtil::PadUpToSize(sizeof(uint64_t), static_cast<uint32_t>(sizeof(uint32_t)) * (num_cols + 2)) +
            num_cols * static_cast<uint32_t>(sizeof(ArrowColumnInfo));
   }
 
@@ -239,6 +491,12 @@ class ArrowBlockMetadata {
    */
   uint32_t NumRecords() const { return num_records_; }
 
+  /**
+   * @return number of columns in the block that have an encoded copy. Readers only need to look for encoded copies of
+   *         the columns they read if this is not 0.
+   */
+  std::atomic<uint32_t> &NumEncodedColumns() { return num_encoded_columns_; }
+
   /**
    *
    * @param col_id the column of interest
@@ -274,8 +532,27 @@ class ArrowBlockMetadata {
     return reinterpret_cast<ArrowColumnInfo *>(null_count_end)[!col_id];
   }
 
+  /**
+   * @param layout layout object of the Block
+   * @param col_id the column of interest
+   * @return ColumnZoneMap object of the given column. Only populated for fixed-length columns of frozen blocks.
+   */
+  ColumnZoneMap &GetZoneMap(const BlockLayout &layout, col_id_t col_id) {
+    return GetColumnInfo(layout, col_id).ZoneMap();
+  }
+
+  /**
+   * @param layout layout object of the Block
+   * @param col_id the column of interest
+   * @return ColumnZoneMap object of the given column. Only populated for fixed-length columns of frozen blocks.
+   */
+  const ColumnZoneMap &GetZoneMap(const BlockLayout &layout, col_id_t col_id) const {
+    return GetColumnInfo(layout, col_id).ZoneMap();
+  }
+
  private:
-  uint32_t num_records_;  // number of actual records
+  uint32_t num_records_;                       // number of actual records
+  std::atomic<uint32_t> num_encoded_columns_;  // number of columns with an encoded copy
   // null_count[num_cols] (32-bit) | padding up to 8 byte-aligned | arrow_varlen_buffers[num_cols] |
   byte varlen_content_[];
 };
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <sys/uio.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "storage/projected_row.h"
+#include "storage/storage_defs.h"
+#include "type/type_id.h"
+
+namespace terrier::transaction {
+class TransactionContext;
+}
+
+namespace terrier::storage {
+class DataTable;
+
+/**
+ * Writes the contents of a table out as an Arrow IPC file (also known as Feather V2), which tools like pyarrow or
+ * pandas can load without going through the database. Every block of the table becomes a record batch of the file.
+ *
+ * Frozen blocks are already laid out the way Arrow expects, so their buffers are handed to writev straight from block
+ * memory while the writer holds an in-place read on the block. The exceptions are boolean columns, which Arrow packs
+ * into bits, and dictionary compressed varlens, because the file format does not allow a different dictionary per
+ * record batch. Blocks that are not frozen are materialized tuple by tuple, as visible to the given transaction.
+ *
+ * Dates and timestamps are written out as the unsigned integers they are stored as, because their encodings do not
+ * match any of the Arrow temporal types.
+ *
+ * @see https://arrow.apache.org/docs/format/Columnar.html#ipc-file-format
+ */
+class ArrowIpcWriter {
+ public:
+  /**
+   * Describes a column of the table to write out
+   */
+  struct Field {
+    /**
+     * Name of the column in the Arrow schema
+     */
+    std::string name_;
+    /**
+     * SQL type of the column
+     */
+    type::TypeId type_;
+    /**
+     * Whether the column can hold nulls
+     */
+    bool nullable_;
+    /**
+     * Column in the data table
+     */
+    col_id_t col_id_;
+  };
+
+  /**
+   * Instantiates a new writer for the given columns of a table
+   * @param table the table to write out
+   * @param fields columns to write out, in the order they should appear in the file
+   */
+  ArrowIpcWriter(const DataTable *table, std::vector<Field> fields) : table_(table), fields_(std::move(fields)) {}
+
+  /**
+   * Writes the contents of the table, as visible to the given transaction, out to the file at the given path. The file
+   * is overwritten if it already exists.
+   * @param txn the transaction to read hot blocks with
+   * @param file_path path to the file to write
+   * @throws runtime_error if the file cannot be written
+   */
+  void WriteFile(transaction::TransactionContext *txn, const std::string &file_path);
+
+  /**
+   * @return number of blocks that were written out straight from block memory in the last WriteFile call
+   */
+  uint32_t NumBlocksInPlace() const { return num_blocks_in_place_; }
+
+  /**
+   * @return number of blocks that had to be materialized in the last WriteFile call
+   */
+  uint32_t NumBlocksMaterialized() const { return num_blocks_materialized_; }
+
+ private:
+  // Location of a message in the file, as recorded in the footer
+  struct FileBlock {
+    int64_t offset_;
+    int32_t metadata_length_;
+    int32_t padding_;
+    int64_t body_length_;
+  };
+
+  class RecordBatch;
+
+  void WriteFrozenBlock(RawBlock *block);
+  void WriteHotBlock(transaction::TransactionContext *txn, RawBlock *block, ProjectedRow *row);
+  FileBlock WriteMessage(const std::vector<uint8_t> &metadata, std::vector<iovec> *body, uint64_t body_length);
+
+  const DataTable *const table_;
+  const std::vector<Field> fields_;
+  int out_ = -1;
+  int64_t file_offset_ = 0;
+  std::vector<FileBlock> record_batches_;
+  uint32_t num_blocks_in_place_ = 0, num_blocks_materialized_ = 0;
+};
+}  // namespace terrier::storage
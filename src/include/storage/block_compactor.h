@@ -1,14 +1,23 @@
 #pragma once
-#include <queue>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
+#include "common/container/concurrent_queue.h"
+#include "common/dedicated_thread_owner.h"
+#include "common/dedicated_thread_registry.h"
+#include "common/dedicated_thread_task.h"
+#include "common/spin_latch.h"
 #include "storage/arrow_block_metadata.h"
 #include "storage/data_table.h"
 #include "storage/storage_defs.h"
 #include "transaction/transaction_manager.h"
 namespace terrier::storage {
 
+class BlockCompactorTask;
+
 /**
  * Typedef for a standard hash map with varlen entry as the key. The map uses deep equality checks (whether
  * the stored underlying byte string is the same) for key comparison.
@@ -21,8 +30,13 @@ using VarlenEntryMap = std::unordered_map<VarlenEntry, T, VarlenContentHasher, V
  * arrow-compatible. In the process, any gaps resulting from deletes or aborted transactions are also eliminated.
  * If the compaction is successful, the block is considered to be fully cold and will be accessed mostly as read-only
  * data.
+ *
+ * The compaction queue can be drained by calling ProcessCompactionQueue, or by dedicated workers requested from the
+ * DedicatedThreadRegistry with StartWorkers. Workers take batches of blocks off the queue, and partition each batch
+ * by table. Only one worker at a time processes the blocks of a table, so workers never contend with each other on the
+ * same table, while blocks of different tables are compacted and gathered in parallel.
  */
-class BlockCompactor {
+class BlockCompactor : public common::DedicatedThreadOwner {
  private:
   // A Compaction group is a series of blocks all belonging to the same data table. We compact them together
   // so slots can be freed up. If we only compact single block at a time, deleted slots will never be reclaimed.
@@ -48,24 +62,82 @@ class BlockCompactor {
     ProjectedRow *read_buffer_;
   };
 
+  // Number of blocks of each outcome in a pass over the compaction queue
+  struct PassStats {
+    uint64_t num_compacted_ = 0;
+    uint64_t num_frozen_ = 0;
+    uint64_t num_aborted_ = 0;
+  };
+
  public:
-  FAKED_IN_TEST ~BlockCompactor() = default;
+  /**
+   * Maximum number of blocks a worker takes off the compaction queue in one pass
+   */
+  static constexpr uint32_t MAX_BATCH_SIZE = 64;
+
+  /**
+   * Constructs a compactor that is only driven by calls to ProcessCompactionQueue
+   */
+  BlockCompactor() : BlockCompactor(DISABLED) {}
+
+  /**
+   * Constructs a compactor that can also run dedicated workers
+   * @param thread_registry the registry to request worker threads from
+   */
+  explicit BlockCompactor(common::ManagedPointer<common::DedicatedThreadRegistry> thread_registry)
+      : DedicatedThreadOwner(thread_registry) {}
+
+  /**
+   * Stops the workers, if there are any
+   */
+  ~BlockCompactor() override { StopWorkers(); }
 
   /**
    * Processes the compaction queue and mark processed blocks as cold if successful. The compaction can fail due
    * to live versions or contention. There will be a brief window where user transactions writing to the block
-   * can be aborted, but no readers would be blocked.
+   * can be aborted, but no readers would be blocked. Cooling blocks that still have live versions are put back in
+   * the queue to be retried by the next call.
    */
   void ProcessCompactionQueue(transaction::DeferredActionManager *deferred_action_manager,
                               transaction::TransactionManager *txn_manager);
 
   /**
-   * Adds a block associated with a data table to the compaction to be processed in the future.
+   * Adds a block associated with a data table to the compaction to be processed in the future. Safe to call
+   * concurrently with the workers and with other callers.
    * @param block the block that needs to be processed by the compactor
    */
-  FAKED_IN_TEST void PutInQueue(RawBlock *block) { compaction_queue_.push(block); }
+  FAKED_IN_TEST void PutInQueue(RawBlock *block) { compaction_queue_.Enqueue(block); }
+
+  /**
+   * Requests dedicated worker threads that keep draining the compaction queue until StopWorkers is called. Must not be
+   * called while workers are running. If a worker collects metrics, it records every pass that did some work.
+   * @param num_workers number of workers
+   * @param interval time a worker sleeps after finding the queue empty
+   * @param deferred_action_manager the deferred action manager used to free stale varlens and retry compactions
+   * @param txn_manager the transaction manager used for compaction transactions
+   */
+  void StartWorkers(uint32_t num_workers, std::chrono::microseconds interval,
+                    transaction::DeferredActionManager *deferred_action_manager,
+                    transaction::TransactionManager *txn_manager);
+
+  /**
+   * Stops the workers started by StartWorkers and waits for them to finish their current pass. Blocks still in the
+   * queue stay there.
+   */
+  void StopWorkers();
 
  private:
+  friend class BlockCompactorTask;
+
+  // Takes up to max_blocks blocks off the queue and processes the blocks of every table that no other worker is
+  // processing. The blocks of the other tables are put back in the queue.
+  PassStats ProcessBatch(uint32_t max_blocks, transaction::DeferredActionManager *deferred_action_manager,
+                         transaction::TransactionManager *txn_manager);
+
+  void ProcessBlock(RawBlock *block, transaction::DeferredActionManager *deferred_action_manager,
+                    transaction::TransactionManager *txn_manager, PassStats *stats);
+
+
   bool EliminateGaps(CompactionGroup *cg);
 
   bool CheckForVersionsAndGaps(const TupleAccessStrategy &accessor, RawBlock *block);
@@ -73,12 +145,28 @@ class BlockCompactor {
   // Move a tuple and updated associated information in their respective blocks
   bool MoveTuple(CompactionGroup *cg, TupleSlot from, TupleSlot to);
 
-  void GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlock *block, DataTable *table);
+  // Also encodes the fixed-length columns. Encoded copies left over from an earlier freeze go into stale_encodings, and
+  // the new ones into encodings, so the columns in the block can be released once nobody can be reading them.
+  void GatherVarlens(std::vector<VarlenEntry> *loose_ptrs, std::vector<ArrowEncodedColumn *> *stale_encodings,
+                     std::vector<std::pair<col_id_t, const ArrowEncodedColumn *>> *encodings, RawBlock *block,
+                     DataTable *table);
+
+  // Gives back the memory of the fixed-length columns of a frozen block that still have the given encoded copies
+  void ReleasePlainColumns(RawBlock *block,
+                           const std::vector<std::pair<col_id_t, const ArrowEncodedColumn *>> &encodings);
 
-  void CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata, col_id_t col_id,
+  // Count the nulls and compute the range of the non-null values of a fixed-length column
+  void ComputeZoneMap(ArrowBlockMetadata *metadata, const BlockLayout &layout, col_id_t col_id,
+                      common::RawConcurrentBitmap *column_bitmap, const byte *values);
+
+  template <class T>
+  void ComputeZoneMapImpl(ArrowBlockMetadata *metadata, const BlockLayout &layout, col_id_t col_id,
+                      common::RawConcurrentBitmap *column_bitmap, const T *values);
+
+  void CopyToArrowVarlen(std::vector<VarlenEntry> *loose_ptrs, ArrowBlockMetadata *metadata, col_id_t col_id,
                          common::RawConcurrentBitmap *column_bitmap, ArrowColumnInfo *col, VarlenEntry *values);
 
-  void BuildDictionary(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata, col_id_t col_id,
+  void BuildDictionary(std::vector<VarlenEntry> *loose_ptrs, ArrowBlockMetadata *metadata, col_id_t col_id,
                        common::RawConcurrentBitmap *column_bitmap, ArrowColumnInfo *col, VarlenEntry *values);
 
   void ComputeFilled(const BlockLayout &layout, std::vector<uint32_t> *filled, const std::vector<uint32_t> &empty) {
@@ -94,6 +182,54 @@ class BlockCompactor {
     }
   }
 
-  std::queue<RawBlock *> compaction_queue_;
+  common::ConcurrentQueue<RawBlock *> compaction_queue_;
+  // Tables whose blocks are being processed by some worker
+  common::SpinLatch tables_latch_;
+  std::unordered_set<DataTable *> tables_in_progress_;
+  std::vector<common::ManagedPointer<BlockCompactorTask>> workers_;
+};
+
+/**
+ * A dedicated block compactor worker. Keeps taking batches of blocks off the compaction queue until terminated.
+ */
+class BlockCompactorTask : public common::DedicatedThreadTask {
+ public:
+  /**
+   * @param compactor the compactor whose queue to drain
+   * @param worker_id id of the worker, used to tell workers apart in the metrics
+   * @param interval time to sleep after finding the queue empty
+   * @param deferred_action_manager the deferred action manager used to free stale varlens and retry compactions
+   * @param txn_manager the transaction manager used for compaction transactions
+   */
+  BlockCompactorTask(BlockCompactor *compactor, uint32_t worker_id, std::chrono::microseconds interval,
+                     transaction::DeferredActionManager *deferred_action_manager,
+                     transaction::TransactionManager *txn_manager)
+      : compactor_(compactor),
+        worker_id_(worker_id),
+        interval_(interval),
+        deferred_action_manager_(deferred_action_manager),
+        txn_manager_(txn_manager) {}
+
+  /**
+   * Runs the worker loop until Terminate is called
+   */
+  void RunTask() override;
+
+  /**
+   * Signals the worker to stop after its current pass
+   */
+  void Terminate() override {
+    // If the task hasn't run yet, yield the thread until it's started
+    while (!run_task_.load()) std::this_thread::yield();
+    run_task_.store(false);
+  }
+
+ private:
+  BlockCompactor *const compactor_;
+  const uint32_t worker_id_;
+  const std::chrono::microseconds interval_;
+  transaction::DeferredActionManager *const deferred_action_manager_;
+  transaction::TransactionManager *const txn_manager_;
+  std::atomic<bool> run_task_{false};
 };
 }  // namespace terrier::storage
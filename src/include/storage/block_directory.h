@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>  // NOLINT
+#include "common/macros.h"
+
+namespace terrier::storage {
+class RawBlock;
+
+/**
+ * Append-only array of the blocks of a table, which can be read without latching while blocks are being appended.
+ *
+ * Block pointers are kept in chunks that double in size, and a chunk is only allocated once a block lands in it. A
+ * chunk never moves once allocated, so readers can look up blocks without latching, and appenders only contend on an
+ * atomic counter. A table with a handful of blocks only pays for the first chunk, and the chunks together cover every
+ * block index a uint32_t can hold.
+ *
+ * The directory does not own the blocks in it.
+ */
+class BlockDirectory {
+ public:
+  /**
+   * Constructs an empty directory
+   */
+  BlockDirectory() = default;
+
+  /**
+   * Frees the chunks of the directory, but not the blocks in them
+   */
+  ~BlockDirectory() {
+    for (auto &chunk : chunks_) delete[] chunk.load();
+  }
+
+  DISALLOW_COPY_AND_MOVE(BlockDirectory);
+
+  /**
+   * @return number of blocks that are published in the directory. Every block below this index can be read.
+   */
+  uint32_t Size() const { return num_blocks_.load(); }
+
+  /**
+   * @param block_idx index of a published block
+   * @return the block at the given index
+   */
+  RawBlock *At(const uint32_t block_idx) const {
+    TERRIER_ASSERT(block_idx < num_blocks_.load(), "block must be published in the directory");
+    const uint32_t chunk_idx = ChunkIndex(block_idx);
+    return chunks_[chunk_idx].load()[block_idx - ChunkStart(chunk_idx)];
+  }
+
+  /**
+   * @param block_idx index of a block
+   * @return the block at the given index, or nullptr if there is no such block (yet)
+   */
+  RawBlock *AtOrNull(const uint32_t block_idx) const {
+    return block_idx < num_blocks_.load() ? At(block_idx) : nullptr;
+  }
+
+  /**
+   * Appends a block to the directory. The block is visible to readers once every block appended before it is.
+   * @param block the block to append
+   * @return index of the block
+   */
+  uint32_t Append(RawBlock *const block) {
+    const uint32_t block_idx = num_reserved_blocks_.fetch_add(1);
+    TERRIER_ASSERT(block_idx != UINT32_MAX, "block indexes have run out");
+    const uint32_t chunk_idx = ChunkIndex(block_idx);
+    std::atomic<RawBlock **> &chunk = chunks_[chunk_idx];
+    RawBlock **chunk_blocks = chunk.load();
+    if (chunk_blocks == nullptr) {
+      // Whoever gets to install a chunk first wins, the others throw theirs away
+      auto *new_chunk = new RawBlock *[ChunkSize(chunk_idx)];
+      if (chunk.compare_exchange_strong(chunk_blocks, new_chunk))
+        chunk_blocks = new_chunk;
+      else
+        delete[] new_chunk;
+    }
+    chunk_blocks[block_idx - ChunkStart(chunk_idx)] = block;
+    // Publish blocks in order, so that every index below num_blocks_ refers to a block that has been written. Appends
+    // only happen once per filled block, so waiting on a concurrent appender with a smaller index is short and rare.
+    // We yield while waiting in case that appender has been descheduled, or else appenders that queued up behind it
+    // would each spin away a whole time slice before handing over to the next.
+    for (uint32_t expected = block_idx; !num_blocks_.compare_exchange_weak(expected, block_idx + 1);) {
+      expected = block_idx;
+      std::this_thread::yield();
+    }
+    return block_idx;
+  }
+
+ private:
+  // Chunk i holds FIRST_CHUNK_SIZE * 2^i blocks, starting at index FIRST_CHUNK_SIZE * (2^i - 1)
+  static constexpr uint32_t FIRST_CHUNK_SIZE = 1024;
+  static constexpr uint32_t NUM_CHUNKS = 23;
+
+  static constexpr uint32_t ChunkIndex(const uint32_t block_idx) {
+    return 63 - __builtin_clzll(block_idx / FIRST_CHUNK_SIZE + 1);
+  }
+  static constexpr uint64_t ChunkStart(const uint32_t chunk_idx) {
+    return FIRST_CHUNK_SIZE * ((uint64_t{1} << chunk_idx) - 1);
+  }
+  static constexpr uint64_t ChunkSize(const uint32_t chunk_idx) { return uint64_t{FIRST_CHUNK_SIZE} << chunk_idx; }
+
+  static_assert(FIRST_CHUNK_SIZE * ((uint64_t{1} << NUM_CHUNKS) - 1) > UINT32_MAX,
+                "the chunks must cover every block index");
+
+  std::atomic<RawBlock **> chunks_[NUM_CHUNKS] = {};
+  // Number of block indexes handed out to appenders
+  std::atomic<uint32_t> num_reserved_blocks_ = 0;
+  // Number of blocks that are published in the directory
+  std::atomic<uint32_t> num_blocks_ = 0;
+};
+}  // namespace terrier::storage
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "storage/data_table.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage {
+/**
+ * The block evictor moves frozen blocks that have not been read in a while out of memory and into a local block file,
+ * so that a node can hold more cold data than fits in its memory.
+ *
+ * An evicted block keeps its address, because tuple slots and indexes point into it. To evict a block, the evictor
+ * writes it out to the block's slot in the file, and maps that slot privately over the block in place of the anonymous
+ * memory it was in. From then on the pages of the block are only backed by the file, so the kernel is free to drop
+ * them, and any access (a scan, a select or an index lookup) faults them back in from the file. The first page of the
+ * block is not evicted and stays behind as a stub, because it holds the block header, which readers and writers update
+ * without latching the block. Writes to an evicted block, which can only happen after it is thawed, copy the pages they
+ * touch back to memory. Once the block is frozen again, it is written out to the same slot. Varlens that do not fit
+ * inline live outside of the block, and stay in memory.
+ *
+ * The access observer hands blocks to the evictor when it sends them to be frozen, and the evictor goes over them every
+ * time the garbage collector runs, so the evictor, like the observer, is only ever invoked from the GC thread. A block
+ * is evicted once it has been frozen and unread for the given number of GC invocations. Writing a block out takes a
+ * while, so the evictor only evicts a few blocks per GC invocation, and leaves the rest for the next ones. It does not
+ * hold its latch while writing, so that threads freeing other blocks do not wait on it.
+ *
+ * Blocks carved out of arenas backed by huge pages (see BlockAllocator) cannot be partially remapped. The evictor only
+ * finds out once it tries to map the file over such a block, after which the block stays in memory for good and its
+ * slot in the file goes to the next block. Evicted blocks keep their memory, because tuple slots point into it, so
+ * eviction only lets the kernel drop their pages. The memory goes back to the block store when the block is freed.
+ *
+ * The evictor listens for blocks being freed. It puts anonymous memory back under a freed block that was ever evicted,
+ * so that the block store never hands out memory that is still backed by the file, and hands the block's slot in the
+ * file to the next block it evicts.
+ */
+class BlockEvictor : public BlockReleaseListener {
+ public:
+  /**
+   * Instantiates a new evictor with a fresh block file at the given path. A file already at the path is overwritten.
+   * @param file_path path to the block file
+   * @param idle_threshold number of GC invocations a frozen block needs to go unread before it is evicted
+   * @param max_evictions_per_pass maximum number of blocks evicted in one GC invocation
+   * @throws runtime_error if the file cannot be created
+   */
+  BlockEvictor(std::string file_path, uint32_t idle_threshold, uint32_t max_evictions_per_pass = 4);
+
+  /**
+   * Closes and removes the block file. Blocks that are evicted stay readable, because their mappings keep the file
+   * around until the memory of the block is unmapped.
+   */
+  ~BlockEvictor() override;
+
+  DISALLOW_COPY_AND_MOVE(BlockEvictor);
+
+  /**
+   * Starts watching the given block, which is on its way to be frozen. Watching a block twice has no effect.
+   * @param block the block to watch
+   */
+  void WatchBlock(RawBlock *block);
+
+  /**
+   * Signals to the evictor that a new GC run has begun. The evictor then evicts up to the maximum number of watched
+   * blocks that have been frozen and unread for long enough.
+   */
+  void ObserveGCInvocation();
+
+  /**
+   * Evicts the given block right away, if it is frozen.
+   * @param block the block to evict
+   * @return whether the block was evicted
+   */
+  bool Evict(RawBlock *block);
+
+  /**
+   * @return number of times a block was evicted since the evictor was created
+   */
+  uint64_t NumEvictions() const { return num_evictions_; }
+
+  /**
+   * @return maximum number of blocks evicted in one GC invocation
+   */
+  uint32_t MaxEvictionsPerPass() const { return max_evictions_per_pass_; }
+
+  /**
+   * Stops watching the given block, which is about to be freed, and frees its slot in the file. Waits for the block to
+   * be written out first, if it is being evicted.
+   * @param block the block about to be freed
+   */
+  void ForgetBlock(RawBlock *block) override;
+
+ private:
+  struct BlockInfo {
+    int64_t file_offset_ = -1;  // slot of the block in the file, or -1 if the block was never written out
+    bool watched_ = false;      // whether the block is in watched_blocks_
+    bool evicted_ = false;      // whether the block was evicted and not sent to be frozen since
+    bool evictable_ = true;     // false if the memory of the block cannot be remapped
+  };
+
+  const std::string file_path_;
+  const uint32_t idle_threshold_;
+  const uint32_t max_evictions_per_pass_;
+  // Number of bytes at the start of every block that stay in memory
+  const uint64_t stub_size_;
+  int fd_;
+  // Held by the GC thread while it goes over watched blocks, but not while it writes a block out, and by threads that
+  // free blocks
+  std::mutex latch_;
+  // Block currently being written out, which must not be freed until it is done
+  RawBlock *evicting_ = nullptr;
+  std::condition_variable eviction_done_;
+  int64_t file_size_ = 0;
+  uint64_t num_evictions_ = 0;
+  // Every block that was handed to the evictor and not freed since. Blocks keep their slot in the file until they are
+  // freed, because the slot stays mapped over the parts of the block that have not been written to since it was
+  // evicted.
+  std::unordered_map<RawBlock *, BlockInfo> blocks_;
+  // Slots in the file left behind by freed blocks
+  std::vector<int64_t> free_slots_;
+  // Blocks that may need to be evicted, along with the number of GC invocations they have gone frozen and unread for
+  std::vector<std::pair<RawBlock *, uint32_t>> watched_blocks_;
+
+  // Evict, for callers that already hold latch_. The latch is let go while the block is written out, and held again on
+  // return.
+  bool EvictLocked(RawBlock *block, std::unique_lock<std::mutex> *lock);
+};
+}  // namespace terrier::storage
@@ -1,8 +1,13 @@
 #pragma once
-#include <list>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <vector>
+#include "common/container/concurrent_queue.h"
 #include "common/performance_counter.h"
+#include "common/shared_latch.h"
+#include "common/spin_latch.h"
+#include "storage/block_directory.h"
 #include "storage/projected_columns.h"
 #include "storage/storage_defs.h"
 #include "storage/tuple_access_strategy.h"
@@ -34,6 +39,22 @@ class HashIndex;
 DEFINE_PERFORMANCE_CLASS(DataTableCounter, DataTableCounterMembers)
 #undef DataTableCounterMembers
 
+/**
+ * Interface for components that hold on to blocks of tables across calls, such as the access observer and the block
+ * evictor, and so need to let go of a block before its memory is handed back to the block store.
+ */
+class BlockReleaseListener {
+ public:
+  virtual ~BlockReleaseListener() = default;
+
+  /**
+   * Called right before the given block is released to the block store, from whichever thread frees the block. The
+   * block is still intact when this is called, but must not be referenced after it returns.
+   * @param block the block about to be released
+   */
+  virtual void ForgetBlock(RawBlock *block) = 0;
+};
+
 /**
  * A DataTable is a thin layer above blocks that handles visibility, schemas, and maintenance of versions for a
  * SQL table. This class should be the main outward facing API for the storage engine. SQL level concepts such
@@ -56,6 +77,11 @@ class DataTable {
      */
     const TupleSlot *operator->() const { return &current_slot_; }
 
+    /**
+     * @return the table the iterator goes through
+     */
+    const DataTable *GetTable() const { return table_; }
+
     /**
      * pre-fix increment.
      * @return self-reference after the iterator is advanced
@@ -75,11 +101,11 @@ class DataTable {
     /**
      * Equality check.
      * @param other other iterator to compare to
-     * @return if the two iterators point to the same slot
+     * @return if the two iterators point to the same slot of the same table
      */
     bool operator==(const SlotIterator &other) const {
-      // TODO(Tianyu): I believe this is enough?
-      return current_slot_ == other.current_slot_;
+      // The end iterators of two tables whose last blocks are full both point to no block at all
+      return table_ == other.table_ && current_slot_ == other.current_slot_;
     }
 
     /**
@@ -91,18 +117,24 @@ class DataTable {
 
    private:
     friend class DataTable;
+    SlotIterator(const DataTable *table, uint32_t block_idx, uint32_t offset_in_block)
+        : table_(table), block_idx_(block_idx) {
+      current_slot_ = {table->BlockAtOrNull(block_idx), offset_in_block};
+    }
+
     /**
-     * @warning MUST BE CALLED ONLY WHEN CALLER HOLDS LOCK TO THE LIST OF RAW BLOCKS IN THE DATA TABLE
+     * Moves the iterator to the first slot of the next block in the table.
      */
-    SlotIterator(const DataTable *table, std::list<RawBlock *>::const_iterator block, uint32_t offset_in_block)
-        : table_(table), block_(block) {
-      current_slot_ = {block == table->blocks_.end() ? nullptr : *block, offset_in_block};
+    void AdvanceToNextBlock() {
+      ++block_idx_;
+      // Cannot dereference if the next block does not exist (yet), so just use nullptr to denote
+      current_slot_ = {table_->BlockAtOrNull(block_idx_), 0};
     }
 
     // TODO(Tianyu): Can potentially collapse this information into the RawBlock so we don't have to hold a pointer to
     // the table anymore. Right now we need the table to know how many slots there are in the block
     const DataTable *table_;
-    std::list<RawBlock *>::const_iterator block_;
+    uint32_t block_idx_;
     TupleSlot current_slot_;
   };
   /**
@@ -116,10 +148,23 @@ class DataTable {
   DataTable(BlockStore *store, const BlockLayout &layout, layout_version_t layout_version);
 
   /**
-   * Destructs a DataTable, frees all its blocks and any potential varlen entries.
+   * Destructs a DataTable, frees all its blocks and any potential varlen entries. Every registered block release
+   * listener is told about each block before it is freed.
    */
   ~DataTable();
 
+  /**
+   * Registers a listener to be told about every block freed from now on by any table
+   * @param listener the listener to register
+   */
+  static void AddBlockReleaseListener(BlockReleaseListener *listener);
+
+  /**
+   * Stops telling the given listener about freed blocks. Waits for any call to it that is still running.
+   * @param listener the listener to unregister
+   */
+  static void RemoveBlockReleaseListener(BlockReleaseListener *listener);
+
   /**
    * Materializes a single tuple from the given slot, as visible to the transaction given, according to the format
    * described by the given output buffer.
@@ -148,15 +193,84 @@ class DataTable {
    * @param out_buffer output buffer. The object should already contain projection list information. This buffer is
    *                   always cleared of old values.
    */
-  void Scan(transaction::TransactionContext *txn, SlotIterator *start_pos, ProjectedColumns *out_buffer) const;
+  void Scan(transaction::TransactionContext *txn, SlotIterator *start_pos, ProjectedColumns *out_buffer) const {
+    Scan(txn, start_pos, end(), out_buffer);
+  }
+
+  /**
+   * Sequentially scans the table in the range [start_pos, end_pos) and materializes as many tuples as would fit into
+   * the given buffer, as visible to the transaction given. Behaves exactly like the unbounded Scan, except that the
+   * scan stops at end_pos instead of the end of the table. This is used to partition a table for parallel scans.
+   *
+   * @param txn the calling transaction
+   * @param start_pos iterator to the starting location for the sequential scan
+   * @param end_pos iterator to one past the last slot to scan
+   * @param out_buffer output buffer. The object should already contain projection list information. This buffer is
+   *                   always cleared of old values.
+   */
+  void Scan(transaction::TransactionContext *txn, SlotIterator *start_pos, const SlotIterator &end_pos,
+            ProjectedColumns *out_buffer) const;
+
+  /**
+   * Zero-copy counterpart of Scan for frozen blocks. If start_pos points into a frozen block, takes an in-place read on
+   * that block and points out_columns and out_nulls directly at the block's storage for the given columns, covering at
+   * most max_tuples tuples from start_pos onwards. Every tuple exposed this way is visible to all transactions. The
+   * given iterator is mutated to point to one slot passed the last tuple exposed. Nothing happens if the block is not
+   * frozen, or if start_pos does not lie on a byte boundary of the block's null bitmaps.
+   *
+   * Fixed-length columns that the compactor encoded cannot be pointed at, and are decoded into the given decode buffer
+   * instead, which also caps the number of tuples exposed. If there is no decode buffer, blocks with encoded columns
+   * among the given ones are not read in place.
+   *
+   * The pointers stay valid until the caller gives up the in-place read with ReleaseInPlaceRead() on the returned
+   * block's controller. Until then, writers to the block will wait, so the caller must not modify the block itself.
+   *
+   * @param start_pos iterator to the starting location for the scan
+   * @param end_pos iterator to one past the last slot to scan
+   * @param col_ids the columns to expose. Should not reference col_id 0
+   * @param num_cols number of columns in col_ids
+   * @param max_tuples maximum number of tuples to expose
+   * @param[out] out_columns start of the values of each column, in the order of col_ids
+   * @param[out] out_nulls null bitmap of each column, in the order of col_ids. A set bit means the value is present.
+   * @param[out] num_tuples number of tuples exposed
+   * @param[out] out_codes if not null, the dictionary codes of each dictionary-compressed varlen column, in the order
+   *                       of col_ids, and nullptr for every other column. Codes of null values are garbage.
+   * @param[out] out_dictionaries if not null, the sorted dictionary of each dictionary-compressed varlen column, in the
+   *                              order of col_ids, and nullptr for every other column
+   * @param decoded if not null, buffer to decode encoded columns into, whose columns are the ones in col_ids, in the
+   *                same order. Only the values are written to it.
+   * @return the block read in place, or nullptr if the block cannot be read in place
+   */
+  RawBlock *ScanInPlace(SlotIterator *start_pos, const SlotIterator &end_pos, const col_id_t *col_ids,
+                        uint16_t num_cols, uint32_t max_tuples, byte **out_columns,
+                        const common::RawBitmap **out_nulls, uint32_t *num_tuples,
+                        const uint32_t **out_codes = nullptr, const ArrowVarlenColumn **out_dictionaries = nullptr,
+                        ProjectedColumns *decoded = nullptr) const;
+
+  /**
+   * Reads the zone map of a column in the block the given iterator points into. Zone maps are only maintained for
+   * fixed-length columns of frozen blocks, and the range they give covers every tuple in the block that is visible to
+   * any transaction that is reading it.
+   *
+   * @param pos iterator into the block of interest
+   * @param col_id the column of interest. Should be a fixed-length column and not reference col_id 0
+   * @param[out] zone_map the range of non-null values of the column in the block
+   * @param[out] num_values number of non-null values of the column in the block
+   * @return true if the block is frozen and the zone map was read, false otherwise
+   */
+  bool ReadZoneMap(const SlotIterator &pos, col_id_t col_id, ColumnZoneMap *zone_map, uint32_t *num_values) const;
+
+  /**
+   * Moves the given iterator to the first slot of the next block, or to end_pos if that comes first.
+   * @param pos the iterator to move
+   * @param end_pos iterator to one past the last slot to scan
+   */
+  void SkipBlock(SlotIterator *pos, const SlotIterator &end_pos) const;
 
   /**
    * @return the first tuple slot contained in the data table
    */
-  SlotIterator begin() const {  // NOLINT for STL name compability
-    common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-    return {this, blocks_.begin(), 0};
-  }
+  SlotIterator begin() const { return {this, 0, 0}; }  // NOLINT for STL name compability
 
   /**
    * Returns one past the last tuple slot contained in the data table. Note that this is not an accurate number when
@@ -167,6 +281,28 @@ class DataTable {
    */
   SlotIterator end() const;  // NOLINT for STL name compability
 
+  /**
+   * @param block_idx index of a block in the data table
+   * @return iterator to the first tuple slot of the given block, or end() if the table has no such block
+   */
+  SlotIterator beginAt(uint32_t block_idx) const;  // NOLINT for STL name compability
+
+  /**
+   * @param block_idx index of a block in the data table
+   * @return iterator to one past the last tuple slot before the given block, or end() if the table has no such block
+   */
+  SlotIterator endAt(uint32_t block_idx) const { return beginAt(block_idx); }  // NOLINT for STL name compability
+
+  /**
+   * @return the number of blocks currently in the data table. Note that this can grow concurrently as inserts happen.
+   */
+  uint32_t GetNumBlocks() const { return blocks_.Size(); }
+
+  /**
+   * @return the layout version of this DataTable
+   */
+  layout_version_t GetLayoutVersion() const { return layout_version_; }
+
   /**
    * Update the tuple according to the redo buffer given, and update the version chain to link to an
    * undo record that is allocated in the txn. The undo record is populated with a before-image of the tuple in the
@@ -193,6 +329,36 @@ class DataTable {
    */
   TupleSlot Insert(transaction::TransactionContext *txn, const ProjectedRow &redo);
 
+  /**
+   * Inserts all tuples in the given ProjectedColumns. Slots are reserved in runs of consecutive slots of a block, the
+   * values of each run are copied in column by column, and the undo records of a run are laid out contiguously. The
+   * effect is otherwise the same as calling Insert on every tuple in order.
+   *
+   * @param txn the calling transaction
+   * @param redo after-images of the inserted tuples, in rows 0 to NumTuples() - 1. Should not reference col_id 0
+   * @param[out] slots array of at least redo.NumTuples() elements, filled with the TupleSlot allocated for each tuple
+   */
+  void InsertBatch(transaction::TransactionContext *txn, const ProjectedColumns &redo, TupleSlot *slots);
+
+  /**
+   * Turns thread-local insertion blocks on or off for this table. When on, an inserting thread claims a block for
+   * itself, and keeps inserting into that block until it is full without touching the block's busy bit for every
+   * tuple. Full blocks are handed back to the table, and a new one is claimed. This is meant for bulk loads, where
+   * many threads insert into the same table and would otherwise fight over the busy bits of the same few blocks.
+   *
+   * A thread that inserted with this turned on should call ReleaseThreadLocalBlock() once it is done inserting, so
+   * that others can use the rest of its claimed block. Turning this off hands back the blocks still claimed by any
+   * thread, including threads that have since exited.
+   * @param enabled whether inserting threads should claim their own block
+   */
+  void SetThreadLocalInsertion(bool enabled);
+
+  /**
+   * Hands the block claimed by the calling thread for thread-local insertion, if any, back to the table so that other
+   * threads can insert into its remaining slots.
+   */
+  void ReleaseThreadLocalBlock();
+
   /**
    * Deletes the given TupleSlot, this will call StageDelete on the provided txn to generate the RedoRecord for delete.
    * The rest of the behavior follows Update's behavior.
@@ -227,28 +393,84 @@ class DataTable {
   // The block compactor elides transactional protection in the gather/compression phase and
   // needs raw access to the underlying table.
   friend class BlockCompactor;
+  // The Arrow exporter reads frozen blocks in place and needs raw access to the underlying table.
+  friend class ArrowIpcWriter;
 
   BlockStore *const block_store_;
   const layout_version_t layout_version_;
   const TupleAccessStrategy accessor_;
 
   // TODO(Tianyu): For now, on insertion, we simply sequentially go through a block and allocate a
-  // new one when the current one is full. Needless to say, we will need to revisit this when extending GC to handle
-  // deleted tuples and recycle slots
-  // TODO(Tianyu): Now that we are switching to a linked list, there probably isn't a reason for it
-  // to be latched. Could just easily write a lock-free one if there's performance gain(probably not). vector->list has
-  // negligible difference in insert performance (within margin of error) when benchmarked.
-  // We also might need our own implementation because we need to handle GC of an unlinked block, as a sequential scan
-  // might be on it
-  std::list<RawBlock *> blocks_;
-  // latch used to protect block list
-  mutable common::SpinLatch blocks_latch_;
-  // latch used to protect insertion_head_
-  mutable common::SpinLatch header_latch_;
-  std::list<RawBlock *>::iterator insertion_head_;
-  // Check if we need to advance the insertion_head_
-  // This function uses header_latch_ to ensure correctness
-  void CheckMoveHead(std::list<RawBlock *>::iterator block);
+  // new one when the current one is full, unless the GC has handed back a deleted slot to reuse.
+  // TODO(Tianyu): We might need to handle GC of an unlinked block, as a sequential scan might be on it
+
+  // The blocks of the table, which can be looked up without latching
+  BlockDirectory blocks_;
+  // Index of the first block that may have free tuple slots
+  std::atomic<uint32_t> insertion_head_ = 0;
+
+  // Returns the block at the given index, which must be published
+  RawBlock *BlockAt(const uint32_t block_idx) const { return blocks_.At(block_idx); }
+
+  // Returns the block at the given index, or nullptr if there is no such block (yet)
+  RawBlock *BlockAtOrNull(const uint32_t block_idx) const { return blocks_.AtOrNull(block_idx); }
+
+  // Appends a block to the directory and returns its index
+  uint32_t AppendBlock(RawBlock *block) { return blocks_.Append(block); }
+
+  // Check if we need to advance the insertion_head_ past the given full block
+  void CheckMoveHead(uint32_t block_idx);
+
+  // A block claimed by a thread for thread-local insertion, whose busy bit is held by the claim. The owning thread
+  // marks the claim as in use while it allocates from the block, so that another thread can revoke the claim without
+  // racing with it. A revoked claim no longer holds the busy bit, and the owner drops it the next time it looks.
+  struct InsertionClaim {
+    enum : uint8_t { IDLE, IN_USE, REVOKED };
+    InsertionClaim(RawBlock *const block, const uint32_t block_idx) : block_(block), block_idx_(block_idx) {}
+    RawBlock *const block_;
+    const uint32_t block_idx_;
+    std::atomic<uint8_t> state_ = IDLE;
+  };
+
+  // Unique among all DataTables ever created, used to key the per-thread claimed insertion blocks, so a stale entry
+  // left by a destroyed table can never be mistaken for one of this table's
+  const uint64_t table_id_;
+  // Whether inserting threads claim a block to themselves instead of taking the busy bit of a block per insert
+  std::atomic<bool> thread_local_insertion_ = false;
+  // Every claim made on this table that has not been revoked yet, so that they can be revoked when thread-local
+  // insertion is turned off. Claims that their owner handed back are only pruned when the next one is added.
+  common::SpinLatch claims_latch_;
+  std::vector<std::shared_ptr<InsertionClaim>> claims_;
+  // Blocks claimed by the current thread for thread-local insertion, keyed by the id of the table they belong to
+  static thread_local std::unordered_map<uint64_t, std::shared_ptr<InsertionClaim>> claimed_insertion_blocks_;
+  // Components to tell about blocks before they are freed, shared by every table
+  static common::SharedLatch release_listeners_latch_;
+  static std::vector<BlockReleaseListener *> release_listeners_;
+
+  // Takes the claim away from its owner and hands its block back to the table, unless the claim was already revoked.
+  // Waits for the owner to finish allocating from the block if it is doing so.
+  void RevokeClaim(InsertionClaim *claim);
+
+  // Slots of deleted tuples in hot blocks that the GC has handed back for reuse. Entries can go stale if the compactor
+  // fills the slot first, so a slot must still be claimed through its allocation bit when taken off the list.
+  common::ConcurrentQueue<TupleSlot> free_slots_;
+
+  // Called by the GC once a deleted tuple can no longer be seen by anyone and its index entries are gone. Deallocates
+  // the slot and, if its block is still hot, puts it on the free list for the next insert.
+  void RecycleSlot(TupleSlot slot);
+
+  // Takes a slot off the free list and claims it for a new tuple. Returns false if there is no slot to reuse.
+  bool AllocateRecycledSlot(TupleSlot *slot);
+
+  // Allocates up to max_slots consecutive slots for new tuples in a single block, first pointing to the first of them.
+  // Takes care of the busy bit and of thread-local insertion blocks. Returns the number of slots allocated, at least 1.
+  uint32_t AllocateSlots(uint32_t max_slots, TupleSlot *first);
+
+  // Finds a block with free slots starting from the insertion head, or creates one, and allocates up to max_slots
+  // consecutive slots in it. Returns the index of the block, which is left with its busy bit set so the caller is the
+  // only one that can insert into it.
+  uint32_t ClaimInsertionBlock(uint32_t max_slots, TupleSlot *first, uint32_t *num_slots);
+
   mutable DataTableCounter data_table_counter_;
 
   // A templatized version for select, so that we can use the same code for both row and column access.
@@ -256,7 +478,35 @@ class DataTable {
   template <class RowType>
   bool SelectIntoBuffer(transaction::TransactionContext *txn, TupleSlot slot, RowType *out_buffer) const;
 
+  // Copies the tuples of a frozen block, starting at start_pos, into out_buffer beginning at index filled. A frozen
+  // block has no versions and no gaps, so whole column runs are copied without per-tuple visibility checks. Caller
+  // must hold an in-place read on the block. start_pos is advanced past the copied tuples, and the number of tuples
+  // copied is returned.
+  uint32_t ScanFrozenBlock(SlotIterator *start_pos, const SlotIterator &end_pos, ProjectedColumns *out_buffer,
+                           uint32_t filled) const;
+
+  // Materializes the visible tuples of the hot block start_pos points into, starting at start_pos, into out_buffer
+  // beginning at index filled, without looking at version chains. This is only safe if the block's version synopsis
+  // shows no versions before and after the copy. If it does not, start_pos and filled are left untouched and false is
+  // returned. Otherwise, both are advanced past the tuples read and true is returned.
+  bool ScanVersionFreeBlock(SlotIterator *start_pos, const SlotIterator &end_pos, ProjectedColumns *out_buffer,
+                            uint32_t *filled) const;
+
+  // Number of tuples, at most max_tuples, left in the frozen block start_pos points into before reaching either the
+  // end of the block's records or end_pos. Caller must hold an in-place read on the block.
+  uint32_t NumFrozenTuples(const SlotIterator &start_pos, const SlotIterator &end_pos, uint32_t max_tuples) const;
+
+  // Moves start_pos past num_tuples tuples of the frozen block it points into, jumping to the next block (or end_pos)
+  // once the block's records are exhausted. Caller must hold an in-place read on the block.
+  void AdvanceInFrozenBlock(SlotIterator *start_pos, const SlotIterator &end_pos, uint32_t num_tuples) const;
+
   void InsertInto(transaction::TransactionContext *txn, const ProjectedRow &redo, TupleSlot dest);
+
+  // Takes away the encoded copies of the given columns of a block the caller is about to write to, and frees them once
+  // the transaction is done and no reader that found them can still be decoding. The block must already be hot.
+  void ThawColumns(transaction::TransactionContext *txn, RawBlock *block, const col_id_t *col_ids,
+                   uint16_t num_cols) const;
+
   // Atomically read out the version pointer value.
   UndoRecord *AtomicallyReadVersionPtr(TupleSlot slot, const TupleAccessStrategy &accessor) const;
 
@@ -281,6 +531,11 @@ class DataTable {
   bool CompareAndSwapVersionPtr(TupleSlot slot, const TupleAccessStrategy &accessor, UndoRecord *expected,
                                 UndoRecord *desired);
 
+  // Unlinks the records behind the head of a version chain that are older than the oldest running transaction. The
+  // caller must own the version chain by having installed the head. The records stay with their transactions, so they
+  // are freed when the GC deallocates those.
+  void TruncateVersionChainTail(UndoRecord *head, transaction::timestamp_t oldest) const;
+
   // Allocates a new block to be used as insertion head.
   RawBlock *NewBlock();
 
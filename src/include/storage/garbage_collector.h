@@ -1,9 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <queue>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 #include "common/shared_latch.h"
+#include "common/worker_pool.h"
 #include "storage/access_observer.h"
 #include "storage/index/index.h"
 #include "transaction/transaction_context.h"
@@ -17,6 +22,11 @@ namespace terrier::storage {
  * Based on the contents of this queue, it unlinks the UndoRecords from their version chains when no running
  * transactions can view those versions anymore. It then stores those transactions to attempt to deallocate on the next
  * iteration if no running transactions can still hold references to them.
+ *
+ * Each pass can be spread across a pool of workers. Unlinking is partitioned by table, so that every version chain is
+ * still truncated by exactly one worker, while deallocation is split into batches of transactions. The bookkeeping
+ * around them (deciding which transactions are safe to collect, and handing varlens and accesses back to their
+ * owners) stays on the thread that invokes the GC.
  */
 class GarbageCollector {
  public:
@@ -40,7 +50,8 @@ class GarbageCollector {
         deferred_action_manager_(deferred_action_manager),
         txn_manager_(txn_manager),
         observer_(observer),
-        last_unlinked_{0} {
+        last_unlinked_{0},
+        workers_(0, {}) {
     TERRIER_ASSERT(txn_manager_->GCEnabled(),
                    "The TransactionManager needs to be instantiated with gc_enabled true for GC to work!");
   }
@@ -73,7 +84,30 @@ class GarbageCollector {
    */
   void UnregisterIndexForGC(common::ManagedPointer<index::Index> index);
 
+  /**
+   * Sets the number of workers to spread garbage collection across. A single worker means that the GC runs entirely
+   * on the thread that invokes it, which is the default. The change takes effect at the start of the next pass, so
+   * this is safe to call while the GC is running.
+   * @param num_workers number of workers, at least 1
+   */
+  void SetNumWorkers(const uint32_t num_workers) {
+    TERRIER_ASSERT(num_workers > 0, "The GC needs at least one worker.");
+    num_workers_.store(num_workers);
+  }
+
+  /**
+   * @return number of workers garbage collection is spread across
+   */
+  uint32_t NumWorkers() const { return num_workers_.load(); }
+
  private:
+  // Undo records of one table that are safe to unlink, and what unlinking them leaves for the invoking thread to do
+  struct UnlinkPartition {
+    std::vector<std::pair<transaction::TransactionContext *, UndoRecord *>> records_;
+    std::vector<std::pair<transaction::TransactionContext *, VarlenEntry>> loose_ptrs_;
+    std::vector<RawBlock *> accessed_blocks_;
+  };
+
   /**
    * Process the deallocate queue
    * @return number of txns (not UndoRecords) processed for debugging/testing
@@ -86,19 +120,32 @@ class GarbageCollector {
    */
   uint32_t ProcessUnlinkQueue(transaction::timestamp_t oldest_txn);
 
+  // Unlinks the records of one table
+  void UnlinkTable(UnlinkPartition *partition, transaction::timestamp_t oldest_txn) const;
+
   /**
    * Process deferred actions
    */
   void ProcessDeferredActions(transaction::timestamp_t oldest_txn);
 
+  // Frees the slot of a deleted tuple. If there is a deferred action manager, the slot is also handed back to its
+  // table for reuse, once that is safe.
   void ReclaimSlotIfDeleted(UndoRecord *undo_record) const;
 
-  void ReclaimBufferIfVarlen(transaction::TransactionContext *txn, UndoRecord *undo_record) const;
+  // Collects the varlen buffers the record's version held that the storage engine now needs to free
+  void ReclaimBufferIfVarlen(transaction::TransactionContext *txn, UndoRecord *undo_record,
+                             std::vector<std::pair<transaction::TransactionContext *, VarlenEntry>> *loose_ptrs) const;
 
   void TruncateVersionChain(DataTable *table, TupleSlot slot, transaction::timestamp_t oldest) const;
 
   void ProcessIndexes();
 
+  // Runs the tasks on the workers, or on the invoking thread if the GC only has the one, and waits for all of them
+  void RunOnWorkers(const std::vector<std::function<void()>> &tasks);
+
+  // Grows or shrinks the pool of workers if the number of workers was changed since the last pass
+  void ResizeWorkers();
+
   transaction::TimestampManager *timestamp_manager_;
   transaction::DeferredActionManager *deferred_action_manager_;
   transaction::TransactionManager *const txn_manager_;
@@ -109,6 +156,9 @@ class GarbageCollector {
   transaction::TransactionQueue txns_to_deallocate_;
   // queue of txns that need to be unlinked
   transaction::TransactionQueue txns_to_unlink_;
+  // number of workers asked for, and the threads that make them up once there is more than one
+  std::atomic<uint32_t> num_workers_{1};
+  common::WorkerPool workers_;
 
   std::unordered_set<common::ManagedPointer<index::Index>> indexes_;
   common::SharedLatch indexes_latch_;
@@ -2,7 +2,9 @@
 
 #include <chrono>  //NOLINT
 #include <thread>  //NOLINT
+#include "common/managed_pointer.h"
 #include "di/di_help.h"
+#include "metrics/metrics_manager.h"
 #include "storage/garbage_collector.h"
 
 namespace terrier::storage {
@@ -21,6 +23,14 @@ class GarbageCollectorThread {
   BOOST_DI_INJECT(GarbageCollectorThread, GarbageCollector *gc,
                   (named = GC_PERIOD) std::chrono::milliseconds gc_period);
 
+  /**
+   * @param gc pointer to the garbage collector object to be run on this thread
+   * @param gc_period sleep time between GC invocations
+   * @param metrics_manager metrics manager the thread registers with to report GC metrics, or DISABLED
+   */
+  GarbageCollectorThread(GarbageCollector *gc, std::chrono::milliseconds gc_period,
+                         common::ManagedPointer<metrics::MetricsManager> metrics_manager);
+
   ~GarbageCollectorThread() {
     run_gc_ = false;
     gc_thread_.join();
@@ -54,12 +64,14 @@ class GarbageCollectorThread {
 
  private:
   storage::GarbageCollector *gc_;
+  common::ManagedPointer<metrics::MetricsManager> metrics_manager_;
   volatile bool run_gc_;
   volatile bool gc_paused_;
   std::chrono::milliseconds gc_period_;
   std::thread gc_thread_;
 
   void GCThreadLoop() {
+    if (metrics_manager_ != DISABLED) metrics_manager_->RegisterThread();
     while (run_gc_) {
       std::this_thread::sleep_for(gc_period_);
       if (!gc_paused_) gc_->PerformGarbageCollection();
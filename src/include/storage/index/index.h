@@ -163,6 +163,11 @@ class Index {
    */
   const ProjectedRowInitializer &GetProjectedRowInitializer() const { return metadata_.GetProjectedRowInitializer(); }
 
+  /**
+   * @return schema of the keys of this index
+   */
+  const catalog::IndexSchema &GetKeySchema() const { return metadata_.GetSchema(); }
+
   /**
    * @return IndexKeyKind selected by the IndexBuilder at index construction
    */
@@ -140,7 +140,7 @@ class PACKED ProjectedColumns {
    * @return the actual number of tuples this ProjectedColumns holds. These tuples are guaranteed to be laid out in
    * offsets 0 to NumTuples() - 1
    */
-  uint32_t NumTuples() { return num_tuples_; }
+  uint32_t NumTuples() const { return num_tuples_; }
 
   /**
    * Set the number of tuples in the ProjectedColumns to be the given value
@@ -172,6 +172,13 @@ class PACKED ProjectedColumns {
     return StorageUtil::AlignedPtr<storage::TupleSlot>(AttrValueOffsets() + num_cols_);
   }
 
+  /**
+   * @return Head of the array that holds the tuple slots of the tuples currently materialized in the ProjectedColumns
+   */
+  const storage::TupleSlot *TupleSlots() const {
+    return StorageUtil::AlignedPtr<const storage::TupleSlot>(AttrValueOffsets() + num_cols_);
+  }
+
   /**
    * @param projection_list_index index of the desired column in the projection list
    * @return pointer to the column presence bitmap for the given projection list column
@@ -181,6 +188,15 @@ class PACKED ProjectedColumns {
     return reinterpret_cast<common::RawBitmap *>(column_start);
   }
 
+  /**
+   * @param projection_list_index index of the desired column in the projection list
+   * @return const pointer to the column presence bitmap for the given projection list column
+   */
+  const common::RawBitmap *ColumnNullBitmap(uint16_t projection_list_index) const {
+    const byte *column_start = reinterpret_cast<const byte *>(this) + AttrValueOffsets()[projection_list_index];
+    return reinterpret_cast<const common::RawBitmap *>(column_start);
+  }
+
   // TODO(Tianyu): If we make RowView mutable, then remove this function and make the constructor of RowView public.
   /**
    *
@@ -201,12 +217,22 @@ class PACKED ProjectedColumns {
                                                          common::RawBitmap::SizeInBytes(max_tuples_));
   }
 
+  /**
+   * @param projection_list_index index of the desired column in the projection list
+   * @return const pointer to the column value array for the given projection list column
+   */
+  const byte *ColumnStart(uint16_t projection_list_index) const {
+    return StorageUtil::AlignedPtr(sizeof(uint64_t),
+                                   reinterpret_cast<const byte *>(ColumnNullBitmap(projection_list_index)) +
+                                       common::RawBitmap::SizeInBytes(max_tuples_));
+  }
+
   /**
    * Returns the attribute size for the corresponding column
    * @param projection_col_index the column ID within the projection we want the size for
    * @return the size (in bytes) of the attributes in this column
    */
-  uint32_t AttrSizeForColumn(uint16_t projection_col_index);
+  uint32_t AttrSizeForColumn(uint16_t projection_col_index) const;
 
  private:
   friend class ProjectedColumnsInitializer;
@@ -5,6 +5,7 @@
 #include <vector>
 #include "catalog/catalog_defs.h"
 #include "storage/sql_table.h"
+#include "storage/varlen_arena.h"
 #include "storage/write_ahead_log/log_record.h"
 
 namespace terrier::storage {
@@ -66,5 +67,8 @@ class AbstractLogProvider {
    * @return next log record, along with vector of varlen entry pointers
    */
   std::pair<LogRecord *, std::vector<byte *>> ReadNextRecord();
+
+  // Varlens read from the log are allocated from here, the same way a transaction writing them would have
+  VarlenArena varlen_arena_;
 };
 }  // namespace terrier::storage
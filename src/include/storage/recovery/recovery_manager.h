@@ -321,6 +321,18 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    */
   void ReplayRedoRecord(transaction::TransactionContext *txn, LogRecord *record);
 
+  /**
+   * Tells whether a delete from pg_attribute is part of dropping the table or index the column belongs to, rather than
+   * of dropping the column alone
+   * @param txn transaction to use to look up the catalog
+   * @param buffered_changes list of buffered log records of the transaction
+   * @param start_idx index of the delete record in the list
+   * @return true if the class of the column is deleted from pg_class later on in the transaction
+   */
+  bool IsCascadingColumnDelete(transaction::TransactionContext *txn,
+                               const std::vector<std::pair<LogRecord *, std::vector<byte *>>> &buffered_changes,
+                               uint32_t start_idx);
+
   /**
    * Replays a delete record. Updates necessary metadata
    * @param txn txn to use for delete
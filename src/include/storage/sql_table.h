@@ -1,9 +1,18 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <list>
+#include <map>
+#include <memory>
 #include <set>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 #include "catalog/schema.h"
+#include "common/managed_pointer.h"
+#include "common/shared_latch.h"
+#include "common/spin_latch.h"
 #include "storage/data_table.h"
 #include "storage/projected_columns.h"
 #include "storage/projected_row.h"
@@ -19,11 +28,22 @@ class RandomSqlTableTransaction;
 
 namespace terrier::storage {
 
+namespace index {
+class Index;
+}  // namespace index
+
 /**
  * A SqlTable is a thin layer above DataTable that replaces storage layer concepts like BlockLayout with SQL layer
  * concepts like Schema. The goal is to hide concepts like col_id_t and BlockLayout above the SqlTable level.
  * The SqlTable API should only refer to storage concepts via things like Schema and col_oid_t, and then perform the
  * translation to BlockLayout and col_id_t to talk to the DataTable and other areas of the storage layer.
+ *
+ * Every schema change gives the SqlTable a new layout version, with a DataTable of its own, so that ALTER TABLE never
+ * has to rewrite the tuples already in the table. Callers say which version they expect their projections to be laid
+ * out for, and tuples stored under a different version are translated on the fly: columns that do not exist in the
+ * version a tuple was written in read as NULL. Updates are applied to a tuple where it is, and a tuple only moves to a
+ * newer version when a column it does not have is to be written, which the Update that takes the unstaged delta does
+ * through Migrate.
  */
 class SqlTable {
   /**
@@ -35,6 +55,8 @@ class SqlTable {
     DataTable *data_table_;
     BlockLayout layout_;
     ColumnMap column_map_;
+    // oid of each column, indexed by col_id
+    std::vector<catalog::col_oid_t> col_oids_;
   };
 
  public:
@@ -50,7 +72,39 @@ class SqlTable {
   /**
    * Destructs a SqlTable, frees all its members.
    */
-  ~SqlTable() { delete table_.data_table_; }
+  ~SqlTable();
+
+  /**
+   * Maximum number of layout versions a SqlTable can have, counting the one it was created with
+   */
+  static constexpr uint16_t MAX_NUM_VERSIONS = 256;
+
+  /**
+   * Adds a layout version for the given Schema. Tuples already in the table stay where they are, and are translated
+   * when read under the new version. Columns keep their oid across versions, and cannot change their size.
+   * @param schema the new Schema of this SqlTable
+   * @return the new layout version
+   * @throws runtime_error if the table has run out of layout versions, or a column changed its size
+   * @warning the Schema must not be changed concurrently from more than one thread
+   */
+  layout_version_t UpdateSchema(const catalog::Schema &schema);
+
+  /**
+   * Adds layout versions for the given Schema until the table has the given one, which recovery uses to rebuild the
+   * version a schema change was given. The versions taken by schema changes that were rolled back in between get the
+   * same layout, as no tuple was ever committed under them.
+   * @param schema the new Schema of this SqlTable
+   * @param version the layout version the Schema was given, which must be newer than every version of the table
+   * @throws runtime_error if the table has run out of layout versions, or a column changed its size
+   */
+  void UpdateSchema(const catalog::Schema &schema, layout_version_t version);
+
+  /**
+   * @return the most recent layout version of this SqlTable
+   */
+  layout_version_t GetLatestVersion() const {
+    return layout_version_t(static_cast<uint16_t>(num_versions_.load() - 1));
+  }
 
   /**
    * Materializes a single tuple from the given slot, as visible at the timestamp of the calling txn.
@@ -58,28 +112,45 @@ class SqlTable {
    * @param txn the calling transaction
    * @param slot the tuple slot to read
    * @param out_buffer output buffer. The object should already contain projection list information. @see ProjectedRow.
+   * @param version the layout version out_buffer is laid out for
    * @return true if tuple is visible to this txn and ProjectedRow has been populated, false otherwise
    */
-  bool Select(transaction::TransactionContext *const txn, const TupleSlot slot, ProjectedRow *const out_buffer) const {
-    return table_.data_table_->Select(txn, slot, out_buffer);
+  bool Select(transaction::TransactionContext *const txn, const TupleSlot slot, ProjectedRow *const out_buffer,
+              const layout_version_t version = layout_version_t(0)) const {
+    const layout_version_t tuple_version = slot.GetBlock()->layout_version_;
+    if (tuple_version != version) return SelectTranslated(txn, slot, tuple_version, out_buffer, version);
+    return Version(version).data_table_->Select(txn, slot, out_buffer);
   }
 
   /**
    * Update the tuple according to the redo buffer given. StageWrite must have been called as well in order for the
    * operation to be logged.
    *
+   * The tuple is updated where it is, even if it is stored under a different layout version. The delta is then
+   * translated in place to the version of the tuple, which is the version it is logged under, so it cannot be read
+   * with a projection map of the given version afterwards. The update fails if the version of the tuple lacks some of
+   * the columns in the delta, which NeedsMigration tells. Such tuples have to be moved with Migrate first, which the
+   * other Update does by itself.
+   *
    * @param txn the calling transaction
    * @param redo the desired change to be applied. This should be the after-image of the attributes of interest. The
    * TupleSlot in this RedoRecord must be set to the intended tuple.
+   * @param version the layout version the redo is laid out for
    * @return true if successful, false otherwise
    */
-  bool Update(transaction::TransactionContext *const txn, RedoRecord *const redo) const {
+  bool Update(transaction::TransactionContext *const txn, RedoRecord *const redo,
+              const layout_version_t version = layout_version_t(0)) const {
     TERRIER_ASSERT(redo->GetTupleSlot() != TupleSlot(nullptr, 0), "TupleSlot was never set in this RedoRecord.");
     TERRIER_ASSERT(redo == reinterpret_cast<LogRecord *>(txn->redo_buffer_.LastRecord())
                                ->LogRecord::GetUnderlyingRecordBodyAs<RedoRecord>(),
                    "This RedoRecord is not the most recent entry in the txn's RedoBuffer. Was StageWrite called "
                    "immediately before?");
-    const auto result = table_.data_table_->Update(txn, redo->GetTupleSlot(), *(redo->Delta()));
+    const TupleSlot slot = redo->GetTupleSlot();
+    const layout_version_t tuple_version = slot.GetBlock()->layout_version_;
+    redo->SetLayoutVersion(tuple_version);
+    // The staged redo can never be applied if the tuple lacks some of its columns, so the txn cannot commit either
+    const auto result = (tuple_version == version || TranslateDelta(redo->Delta(), version, tuple_version)) &&
+                        Version(tuple_version).data_table_->Update(txn, slot, *(redo->Delta()));
     if (!result) {
       // For MVCC correctness, this txn must now abort for the GC to clean up the version chain in the DataTable
       // correctly.
@@ -88,25 +159,111 @@ class SqlTable {
     return result;
   }
 
+  /**
+   * Stages and applies an update of a tuple stored under any layout version. A tuple stored under a version that lacks
+   * some of the updated columns is moved to the given version with Migrate first, which also moves the entries of the
+   * given indexes. Index entries for changes to key columns made by the delta itself are still up to the caller.
+   *
+   * @param txn the calling transaction
+   * @param db_oid oid of the database the table is in, for the log records
+   * @param table_oid oid of the table, for the log records
+   * @param slot the tuple to update
+   * @param delta the after-image of the attributes of interest
+   * @param indexes the indexes on the table
+   * @param version the layout version the delta is laid out for
+   * @return slot of the updated tuple, which differs from the given one if the tuple was moved, or
+   * TupleSlot(nullptr, 0) if the update failed, in which case the txn must abort
+   * @throws runtime_error if the tuple needs to be moved and one of the indexes is keyed on an expression
+   */
+  TupleSlot Update(transaction::TransactionContext *txn, catalog::db_oid_t db_oid, catalog::table_oid_t table_oid,
+                   TupleSlot slot, const ProjectedRow &delta,
+                   const std::vector<common::ManagedPointer<index::Index>> &indexes,
+                   layout_version_t version = layout_version_t(0));
+
   /**
    * Inserts a tuple, as given in the redo, and return the slot allocated for the tuple. StageWrite must have been
    * called as well in order for the operation to be logged.
    *
    * @param txn the calling transaction
    * @param redo after-image of the inserted tuple.
+   * @param version the layout version the redo is laid out for, which the tuple is stored under
    * @return TupleSlot for the inserted tuple
    */
-  TupleSlot Insert(transaction::TransactionContext *const txn, RedoRecord *const redo) const {
+  TupleSlot Insert(transaction::TransactionContext *const txn, RedoRecord *const redo,
+                   const layout_version_t version = layout_version_t(0)) const {
     TERRIER_ASSERT(redo->GetTupleSlot() == TupleSlot(nullptr, 0), "TupleSlot was set in this RedoRecord.");
     TERRIER_ASSERT(redo == reinterpret_cast<LogRecord *>(txn->redo_buffer_.LastRecord())
                                ->LogRecord::GetUnderlyingRecordBodyAs<RedoRecord>(),
                    "This RedoRecord is not the most recent entry in the txn's RedoBuffer. Was StageWrite called "
                    "immediately before?");
-    const auto slot = table_.data_table_->Insert(txn, *(redo->Delta()));
+    const auto slot = Version(version).data_table_->Insert(txn, *(redo->Delta()));
     redo->SetTupleSlot(slot);
+    redo->SetLayoutVersion(version);
     return slot;
   }
 
+  /**
+   * @param slot a tuple in the table
+   * @param col_oids the columns to be written
+   * @return true if some of the columns do not exist in the layout version the tuple is stored under, in which case the
+   * tuple has to be moved with Migrate before it can be updated
+   */
+  bool NeedsMigration(const TupleSlot slot, const std::vector<catalog::col_oid_t> &col_oids) const {
+    const ColumnMap &column_map = Version(slot.GetBlock()->layout_version_).column_map_;
+    return std::any_of(col_oids.cbegin(), col_oids.cend(),
+                       [&](const catalog::col_oid_t col_oid) { return column_map.count(col_oid) == 0; });
+  }
+
+  /**
+   * Moves a tuple to the given layout version, so that the columns added since it was written can be updated. The
+   * tuple is deleted, and its image is inserted again under the given version. Both are staged and logged like any
+   * other delete and insert, so the caller must not have staged anything for it. The entries of the given indexes are
+   * moved to the returned slot.
+   *
+   * @param txn the calling transaction
+   * @param db_oid oid of the database the table is in, for the log records
+   * @param table_oid oid of the table, for the log records
+   * @param slot the tuple to move
+   * @param version the layout version to move the tuple to
+   * @param indexes the indexes on the table, which must only be keyed on plain columns
+   * @return slot of the moved tuple, or TupleSlot(nullptr, 0) if the delete failed, in which case the txn must abort
+   * @throws runtime_error if one of the indexes is keyed on an expression
+   */
+  TupleSlot Migrate(transaction::TransactionContext *txn, catalog::db_oid_t db_oid, catalog::table_oid_t table_oid,
+                    TupleSlot slot, layout_version_t version,
+                    const std::vector<common::ManagedPointer<index::Index>> &indexes = {});
+
+  /**
+   * Inserts all tuples in the batch, as given in the redo, and writes the slot allocated for each tuple into the redo.
+   * StageBatchWrite must have been called as well in order for the operation to be logged.
+   *
+   * @param txn the calling transaction
+   * @param redo after-images of the inserted tuples. The tuple slots of its columns are filled in by this call.
+   * @param version the layout version the redo is laid out for, which the tuples are stored under
+   */
+  void InsertBatch(transaction::TransactionContext *const txn, BatchRedoRecord *const redo,
+                   const layout_version_t version = layout_version_t(0)) const {
+    TERRIER_ASSERT(redo == reinterpret_cast<LogRecord *>(txn->redo_buffer_.LastRecord())
+                               ->LogRecord::GetUnderlyingRecordBodyAs<BatchRedoRecord>(),
+                   "This BatchRedoRecord is not the most recent entry in the txn's RedoBuffer. Was StageBatchWrite "
+                   "called immediately before?");
+    Version(version).data_table_->InsertBatch(txn, *(redo->Columns()), redo->Columns()->TupleSlots());
+  }
+
+  /**
+   * Turns thread-local insertion blocks on or off for the DataTable of every layout version.
+   * @param enabled whether inserting threads should claim their own block
+   * @see DataTable::SetThreadLocalInsertion
+   */
+  void SetThreadLocalInsertion(bool enabled);
+
+  /**
+   * Hands the blocks claimed by the calling thread for thread-local insertion, if any, back to their DataTables.
+   */
+  void ReleaseThreadLocalBlock() const {
+    for (uint16_t i = 0; i < num_versions_.load(); i++) tables_[i]->data_table_->ReleaseThreadLocalBlock();
+  }
+
   /**
    * Deletes the given TupleSlot. StageDelete must have been called as well in order for the operation to be logged.
    * @param txn the calling transaction
@@ -122,7 +279,7 @@ class SqlTable {
                 ->GetTupleSlot() == slot,
         "This Delete is not the most recent entry in the txn's RedoBuffer. Was StageDelete called immediately before?");
 
-    const auto result = table_.data_table_->Delete(txn, slot);
+    const auto result = Version(slot.GetBlock()->layout_version_).data_table_->Delete(txn, slot);
     if (!result) {
       // For MVCC correctness, this txn must now abort for the GC to clean up the version chain in the DataTable
       // correctly.
@@ -136,68 +293,209 @@ class SqlTable {
    * fit into the given buffer, as visible to the transaction given, according to the format described by the given
    * output buffer. The tuples materialized are guaranteed to be visible and valid, and the function makes best effort
    * to fill the buffer, unless there are no more tuples. The given iterator is mutated to point to one slot past the
-   * last slot scanned in the invocation.
+   * last slot scanned in the invocation. A single invocation only reads tuples of one layout version.
    *
    * @param txn the calling transaction
    * @param start_pos iterator to the starting location for the sequential scan
    * @param out_buffer output buffer. The object should already contain projection list information. This buffer is
    *                   always cleared of old values.
+   * @param version the layout version out_buffer is laid out for
    */
   void Scan(transaction::TransactionContext *const txn, DataTable::SlotIterator *const start_pos,
-            ProjectedColumns *const out_buffer) const {
-    return table_.data_table_->Scan(txn, start_pos, out_buffer);
+            ProjectedColumns *const out_buffer, const layout_version_t version = layout_version_t(0)) const {
+    Scan(txn, start_pos, end(), out_buffer, version);
   }
 
   /**
-   * @return the first tuple slot contained in the underlying DataTable
+   * @return the first tuple slot contained in the table, which is in the DataTable of the first layout version
    */
-  DataTable::SlotIterator begin() const { return table_.data_table_->begin(); }  // NOLINT for STL name compability
+  DataTable::SlotIterator begin() const {  // NOLINT for STL name compability
+    return Version(layout_version_t(0)).data_table_->begin();
+  }
 
   /**
-   * @return one past the last tuple slot contained in the underlying DataTable
+   * @return one past the last tuple slot contained in the table, which is in the DataTable of the latest layout version
    */
-  DataTable::SlotIterator end() const { return table_.data_table_->end(); }  // NOLINT for STL name compability
+  DataTable::SlotIterator end() const {  // NOLINT for STL name compability
+    return Version(GetLatestVersion()).data_table_->end();
+  }
+
+  /**
+   * Sequentially scans the table in the range [start_pos, end_pos), going through the DataTables of the layout versions
+   * in order.
+   * @see DataTable::Scan
+   *
+   * @param txn the calling transaction
+   * @param start_pos iterator to the starting location for the sequential scan
+   * @param end_pos iterator to one past the last slot to scan
+   * @param out_buffer output buffer. The object should already contain projection list information. This buffer is
+   *                   always cleared of old values.
+   * @param version the layout version out_buffer is laid out for
+   */
+  void Scan(transaction::TransactionContext *txn, DataTable::SlotIterator *start_pos,
+            const DataTable::SlotIterator &end_pos, ProjectedColumns *out_buffer,
+            layout_version_t version = layout_version_t(0)) const;
+
+  /**
+   * Exposes tuples of a frozen block of the table without copying them. Blocks of other layout versions than the given
+   * one cannot be read in place.
+   * @see DataTable::ScanInPlace
+   *
+   * @param start_pos iterator to the starting location for the scan
+   * @param end_pos iterator to one past the last slot to scan
+   * @param col_ids the columns to expose
+   * @param num_cols number of columns in col_ids
+   * @param max_tuples maximum number of tuples to expose
+   * @param[out] out_columns start of the values of each column, in the order of col_ids
+   * @param[out] out_nulls null bitmap of each column, in the order of col_ids
+   * @param[out] num_tuples number of tuples exposed
+   * @param[out] out_codes if not null, the dictionary codes of each dictionary-compressed column
+   * @param[out] out_dictionaries if not null, the sorted dictionary of each dictionary-compressed column
+   * @param decoded if not null, buffer to decode encoded columns into
+   * @param version the layout version col_ids refer to
+   * @return the block read in place, or nullptr if the block cannot be read in place
+   */
+  RawBlock *ScanInPlace(DataTable::SlotIterator *const start_pos, const DataTable::SlotIterator &end_pos,
+                        const col_id_t *const col_ids, const uint16_t num_cols, const uint32_t max_tuples,
+                        byte **const out_columns, const common::RawBitmap **const out_nulls, uint32_t *const num_tuples,
+                        const uint32_t **const out_codes = nullptr,
+                        const ArrowVarlenColumn **const out_dictionaries = nullptr,
+                        ProjectedColumns *const decoded = nullptr,
+                        const layout_version_t version = layout_version_t(0)) const {
+    AdvanceToNextVersion(start_pos, end_pos);
+    const DataTable *const table = start_pos->GetTable();
+    if (table->GetLayoutVersion() != version) return nullptr;
+    return table->ScanInPlace(start_pos, EndInTable(*start_pos, end_pos), col_ids, num_cols, max_tuples, out_columns,
+                              out_nulls, num_tuples, out_codes, out_dictionaries, decoded);
+  }
+
+  /**
+   * Reads the zone map of a column in the block the given iterator points into. Blocks of other layout versions than
+   * the given one never have their zone maps read.
+   * @see DataTable::ReadZoneMap
+   *
+   * @param pos iterator into the block of interest
+   * @param col_id the column of interest
+   * @param[out] zone_map the range of non-null values of the column in the block
+   * @param[out] num_values number of non-null values of the column in the block
+   * @param version the layout version col_id refers to
+   * @return true if the block is frozen and the zone map was read, false otherwise
+   */
+  bool ReadZoneMap(const DataTable::SlotIterator &pos, const col_id_t col_id, ColumnZoneMap *const zone_map,
+                   uint32_t *const num_values, const layout_version_t version = layout_version_t(0)) const {
+    if (pos.GetTable()->GetLayoutVersion() != version) return false;
+    return pos.GetTable()->ReadZoneMap(pos, col_id, zone_map, num_values);
+  }
+
+  /**
+   * Moves the given iterator to the first slot of the next block, or to end_pos if that comes first.
+   * @param pos the iterator to move
+   * @param end_pos iterator to one past the last slot to scan
+   */
+  void SkipBlock(DataTable::SlotIterator *const pos, const DataTable::SlotIterator &end_pos) const {
+    AdvanceToNextVersion(pos, end_pos);
+    pos->GetTable()->SkipBlock(pos, EndInTable(*pos, end_pos));
+  }
+
+  /**
+   * Blocks are numbered across the DataTables of all layout versions, in order. The numbering shifts whenever a block
+   * is added to a DataTable other than the one of the latest version.
+   * @param block_idx index of a block in the table
+   * @return iterator to the first tuple slot of the given block
+   */
+  DataTable::SlotIterator beginAt(uint32_t block_idx) const;  // NOLINT for STL name compability
+
+  /**
+   * @param block_idx index of a block in the table
+   * @return iterator to one past the last tuple slot before the given block
+   */
+  DataTable::SlotIterator endAt(const uint32_t block_idx) const {  // NOLINT for STL name compability
+    return beginAt(block_idx);
+  }
+
+  /**
+   * @return the number of blocks currently in the DataTables of all layout versions
+   */
+  uint32_t GetNumBlocks() const {
+    uint32_t num_blocks = 0;
+    for (uint16_t i = 0; i < num_versions_.load(); i++) num_blocks += tables_[i]->data_table_->GetNumBlocks();
+    return num_blocks;
+  }
 
   /**
    * Generates an ProjectedColumnsInitializer for the execution layer to use. This performs the translation from col_oid
    * to col_id for the Initializer's constructor so that the execution layer doesn't need to know anything about col_id.
    * @param col_oids set of col_oids to be projected
    * @param max_tuples the maximum number of tuples to store in the ProjectedColumn
+   * @param version the layout version to lay the ProjectedColumns out for
    * @return initializer to create ProjectedColumns
    * @warning col_oids must be a set (no repeats)
    */
-  ProjectedColumnsInitializer InitializerForProjectedColumns(const std::vector<catalog::col_oid_t> &col_oids,
-                                                             const uint32_t max_tuples) const {
+  ProjectedColumnsInitializer InitializerForProjectedColumns(
+      const std::vector<catalog::col_oid_t> &col_oids, const uint32_t max_tuples,
+      const layout_version_t version = layout_version_t(0)) const {
     TERRIER_ASSERT((std::set<catalog::col_oid_t>(col_oids.cbegin(), col_oids.cend())).size() == col_oids.size(),
                    "There should not be any duplicated in the col_ids!");
-    auto col_ids = ColIdsForOids(col_oids);
+    auto col_ids = ColIdsForOids(col_oids, version);
     TERRIER_ASSERT(col_ids.size() == col_oids.size(),
                    "Projection should be the same number of columns as requested col_oids.");
-    return ProjectedColumnsInitializer(table_.layout_, col_ids, max_tuples);
+    return ProjectedColumnsInitializer(Version(version).layout_, col_ids, max_tuples);
+  }
+
+  /**
+   * Generates a ProjectedColumnsInitializer for a batch of inserted tuples, holding as many tuples as fit into a single
+   * redo buffer segment. Callers inserting more tuples than that split them into several batches.
+   * @param col_oids set of col_oids to be inserted
+   * @param version the layout version to lay the batch out for
+   * @return initializer to pass to TransactionContext::StageBatchWrite
+   * @warning col_oids must be a set (no repeats)
+   */
+  ProjectedColumnsInitializer InitializerForBatchInsert(const std::vector<catalog::col_oid_t> &col_oids,
+                                                        const layout_version_t version = layout_version_t(0)) const {
+    const auto col_ids = ColIdsForOids(col_oids, version);
+    const uint32_t max_tuples = BatchRedoRecord::MaxTuples(Version(version).layout_, col_ids);
+    TERRIER_ASSERT(max_tuples > 0, "a single tuple of these columns does not fit into a redo buffer segment");
+    return InitializerForProjectedColumns(col_oids, max_tuples, version);
   }
 
   /**
    * Generates an ProjectedRowInitializer for the execution layer to use. This performs the translation from col_oid to
    * col_id for the Initializer's constructor so that the execution layer doesn't need to know anything about col_id.
    * @param col_oids set of col_oids to be projected
+   * @param version the layout version to lay the ProjectedRow out for
    * @return initializer to create ProjectedRow
    * @warning col_oids must be a set (no repeats)
    */
-  ProjectedRowInitializer InitializerForProjectedRow(const std::vector<catalog::col_oid_t> &col_oids) const {
+  ProjectedRowInitializer InitializerForProjectedRow(const std::vector<catalog::col_oid_t> &col_oids,
+                                                     const layout_version_t version = layout_version_t(0)) const {
     TERRIER_ASSERT((std::set<catalog::col_oid_t>(col_oids.cbegin(), col_oids.cend())).size() == col_oids.size(),
                    "There should not be any duplicated in the col_ids!");
-    auto col_ids = ColIdsForOids(col_oids);
+    auto col_ids = ColIdsForOids(col_oids, version);
     TERRIER_ASSERT(col_ids.size() == col_oids.size(),
                    "Projection should be the same number of columns as requested col_oids.");
-    return ProjectedRowInitializer::Create(table_.layout_, col_ids);
+    return ProjectedRowInitializer::Create(Version(version).layout_, col_ids);
   }
 
+  /**
+   * Writes the contents of the table, as visible to the given transaction, out to an Arrow IPC file. Frozen blocks are
+   * written out from block memory, and the rest of the blocks are materialized.
+   * @param txn the calling transaction
+   * @param schema schema of the table, which the column names and types are taken from
+   * @param file_path path to the file to write, which is overwritten if it already exists
+   * @throws runtime_error if the file cannot be written, or the table has more than one layout version
+   * @see ArrowIpcWriter
+   */
+  void ExportToArrow(transaction::TransactionContext *txn, const catalog::Schema &schema,
+                     const std::string &file_path) const;
+
   /**
    * Generate a projection map given column oids
    * @param col_oids oids that will be scanned.
+   * @param version the layout version of the projection
    * @return the projection map
    */
-  ProjectionMap ProjectionMapForOids(const std::vector<catalog::col_oid_t> &col_oids);
+  ProjectionMap ProjectionMapForOids(const std::vector<catalog::col_oid_t> &col_oids,
+                                     layout_version_t version = layout_version_t(0));
 
  private:
   friend class RecoveryManager;  // Needs access to OID and ID mappings
@@ -207,22 +505,86 @@ class SqlTable {
 
   BlockStore *const block_store_;
 
-  // Eventually we'll support adding more tables when schema changes. For now we'll always access the one DataTable.
-  DataTableVersion table_;
+  // Versions are only ever appended, and a version is published by bumping num_versions_ once it is fully constructed,
+  // so readers never have to latch.
+  DataTableVersion *tables_[MAX_NUM_VERSIONS] = {};
+  std::atomic<uint16_t> num_versions_ = 0;
+  common::SpinLatch schema_latch_;
+  bool thread_local_insertion_ = false;
+
+  // How tuples of one layout version are read for a projection laid out for another one
+  struct Translation {
+    // Projection, laid out for the version of the tuples, of the columns that exist in both versions. Only one of the
+    // two is set, depending on whether the translation is for selects or for scans.
+    std::unique_ptr<ProjectedRowInitializer> row_initializer_;
+    std::unique_ptr<ProjectedColumnsInitializer> columns_initializer_;
+    // For every column of the requested projection, its index in the translated one, or -1 if the tuples lack it
+    std::vector<int32_t> sources_;
+  };
+  // Versions read from and to, maximum number of tuples (0 for selects), and col_ids of the requested projection
+  using TranslationKey = std::tuple<uint16_t, uint16_t, uint32_t, std::vector<col_id_t>>;
+  // Translations are built on first use and kept for the lifetime of the table, as the same projections are read over
+  // and over again
+  mutable common::SharedLatch translations_latch_;
+  mutable std::map<TranslationKey, std::unique_ptr<Translation>> translations_;
+
+  const DataTableVersion &Version(const layout_version_t version) const {
+    TERRIER_ASSERT((!version) < num_versions_.load(), "Layout version does not exist.");
+    return *tables_[!version];
+  }
+
+  // Creates the DataTable and mappings of the given version of the table
+  DataTableVersion *CreateVersion(const catalog::Schema &schema, layout_version_t version) const;
+
+  // end_pos if it is in the same DataTable as pos, or else the end of the DataTable of pos
+  static DataTable::SlotIterator EndInTable(const DataTable::SlotIterator &pos,
+                                            const DataTable::SlotIterator &end_pos) {
+    return pos.GetTable() == end_pos.GetTable() ? end_pos : pos.GetTable()->end();
+  }
+
+  // Moves an iterator that is past the last slot of the DataTable of one version to the first slot of the next version,
+  // unless end_pos is in the same DataTable
+  void AdvanceToNextVersion(DataTable::SlotIterator *pos, const DataTable::SlotIterator &end_pos) const;
+
+  // Col_ids, in version to, of the columns with the given col_ids in version from that exist in both versions. As a
+  // projection cannot be empty, the result has a column of version to even if none of the columns exist in it.
+  std::vector<col_id_t> TranslateColIds(layout_version_t from, const col_id_t *col_ids, uint16_t num_cols,
+                                        layout_version_t to) const;
+
+  // The translation of the projection with the given col_ids in version from for reading tuples of version to. Scans
+  // pass the size of their output buffer, and selects pass 0.
+  const Translation &GetTranslation(layout_version_t from, const col_id_t *col_ids, uint16_t num_cols,
+                                    layout_version_t to, uint32_t max_tuples) const;
+
+  bool SelectTranslated(transaction::TransactionContext *txn, TupleSlot slot, layout_version_t tuple_version,
+                        ProjectedRow *out_buffer, layout_version_t version) const;
+
+  // Rewrites a delta laid out for version from to be laid out for version to, in place. Returns false, leaving the
+  // delta alone, if some column of the delta does not exist in version to.
+  bool TranslateDelta(ProjectedRow *delta, layout_version_t from, layout_version_t to) const;
+
+  // Fills in the key of the given index from an image of all columns of a tuple laid out for the given version. Key
+  // columns that the version does not have are null.
+  void BuildIndexKey(const index::Index &index, const ProjectedRow &image, layout_version_t version,
+                     ProjectedRow *key) const;
 
   /**
    * Given a set of col_oids, return a vector of corresponding col_ids to use for ProjectionInitialization
    * @param col_oids set of col_oids, they must be in the table's ColumnMap
+   * @param version the layout version to look the col_oids up in
    * @return vector of col_ids for these col_oids
    */
-  std::vector<col_id_t> ColIdsForOids(const std::vector<catalog::col_oid_t> &col_oids) const;
+  std::vector<col_id_t> ColIdsForOids(const std::vector<catalog::col_oid_t> &col_oids,
+                                      layout_version_t version = layout_version_t(0)) const;
 
   /**
-   * @warning This function is expensive to call and should be used with caution and sparingly.
    * Returns the col oid for the given col id
    * @param col_id given col id
+   * @param version the layout version col_id refers to
    * @return col oid for the provided col id
    */
-  catalog::col_oid_t OidForColId(col_id_t col_id) const;
+  catalog::col_oid_t OidForColId(col_id_t col_id, layout_version_t version = layout_version_t(0)) const {
+    return Version(version).col_oids_[!col_id];
+  }
 };
 }  // namespace terrier::storage
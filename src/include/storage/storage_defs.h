@@ -37,6 +37,26 @@ STRONG_TYPEDEF(layout_version_t, uint16_t);
 
 class DataTable;
 
+/**
+ * Write statistics kept in the header of every block, which the access observer uses to tell whether the block has
+ * gone cold. Only the thread that runs the garbage collector reads or writes them.
+ * @see AccessObserver
+ */
+struct BlockAccessStats {
+  /**
+   * The GC invocation (truncated to 32 bits) in which a write to the block was last observed
+   */
+  uint32_t last_write_epoch_;
+  /**
+   * Number of writes observed recently. It halves every few GC invocations without writes.
+   */
+  uint16_t heat_;
+  /**
+   * Flags the access observer keeps about the block
+   */
+  uint16_t flags_;
+};
+
 /**
  * A block is a chunk of memory used for storage. It does not have any meaning
  * unless interpreted by a TupleAccessStrategy. The header layout is documented in the class as well.
@@ -52,10 +72,11 @@ class alignas(common::Constants::BLOCK_SIZE) RawBlock {
   DataTable *data_table_;
 
   /**
-   * Padding for flags or whatever we may want in the future. Determined by size of layout_version below. See
-   * tuple_access_strategy.h for more details on Block header layout.
+   * Set whenever the block is read, and cleared by the block evictor, which uses it to tell whether the block has gone
+   * unread for a while. Sized to match layout_version below. See tuple_access_strategy.h for more details on Block
+   * header layout.
    */
-  uint16_t padding_;
+  std::atomic<uint16_t> recently_read_;
 
   /**
    * Layout version.
@@ -76,11 +97,24 @@ class alignas(common::Constants::BLOCK_SIZE) RawBlock {
    */
   BlockAccessController controller_;
 
+  /**
+   * Version synopsis of the block: the number of slots in the block whose version pointer is not null. Writers
+   * increment it after installing the first version of a slot and before changing the slot in place, and the GC
+   * decrements it when it truncates a version chain entirely. While it stays at 0, no tuple in the block has versions
+   * and readers can skip the version chain checks.
+   */
+  std::atomic<uint64_t> num_versioned_slots_;
+
+  /**
+   * Write statistics of the block used to identify cold blocks.
+   */
+  BlockAccessStats access_stats_;
+
   /**
    * Contents of the raw block.
    */
   byte content_[common::Constants::BLOCK_SIZE - sizeof(uintptr_t) - sizeof(uint16_t) - sizeof(layout_version_t) -
-                sizeof(uint32_t) - sizeof(BlockAccessController)];
+                sizeof(uint32_t) - sizeof(BlockAccessController) - sizeof(uint64_t) - sizeof(BlockAccessStats)];
   // A Block needs to always be aligned to 1 MB, so we can get free bytes to
   // store offsets within a block in one 8-byte word
 
@@ -90,6 +124,14 @@ class alignas(common::Constants::BLOCK_SIZE) RawBlock {
    * @return the offset which tells us where the next insertion should take place
    */
   uint32_t GetInsertHead() { return INT32_MAX & insert_head_.load(); }
+
+  /**
+   * Records that the block was read. The flag is only written if it is not set yet, so that concurrent readers of a
+   * block do not fight over its cache line.
+   */
+  void MarkRead() {
+    if (recently_read_.load(std::memory_order_relaxed) == 0) recently_read_.store(1, std::memory_order_relaxed);
+  }
 };
 
 /**
@@ -161,15 +203,37 @@ class TupleSlot {
 };
 
 /**
- * Allocator that allocates a block
+ * Allocator that allocates a block. Blocks are carved out of arenas mapped with huge pages, so that scanning a block
+ * touches as few TLB entries as possible. If no huge pages are reserved on the system, arenas fall back to regular
+ * pages with a hint to the kernel to back them with transparent huge pages. Every arena is bound to the NUMA node of
+ * the thread that maps it, which is the thread that asked for the first block in it.
+ *
+ * The allocator is not thread-safe. The block store only calls it while holding its own latch.
  */
 class BlockAllocator {
  public:
+  /**
+   * Size of an arena, which is the size of a huge page
+   */
+  static constexpr uint64_t ARENA_SIZE = 2 * common::Constants::MB;
+
+  /**
+   * Constructs a new allocator. No memory is mapped until the first block is asked for.
+   */
+  BlockAllocator() = default;
+
+  /**
+   * Unmaps every arena that no longer holds any blocks. Blocks that were never deleted are leaked.
+   */
+  ~BlockAllocator();
+
+  DISALLOW_COPY_AND_MOVE(BlockAllocator);
+
   /**
    * Allocates a new object by calling its constructor.
-   * @return a pointer to the allocated object.
+   * @return a pointer to the allocated object, or nullptr if no memory could be mapped.
    */
-  RawBlock *New() { return new RawBlock(); }
+  RawBlock *New();
 
   /**
    * Reuse a reused chunk of memory to be handed out again
@@ -179,15 +243,33 @@ class BlockAllocator {
   }
 
   /**
-   * Deletes the object by calling its destructor.
+   * Deletes the object by calling its destructor. The arena it came from is unmapped once it holds no more blocks.
    * @param ptr a pointer to the object to be deleted.
    */
-  void Delete(RawBlock *const ptr) { delete ptr; }
+  void Delete(RawBlock *ptr);
+
+ private:
+  static_assert(ARENA_SIZE % common::Constants::BLOCK_SIZE == 0, "arenas must hold a whole number of blocks");
+
+  // Arena that blocks are currently being carved out of, one per NUMA node
+  struct OpenArena {
+    byte *next_block_ = nullptr;
+    uint32_t blocks_left_ = 0;
+  };
+  std::vector<OpenArena> open_arenas_;
+  // Number of blocks handed out and not yet deleted, for every arena currently mapped
+  std::unordered_map<byte *, uint32_t> live_blocks_;
+
+  static byte *ArenaOf(const void *block) {
+    return reinterpret_cast<byte *>(reinterpret_cast<uintptr_t>(block) & ~(ARENA_SIZE - 1));
+  }
+
+  bool IsOpen(const byte *arena) const;
 };
 
 /**
  * A block store is essentially an object pool. However, all blocks should be
- * aligned, so we will need to use the default constructor instead of raw
+ * aligned, so we will need to carve them out of aligned arenas instead of raw
  * malloc.
  */
 using BlockStore = common::ObjectPool<RawBlock, BlockAllocator>;
@@ -208,7 +290,7 @@ enum class DeltaRecordType : uint8_t { UPDATE = 0, INSERT, DELETE };
 /**
  * Types of LogRecords
  */
-enum class LogRecordType : uint8_t { REDO = 1, DELETE, COMMIT, ABORT };
+enum class LogRecordType : uint8_t { REDO = 1, DELETE, COMMIT, ABORT, BATCH_REDO };
 
 /**
  * Callback function and arguments to be called when record is persisted
@@ -240,12 +322,26 @@ class VarlenEntry {
   static VarlenEntry Create(byte *content, uint32_t size, bool reclaim) {
     VarlenEntry result;
     TERRIER_ASSERT(size > InlineThreshold(), "small varlen values should be inlined");
+    TERRIER_ASSERT(size <= SIZE_MASK, "varlen value is too large");
     result.size_ = reclaim ? size : (INT32_MIN | size);  // the first bit denotes whether we can reclaim it
     std::memcpy(result.prefix_, content, sizeof(uint32_t));
     result.content_ = content;
     return result;
   }
 
+  /**
+   * Constructs a new varlen entry that takes ownership of a buffer allocated from a VarlenArena. The buffer is
+   * reclaimable, the same as with Create, but is handed back to its arena instead of deleted.
+   * @param content pointer to the varlen content itself, allocated with VarlenArena::Allocate
+   * @param size length of the varlen content, in bytes (no C-style nul-terminator)
+   * @return constructed VarlenEntry object
+   */
+  static VarlenEntry CreateFromArena(byte *content, uint32_t size) {
+    VarlenEntry result = Create(content, size, true);
+    result.size_ |= FROM_ARENA;
+    return result;
+  }
+
   /**
    * Constructs a new varlen entry, with the associated varlen value inlined within the struct itself. This is only
    * possible when the inlined value is smaller than InlineThreshold() as defined. The value is copied and the given
@@ -279,7 +375,7 @@ class VarlenEntry {
   /**
    * @return size of the varlen value stored in this entry, in bytes.
    */
-  uint32_t Size() const { return static_cast<uint32_t>(INT32_MAX & size_); }
+  uint32_t Size() const { return static_cast<uint32_t>(SIZE_MASK & size_); }
 
   /**
    * @return whether the content is inlined or not.
@@ -295,6 +391,11 @@ class VarlenEntry {
     return size_ > static_cast<int32_t>(InlineThreshold());
   }
 
+  /**
+   * @return whether the content is owned by the entry and was allocated from a VarlenArena
+   */
+  bool FromArena() const { return NeedReclaim() && (size_ & FROM_ARENA) != 0; }
+
   /**
    * @return pointer to the stored prefix of the varlen entry
    */
@@ -314,6 +415,10 @@ class VarlenEntry {
   }
 
  private:
+  // The second highest bit of size_ marks buffers allocated from a VarlenArena
+  static constexpr int32_t FROM_ARENA = 1 << 30;
+  static constexpr int32_t SIZE_MASK = INT32_MAX & ~FROM_ARENA;
+
   int32_t size_;                   // buffer reclaimable => sign bit is 0 or size <= InlineThreshold
   byte prefix_[sizeof(uint32_t)];  // Explicit padding so that we can use these bits for inlined values or prefix
   const byte *content_;            // pointer to content of the varlen entry if not inlined
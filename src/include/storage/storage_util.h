@@ -7,6 +7,7 @@
 #include "common/strong_typedef.h"
 #include "storage/block_layout.h"
 #include "storage/storage_defs.h"
+#include "storage/varlen_arena.h"
 
 namespace terrier::catalog {
 class Schema;
@@ -174,16 +175,17 @@ class StorageUtil {
   static void DeallocateVarlens(RawBlock *block, const TupleAccessStrategy &accessor);
 
   /**
-   * Helper method to turn a string into a VarlenEntry
+   * Helper method to turn a string into a VarlenEntry. Values too large to be inlined are allocated from the arena of
+   * the calling thread.
    * @param str input to be turned into a VarlenEntry
    * @return varlen entry representing string
-   * @warning checking IsInlined() to see if you need to possibly clean up a buffer
+   * @warning checking NeedReclaim() to see if you need to possibly clean up a buffer with VarlenArena::Free
    */
   static storage::VarlenEntry CreateVarlen(const std::string &str) {
     if (str.size() > storage::VarlenEntry::InlineThreshold()) {
-      byte *contents = common::AllocationUtil::AllocateAligned(str.size());
+      byte *contents = VarlenArena::ThreadLocal().Allocate(static_cast<uint32_t>(str.size()));
       std::memcpy(contents, str.data(), str.size());
-      return storage::VarlenEntry::Create(contents, static_cast<uint32_t>(str.size()), true);
+      return storage::VarlenEntry::CreateFromArena(contents, static_cast<uint32_t>(str.size()));
     }
     return storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>(str.data()),
                                               static_cast<uint32_t>(str.size()));
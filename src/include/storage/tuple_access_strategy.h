@@ -44,7 +44,9 @@ class TupleAccessStrategy {
   /*
    * Block Header layout:
    * -----------------------------------------------------------------------------------------------------------------
-   * | data_table *(64) | padding (16) | layout_version (16) | insert_head (32) |        control_block (64)          |
+   * | data_table *(64) | recently_read (16) | layout_version (16) | insert_head (32) | control_block (64) |
+   * -----------------------------------------------------------------------------------------------------------------
+   * | versioned (64) | access_stats (64) |
    * -----------------------------------------------------------------------------------------------------------------
    * | ArrowBlockMetadata | attr_offsets[num_col] (32) | bitmap for slots (64-bit aligned) | data (64-bit aligned)   |
    * -----------------------------------------------------------------------------------------------------------------
@@ -134,6 +136,31 @@ class TupleAccessStrategy {
     return reinterpret_cast<Block *>(block)->Column(layout_, col_id)->ColumnStart(layout_, col_id);
   }
 
+  /**
+   * Readers of a fixed-length column have to decode values from its encoded copy when there is one, because the
+   * column in the block may have been released.
+   * @param block block to access
+   * @param col_id id of the column
+   * @return the encoded copy of the column, or nullptr if the values can be read from the block
+   */
+  const ArrowEncodedColumn *EncodedColumn(RawBlock *block, const col_id_t col_id) const {
+    if (layout_.IsVarlen(col_id)) return nullptr;
+    ArrowBlockMetadata &metadata = GetArrowBlockMetadata(block);
+    // Most blocks have never been frozen, and this saves them from looking up the column info
+    if (metadata.NumEncodedColumns().load() == 0) return nullptr;
+    return metadata.GetColumnInfo(layout_, col_id).EncodedColumn();
+  }
+
+  /**
+   * Takes the encoded copy away from a fixed-length column of the block, putting the values back into the block if
+   * they were released, so that the column can be written to. See ArrowColumnInfo::Thaw.
+   * @param block block to access
+   * @param col_id id of the column
+   * @return the encoded copy, which can only be freed once no reader can be decoding from it anymore, or nullptr if
+   *         the column had none
+   */
+  ArrowEncodedColumn *ThawColumn(RawBlock *block, col_id_t col_id) const;
+
   /**
    * @param slot tuple slot to access
    * @param col_id id of the column
@@ -202,14 +229,14 @@ class TupleAccessStrategy {
   }
 
   /**
-   * Flip a deallocated slot to be allocated again. This is useful when compacting a block,
-   * as we want to make decisions in the compactor on what slot to use, not in this class.
-   * This method should not be called other than that.
-   * @param slot the tuple slot to reallocate. Must be currently deallocated.
+   * Flip a deallocated slot to be allocated again. This is useful when compacting a block, or when reusing the slot of
+   * a deleted tuple, as we want to make decisions on what slot to use outside of this class. Both can race for the
+   * same slot, so only one of them can succeed.
+   * @param slot the tuple slot to reallocate.
+   * @return true if the slot was deallocated and is now allocated by the caller, false otherwise
    */
-  void Reallocate(TupleSlot slot) const {
-    TERRIER_ASSERT(!Allocated(slot), "Can only reallocate slots that are deallocated");
-    reinterpret_cast<Block *>(slot.GetBlock())->SlotAllocationBitmap(layout_)->Flip(slot.GetOffset(), false);
+  bool Reallocate(TupleSlot slot) const {
+    return reinterpret_cast<Block *>(slot.GetBlock())->SlotAllocationBitmap(layout_)->Flip(slot.GetOffset(), false);
   }
 
   /**
@@ -218,7 +245,17 @@ class TupleAccessStrategy {
    * @param[out] slot tuple to write to.
    * @return true if the allocation succeeded, false if no space could be found.
    */
-  bool Allocate(RawBlock *block, TupleSlot *slot) const;
+  bool Allocate(RawBlock *block, TupleSlot *slot) const { return AllocateRange(block, 1, slot) == 1; }
+
+  /**
+   * Allocates up to max_slots consecutive slots for new tuples, starting from the insert head of the block. The insert
+   * head is only moved once for the whole range.
+   * @param block block to allocate slots in.
+   * @param max_slots maximum number of slots to allocate.
+   * @param[out] first the first slot allocated.
+   * @return number of slots allocated, 0 if no space could be found.
+   */
+  uint32_t AllocateRange(RawBlock *block, uint32_t max_slots, TupleSlot *first) const;
 
   /**
    * @param block the block to access
@@ -2,6 +2,7 @@
 #include <vector>
 #include "storage/projected_row.h"
 #include "transaction/transaction_defs.h"
+#include "transaction/transaction_util.h"
 
 namespace terrier::storage {
 class DataTable;
@@ -35,6 +36,20 @@ class UndoRecord {
    */
   const std::atomic<transaction::timestamp_t> &Timestamp() const { return timestamp_; }
 
+  /**
+   * A committing transaction only publishes its commit timestamp in its own finish time, and its records are stamped
+   * with it later, by the GC. Until then, this reads the timestamp through the transaction, waiting out the short
+   * window in which the transaction is checking out its commit timestamp.
+   * @return Timestamp up to which the old projected row was visible, whether or not this record has been stamped.
+   */
+  transaction::timestamp_t EffectiveTimestamp() const {
+    const transaction::timestamp_t timestamp = timestamp_.load();
+    if (txn_finish_time_ == nullptr || transaction::TransactionUtil::Committed(timestamp)) return timestamp;
+    transaction::timestamp_t finish_time = txn_finish_time_->load();
+    while (finish_time == transaction::COMMITTING_TXN_TIMESTAMP) finish_time = txn_finish_time_->load();
+    return finish_time;
+  }
+
   /**
    * @return the type of this undo record
    */
@@ -99,14 +114,17 @@ class UndoRecord {
    * @param timestamp timestamp of the transaction that generated this UndoRecord
    * @param slot the TupleSlot this UndoRecord points to
    * @param table the DataTable this UndoRecord points to
+   * @param txn_finish_time finish time of the transaction that generated this UndoRecord, if it is to be read through
    * @return pointer to the initialized UndoRecord
    */
   static UndoRecord *InitializeInsert(byte *const head, const transaction::timestamp_t timestamp, const TupleSlot slot,
-                                      DataTable *const table) {
+                                      DataTable *const table,
+                                      const std::atomic<transaction::timestamp_t> *const txn_finish_time = nullptr) {
     auto *result = reinterpret_cast<UndoRecord *>(head);
     result->type_ = DeltaRecordType::INSERT;
     result->next_ = nullptr;
     result->timestamp_.store(timestamp);
+    result->txn_finish_time_ = txn_finish_time;
     result->table_ = table;
     result->slot_ = slot;
     return result;
@@ -119,14 +137,17 @@ class UndoRecord {
    * @param timestamp timestamp of the transaction that generated this UndoRecord
    * @param slot the TupleSlot this UndoRecord points to
    * @param table the DataTable this UndoRecord points to
+   * @param txn_finish_time finish time of the transaction that generated this UndoRecord, if it is to be read through
    * @return pointer to the initialized UndoRecord
    */
   static UndoRecord *InitializeDelete(byte *const head, const transaction::timestamp_t timestamp, const TupleSlot slot,
-                                      DataTable *const table) {
+                                      DataTable *const table,
+                                      const std::atomic<transaction::timestamp_t> *const txn_finish_time = nullptr) {
     auto *result = reinterpret_cast<UndoRecord *>(head);
     result->type_ = DeltaRecordType::DELETE;
     result->next_ = nullptr;
     result->timestamp_.store(timestamp);
+    result->txn_finish_time_ = txn_finish_time;
     result->table_ = table;
     result->slot_ = slot;
     return result;
@@ -140,15 +161,18 @@ class UndoRecord {
    * @param slot the TupleSlot this UndoRecord points to
    * @param table the DataTable this UndoRecord points to
    * @param initializer the initializer to use for the embedded ProjectedRow
+   * @param txn_finish_time finish time of the transaction that generated this UndoRecord, if it is to be read through
    * @return pointer to the initialized UndoRecord
    */
   static UndoRecord *InitializeUpdate(byte *const head, const transaction::timestamp_t timestamp, const TupleSlot slot,
-                                      DataTable *const table, const ProjectedRowInitializer &initializer) {
+                                      DataTable *const table, const ProjectedRowInitializer &initializer,
+                                      const std::atomic<transaction::timestamp_t> *const txn_finish_time = nullptr) {
     auto *result = reinterpret_cast<UndoRecord *>(head);
 
     result->type_ = DeltaRecordType::UPDATE;
     result->next_ = nullptr;
     result->timestamp_.store(timestamp);
+    result->txn_finish_time_ = txn_finish_time;
     result->table_ = table;
     result->slot_ = slot;
 
@@ -166,15 +190,18 @@ class UndoRecord {
    * @param slot the TupleSlot this UndoRecord points to
    * @param table the DataTable this UndoRecord points to
    * @param redo the redo changes to be applied
+   * @param txn_finish_time finish time of the transaction that generated this UndoRecord, if it is to be read through
    * @return pointer to the initialized UndoRecord
    */
   static UndoRecord *InitializeUpdate(byte *const head, const transaction::timestamp_t timestamp, const TupleSlot slot,
-                                      DataTable *const table, const storage::ProjectedRow &redo) {
+                                      DataTable *const table, const storage::ProjectedRow &redo,
+                                      const std::atomic<transaction::timestamp_t> *const txn_finish_time = nullptr) {
     auto *result = reinterpret_cast<UndoRecord *>(head);
 
     result->type_ = DeltaRecordType::UPDATE;
     result->next_ = nullptr;
     result->timestamp_.store(timestamp);
+    result->txn_finish_time_ = txn_finish_time;
     result->table_ = table;
     result->slot_ = slot;
 
@@ -187,6 +214,8 @@ class UndoRecord {
   DeltaRecordType type_;
   std::atomic<UndoRecord *> next_;
   std::atomic<transaction::timestamp_t> timestamp_;
+  // Finish time of the transaction that generated this record, which it commits through
+  const std::atomic<transaction::timestamp_t> *txn_finish_time_;
   DataTable *table_;
   TupleSlot slot_;
   // This needs to be aligned to 8 bytes to ensure the real size of UndoRecord (plus actual ProjectedRow) is also
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "common/constants.h"
+#include "common/macros.h"
+#include "common/strong_typedef.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage {
+/**
+ * Bump allocator for the buffers of varlen values that are too large to be inlined in their VarlenEntry.
+ *
+ * Buffers are carved out of chunks. Every chunk counts the buffers in it that are still alive, and is freed as a whole
+ * once none are left and the arena has moved on to the next chunk. The values written by a transaction tend to die
+ * together, for example when the block they went into is gathered or the table is dropped, so this trades a malloc
+ * and a free for every value for a pointer bump and a decrement, and keeps the values from fragmenting the heap.
+ *
+ * A chunk stays around for as long as any value in it does. Chunks are kept small, and values larger than a fraction
+ * of a chunk get a chunk of their own, so a long-lived value never holds on to more than one small chunk.
+ *
+ * Chunks are aligned to their size and start with a tagged header, so a buffer finds its chunk from its address
+ * alone, and freeing a buffer takes no latch. VarlenEntry::CreateFromArena marks the entries that own an arena buffer,
+ * which lets Free(const VarlenEntry &) tell them apart from buffers allocated with new[].
+ *
+ * An arena is not thread-safe, and is meant to be used by one transaction or thread at a time. Free is thread-safe.
+ */
+class VarlenArena {
+ public:
+  /**
+   * Size of a chunk. Chunks are aligned to their size, so that a buffer can find its chunk.
+   */
+  static constexpr uint32_t CHUNK_SIZE = 16 * common::Constants::KB;
+
+  /**
+   * Values larger than this get a chunk of their own, which is freed as soon as the value is
+   */
+  static constexpr uint32_t MAX_SHARED_SIZE = CHUNK_SIZE / 8;
+
+  /**
+   * Instantiates a new arena. No memory is allocated until the first buffer is asked for.
+   */
+  VarlenArena() = default;
+
+  /**
+   * Lets go of the chunk currently being allocated from. Buffers allocated from the arena stay valid until freed.
+   */
+  ~VarlenArena();
+
+  DISALLOW_COPY_AND_MOVE(VarlenArena);
+
+  /**
+   * @return the arena of the calling thread, for varlens that are not written on behalf of a transaction
+   */
+  static VarlenArena &ThreadLocal();
+
+  /**
+   * Allocates a buffer for a varlen value
+   * @param size size of the value, in bytes
+   * @return the buffer, which needs to be wrapped with VarlenEntry::CreateFromArena, or freed with Free once the value
+   * is dead
+   */
+  byte *Allocate(uint32_t size);
+
+  /**
+   * Frees a buffer allocated from an arena
+   * @param content the buffer to free
+   */
+  static void Free(const byte *content);
+
+  /**
+   * Frees the buffer of a varlen entry that owns it, whether the buffer was allocated from an arena or with new[]
+   * @param entry the entry whose buffer to free. Must need reclaiming.
+   */
+  static void Free(const VarlenEntry &entry) {
+    TERRIER_ASSERT(entry.NeedReclaim(), "only buffers owned by the storage engine can be freed");
+    if (entry.FromArena())
+      Free(entry.Content());
+    else
+      delete[] entry.Content();
+  }
+
+  /**
+   * @return number of chunks currently allocated across all arenas
+   */
+  static uint64_t NumChunks();
+
+ private:
+  struct ChunkHeader {
+    // Tells a chunk apart from any other memory, only to catch buffers that did not come from an arena
+    uint64_t tag_;
+    // Number of live buffers in the chunk, plus one while an arena is allocating out of it
+    std::atomic<uint64_t> num_refs_;
+  };
+
+  static ChunkHeader *NewChunk(uint64_t size);
+  static void Release(ChunkHeader *chunk);
+
+  ChunkHeader *chunk_ = nullptr;
+  uint32_t next_offset_ = CHUNK_SIZE;
+};
+}  // namespace terrier::storage
@@ -68,6 +68,27 @@ struct PosixIoWrappers {
    * @throws runtime_error if the underlying posix call failed
    */
   static void WriteFully(int fd, const void *buf, size_t nbyte);
+
+  /**
+   * Wrapper around the posix writev call, where a single function call will always write all of the given buffers out,
+   * however many there are. (unlike posix writev, which can write fewer bytes or reject too many buffers)
+   * @param fd posix fildes arg
+   * @param iov posix iov arg. The entries are modified to keep track of progress.
+   * @param iovcnt posix iovcnt arg
+   * @throws runtime_error if the underlying posix call failed
+   */
+  static void WriteVFully(int fd, struct iovec *iov, size_t iovcnt);
+
+  /**
+   * Wrapper around the posix pwrite call, where a single function call will always write the entire buffer out at the
+   * given offset. (unlike posix pwrite, which can write arbitrarily many bytes less than the given amount)
+   * @param fd posix fildes arg
+   * @param buf posix buf arg
+   * @param nbyte posix nbyte arg
+   * @param offset posix offset arg
+   * @throws runtime_error if the underlying posix call failed
+   */
+  static void PWriteFully(int fd, const void *buf, size_t nbyte, off_t offset);
 };
 // TODO(Tianyu):  we need control over when and what to flush as the log manager. Thus, we need to write our
 // own wrapper around lower level I/O functions. I could be wrong, and in that case we should
@@ -1,6 +1,9 @@
 #pragma once
 #include <transaction/timestamp_manager.h>
+#include <vector>
+#include "common/constants.h"
 #include "storage/data_table.h"
+#include "storage/projected_columns.h"
 #include "storage/projected_row.h"
 #include "transaction/transaction_defs.h"
 
@@ -110,6 +113,16 @@ class RedoRecord {
    */
   void SetTupleSlot(const TupleSlot tuple_slot) { tuple_slot_ = tuple_slot; }
 
+  /**
+   * @return the layout version of the table the delta is laid out for, which the tuple is stored under
+   */
+  layout_version_t GetLayoutVersion() const { return layout_version_; }
+
+  /**
+   * @param layout_version the layout version of the table the delta is laid out for
+   */
+  void SetLayoutVersion(const layout_version_t layout_version) { layout_version_ = layout_version; }
+
   /**
    * @return inlined delta that (was/is to be) applied to the tuple in the table
    */
@@ -150,6 +163,7 @@ class RedoRecord {
     body->db_oid_ = db_oid;
     body->table_oid_ = table_oid;
     body->tuple_slot_ = TupleSlot(nullptr, 0);
+    body->layout_version_ = layout_version_t(0);
     initializer.InitializeRow(body->Delta());
     return result;
   }
@@ -175,6 +189,7 @@ class RedoRecord {
     body->db_oid_ = db_oid;
     body->table_oid_ = table_oid;
     body->tuple_slot_ = tuple_slot;
+    body->layout_version_ = layout_version_t(0);
     return result;
   }
 
@@ -186,6 +201,7 @@ class RedoRecord {
   catalog::db_oid_t db_oid_;
   catalog::table_oid_t table_oid_;
   TupleSlot tuple_slot_;
+  layout_version_t layout_version_;
   // This needs to be aligned to 8 bytes to ensure the real size of RedoRecord (plus actual ProjectedRow) is also
   // a multiple of 8.
   uint64_t varlen_contents_[0];
@@ -194,6 +210,99 @@ class RedoRecord {
 // TODO(Tianyu): Same here
 static_assert(sizeof(RedoRecord) % 8 == 0, "a projected row inside the redo record needs to be aligned to 8 bytes");
 
+/**
+ * Record body of a batch of inserts into the same table. The header is stored in the LogRecord class that would
+ * presumably return this object. This only exists in memory, to save staging a RedoRecord per tuple; the log
+ * serializer writes every tuple of the batch out as a regular RedoRecord.
+ */
+class BatchRedoRecord {
+ public:
+  MEM_REINTERPRETATION_ONLY(BatchRedoRecord)
+
+  /**
+   * @return database oid for this redo record
+   */
+  catalog::db_oid_t GetDatabaseOid() const { return db_oid_; }
+
+  /**
+   * @return table oid for this redo record
+   */
+  catalog::table_oid_t GetTableOid() const { return table_oid_; }
+
+  /**
+   * @return inlined after-images of the inserted tuples. The tuple slots are filled in once they are inserted.
+   */
+  ProjectedColumns *Columns() { return reinterpret_cast<ProjectedColumns *>(varlen_contents_); }
+
+  /**
+   * @return const inlined after-images of the inserted tuples
+   */
+  const ProjectedColumns *Columns() const { return reinterpret_cast<const ProjectedColumns *>(varlen_contents_); }
+
+  /**
+   * @return type of record this type of body holds
+   */
+  static constexpr LogRecordType RecordType() { return LogRecordType::BATCH_REDO; }
+
+  /**
+   * @return Size of the entire record of this type, in bytes, in memory, if the underlying Columns are to have the
+   * same structure as described by the given initializer.
+   */
+  static uint32_t Size(const ProjectedColumnsInitializer &initializer) {
+    return static_cast<uint32_t>(sizeof(LogRecord) + sizeof(BatchRedoRecord) + initializer.ProjectedColumnsSize());
+  }
+
+  /**
+   * @param layout layout of the table the batch is inserted into
+   * @param col_ids the columns of the batch
+   * @return the largest number of tuples a batch of the given columns can hold and still fit in a single redo buffer
+   * segment, or 0 if not even one tuple fits
+   */
+  static uint32_t MaxTuples(const BlockLayout &layout, const std::vector<col_id_t> &col_ids) {
+    // Every tuple takes up at least the space of its tuple slot, which bounds the search
+    uint32_t lo = 0, hi = common::Constants::BUFFER_SEGMENT_SIZE / sizeof(TupleSlot);
+    while (lo < hi) {
+      const uint32_t mid = lo + (hi - lo + 1) / 2;
+      if (Size(ProjectedColumnsInitializer(layout, col_ids, mid)) <= common::Constants::BUFFER_SEGMENT_SIZE)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+    return lo;
+  }
+
+  /**
+   * Initialize an entire LogRecord (header included) to have an underlying batched redo record, using the parameters
+   * supplied
+   * @param head pointer location to initialize, this is also the returned address (reinterpreted)
+   * @param txn_begin begin timestamp of the transaction that generated this log record
+   * @param db_oid database oid of this redo record
+   * @param table_oid table oid of this redo record
+   * @param initializer the initializer to use for the underlying columns
+   * @return pointer to the initialized log record, always equal in value to the given head
+   */
+  static LogRecord *Initialize(byte *const head, const transaction::timestamp_t txn_begin,
+                               const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid,
+                               const ProjectedColumnsInitializer &initializer) {
+    LogRecord *result = LogRecord::InitializeHeader(head, LogRecordType::BATCH_REDO, Size(initializer), txn_begin);
+    auto *body = result->GetUnderlyingRecordBodyAs<BatchRedoRecord>();
+    body->db_oid_ = db_oid;
+    body->table_oid_ = table_oid;
+    initializer.Initialize(body->Columns());
+    return result;
+  }
+
+ private:
+  catalog::db_oid_t db_oid_;
+  catalog::table_oid_t table_oid_;
+  // This needs to be aligned to 8 bytes to ensure the real size of BatchRedoRecord (plus actual ProjectedColumns) is
+  // also a multiple of 8.
+  uint64_t varlen_contents_[0];
+};
+
+static_assert(sizeof(BatchRedoRecord) % 8 == 0,
+              "projected columns inside the batched redo record need to be aligned to 8 bytes");
+
 /**
  * Record body of a Delete. The header is stored in the LogRecord class that would presumably return this
  * object.
@@ -96,7 +96,9 @@ class LogSerializerTask : public common::DedicatedThreadTask {
   // We aggregate all transactions we serialize so we can bulk remove the from the timestamp manager
   // TODO(Gus): If we guarantee there is only one TSManager in the system, this can just be a vector. We could also pass
   // TS into the serializer instead of having a pointer for it in every commit/abort record
-  std::unordered_map<transaction::TimestampManager *, std::vector<transaction::timestamp_t>> serialized_txns_;
+  // Transactions are identified by the slot of the active txn set they are tracked in, and their start timestamp
+  std::unordered_map<transaction::TimestampManager *, std::vector<std::pair<uint32_t, transaction::timestamp_t>>>
+      serialized_txns_;
 
   // The queue containing empty buffers. Task will dequeue a buffer from this queue when it needs a new buffer
   common::ConcurrentBlockingQueue<BufferedLogWriter *> *empty_buffer_queue_;
@@ -134,6 +136,22 @@ class LogSerializerTask : public common::DedicatedThreadTask {
    */
   uint64_t SerializeRecord(const LogRecord &record);
 
+  /**
+   * Serialize out every tuple of a batched redo record to the log, as a regular redo record each
+   * @param record the batched redo record to serialize
+   * @return bytes serialized, used for metrics
+   */
+  uint64_t SerializeBatchRedoRecord(const LogRecord &record);
+
+  /**
+   * Serialize out the value of a non-null attribute of a redo record
+   * @param block_layout layout of the table the attribute belongs to
+   * @param col_id column id of the attribute
+   * @param column_value_address address of the attribute's value
+   * @return bytes serialized, used for metrics
+   */
+  uint64_t SerializeAttribute(const BlockLayout &block_layout, col_id_t col_id, const byte *column_value_address);
+
   /**
    * Serialize the data pointed to by val to current serialization buffer
    * @tparam T Type of the value
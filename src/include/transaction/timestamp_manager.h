@@ -1,7 +1,10 @@
 #pragma once
 #include <algorithm>
-#include <unordered_set>
+#include <atomic>
+#include <deque>
+#include <utility>
 #include <vector>
+#include "common/constants.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
 #include "transaction/transaction_defs.h"
@@ -15,90 +18,124 @@ namespace terrier::transaction {
 class TransactionManager;
 /**
  * Generates timestamps, and keeps track of the lifetime of transactions (whether they have entered or left the system)
+ *
+ * The clock advances in epochs of EPOCH_SIZE timestamps. Checking out a timestamp, as commits, aborts and the GC do,
+ * returns the last timestamp of the current epoch and moves the clock on to the next one. Start timestamps are handed
+ * out from within the current epoch without writing to the clock: every slot owns a range of SLOT_RANGE timestamps in
+ * each epoch, and hands them out in order under its latch. A transaction thus starts after every timestamp checked out
+ * before it read the clock, and before every one checked out after, which is all snapshot isolation needs.
  */
 class TimestampManager {
  public:
   /**
-   * @return unique timestamp based on current time, and advances one tick
+   * Number of timestamps in an epoch of the clock
    */
-  timestamp_t CheckOutTimestamp() { return time_++; }
+  static constexpr uint64_t EPOCH_SIZE = 4096;
 
   /**
-   * @return current time without advancing the tick
+   * Number of slots active transactions are tracked in. Threads are spread over them round-robin.
    */
-  timestamp_t CurrentTime() const { return time_.load(); }
+  static constexpr uint32_t NUM_SLOTS = 64;
+
+  /**
+   * Number of timestamps of every epoch a slot can hand out start times from. The last one of the range is never
+   * handed out, since for the last slot it is the timestamp that closes the epoch.
+   */
+  static constexpr uint64_t SLOT_RANGE = EPOCH_SIZE / NUM_SLOTS;
+
+  /**
+   * @return unique timestamp based on current time, and advances the clock to the next epoch
+   */
+  timestamp_t CheckOutTimestamp() { return time_.fetch_add(EPOCH_SIZE) + (EPOCH_SIZE - 1); }
+
+  /**
+   * @return current time without advancing the clock. This is newer than any timestamp handed out so far.
+   */
+  timestamp_t CurrentTime() const { return time_.load() + (EPOCH_SIZE - 1); }
 
   /**
    * Get the oldest transaction alive (by start timestamp given out by this timestamp manager at this time)
    * Because of concurrent operations, it is not guaranteed that upon return the txn is still alive. However,
-   * it is guaranteed that the return timestamp is older than any transactions live.
-   * @warning If logging is enabled, txns are not removed from the txn set until they are serialized. Thus, the active
-   * txn set can grow greatly in size, making this call expensive. Consider using CachedOldestTransactionStartTime for
-   * better peformance at the cost of a more stale timestamp.
-   * @return timestamp that is older than any transactions alive
+   * it is guaranteed that the return timestamp is no newer than the start time of any live txn.
+   * This takes no latches: every slot publishes a lower bound on the start times of its transactions, which is read
+   * here without holding up the threads that begin and finish transactions.
+   * @warning This call reads the published bound of every slot of the active txn set. Consider using
+   * CachedOldestTransactionStartTime for better peformance at the cost of a more stale timestamp.
+   * @return timestamp that is no newer than the start time of any transaction alive
    */
   timestamp_t OldestTransactionStartTime();
 
   /**
    * Get the cached timestamp of the oldest active txn. The cached timestamp is only refreshed upon every invocation of
-   * OldestTransactionStartTime, so it may be stale. On the other hand, this function does not require taking a latch or
-   * iterating through the running txns set, making it much cheaper than OldestTransactionStartTime. This has the same
-   * correctness guarantee as OldestTransactionStartTime, but may cause performance degradations for processes that rely
-   * on very fresh oldest txn timestamps
-   * @return timestamp that is older than any transactions alive
+   * OldestTransactionStartTime, so it may be stale. On the other hand, this function does not require reading the clock
+   * or every slot of the active txn set, making it much cheaper than OldestTransactionStartTime. This has the same
+   * correctness guarantee as OldestTransactionStartTime, but may cause performance degradations for processes
+   * that rely on very fresh oldest txn timestamps
+   * @return timestamp that is no newer than the start time of any transaction alive
    */
   timestamp_t CachedOldestTransactionStartTime();
 
  private:
-  // TransactionManager needs to be able to use the curr_running_txns_latch to guard more than just the
-  // duration of the following method calls --- things such as adding to the GC queue needs to be atomic
-  // along with removing a transaction from the table of active transactions. We need this for correctness
-  // in the deferred action framework when dropping tables.
+  // TransactionManager needs to hand a transaction to the GC before the transaction is removed from the active txn
+  // set, as nothing else stops the oldest active transaction from moving past it in between. We need this for
+  // correctness in the deferred action framework when dropping tables: the GC could otherwise free a dropped table
+  // before it gets to unlink the records the transaction left in it.
   friend class TransactionManager;
   friend class storage::LogSerializerTask;
-  timestamp_t BeginTransaction() {
-    timestamp_t start_time;
-    {
-      common::SpinLatch::ScopedSpinLatch running_guard(&curr_running_txns_latch_);
-      // There is a three-way race that needs to be prevented.  Specifically, we
-      // cannot allow both a transaction to commit and the GC to poll for the
-      // oldest running transaction in between this transaction acquiring its
-      // begin timestamp and getting inserted into the current running
-      // transactions list.  Using the current running transactions latch
-      // prevents the GC from polling and stops the race.  This allows us to
-      // replace acquiring a shared instance of the commit latch with a
-      // read-only spin-latch and move the allocation out of a critical section.
-      start_time = time_++;
-
-      const auto ret UNUSED_ATTRIBUTE = curr_running_txns_.emplace(start_time);
-      TERRIER_ASSERT(ret.second, "commit start time should be globally unique");
-    }  // Release latch on current running transactions
-    return start_time;
+  // Published by a slot with no running transactions. Compares newer than any timestamp the clock will hand out.
+  static constexpr timestamp_t NO_ACTIVE_TXN = timestamp_t(INT64_MAX);
+
+  // Tracks the transactions begun by the threads assigned to the slot. Start times are only ever appended in increasing
+  // order, so the oldest one is always at the front. The latch is only contended by the threads sharing the slot and
+  // the log serializer, never by the GC.
+  struct alignas(common::Constants::CACHELINE_SIZE) Slot {
+    common::SpinLatch latch_;
+    // No transaction in the slot has started before this, or NO_ACTIVE_TXN if the slot is empty. Written under the
+    // latch, and read by the GC without it.
+    std::atomic<timestamp_t> oldest_{NO_ACTIVE_TXN};
+    std::deque<timestamp_t> start_times_;
+    // Epoch the slot last handed out a start time in, and the offset of the next one in the slot's range of it
+    timestamp_t epoch_ = INITIAL_TXN_TIMESTAMP;
+    uint64_t next_offset_ = 0;
+  };
+
+  /**
+   * Hands out a start timestamp to a new transaction, and adds it to the active txn set
+   * @param[out] slot index of the slot the transaction is tracked in, to be given back on removal
+   * @return start timestamp of the transaction
+   */
+  timestamp_t BeginTransaction(uint32_t *slot);
+
+  // Publishes the oldest start time left in the slot after a removal. Requires the slot's latch.
+  static void PublishOldest(Slot *slot) {
+    slot->oldest_.store(slot->start_times_.empty() ? NO_ACTIVE_TXN : slot->start_times_.front());
   }
 
   /**
-   * Remove a timestamp from active txn set
-   * @param timestamp timestamp to remove
+   * Remove a transaction from active txn set
+   * @param slot slot the transaction is tracked in
+   * @param timestamp start timestamp of the transaction
    */
-  void RemoveTransaction(timestamp_t timestamp);
+  void RemoveTransaction(uint32_t slot, timestamp_t timestamp);
 
   /**
-   * Bulk remove a set of timestamps from the active txn set. Only grabs the curr_running_txns_latch_ once for all the
-   * timestamps.
-   * @param timestamps vector of timestamps to remove
+   * Bulk remove a set of transactions from the active txn set. Only grabs each slot's latch once for all of its
+   * transactions.
+   * @param txns vector of the slots and start timestamps of the transactions to remove
    */
-  void RemoveTransactions(const std::vector<timestamp_t> &timestamps);
+  void RemoveTransactions(const std::vector<std::pair<uint32_t, timestamp_t>> &txns);
+
+  static uint32_t SlotIndex() {
+    static std::atomic<uint32_t> next_slot = 0;
+    thread_local const uint32_t slot = next_slot++ % NUM_SLOTS;
+    return slot;
+  }
 
-  // TODO(Tianyu): Timestamp generation needs to be more efficient (batches)
   // TODO(Tianyu): We don't handle timestamp wrap-arounds. I doubt this would be an issue any time soon.
+  // First timestamp of the current epoch. It only ever advances by whole epochs.
   std::atomic<timestamp_t> time_{INITIAL_TXN_TIMESTAMP};
   // We cache the oldest txn start time
   std::atomic<timestamp_t> cached_oldest_txn_start_time_{INITIAL_TXN_TIMESTAMP};
-  // TODO(Matt): consider a different data structure if this becomes a measured bottleneck
-  // TODO(Gus): This data structure initially only held items in the order of # of workers. With the logging change, it
-  // can hold many more, since txns are only removed when serialized. We should consider if there is a possible better
-  // data structure
-  std::unordered_set<timestamp_t> curr_running_txns_;
-  mutable common::SpinLatch curr_running_txns_latch_;
+  Slot slots_[NUM_SLOTS];
 };
 }  // namespace terrier::transaction
@@ -1,5 +1,7 @@
 #pragma once
+#include <stdexcept>
 #include <vector>
+#include "common/constants.h"
 #include "common/macros.h"
 #include "common/object_pool.h"
 #include "common/strong_typedef.h"
@@ -8,6 +10,7 @@
 #include "storage/storage_defs.h"
 #include "storage/tuple_access_strategy.h"
 #include "storage/undo_record.h"
+#include "storage/varlen_arena.h"
 #include "storage/write_ahead_log/log_record.h"
 #include "transaction/transaction_util.h"
 
@@ -52,7 +55,7 @@ class TransactionContext {
    * DataTable.
    */
   ~TransactionContext() {
-    for (const byte *ptr : loose_ptrs_) delete[] ptr;
+    for (const auto &entry : loose_ptrs_) storage::VarlenArena::Free(entry);
   }
 
   /**
@@ -76,6 +79,14 @@ class TransactionContext {
    */
   timestamp_t FinishTime() const { return finish_time_.load(); }
 
+  /**
+   * @return a lower bound on the start time of every transaction that runs alongside this one, taken from the oldest
+   * running transaction the system last polled for before this one began. Versions that were overwritten before this
+   * time are invisible to all of them. TransactionContexts generated outside of the TransactionManager have
+   * INITIAL_TXN_TIMESTAMP here, which bounds nothing.
+   */
+  timestamp_t OldestActiveStartTime() const { return oldest_active_start_time_; }
+
   /**
    * Reserve space on this transaction's undo buffer for a record to log the update given
    * @param table pointer to the updated DataTable object
@@ -86,7 +97,8 @@ class TransactionContext {
   storage::UndoRecord *UndoRecordForUpdate(storage::DataTable *const table, const storage::TupleSlot slot,
                                            const storage::ProjectedRow &redo) {
     const uint32_t size = storage::UndoRecord::Size(redo);
-    return storage::UndoRecord::InitializeUpdate(undo_buffer_.NewEntry(size), finish_time_.load(), slot, table, redo);
+    return storage::UndoRecord::InitializeUpdate(undo_buffer_.NewEntry(size), finish_time_.load(), slot, table, redo,
+                                                 &finish_time_);
   }
 
   /**
@@ -97,7 +109,25 @@ class TransactionContext {
    */
   storage::UndoRecord *UndoRecordForInsert(storage::DataTable *const table, const storage::TupleSlot slot) {
     byte *const result = undo_buffer_.NewEntry(sizeof(storage::UndoRecord));
-    return storage::UndoRecord::InitializeInsert(result, finish_time_.load(), slot, table);
+    return storage::UndoRecord::InitializeInsert(result, finish_time_.load(), slot, table, &finish_time_);
+  }
+
+  /**
+   * Reserve contiguous space on this transaction's undo buffer for records to log the inserts of a run of consecutive
+   * slots in a block. The run must be short enough for its records to fit in a single buffer segment.
+   * @param table pointer to the updated DataTable object
+   * @param first the first TupleSlot inserted
+   * @param num_slots number of slots in the run
+   * @return a persistent pointer to the first of num_slots consecutive undo records, one for each slot in order
+   */
+  storage::UndoRecord *UndoRecordsForInsert(storage::DataTable *const table, const storage::TupleSlot first,
+                                            const uint32_t num_slots) {
+    auto *const result = reinterpret_cast<storage::UndoRecord *>(
+        undo_buffer_.NewEntry(static_cast<uint32_t>(sizeof(storage::UndoRecord)) * num_slots));
+    for (uint32_t i = 0; i < num_slots; i++)
+      storage::UndoRecord::InitializeInsert(reinterpret_cast<byte *>(result + i), finish_time_.load(),
+                                            {first.GetBlock(), first.GetOffset() + i}, table, &finish_time_);
+    return result;
   }
 
   /**
@@ -108,7 +138,7 @@ class TransactionContext {
    */
   storage::UndoRecord *UndoRecordForDelete(storage::DataTable *const table, const storage::TupleSlot slot) {
     byte *const result = undo_buffer_.NewEntry(sizeof(storage::UndoRecord));
-    return storage::UndoRecord::InitializeDelete(result, finish_time_.load(), slot, table);
+    return storage::UndoRecord::InitializeDelete(result, finish_time_.load(), slot, table, &finish_time_);
   }
 
   /**
@@ -132,6 +162,27 @@ class TransactionContext {
     return log_record->GetUnderlyingRecordBodyAs<storage::RedoRecord>();
   }
 
+  /**
+   * Expose a record that can hold a batch of inserted tuples, described by the initializer given, that will be logged
+   * out to disk. The tuples must be written in this space and then inserted into the SqlTable with InsertBatch.
+   * @param db_oid the database oid that this record changes
+   * @param table_oid the table oid that this record changes
+   * @param initializer the initializer to use for the underlying record. The record must fit into a single buffer
+   * segment, which bounds the number of tuples in the batch (see SqlTable::InitializerForBatchInsert).
+   * @return pointer to the initialized batched redo record.
+   * @throw std::runtime_error if the record does not fit into a buffer segment. Nothing is staged in that case.
+   * @warning The same warnings as StageWrite apply.
+   */
+  storage::BatchRedoRecord *StageBatchWrite(const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid,
+                                            const storage::ProjectedColumnsInitializer &initializer) {
+    const uint32_t size = storage::BatchRedoRecord::Size(initializer);
+    if (size > common::Constants::BUFFER_SEGMENT_SIZE)
+      throw std::runtime_error("Batch of inserted tuples does not fit into a redo buffer segment");
+    auto *const log_record =
+        storage::BatchRedoRecord::Initialize(redo_buffer_.NewEntry(size), start_time_, db_oid, table_oid, initializer);
+    return log_record->GetUnderlyingRecordBodyAs<storage::BatchRedoRecord>();
+  }
+
   /**
    * Initialize a record that logs a delete, that will be logged out to disk
    * @param db_oid the database oid that this record changes
@@ -146,6 +197,16 @@ class TransactionContext {
     storage::DeleteRecord::Initialize(redo_buffer_.NewEntry(size), start_time_, db_oid, table_oid, slot);
   }
 
+  /**
+   * Allocates a buffer for a varlen value, too large to be inlined, that the transaction is about to write. Buffers
+   * are carved out of an arena of the transaction, and are wrapped with VarlenEntry::CreateFromArena. Once the value
+   * is written, the storage engine takes ownership of the buffer. A buffer that ends up not being written needs to be
+   * freed with VarlenArena::Free.
+   * @param size size of the value, in bytes
+   * @return the buffer to hold the value
+   */
+  byte *AllocateVarlen(const uint32_t size) { return varlen_arena_.Allocate(size); }
+
   // TODO(Tianyu): We need to discuss what happens to the loose_ptrs field now that we have deferred actions.
   /**
    * @return whether the transaction is read-only
@@ -201,11 +262,15 @@ class TransactionContext {
   friend class storage::RecoveryTests;           // Needs access to redo buffer
   const timestamp_t start_time_;
   std::atomic<timestamp_t> finish_time_;
+  // Slot of the TimestampManager's active txn set this transaction is tracked in
+  uint32_t active_txn_slot_ = 0;
+  timestamp_t oldest_active_start_time_ = INITIAL_TXN_TIMESTAMP;
   storage::UndoBuffer undo_buffer_;
   storage::RedoBuffer redo_buffer_;
   // TODO(Tianyu): Maybe not so much of a good idea to do this. Make explicit queue in GC?
   //
-  std::vector<const byte *> loose_ptrs_;
+  std::vector<storage::VarlenEntry> loose_ptrs_;
+  storage::VarlenArena varlen_arena_;
 
   // These actions will be triggered (not deferred) at abort/commit.
   std::forward_list<TransactionEndAction> abort_actions_;
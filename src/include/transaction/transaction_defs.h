@@ -14,6 +14,10 @@ static constexpr timestamp_t INVALID_TXN_TIMESTAMP = timestamp_t(INT64_MIN);
 // First txn timestamp that can be given out by the txn manager
 static constexpr timestamp_t INITIAL_TXN_TIMESTAMP = timestamp_t(0);
 
+// Finish time of a transaction that is checking out its commit timestamp. The clock never gets this far, so it is not
+// a valid commit timestamp, and is not a valid txn id either.
+static constexpr timestamp_t COMMITTING_TXN_TIMESTAMP = timestamp_t(INT64_MAX);
+
 class TransactionContext;
 class DeferredActionManager;
 
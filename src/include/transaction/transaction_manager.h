@@ -2,7 +2,7 @@
 #include <queue>
 #include <unordered_set>
 #include <utility>
-#include "common/gate.h"
+#include "common/container/concurrent_queue.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
 #include "di/di_help.h"
@@ -72,8 +72,8 @@ class TransactionManager {
   bool GCEnabled() const { return gc_enabled_; }
 
   /**
-   * Return a copy of the completed txns queue and empty the local version
-   * @return copy of the completed txns for the GC to process
+   * Drain the completed txns queue
+   * @return the completed txns for the GC to process, newest first
    */
   TransactionQueue CompletedTransactionsForGC();
 
@@ -82,10 +82,9 @@ class TransactionManager {
   DeferredActionManager *deferred_action_manager_;
   storage::RecordBufferSegmentPool *buffer_pool_;
 
-  common::Gate txn_gate_;
-
   bool gc_enabled_ = false;
-  TransactionQueue completed_txns_;
+  // Finished txns waiting to be handed to the GC. Workers only ever enqueue, and the GC drains it.
+  common::ConcurrentQueue<TransactionContext *> completed_txns_;
   storage::LogManager *const log_manager_;
 
   timestamp_t UpdatingCommitCriticalSection(TransactionContext *txn);
@@ -40,12 +40,36 @@ DBMain::DBMain(std::unordered_map<settings::Param, settings::ParamInfo> &&param_
   log_manager_->Start();
 
   timestamp_manager_ = new transaction::TimestampManager;
-  txn_manager_ =
-      new transaction::TransactionManager(timestamp_manager_, DISABLED, buffer_segment_pool_, true, log_manager_);
-  garbage_collector_ = new storage::GarbageCollector(timestamp_manager_, DISABLED, txn_manager_, DISABLED);
+  deferred_action_manager_ = new transaction::DeferredActionManager(timestamp_manager_);
+  txn_manager_ = new transaction::TransactionManager(timestamp_manager_, deferred_action_manager_,
+                                                     buffer_segment_pool_, true, log_manager_);
+
+  // Freezing cold blocks is off unless there are compactor threads to do it
+  const auto num_compactor_workers = settings_manager_->GetInt(settings::Param::compactor_num_workers);
+  if (num_compactor_workers > 0) {
+    block_compactor_ = new storage::BlockCompactor(common::ManagedPointer(thread_registry_));
+    // Frozen blocks stay in memory unless they are to be evicted after some time
+    const auto evictor_idle_threshold = settings_manager_->GetInt(settings::Param::block_evictor_idle_threshold);
+    if (evictor_idle_threshold > 0)
+      block_evictor_ = new storage::BlockEvictor(
+          settings_manager_->GetString(settings::Param::block_file_path), static_cast<uint32_t>(evictor_idle_threshold),
+          static_cast<uint32_t>(settings_manager_->GetInt(settings::Param::block_evictor_max_evictions_per_pass)));
+    access_observer_ = new storage::AccessObserver(
+        block_compactor_, static_cast<uint32_t>(settings_manager_->GetInt(settings::Param::cold_data_epoch_threshold)),
+        block_evictor_);
+  }
+  garbage_collector_ =
+      new storage::GarbageCollector(timestamp_manager_, deferred_action_manager_, txn_manager_, access_observer_);
+  garbage_collector_->SetNumWorkers(settings_manager_->GetInt(settings::Param::gc_num_workers));
   gc_thread_ = new storage::GarbageCollectorThread(garbage_collector_,
                                                    std::chrono::milliseconds{type::TransientValuePeeker::PeekInteger(
-                                                       param_map_.find(settings::Param::gc_interval)->second.value_)});
+                                                       param_map_.find(settings::Param::gc_interval)->second.value_)},
+                                                   common::ManagedPointer(metrics_manager_));
+  if (block_compactor_ != nullptr)
+    block_compactor_->StartWorkers(
+        static_cast<uint32_t>(num_compactor_workers),
+        std::chrono::milliseconds{settings_manager_->GetInt(settings::Param::compactor_interval)},
+        deferred_action_manager_, txn_manager_);
 
   thread_pool_ = new common::WorkerPool(
       type::TransientValuePeeker::PeekInteger(param_map_.find(settings::Param::num_worker_threads)->second.value_), {});
@@ -87,6 +111,7 @@ void DBMain::ForceShutdown() {
 
 void DBMain::CleanUp() {
   main_stat_reg_->Shutdown(false);
+  if (block_compactor_ != nullptr) block_compactor_->StopWorkers();
   log_manager_->PersistAndStop();
   thread_pool_->Shutdown();
   LOG_INFO("Terrier has shut down.");
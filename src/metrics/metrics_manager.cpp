@@ -57,6 +57,16 @@ void MetricsManager::ResetMetric(const MetricsComponent component) const {
         metric->Swap();
         break;
       }
+      case MetricsComponent::COMPACTION: {
+        const auto &metric = metrics_store.second->compaction_metric_;
+        metric->Swap();
+        break;
+      }
+      case MetricsComponent::GARBAGECOLLECTION: {
+        const auto &metric = metrics_store.second->gc_metric_;
+        metric->Swap();
+        break;
+      }
     }
   }
 }
@@ -96,6 +106,14 @@ void MetricsManager::ToCSV() const {
           OpenFiles<TransactionMetricRawData>(&outfiles);
           break;
         }
+        case MetricsComponent::COMPACTION: {
+          OpenFiles<CompactionMetricRawData>(&outfiles);
+          break;
+        }
+        case MetricsComponent::GARBAGECOLLECTION: {
+          OpenFiles<GarbageCollectionMetricRawData>(&outfiles);
+          break;
+        }
       }
       aggregated_metrics_[component]->ToCSV(&outfiles);
       for (auto &file : outfiles) {
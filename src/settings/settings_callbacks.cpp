@@ -36,6 +36,14 @@ void Callbacks::WorkerPoolThreads(void *const old_value, void *const new_value,
   action_context->SetState(common::ActionState::SUCCESS);
 }
 
+void Callbacks::GCNumWorkers(void *const old_value, void *const new_value, DBMain *const db_main,
+                             const std::shared_ptr<common::ActionContext> &action_context) {
+  action_context->SetState(common::ActionState::IN_PROGRESS);
+  int num_workers = *static_cast<int *>(new_value);
+  db_main->garbage_collector_->SetNumWorkers(num_workers);
+  action_context->SetState(common::ActionState::SUCCESS);
+}
+
 void Callbacks::NumLogManagerBuffers(void *const old_value, void *const new_value, DBMain *const db_main,
                                      const std::shared_ptr<common::ActionContext> &action_context) {
   action_context->SetState(common::ActionState::IN_PROGRESS);
@@ -69,4 +77,26 @@ void Callbacks::MetricsTransaction(void *const old_value, void *const new_value,
   action_context->SetState(common::ActionState::SUCCESS);
 }
 
+void Callbacks::MetricsCompaction(void *const old_value, void *const new_value, DBMain *const db_main,
+                                  const std::shared_ptr<common::ActionContext> &action_context) {
+  action_context->SetState(common::ActionState::IN_PROGRESS);
+  bool new_status = *static_cast<bool *>(new_value);
+  if (new_status)
+    db_main->metrics_manager_->EnableMetric(metrics::MetricsComponent::COMPACTION);
+  else
+    db_main->metrics_manager_->DisableMetric(metrics::MetricsComponent::COMPACTION);
+  action_context->SetState(common::ActionState::SUCCESS);
+}
+
+void Callbacks::MetricsGC(void *const old_value, void *const new_value, DBMain *const db_main,
+                          const std::shared_ptr<common::ActionContext> &action_context) {
+  action_context->SetState(common::ActionState::IN_PROGRESS);
+  bool new_status = *static_cast<bool *>(new_value);
+  if (new_status)
+    db_main->metrics_manager_->EnableMetric(metrics::MetricsComponent::GARBAGECOLLECTION);
+  else
+    db_main->metrics_manager_->DisableMetric(metrics::MetricsComponent::GARBAGECOLLECTION);
+  action_context->SetState(common::ActionState::SUCCESS);
+}
+
 }  // namespace terrier::settings
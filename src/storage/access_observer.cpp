@@ -1,23 +1,88 @@
 #include "storage/access_observer.h"
+#include <algorithm>
 #include "storage/block_compactor.h"
+#include "storage/block_evictor.h"
+#include "storage/data_table.h"
 
 namespace terrier::storage {
 void AccessObserver::ObserveGCInvocation() {
+  // The evictor writes blocks out, which is too slow to do while holding the latch
+  if (evictor_ != nullptr) evictor_->ObserveGCInvocation();
+  common::SpinLatch::ScopedSpinLatch guard(&latch_);
   gc_epoch_++;
-  for (auto it = last_touched_.begin(), end = last_touched_.end(); it != end;) {
-    if (it->second + COLD_DATA_EPOCH_THRESHOLD < gc_epoch_) {
-      compactor_->PutInQueue(it->first);
-      it = last_touched_.erase(it);
+  auto it = watched_blocks_.begin();
+  for (RawBlock *block : watched_blocks_) {
+    BlockAccessStats &stats = block->access_stats_;
+    const uint32_t idle_epochs = Epoch() - stats.last_write_epoch_;
+    if (idle_epochs > Threshold(&Policy(block->data_table_)) && DecayedHeat(stats) <= COLD_HEAT_LIMIT) {
+      stats.flags_ = static_cast<uint16_t>((stats.flags_ & ~WATCHED) | QUEUED);
+      compactor_->PutInQueue(block);
+      if (evictor_ != nullptr) evictor_->WatchBlock(block);
     } else {
-      ++it;
+      *it++ = block;
     }
   }
+  watched_blocks_.erase(it, watched_blocks_.end());
 }
 
 void AccessObserver::ObserveWrite(RawBlock *block) {
+  common::SpinLatch::ScopedSpinLatch guard(&latch_);
+  BlockAccessStats &stats = block->access_stats_;
+  // The writes of the compactor itself leave the block cooling or frozen. Any other write brings the block back to hot.
+  const bool hot = block->controller_.GetBlockState()->load() == BlockState::HOT;
+  if (stats.flags_ & QUEUED) {
+    stats.flags_ = static_cast<uint16_t>(stats.flags_ & ~QUEUED);
+    // The block was written to after we sent it to the compactor, which undid the work of the compactor.
+    if (hot) {
+      TablePolicy &policy = Policy(block->data_table_);
+      policy.backoff_ = std::min<uint8_t>(static_cast<uint8_t>(policy.backoff_ + 1), MAX_THRASH_BACKOFF);
+      policy.last_thrash_epoch_ = Epoch();
+    }
+  }
+
   // The compactor is only concerned with blocks that are already full. We assume that partially empty blocks are
   // always hot.
-  if (block->GetInsertHead() == block->data_table_->GetBlockLayout().NumSlots()) last_touched_[block] = gc_epoch_;
+  if (block->GetInsertHead() != block->data_table_->GetBlockLayout().NumSlots()) return;
+  const uint16_t heat = DecayedHeat(stats);
+  stats.heat_ = !hot || heat == UINT16_MAX ? heat : static_cast<uint16_t>(heat + 1);
+  stats.last_write_epoch_ = Epoch();
+  if (!(stats.flags_ & WATCHED)) {
+    stats.flags_ = static_cast<uint16_t>(stats.flags_ | WATCHED);
+    watched_blocks_.push_back(block);
+  }
+}
+
+void AccessObserver::SetTableColdThreshold(const DataTable *const table, const uint32_t cold_threshold) {
+  common::SpinLatch::ScopedSpinLatch guard(&latch_);
+  Policy(table).threshold_override_ = cold_threshold;
+}
+
+uint32_t AccessObserver::TableColdThreshold(const DataTable *const table) {
+  common::SpinLatch::ScopedSpinLatch guard(&latch_);
+  return Threshold(&Policy(table));
+}
+
+void AccessObserver::ForgetBlock(RawBlock *const block) {
+  common::SpinLatch::ScopedSpinLatch guard(&latch_);
+  BlockAccessStats &stats = block->access_stats_;
+  if (stats.flags_ & WATCHED)
+    watched_blocks_.erase(std::find(watched_blocks_.begin(), watched_blocks_.end(), block));
+  stats.flags_ = 0;
+}
+
+uint32_t AccessObserver::Threshold(TablePolicy *const policy) {
+  const uint32_t base = policy->threshold_override_ == 0 ? cold_threshold_ : policy->threshold_override_;
+  // Lift one level of back-off for every few thresholds' worth of GC invocations without thrashing
+  if (policy->backoff_ > 0 && Epoch() - policy->last_thrash_epoch_ > 4 * (base << policy->backoff_)) {
+    policy->backoff_--;
+    policy->last_thrash_epoch_ = Epoch();
+  }
+  return base << policy->backoff_;
+}
+
+uint16_t AccessObserver::DecayedHeat(const BlockAccessStats &stats) const {
+  const uint32_t half_lives = (Epoch() - stats.last_write_epoch_) / HEAT_HALF_LIFE;
+  return half_lives >= 16 ? 0 : static_cast<uint16_t>(stats.heat_ >> half_lives);
 }
 
 }  // namespace terrier::storage
@@ -0,0 +1,227 @@
+#include "storage/arrow_block_metadata.h"
+#include <emmintrin.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace terrier::storage {
+
+namespace {
+// Values are packed least significant bit first into an array of 64-bit words, and may straddle two words
+uint32_t PackedWords(const uint32_t num_values, const uint8_t bit_width) {
+  return static_cast<uint32_t>((static_cast<uint64_t>(num_values) * bit_width + 63) / 64);
+}
+
+void PackValue(uint64_t *const words, const uint32_t pos, const uint8_t bit_width, const uint64_t value) {
+  const uint64_t bit = static_cast<uint64_t>(pos) * bit_width;
+  const auto word = static_cast<uint32_t>(bit / 64), shift = static_cast<uint32_t>(bit % 64);
+  words[word] |= value << shift;
+  if (shift + bit_width > 64) words[word + 1] |= value >> (64 - shift);
+}
+
+uint64_t UnpackValue(const uint64_t *const words, const uint32_t pos, const uint8_t bit_width, const uint64_t mask) {
+  const uint64_t bit = static_cast<uint64_t>(pos) * bit_width;
+  const auto word = static_cast<uint32_t>(bit / 64), shift = static_cast<uint32_t>(bit % 64);
+  uint64_t value = words[word] >> shift;
+  if (shift + bit_width > 64) value |= words[word + 1] << (64 - shift);
+  return value & mask;
+}
+
+uint8_t MinBitWidth(const uint64_t max_value) {
+  return max_value == 0 ? 0 : static_cast<uint8_t>(64 - __builtin_clzll(max_value));
+}
+}  // namespace
+
+ArrowEncodedColumn *ArrowEncodedColumn::Encode(const uint8_t attr_size, const byte *const values,
+                                               const common::RawConcurrentBitmap *const nulls,
+                                               const uint32_t num_values) {
+  switch (attr_size) {
+    case sizeof(int8_t):
+      return EncodeImpl(reinterpret_cast<const int8_t *>(values), nulls, num_values);
+    case sizeof(int16_t):
+      return EncodeImpl(reinterpret_cast<const int16_t *>(values), nulls, num_values);
+    case sizeof(int32_t):
+      return EncodeImpl(reinterpret_cast<const int32_t *>(values), nulls, num_values);
+    case sizeof(int64_t):
+      return EncodeImpl(reinterpret_cast<const int64_t *>(values), nulls, num_values);
+    default:
+      throw std::runtime_error("unexpected attribute size");
+  }
+}
+
+void ArrowEncodedColumn::Decode(const uint32_t start, const uint32_t num_values, byte *const out) const {
+  TERRIER_ASSERT(start + num_values <= num_values_, "decoding past the end of the column");
+  switch (attr_size_) {
+    case sizeof(int8_t):
+      DecodeImpl(start, num_values, reinterpret_cast<int8_t *>(out));
+      break;
+    case sizeof(int16_t):
+      DecodeImpl(start, num_values, reinterpret_cast<int16_t *>(out));
+      break;
+    case sizeof(int32_t):
+      DecodeImpl(start, num_values, reinterpret_cast<int32_t *>(out));
+      break;
+    case sizeof(int64_t):
+      DecodeImpl(start, num_values, reinterpret_cast<int64_t *>(out));
+      break;
+    default:
+      throw std::runtime_error("unexpected attribute size");
+  }
+}
+
+template <class T>
+ArrowEncodedColumn *ArrowEncodedColumn::EncodeImpl(const T *const values,
+                                                   const common::RawConcurrentBitmap *const nulls,
+                                                   const uint32_t num_values) {
+  if (num_values == 0) return nullptr;
+  // Gather the statistics of every candidate encoding in a single pass. Null slots hold garbage, so they extend
+  // whatever run they are in and are packed as the reference value.
+  T min = std::numeric_limits<T>::max(), max = std::numeric_limits<T>::min();
+  uint32_t num_runs = 0;
+  T run_value = 0;
+  for (uint32_t i = 0; i < num_values; i++) {
+    if (!nulls->Test(i)) continue;
+    min = std::min(min, values[i]);
+    max = std::max(max, values[i]);
+    if (num_runs == 0 || values[i] != run_value) {
+      num_runs++;
+      run_value = values[i];
+    }
+  }
+  // Every value is null, any value will do
+  if (min > max) min = max = 0;
+  if (num_runs == 0) num_runs = 1;
+
+  const auto range =
+      static_cast<uint64_t>(static_cast<int64_t>(max)) - static_cast<uint64_t>(static_cast<int64_t>(min));
+  const uint8_t for_width = MinBitWidth(range);
+  const uint8_t packed_width = min < 0 ? std::numeric_limits<uint8_t>::max() : MinBitWidth(static_cast<uint64_t>(max));
+
+  const uint64_t plain_size = static_cast<uint64_t>(num_values) * sizeof(T);
+  const uint64_t rle_size = static_cast<uint64_t>(num_runs) * (sizeof(T) + sizeof(uint32_t));
+  const uint64_t for_size = PackedWords(num_values, for_width) * sizeof(uint64_t);
+  if (std::min(rle_size, for_size) >= plain_size) return nullptr;
+
+  if (rle_size < for_size) {
+    auto *result = new ArrowEncodedColumn(ArrowColumnEncoding::RUN_LENGTH, sizeof(T), num_values);
+    result->num_runs_ = num_runs;
+    result->data_length_ = static_cast<uint32_t>(rle_size);
+    result->data_ = common::AllocationUtil::AllocateAligned(result->data_length_);
+    auto *run_values = reinterpret_cast<T *>(result->data_);
+    auto *run_ends = reinterpret_cast<uint32_t *>(result->data_ + num_runs * sizeof(T));
+    uint32_t run = 0;
+    for (uint32_t i = 0; i < num_values; i++) {
+      if (!nulls->Test(i)) continue;
+      if (run > 0 && values[i] == run_values[run - 1]) continue;
+      // The previous run, along with any nulls after it, ends where this value starts
+      if (run > 0) run_ends[run - 1] = i;
+      run_values[run++] = values[i];
+    }
+    if (run == 0) run_values[run++] = 0;
+    run_ends[run - 1] = num_values;
+    TERRIER_ASSERT(run == num_runs, "number of runs should not change between passes");
+    return result;
+  }
+
+  // Bit-packing can never be smaller than frame-of-reference, but it is cheaper to decode if it is as small
+  const bool bit_packed = packed_width <= for_width;
+  auto *result = new ArrowEncodedColumn(
+      bit_packed ? ArrowColumnEncoding::BIT_PACKED : ArrowColumnEncoding::FRAME_OF_REFERENCE, sizeof(T), num_values);
+  result->reference_ = bit_packed ? 0 : min;
+  result->bit_width_ = bit_packed ? packed_width : for_width;
+  result->data_length_ = static_cast<uint32_t>(PackedWords(num_values, result->bit_width_) * sizeof(uint64_t));
+  result->data_ = common::AllocationUtil::AllocateAligned(result->data_length_);
+  std::memset(result->data_, 0, result->data_length_);
+  if (result->bit_width_ == 0) return result;
+  auto *words = reinterpret_cast<uint64_t *>(result->data_);
+  const auto reference = static_cast<uint64_t>(result->reference_);
+  for (uint32_t i = 0; i < num_values; i++) {
+    if (!nulls->Test(i)) continue;
+    PackValue(words, i, result->bit_width_, static_cast<uint64_t>(static_cast<int64_t>(values[i])) - reference);
+  }
+  return result;
+}
+
+template <class T>
+void ArrowEncodedColumn::DecodeImpl(const uint32_t start, const uint32_t num_values, T *const out) const {
+  const uint32_t end = start + num_values;
+  switch (encoding_) {
+    case ArrowColumnEncoding::RUN_LENGTH: {
+      const auto *run_values = reinterpret_cast<const T *>(data_);
+      const auto *run_ends = reinterpret_cast<const uint32_t *>(data_ + num_runs_ * sizeof(T));
+      // The first run that ends after start is the one start falls in
+      auto run = static_cast<uint32_t>(std::upper_bound(run_ends, run_ends + num_runs_, start) - run_ends);
+      for (uint32_t pos = start; pos < end; run++) {
+        const T value = run_values[run];
+        const uint32_t run_end = std::min(run_ends[run], end);
+        // Plain fill loop, which the compiler turns into vector stores
+        for (uint32_t i = pos; i < run_end; i++) out[i - start] = value;
+        pos = run_end;
+      }
+      break;
+    }
+    case ArrowColumnEncoding::FRAME_OF_REFERENCE:
+    case ArrowColumnEncoding::BIT_PACKED: {
+      const auto reference = static_cast<uint64_t>(reference_);
+      if (bit_width_ == 0) {
+        for (uint32_t i = 0; i < num_values; i++) out[i] = static_cast<T>(reference_);
+        break;
+      }
+      const auto *words = reinterpret_cast<const uint64_t *>(data_);
+      const uint64_t mask = bit_width_ == 64 ? ~0ULL : (1ULL << bit_width_) - 1;
+      for (uint32_t i = start; i < end; i++)
+        out[i - start] = static_cast<T>(static_cast<int64_t>(reference + UnpackValue(words, i, bit_width_, mask)));
+      break;
+    }
+    default:
+      throw std::runtime_error("unexpected control flow");
+  }
+}
+
+uintptr_t ArrowColumnInfo::LockEncodedColumn() {
+  uintptr_t current = encoded_column_.load();
+  while (true) {
+    // Nothing to lock if there is no encoded copy, which can only come back while the block is freezing
+    if (current == 0) return current;
+    if ((current & ENCODED_COLUMN_LOCKED) != 0) {
+      _mm_pause();
+      current = encoded_column_.load();
+      continue;
+    }
+    if (encoded_column_.compare_exchange_weak(current, current | ENCODED_COLUMN_LOCKED)) return current;
+  }
+}
+
+void ArrowColumnInfo::ReleasePlainColumn(const ArrowEncodedColumn *const encoded, byte *const values,
+                                         const uint64_t size) {
+  const uintptr_t current = LockEncodedColumn();
+  if (current == 0) return;
+  if ((current & ~ENCODED_COLUMN_FLAGS) != reinterpret_cast<uintptr_t>(encoded)) {
+    // A writer thawed the column and the compactor encoded it again since, the newer copy is released on its own
+    encoded_column_.store(current);
+    return;
+  }
+  // Only whole pages can be given back, the partial pages at either end stay in place
+  const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const uintptr_t start = (reinterpret_cast<uintptr_t>(values) + page_size - 1) & ~(page_size - 1);
+  const uintptr_t end = (reinterpret_cast<uintptr_t>(values) + size) & ~(page_size - 1);
+  if (start < end && madvise(reinterpret_cast<void *>(start), end - start, MADV_DONTNEED) == 0)
+    encoded_column_.store(current | ENCODED_COLUMN_RELEASED);
+  else
+    encoded_column_.store(current);
+}
+
+ArrowEncodedColumn *ArrowColumnInfo::Thaw(byte *const values) {
+  const uintptr_t current = LockEncodedColumn();
+  if (current == 0) return nullptr;
+  auto *encoded = reinterpret_cast<ArrowEncodedColumn *>(current & ~ENCODED_COLUMN_FLAGS);
+  // Released pages read back as zeros (or as the evicted file), and the values have to be put back before anyone
+  // reads the column from the block again. Only the values are decoded, the null bitmap was never released.
+  if ((current & ENCODED_COLUMN_RELEASED) != 0) encoded->Decode(0, encoded->NumValues(), values);
+  encoded_column_.store(0);
+  return encoded;
+}
+
+}  // namespace terrier::storage
@@ -0,0 +1,477 @@
+#include "storage/arrow_ipc_writer.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "storage/arrow_block_metadata.h"
+#include "storage/data_table.h"
+#include "storage/write_ahead_log/log_io.h"
+#include "type/type_util.h"
+
+namespace terrier::storage {
+namespace {
+// Values from the Arrow flatbuffer schemas (Schema.fbs, Message.fbs and File.fbs)
+constexpr int16_t METADATA_VERSION_V5 = 4;
+constexpr int16_t ENDIANNESS_LITTLE = 0;
+constexpr int16_t PRECISION_DOUBLE = 2;
+constexpr uint8_t HEADER_SCHEMA = 1;
+constexpr uint8_t HEADER_RECORD_BATCH = 3;
+constexpr uint8_t TYPE_INT = 2;
+constexpr uint8_t TYPE_FLOATING_POINT = 3;
+constexpr uint8_t TYPE_BINARY = 4;
+constexpr uint8_t TYPE_UTF8 = 5;
+constexpr uint8_t TYPE_BOOL = 6;
+
+constexpr char MAGIC[] = "ARROW1";
+constexpr uint32_t CONTINUATION = UINT32_MAX;
+// Every message and every buffer in a message body starts at a multiple of this
+constexpr uint64_t ALIGNMENT = 8;
+const uint8_t ZEROS[ALIGNMENT] = {};
+
+uint64_t Padding(const uint64_t size) { return (ALIGNMENT - size % ALIGNMENT) % ALIGNMENT; }
+
+iovec MakeIovec(const void *base, const uint64_t len) { return {const_cast<void *>(base), len}; }
+
+/*
+ * A bare-bones flatbuffer builder, with just enough to encode the Arrow metadata. Like the flatbuffers library, it
+ * builds the buffer back to front, so that every object is written before the objects that refer to it, and refers
+ * to objects by their distance from the end of the buffer. The bytes are kept in reverse order until Finish.
+ */
+class FlatBufferBuilder {
+ public:
+  uint32_t Size() const { return static_cast<uint32_t>(bytes_.size()); }
+
+  template <class T>
+  void Add(const T value) {
+    Align(sizeof(T));
+    PushBytes(&value, sizeof(T));
+  }
+
+  uint32_t AddOffset(const uint32_t offset) {
+    Align(sizeof(uint32_t));
+    // Offsets are relative to where they are stored
+    Add<uint32_t>(Size() + static_cast<uint32_t>(sizeof(uint32_t)) - offset);
+    return Size();
+  }
+
+  uint32_t CreateString(const std::string &str) {
+    PreAlign(str.size() + 1, sizeof(uint32_t));
+    bytes_.push_back(0);
+    PushBytes(str.data(), str.size());
+    Add<uint32_t>(static_cast<uint32_t>(str.size()));
+    return Size();
+  }
+
+  uint32_t CreateOffsetVector(const std::vector<uint32_t> &offsets) {
+    PreAlign(offsets.size() * sizeof(uint32_t), sizeof(uint32_t));
+    for (auto it = offsets.rbegin(); it != offsets.rend(); ++it) AddOffset(*it);
+    Add<uint32_t>(static_cast<uint32_t>(offsets.size()));
+    return Size();
+  }
+
+  template <class T>
+  uint32_t CreateStructVector(const T *const structs, const size_t num_structs) {
+    PreAlign(num_structs * sizeof(T), std::max(alignof(T), sizeof(uint32_t)));
+    PushBytes(structs, num_structs * sizeof(T));
+    Add<uint32_t>(static_cast<uint32_t>(num_structs));
+    return Size();
+  }
+
+  void StartTable() {
+    fields_.clear();
+    table_start_ = Size();
+  }
+
+  template <class T>
+  void AddField(const uint16_t slot, const T value) {
+    Add<T>(value);
+    fields_.emplace_back(slot, Size());
+  }
+
+  void AddOffsetField(const uint16_t slot, const uint32_t offset) { fields_.emplace_back(slot, AddOffset(offset)); }
+
+  uint32_t EndTable() {
+    Add<int32_t>(0);  // offset to the vtable, filled in below
+    const uint32_t table = Size();
+    uint16_t num_slots = 0;
+    for (const auto &field : fields_) num_slots = std::max(num_slots, static_cast<uint16_t>(field.first + 1));
+    std::vector<uint16_t> vtable(num_slots, 0);
+    for (const auto &field : fields_) vtable[field.first] = static_cast<uint16_t>(table - field.second);
+    for (auto it = vtable.rbegin(); it != vtable.rend(); ++it) Add<uint16_t>(*it);
+    Add<uint16_t>(static_cast<uint16_t>(table - table_start_));
+    Add<uint16_t>(static_cast<uint16_t>(sizeof(uint16_t) * (num_slots + 2)));
+    // The vtable sits right in front of the table
+    const auto vtable_offset = static_cast<int32_t>(Size() - table);
+    for (uint32_t i = 0; i < sizeof(int32_t); i++)
+      bytes_[table - 1 - i] = reinterpret_cast<const uint8_t *>(&vtable_offset)[i];
+    return table;
+  }
+
+  std::vector<uint8_t> Finish(const uint32_t root) {
+    PreAlign(sizeof(uint32_t), max_align_);
+    AddOffset(root);
+    return {bytes_.rbegin(), bytes_.rend()};
+  }
+
+ private:
+  void PushBytes(const void *const data, const size_t size) {
+    for (size_t i = size; i > 0; i--) bytes_.push_back(reinterpret_cast<const uint8_t *>(data)[i - 1]);
+  }
+
+  void Align(const size_t alignment) { PreAlign(0, alignment); }
+
+  // Pads the buffer so that it is aligned after the given number of bytes are added
+  void PreAlign(const size_t size, const size_t alignment) {
+    max_align_ = std::max(max_align_, alignment);
+    bytes_.resize(bytes_.size() + (alignment - (bytes_.size() + size) % alignment) % alignment, 0);
+  }
+
+  std::vector<uint8_t> bytes_;
+  size_t max_align_ = 1;
+  uint32_t table_start_ = 0;
+  std::vector<std::pair<uint16_t, uint32_t>> fields_;
+};
+
+uint32_t CreateIntType(FlatBufferBuilder *const fbb, const int32_t bit_width, const bool is_signed) {
+  fbb->StartTable();
+  fbb->AddField<int32_t>(0, bit_width);
+  fbb->AddField<uint8_t>(1, static_cast<uint8_t>(is_signed));
+  return fbb->EndTable();
+}
+
+uint32_t CreateField(FlatBufferBuilder *const fbb, const ArrowIpcWriter::Field &field) {
+  const uint32_t name = fbb->CreateString(field.name_);
+  uint8_t type_type;
+  uint32_t type;
+  switch (field.type_) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY:
+      type_type = field.type_ == type::TypeId::BOOLEAN ? TYPE_BOOL
+                                                       : field.type_ == type::TypeId::VARCHAR ? TYPE_UTF8 : TYPE_BINARY;
+      fbb->StartTable();
+      type = fbb->EndTable();
+      break;
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      type_type = TYPE_INT;
+      type = CreateIntType(fbb, BYTE_SIZE * type::TypeUtil::GetTypeSize(field.type_), true);
+      break;
+    case type::TypeId::DATE:
+    case type::TypeId::TIMESTAMP:
+      type_type = TYPE_INT;
+      type = CreateIntType(fbb, BYTE_SIZE * type::TypeUtil::GetTypeSize(field.type_), false);
+      break;
+    case type::TypeId::DECIMAL:
+      type_type = TYPE_FLOATING_POINT;
+      fbb->StartTable();
+      fbb->AddField<int16_t>(0, PRECISION_DOUBLE);
+      type = fbb->EndTable();
+      break;
+    default:
+      throw std::runtime_error("Cannot export column of type " + type::TypeUtil::TypeIdToString(field.type_));
+  }
+  // Readers expect the list of children even if it is empty
+  const uint32_t children = fbb->CreateOffsetVector({});
+  fbb->StartTable();
+  fbb->AddOffsetField(0, name);
+  fbb->AddField<uint8_t>(1, static_cast<uint8_t>(field.nullable_));
+  fbb->AddField<uint8_t>(2, type_type);
+  fbb->AddOffsetField(3, type);
+  fbb->AddOffsetField(5, children);
+  return fbb->EndTable();
+}
+
+uint32_t CreateSchema(FlatBufferBuilder *const fbb, const std::vector<ArrowIpcWriter::Field> &fields) {
+  std::vector<uint32_t> field_offsets;
+  field_offsets.reserve(fields.size());
+  for (const auto &field : fields) field_offsets.push_back(CreateField(fbb, field));
+  const uint32_t field_vector = fbb->CreateOffsetVector(field_offsets);
+  fbb->StartTable();
+  fbb->AddField<int16_t>(0, ENDIANNESS_LITTLE);
+  fbb->AddOffsetField(1, field_vector);
+  return fbb->EndTable();
+}
+
+uint32_t CreateMessage(FlatBufferBuilder *const fbb, const uint8_t header_type, const uint32_t header,
+                       const int64_t body_length) {
+  fbb->StartTable();
+  fbb->AddField<int64_t>(3, body_length);
+  fbb->AddOffsetField(2, header);
+  fbb->AddField<int16_t>(0, METADATA_VERSION_V5);
+  fbb->AddField<uint8_t>(1, header_type);
+  return fbb->EndTable();
+}
+
+// Values of a column of a hot block, copied out of the tuples visible to the exporting transaction
+struct ColumnBuilder {
+  std::vector<uint8_t> validity_;
+  std::vector<uint8_t> values_;
+  std::vector<uint32_t> offsets_{0};
+  uint32_t null_count_ = 0;
+};
+}  // namespace
+
+/*
+ * Buffers of a record batch. Buffers are written out from wherever they are in memory, which is in the block for
+ * frozen blocks. Whatever needs to be rearranged lives in the record batch until it is written.
+ */
+class ArrowIpcWriter::RecordBatch {
+ public:
+  explicit RecordBatch(const uint32_t length) : length_(length) {}
+
+  void AddNode(const uint32_t null_count) { nodes_.push_back({length_, null_count}); }
+
+  void AddBuffer(const void *const data, const uint64_t size) {
+    buffers_.push_back({static_cast<int64_t>(body_length_), static_cast<int64_t>(size)});
+    if (size == 0) return;
+    body_.push_back(MakeIovec(data, size));
+    const uint64_t padding = Padding(size);
+    if (padding > 0) body_.push_back(MakeIovec(ZEROS, padding));
+    body_length_ += size + padding;
+  }
+
+  byte *Allocate(const uint64_t size) {
+    scratch_.emplace_back(new byte[size]);
+    return scratch_.back().get();
+  }
+
+  std::vector<uint8_t> Metadata() const {
+    FlatBufferBuilder fbb;
+    const uint32_t nodes = fbb.CreateStructVector(nodes_.data(), nodes_.size());
+    const uint32_t buffers = fbb.CreateStructVector(buffers_.data(), buffers_.size());
+    fbb.StartTable();
+    fbb.AddField<int64_t>(0, length_);
+    fbb.AddOffsetField(1, nodes);
+    fbb.AddOffsetField(2, buffers);
+    const uint32_t record_batch = fbb.EndTable();
+    return fbb.Finish(CreateMessage(&fbb, HEADER_RECORD_BATCH, record_batch, static_cast<int64_t>(body_length_)));
+  }
+
+  std::vector<iovec> *Body() { return &body_; }
+
+  uint64_t BodyLength() const { return body_length_; }
+
+ private:
+  // FieldNode and Buffer structs of the Arrow metadata
+  struct FieldNode {
+    int64_t length_;
+    int64_t null_count_;
+  };
+  struct Buffer {
+    int64_t offset_;
+    int64_t length_;
+  };
+
+  const int64_t length_;
+  std::vector<FieldNode> nodes_;
+  std::vector<Buffer> buffers_;
+  std::vector<iovec> body_;
+  uint64_t body_length_ = 0;
+  std::vector<std::unique_ptr<byte[]>> scratch_;
+};
+
+void ArrowIpcWriter::WriteFile(transaction::TransactionContext *const txn, const std::string &file_path) {
+  out_ = PosixIoWrappers::Open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  file_offset_ = 0;
+  record_batches_.clear();
+  num_blocks_in_place_ = num_blocks_materialized_ = 0;
+
+  uint8_t magic[ALIGNMENT] = {};
+  std::memcpy(magic, MAGIC, sizeof(MAGIC) - 1);
+  PosixIoWrappers::WriteFully(out_, magic, sizeof(magic));
+  file_offset_ += sizeof(magic);
+  {
+    FlatBufferBuilder fbb;
+    const uint32_t schema = CreateSchema(&fbb, fields_);
+    std::vector<iovec> no_body;
+    WriteMessage(fbb.Finish(CreateMessage(&fbb, HEADER_SCHEMA, schema, 0)), &no_body, 0);
+  }
+
+  std::vector<col_id_t> col_ids;
+  for (const auto &field : fields_) col_ids.push_back(field.col_id_);
+  const ProjectedRowInitializer initializer =
+      ProjectedRowInitializer::Create(table_->accessor_.GetBlockLayout(), col_ids);
+  std::unique_ptr<byte[]> row_buffer(common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize()));
+  ProjectedRow *const row = initializer.InitializeRow(row_buffer.get());
+  const uint32_t num_blocks = table_->GetNumBlocks();
+  for (uint32_t block_idx = 0; block_idx < num_blocks; block_idx++) {
+    RawBlock *const block = table_->beginAt(block_idx)->GetBlock();
+    if (!block->controller_.TryAcquireInPlaceRead()) {
+      WriteHotBlock(txn, block, row);
+      continue;
+    }
+    // Nobody can modify the block until we give up the read, which needs to happen even if the write fails
+    try {
+      WriteFrozenBlock(block);
+    } catch (...) {
+      block->controller_.ReleaseInPlaceRead();
+      throw;
+    }
+    block->controller_.ReleaseInPlaceRead();
+  }
+
+  // End-of-stream marker, followed by the footer that lets readers find the record batches
+  const uint32_t end_of_stream[2] = {CONTINUATION, 0};
+  PosixIoWrappers::WriteFully(out_, end_of_stream, sizeof(end_of_stream));
+  FlatBufferBuilder fbb;
+  const uint32_t schema = CreateSchema(&fbb, fields_);
+  const uint32_t dictionaries = fbb.CreateStructVector<FileBlock>(nullptr, 0);
+  const uint32_t record_batches = fbb.CreateStructVector(record_batches_.data(), record_batches_.size());
+  fbb.StartTable();
+  fbb.AddField<int16_t>(0, METADATA_VERSION_V5);
+  fbb.AddOffsetField(1, schema);
+  fbb.AddOffsetField(2, dictionaries);
+  fbb.AddOffsetField(3, record_batches);
+  const std::vector<uint8_t> footer = fbb.Finish(fbb.EndTable());
+  const auto footer_length = static_cast<int32_t>(footer.size());
+  std::vector<iovec> trailer = {MakeIovec(footer.data(), footer.size()),
+                                MakeIovec(&footer_length, sizeof(footer_length)), MakeIovec(MAGIC, sizeof(MAGIC) - 1)};
+  PosixIoWrappers::WriteVFully(out_, trailer.data(), trailer.size());
+  PosixIoWrappers::Close(out_);
+}
+
+void ArrowIpcWriter::WriteFrozenBlock(RawBlock *const block) {
+  const TupleAccessStrategy &accessor = table_->accessor_;
+  const BlockLayout &layout = accessor.GetBlockLayout();
+  const ArrowBlockMetadata &metadata = accessor.GetArrowBlockMetadata(block);
+  const uint32_t num_records = metadata.NumRecords();
+  if (num_records == 0) return;
+  block->MarkRead();
+
+  RecordBatch batch(num_records);
+  for (const auto &field : fields_) {
+    const col_id_t col_id = field.col_id_;
+    const common::RawConcurrentBitmap *const nulls = accessor.ColumnNullBitmap(block, col_id);
+    const byte *values = accessor.ColumnStart(block, col_id);
+    // Encoded columns may have been released from the block, so they are written out decoded
+    const ArrowEncodedColumn *const encoded = accessor.EncodedColumn(block, col_id);
+    if (encoded != nullptr) {
+      byte *const decoded = batch.Allocate(layout.AttrSize(col_id) * num_records);
+      encoded->Decode(0, num_records, decoded);
+      values = decoded;
+    }
+    batch.AddNode(metadata.NullCount(col_id));
+    // The null bitmap of the block has the same bit layout as an Arrow validity bitmap
+    batch.AddBuffer(nulls, common::RawBitmap::SizeInBytes(num_records));
+
+    if (field.type_ == type::TypeId::BOOLEAN) {
+      // Arrow packs booleans into bits
+      const uint32_t size = common::RawBitmap::SizeInBytes(num_records);
+      auto *const bits = reinterpret_cast<common::RawBitmap *>(batch.Allocate(size));
+      bits->Clear(num_records);
+      for (uint32_t i = 0; i < num_records; i++)
+        if (values[i] != byte{0}) bits->Set(i, true);
+      batch.AddBuffer(bits, size);
+      continue;
+    }
+    if (!layout.IsVarlen(col_id)) {
+      batch.AddBuffer(values, layout.AttrSize(col_id) * num_records);
+      continue;
+    }
+
+    const ArrowColumnInfo &col_info = metadata.GetColumnInfo(layout, col_id);
+    const ArrowVarlenColumn &varlen_column = col_info.VarlenColumn();
+    if (col_info.Type() == ArrowColumnType::GATHERED_VARLEN) {
+      batch.AddBuffer(varlen_column.Offsets(), sizeof(uint32_t) * (num_records + 1));
+      batch.AddBuffer(varlen_column.Values(), varlen_column.Offsets()[num_records]);
+      continue;
+    }
+    // Every block has a dictionary of its own, so the column is written out with the values looked up
+    const uint32_t *const indices = col_info.Indices();
+    auto *const offsets = reinterpret_cast<uint32_t *>(batch.Allocate(sizeof(uint32_t) * (num_records + 1)));
+    offsets[0] = 0;
+    for (uint32_t i = 0; i < num_records; i++) {
+      // The index of a null is garbage
+      const uint32_t *const entry = varlen_column.Offsets() + indices[i];
+      offsets[i + 1] = offsets[i] + (nulls->Test(i) ? entry[1] - entry[0] : 0);
+    }
+    byte *const content = batch.Allocate(offsets[num_records]);
+    for (uint32_t i = 0; i < num_records; i++)
+      std::memcpy(content + offsets[i], varlen_column.Values() + varlen_column.Offsets()[indices[i]],
+                  offsets[i + 1] - offsets[i]);
+    batch.AddBuffer(offsets, sizeof(uint32_t) * (num_records + 1));
+    batch.AddBuffer(content, offsets[num_records]);
+  }
+  record_batches_.push_back(WriteMessage(batch.Metadata(), batch.Body(), batch.BodyLength()));
+  num_blocks_in_place_++;
+}
+
+void ArrowIpcWriter::WriteHotBlock(transaction::TransactionContext *const txn, RawBlock *const block,
+                                   ProjectedRow *const row) {
+  const BlockLayout &layout = table_->accessor_.GetBlockLayout();
+  // Projected rows order their columns by size, so look up where each field ended up
+  std::vector<uint16_t> projection(fields_.size());
+  for (uint16_t i = 0; i < fields_.size(); i++)
+    projection[i] = static_cast<uint16_t>(
+        std::find(row->ColumnIds(), row->ColumnIds() + row->NumColumns(), fields_[i].col_id_) - row->ColumnIds());
+
+  std::vector<ColumnBuilder> columns(fields_.size());
+  uint32_t num_records = 0;
+  const uint32_t insert_head = block->GetInsertHead();
+  for (uint32_t offset = 0; offset < insert_head; offset++) {
+    if (!table_->Select(txn, TupleSlot(block, offset), row)) continue;
+    for (uint16_t i = 0; i < fields_.size(); i++) {
+      ColumnBuilder &column = columns[i];
+      const col_id_t col_id = fields_[i].col_id_;
+      const byte *const value = row->AccessWithNullCheck(projection[i]);
+      if (num_records % BYTE_SIZE == 0) column.validity_.push_back(0);
+      if (value == nullptr)
+        column.null_count_++;
+      else
+        column.validity_.back() = static_cast<uint8_t>(column.validity_.back() | 1U << num_records % BYTE_SIZE);
+
+      if (fields_[i].type_ == type::TypeId::BOOLEAN) {
+        if (num_records % BYTE_SIZE == 0) column.values_.push_back(0);
+        if (value != nullptr && *value != byte{0})
+          column.values_.back() = static_cast<uint8_t>(column.values_.back() | 1U << num_records % BYTE_SIZE);
+      } else if (layout.IsVarlen(col_id)) {
+        if (value != nullptr) {
+          const auto *const entry = reinterpret_cast<const VarlenEntry *>(value);
+          const auto *const content = reinterpret_cast<const uint8_t *>(entry->Content());
+          column.values_.insert(column.values_.end(), content, content + entry->Size());
+        }
+        column.offsets_.push_back(static_cast<uint32_t>(column.values_.size()));
+      } else {
+        column.values_.resize(column.values_.size() + layout.AttrSize(col_id), 0);
+        if (value != nullptr)
+          std::memcpy(&column.values_.back() + 1 - layout.AttrSize(col_id), value, layout.AttrSize(col_id));
+      }
+    }
+    num_records++;
+  }
+  if (num_records == 0) return;
+
+  RecordBatch batch(num_records);
+  for (uint16_t i = 0; i < fields_.size(); i++) {
+    const ColumnBuilder &column = columns[i];
+    batch.AddNode(column.null_count_);
+    batch.AddBuffer(column.validity_.data(), column.validity_.size());
+    if (layout.IsVarlen(fields_[i].col_id_))
+      batch.AddBuffer(column.offsets_.data(), sizeof(uint32_t) * column.offsets_.size());
+    batch.AddBuffer(column.values_.data(), column.values_.size());
+  }
+  record_batches_.push_back(WriteMessage(batch.Metadata(), batch.Body(), batch.BodyLength()));
+  num_blocks_materialized_++;
+}
+
+ArrowIpcWriter::FileBlock ArrowIpcWriter::WriteMessage(const std::vector<uint8_t> &metadata,
+                                                       std::vector<iovec> *const body, const uint64_t body_length) {
+  // Every message is prefixed with a continuation marker and the length of the (padded) metadata that follows
+  const uint64_t padding = Padding(metadata.size());
+  const uint32_t prefix[2] = {CONTINUATION, static_cast<uint32_t>(metadata.size() + padding)};
+  std::vector<iovec> message = {MakeIovec(prefix, sizeof(prefix)), MakeIovec(metadata.data(), metadata.size()),
+                                MakeIovec(ZEROS, padding)};
+  message.insert(message.end(), body->begin(), body->end());
+  PosixIoWrappers::WriteVFully(out_, message.data(), message.size());
+
+  const FileBlock result = {file_offset_, static_cast<int32_t>(sizeof(prefix) + metadata.size() + padding), 0,
+                            static_cast<int64_t>(body_length)};
+  file_offset_ += result.metadata_length_ + result.body_length_;
+  return result;
+}
+}  // namespace terrier::storage
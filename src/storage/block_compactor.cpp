@@ -1,69 +1,155 @@
 #include "storage/block_compactor.h"
 #include <algorithm>
-#include <queue>
+#include <limits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
+#include "common/scoped_timer.h"
+#include "common/thread_context.h"
 #include "storage/index/bwtree_index.h"
 #include "storage/index/index_defs.h"
 #include "storage/sql_table.h"
+#include "storage/varlen_arena.h"
 #include "transaction/transaction_util.h"
 
 namespace terrier::storage {
 void BlockCompactor::ProcessCompactionQueue(transaction::DeferredActionManager *deferred_action_manager,
                                             transaction::TransactionManager *txn_manager) {
-  std::queue<RawBlock *> to_process = std::move(compaction_queue_);
-  while (!to_process.empty()) {
-    RawBlock *block = to_process.front();
-    BlockAccessController &controller = block->controller_;
-    switch (controller.GetBlockState()->load()) {
-      case BlockState::HOT: {
-        // TODO(Tianyu): The policy about how to group blocks together into compaction group can be a lot
-        // more sophisticated. Compacting more blocks together frees up more memory per compaction run,
-        // but makes the compaction transaction larger, which can have performance impact on the rest
-        // of the system. As it currently stands, no memory is freed from this one-block-per-group scheme.
-        CompactionGroup cg(txn_manager->BeginTransaction(), block->data_table_);
-        // TODO(Tianyu): Additionally, frozen blocks can still have empty slots within them. To make sure
-        // these memory are not gone forever, we still need to periodically shuffle tuples around within
-        // frozen blocks. Although code can be reused for doing the compaction, some logic needs to be
-        // written to enqueue these frozen blocks into the compaction queue.
-        cg.blocks_to_compact_.emplace(block, std::vector<uint32_t>());
-        if (EliminateGaps(&cg)) {
-          controller.GetBlockState()->store(BlockState::COOLING);
-          // If no compaction was performed, we still need to shut out any potentially racey transactions that
-          // are alive at the same time as us flipping the block status flag to cooling. However, we must manually
-          // ask the GC to enqueue this block, because no access will be observed from the empty compaction transaction.
-          if (cg.txn_->IsReadOnly())
-            deferred_action_manager->RegisterDeferredAction([this, block]() { PutInQueue(block); });
-          txn_manager->Commit(cg.txn_, transaction::TransactionUtil::EmptyCallback, nullptr);
-        } else {
-          txn_manager->Abort(cg.txn_);
-        }
-        break;
+  ProcessBatch(std::numeric_limits<uint32_t>::max(), deferred_action_manager, txn_manager);
+}
+
+void BlockCompactor::StartWorkers(const uint32_t num_workers, const std::chrono::microseconds interval,
+                                  transaction::DeferredActionManager *const deferred_action_manager,
+                                  transaction::TransactionManager *const txn_manager) {
+  TERRIER_ASSERT(thread_registry_ != DISABLED, "Workers need a thread registry to run on.");
+  TERRIER_ASSERT(workers_.empty(), "Workers are already running.");
+  for (uint32_t worker_id = 0; worker_id < num_workers; worker_id++)
+    workers_.push_back(thread_registry_->RegisterDedicatedThread<BlockCompactorTask>(
+        this /* requester */, this, worker_id, interval, deferred_action_manager, txn_manager));
+}
+
+void BlockCompactor::StopWorkers() {
+  for (auto &worker : workers_) {
+    UNUSED_ATTRIBUTE bool result =
+        thread_registry_->StopTask(this, worker.CastManagedPointerTo<common::DedicatedThreadTask>());
+    TERRIER_ASSERT(result, "BlockCompactorTask should have been stopped");
+  }
+  workers_.clear();
+}
+
+BlockCompactor::PassStats BlockCompactor::ProcessBatch(
+    const uint32_t max_blocks, transaction::DeferredActionManager *const deferred_action_manager,
+    transaction::TransactionManager *const txn_manager) {
+  // Only look at what is in the queue now. Blocks put back while we process them are left for the next pass.
+  std::unordered_map<DataTable *, std::vector<RawBlock *>> partitions;
+  RawBlock *block;
+  for (uint32_t i = 0; i < max_blocks && compaction_queue_.Dequeue(&block); i++)
+    partitions[block->data_table_].push_back(block);
+
+  PassStats stats;
+  for (auto &partition : partitions) {
+    DataTable *const table = partition.first;
+    {
+      common::SpinLatch::ScopedSpinLatch guard(&tables_latch_);
+      if (!tables_in_progress_.insert(table).second) {
+        // Another worker has this table, hand the blocks back so that one of us picks them up later
+        for (RawBlock *table_block : partition.second) PutInQueue(table_block);
+        continue;
       }
-      case BlockState::COOLING: {
-        if (!CheckForVersionsAndGaps(block->data_table_->accessor_, block)) continue;
-        // This is used to clean up any dangling pointers using a deferred action in GC.
-        // We need this piece of memory to live on the heap, so its life time extends to
-        // beyond this function call.
-        auto *loose_ptrs = new std::vector<const byte *>;
-        GatherVarlens(loose_ptrs, block, block->data_table_);
-        controller.GetBlockState()->store(BlockState::FROZEN);
-        // When the old variable length values are no longer visible by running transactions, delete them.
-        deferred_action_manager->RegisterDeferredAction([=]() {
-          for (auto *loose_ptr : *loose_ptrs) delete[] loose_ptr;
-          delete loose_ptrs;
-        });
-        break;
+    }
+    for (RawBlock *table_block : partition.second)
+      ProcessBlock(table_block, deferred_action_manager, txn_manager, &stats);
+    common::SpinLatch::ScopedSpinLatch guard(&tables_latch_);
+    tables_in_progress_.erase(table);
+  }
+  return stats;
+}
+
+void BlockCompactor::ProcessBlock(RawBlock *const block, transaction::DeferredActionManager *deferred_action_manager,
+                                  transaction::TransactionManager *txn_manager, PassStats *const stats) {
+  BlockAccessController &controller = block->controller_;
+  switch (controller.GetBlockState()->load()) {
+    case BlockState::HOT: {
+      // TODO(Tianyu): The policy about how to group blocks together into compaction group can be a lot
+      // more sophisticated. Compacting more blocks together frees up more memory per compaction run,
+      // but makes the compaction transaction larger, which can have performance impact on the rest
+      // of the system. As it currently stands, no memory is freed from this one-block-per-group scheme.
+      CompactionGroup cg(txn_manager->BeginTransaction(), block->data_table_);
+      // TODO(Tianyu): Additionally, frozen blocks can still have empty slots within them. To make sure
+      // these memory are not gone forever, we still need to periodically shuffle tuples around within
+      // frozen blocks. Although code can be reused for doing the compaction, some logic needs to be
+      // written to enqueue these frozen blocks into the compaction queue.
+      cg.blocks_to_compact_.emplace(block, std::vector<uint32_t>());
+      if (EliminateGaps(&cg)) {
+        controller.GetBlockState()->store(BlockState::COOLING);
+        // If no compaction was performed, we still need to shut out any potentially racey transactions that
+        // are alive at the same time as us flipping the block status flag to cooling. However, we must manually
+        // ask the GC to enqueue this block, because no access will be observed from the empty compaction transaction.
+        if (cg.txn_->IsReadOnly())
+          deferred_action_manager->RegisterDeferredAction([this, block]() { PutInQueue(block); });
+        txn_manager->Commit(cg.txn_, transaction::TransactionUtil::EmptyCallback, nullptr);
+        stats->num_compacted_++;
+      } else {
+        txn_manager->Abort(cg.txn_);
+        stats->num_aborted_++;
       }
-      case BlockState::FROZEN:
-        // This is okay. In a rare race, the block can show up in the compaction queue, be accessed, compacted,
-        // and show up again because of the early access.
+      break;
+    }
+    case BlockState::COOLING: {
+      if (!CheckForVersionsAndGaps(block->data_table_->accessor_, block)) {
+        // Versions in the block may not have been pruned yet. Unless a writer has already brought the block back to
+        // hot, try again later.
+        if (controller.GetBlockState()->load() == BlockState::COOLING) PutInQueue(block);
         break;
-      default:
-        throw std::runtime_error("unexpected control flow");
+      }
+      // This is used to clean up any dangling pointers using a deferred action in GC.
+      // We need this piece of memory to live on the heap, so its life time extends to
+      // beyond this function call.
+      auto *loose_ptrs = new std::vector<VarlenEntry>;
+      auto *stale_encodings = new std::vector<ArrowEncodedColumn *>;
+      auto *encodings = new std::vector<std::pair<col_id_t, const ArrowEncodedColumn *>>;
+      GatherVarlens(loose_ptrs, stale_encodings, encodings, block, block->data_table_);
+      controller.GetBlockState()->store(BlockState::FROZEN);
+      // When the old variable length values are no longer visible by running transactions, delete them. By then,
+      // nobody can be reading the fixed-length columns without going through their new encoded copies either.
+      deferred_action_manager->RegisterDeferredAction([=]() {
+        for (const auto &loose_ptr : *loose_ptrs) VarlenArena::Free(loose_ptr);
+        delete loose_ptrs;
+        for (ArrowEncodedColumn *stale : *stale_encodings) delete stale;
+        delete stale_encodings;
+        ReleasePlainColumns(block, *encodings);
+        delete encodings;
+      });
+      stats->num_frozen_++;
+      break;
     }
-    to_process.pop();
+    case BlockState::FROZEN:
+      // This is okay. In a rare race, the block can show up in the compaction queue, be accessed, compacted,
+      // and show up again because of the early access.
+      break;
+    default:
+      throw std::runtime_error("unexpected control flow");
+  }
+}
+
+void BlockCompactorTask::RunTask() {
+  run_task_.store(true);
+  while (run_task_.load()) {
+    uint64_t elapsed_us;
+    BlockCompactor::PassStats stats;
+    {
+      common::ScopedTimer<std::chrono::microseconds> timer(&elapsed_us);
+      stats = compactor_->ProcessBatch(BlockCompactor::MAX_BATCH_SIZE, deferred_action_manager_, txn_manager_);
+    }
+    if (stats.num_compacted_ + stats.num_frozen_ + stats.num_aborted_ == 0) {
+      // Nothing to do, or all of it belongs to tables other workers are busy with
+      std::this_thread::sleep_for(interval_);
+      continue;
+    }
+    if (common::thread_context.metrics_store_ != nullptr &&
+        common::thread_context.metrics_store_->ComponentEnabled(metrics::MetricsComponent::COMPACTION))
+      common::thread_context.metrics_store_->RecordCompactionData(worker_id_, elapsed_us, stats.num_compacted_,
+                                                                  stats.num_frozen_, stats.num_aborted_);
   }
 }
 
@@ -173,15 +259,16 @@ bool BlockCompactor::MoveTuple(CompactionGroup *cg, TupleSlot from, TupleSlot to
       *entry = VarlenEntry::CreateInline(entry->Content(), entry->Size());
     } else {
       // TODO(Tianyu): Copying for correctness. This is not yet shown to be expensive, but might be in the future.
-      byte *copied = common::AllocationUtil::AllocateAligned(entry->Size());
+      byte *copied = cg->txn_->AllocateVarlen(entry->Size());
       std::memcpy(copied, entry->Content(), entry->Size());
-      *entry = VarlenEntry::Create(copied, entry->Size(), true);
+      *entry = VarlenEntry::CreateFromArena(copied, entry->Size());
     }
   }
 
   // Copy the tuple into the empty slot
-  // This operation cannot fail since a logically deleted slot can only be reclaimed by the compaction thread
-  accessor.Reallocate(to);
+  // An insert may have reused the slot since we looked at the block, in which case we treat it like any other
+  // conflict and abort
+  if (!accessor.Reallocate(to)) return false;
   cg->table_->InsertInto(cg->txn_, *record->Delta(), to);
 
   // The delete can fail if a concurrent transaction is updating said tuple. We will have to abort if this is
@@ -234,7 +321,10 @@ bool BlockCompactor::CheckForVersionsAndGaps(const TupleAccessStrategy &accessor
   return ret;
 }
 
-void BlockCompactor::GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlock *block, DataTable *table) {
+void BlockCompactor::GatherVarlens(std::vector<VarlenEntry> *loose_ptrs,
+                                   std::vector<ArrowEncodedColumn *> *stale_encodings,
+                                   std::vector<std::pair<col_id_t, const ArrowEncodedColumn *>> *encodings,
+                                   RawBlock *block, DataTable *table) {
   const TupleAccessStrategy &accessor = table->accessor_;
   const BlockLayout &layout = accessor.GetBlockLayout();
   ArrowBlockMetadata &metadata = accessor.GetArrowBlockMetadata(block);
@@ -242,10 +332,20 @@ void BlockCompactor::GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlo
   for (col_id_t col_id : layout.AllColumns()) {
     common::RawConcurrentBitmap *column_bitmap = accessor.ColumnNullBitmap(block, col_id);
     if (!layout.IsVarlen(col_id)) {
-      metadata.NullCount(col_id) = 0;
-      // Only need to count null for non-varlens
-      for (uint32_t i = 0; i < metadata.NumRecords(); i++)
-        if (!column_bitmap->Test(i)) metadata.NullCount(col_id)++;
+      // Writers only take away the encoded copies of the columns they write to, so a copy from an earlier freeze may
+      // still be around, and may not cover the tuples moved into the block since. Put the values back in the block and
+      // encode them again.
+      ArrowEncodedColumn *stale = accessor.ThawColumn(block, col_id);
+      if (stale != nullptr) stale_encodings->push_back(stale);
+      byte *values = accessor.ColumnStart(block, col_id);
+      // Only need to count null, build the zone map and encode for non-varlens
+      ComputeZoneMap(&metadata, layout, col_id, column_bitmap, values);
+      ArrowEncodedColumn *encoded =
+          ArrowEncodedColumn::Encode(layout.AttrSize(col_id), values, column_bitmap, metadata.NumRecords());
+      if (encoded == nullptr) continue;
+      metadata.GetColumnInfo(layout, col_id).SetEncodedColumn(encoded);
+      metadata.NumEncodedColumns()++;
+      encodings->emplace_back(col_id, encoded);
       continue;
     }
 
@@ -265,13 +365,67 @@ void BlockCompactor::GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlo
   }
 }
 
-void BlockCompactor::CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata,
+void BlockCompactor::ReleasePlainColumns(
+    RawBlock *block, const std::vector<std::pair<col_id_t, const ArrowEncodedColumn *>> &encodings) {
+  const TupleAccessStrategy &accessor = block->data_table_->accessor_;
+  const BlockLayout &layout = accessor.GetBlockLayout();
+  ArrowBlockMetadata &metadata = accessor.GetArrowBlockMetadata(block);
+  // Columns that a writer has thawed since no longer have the same encoded copy, and are left alone
+  for (const auto &encoding : encodings)
+    metadata.GetColumnInfo(layout, encoding.first)
+        .ReleasePlainColumn(encoding.second, accessor.ColumnStart(block, encoding.first),
+                            static_cast<uint64_t>(layout.AttrSize(encoding.first)) * layout.NumSlots());
+}
+
+void BlockCompactor::ComputeZoneMap(ArrowBlockMetadata *metadata, const BlockLayout &layout, col_id_t col_id,
+                                    common::RawConcurrentBitmap *column_bitmap, const byte *values) {
+  switch (layout.AttrSize(col_id)) {
+    case sizeof(int8_t):
+      ComputeZoneMapImpl(metadata, layout, col_id, column_bitmap, reinterpret_cast<const int8_t *>(values));
+      break;
+    case sizeof(int16_t):
+      ComputeZoneMapImpl(metadata, layout, col_id, column_bitmap, reinterpret_cast<const int16_t *>(values));
+      break;
+    case sizeof(int32_t):
+      ComputeZoneMapImpl(metadata, layout, col_id, column_bitmap, reinterpret_cast<const int32_t *>(values));
+      break;
+    case sizeof(int64_t):
+      ComputeZoneMapImpl(metadata, layout, col_id, column_bitmap, reinterpret_cast<const int64_t *>(values));
+      break;
+    default:
+      throw std::runtime_error("unexpected attribute size");
+  }
+}
+
+template <class T>
+void BlockCompactor::ComputeZoneMapImpl(ArrowBlockMetadata *metadata, const BlockLayout &layout, col_id_t col_id,
+                                    common::RawConcurrentBitmap *column_bitmap, const T *values) {
+  uint32_t null_count = 0;
+  T min = std::numeric_limits<T>::max(), max = std::numeric_limits<T>::min();
+  // Update null count and the range of the non-null values in a single pass
+  for (uint32_t i = 0; i < metadata->NumRecords(); i++) {
+    if (!column_bitmap->Test(i)) {
+      null_count++;
+      continue;
+    }
+    min = std::min(min, values[i]);
+    max = std::max(max, values[i]);
+  }
+  metadata->NullCount(col_id) = null_count;
+  // If every value is null the range is left inverted (min > max), which readers never need to look at, since
+  // no tuple can satisfy a predicate on the column anyway.
+  ColumnZoneMap &zone_map = metadata->GetZoneMap(layout, col_id);
+  zone_map.Min() = min;
+  zone_map.Max() = max;
+}
+
+void BlockCompactor::CopyToArrowVarlen(std::vector<VarlenEntry> *loose_ptrs, ArrowBlockMetadata *metadata,
                                        col_id_t col_id, common::RawConcurrentBitmap *column_bitmap,
                                        ArrowColumnInfo *col, VarlenEntry *values) {
   uint32_t varlen_size = 0;
   // Read through every tuple and update null count and total varlen size
+  metadata->NullCount(col_id) = 0;
   for (uint32_t i = 0; i < metadata->NumRecords(); i++) {
-    metadata->NullCount(col_id) = 0;
     if (!column_bitmap->Test(i))
       // Update null count
       metadata->NullCount(col_id)++;
@@ -292,7 +446,7 @@ void BlockCompactor::CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, Ar
     std::memcpy(new_col.Values() + acc, entry.Content(), entry.Size());
 
     // Need to GC
-    if (entry.NeedReclaim()) loose_ptrs->push_back(entry.Content());
+    if (entry.NeedReclaim()) loose_ptrs->push_back(entry);
 
     // Because this change does not change the logical content of the database, and reads of aligned qwords on
     // modern architectures are atomic anyways, this is still safe for possible concurrent readers. The deferred
@@ -306,14 +460,14 @@ void BlockCompactor::CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, Ar
   col->VarlenColumn() = std::move(new_col);
 }
 
-void BlockCompactor::BuildDictionary(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata,
+void BlockCompactor::BuildDictionary(std::vector<VarlenEntry> *loose_ptrs, ArrowBlockMetadata *metadata,
                                      col_id_t col_id, common::RawConcurrentBitmap *column_bitmap, ArrowColumnInfo *col,
                                      VarlenEntry *values) {
   VarlenEntryMap<uint32_t> dictionary;
   // Read through every tuple and update null count and build the dictionary
   uint32_t varlen_size = 0;
+  metadata->NullCount(col_id) = 0;
   for (uint32_t i = 0; i < metadata->NumRecords(); i++) {
-    metadata->NullCount(col_id) = 0;
     if (!column_bitmap->Test(i)) {
       // Update null count
       metadata->NullCount(col_id)++;
@@ -351,7 +505,7 @@ void BlockCompactor::BuildDictionary(std::vector<const byte *> *loose_ptrs, Arro
     // Only do a gather operation if the column is varlen
     VarlenEntry &entry = values[i];
     // Need to GC
-    if (entry.NeedReclaim()) loose_ptrs->push_back(entry.Content());
+    if (entry.NeedReclaim()) loose_ptrs->push_back(entry);
     uint32_t dictionary_code = new_col_info.Indices()[i] = dictionary[entry];
 
     byte *dictionary_word = new_col.Values() + new_col.Offsets()[dictionary_code];
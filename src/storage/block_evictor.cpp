@@ -0,0 +1,172 @@
+#include "storage/block_evictor.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include "loggers/storage_logger.h"
+
+namespace terrier::storage {
+BlockEvictor::BlockEvictor(std::string file_path, const uint32_t idle_threshold,
+                           const uint32_t max_evictions_per_pass)
+    : file_path_(std::move(file_path)),
+      idle_threshold_(idle_threshold),
+      max_evictions_per_pass_(max_evictions_per_pass),
+      stub_size_(static_cast<uint64_t>(sysconf(_SC_PAGESIZE))),
+      fd_(PosixIoWrappers::Open(file_path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR)) {
+  TERRIER_ASSERT(offsetof(RawBlock, content_) <= stub_size_, "the fields of a block must fit in its stub");
+  TERRIER_ASSERT(common::Constants::BLOCK_SIZE % stub_size_ == 0, "blocks must be made up of whole pages");
+  DataTable::AddBlockReleaseListener(this);
+}
+
+BlockEvictor::~BlockEvictor() {
+  DataTable::RemoveBlockReleaseListener(this);
+  PosixIoWrappers::Close(fd_);
+  unlink(file_path_.c_str());
+}
+
+void BlockEvictor::WatchBlock(RawBlock *const block) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BlockInfo &info = blocks_[block];
+  // The block is about to be frozen again, after writes that copied its pages back to memory
+  info.evicted_ = false;
+  if (info.watched_ || !info.evictable_) return;
+  info.watched_ = true;
+  watched_blocks_.emplace_back(block, 0);
+}
+
+void BlockEvictor::ObserveGCInvocation() {
+  std::unique_lock<std::mutex> lock(latch_);
+  std::vector<RawBlock *> to_evict;
+  auto it = watched_blocks_.begin();
+  for (auto &entry : watched_blocks_) {
+    RawBlock *const block = entry.first;
+    BlockInfo &info = blocks_[block];
+    // Reads are only tracked to tell when to evict, so the flag can be cleared whatever state the block is in
+    const bool read = block->recently_read_.exchange(0) != 0;
+    bool keep = true;
+    if (block->controller_.GetBlockState()->load() != BlockState::FROZEN) {
+      // Still being worked on by the compactor, or thawed by a write before it could be evicted
+      info.evicted_ = false;
+      entry.second = 0;
+    } else if (info.evicted_ || !info.evictable_) {
+      keep = false;
+    } else if (read) {
+      entry.second = 0;
+    } else if (entry.second < idle_threshold_) {
+      entry.second++;
+    }
+    // Blocks over the limit keep their idle count, and are evicted in a later invocation. So are blocks that fail to be
+    // evicted for any reason other than sitting in huge pages.
+    if (keep && entry.second >= idle_threshold_ && to_evict.size() < max_evictions_per_pass_)
+      to_evict.push_back(block);
+
+    if (keep)
+      *it++ = entry;
+    else
+      info.watched_ = false;
+  }
+  watched_blocks_.erase(it, watched_blocks_.end());
+
+  // Blocks evicted here are let go of by the next invocation
+  for (RawBlock *const block : to_evict) EvictLocked(block, &lock);
+}
+
+bool BlockEvictor::Evict(RawBlock *const block) {
+  std::unique_lock<std::mutex> lock(latch_);
+  blocks_.emplace(block, BlockInfo());
+  return EvictLocked(block, &lock);
+}
+
+void BlockEvictor::ForgetBlock(RawBlock *const block) {
+  std::unique_lock<std::mutex> lock(latch_);
+  // The block is still being written out, and its memory cannot go back to the block store before that is done
+  eviction_done_.wait(lock, [=] { return evicting_ != block; });
+  auto it = blocks_.find(block);
+  if (it == blocks_.end()) return;
+  const BlockInfo info = it->second;
+  blocks_.erase(it);
+  if (info.watched_) {
+    auto is_block = [=](const std::pair<RawBlock *, uint32_t> &entry) { return entry.first == block; };
+    watched_blocks_.erase(std::find_if(watched_blocks_.begin(), watched_blocks_.end(), is_block));
+  }
+  if (info.file_offset_ == -1) return;
+
+  // Pages of the block that were not written to since it was evicted still follow its slot in the file, so they have to
+  // be swapped for anonymous memory before the slot can go to another block, and before the block store hands out the
+  // memory again. The contents of a freed block do not matter.
+  void *const mapped = mmap(reinterpret_cast<byte *>(block) + stub_size_, common::Constants::BLOCK_SIZE - stub_size_,
+                            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+  if (mapped == MAP_FAILED) {
+    // The slot stays mapped under the block, so it is never reused
+    STORAGE_LOG_ERROR("Failed to unmap freed block from the block file");
+    return;
+  }
+  free_slots_.push_back(info.file_offset_);
+}
+
+bool BlockEvictor::EvictLocked(RawBlock *const block, std::unique_lock<std::mutex> *const lock) {
+  // Blocks freed while the latch was let go of for an earlier block are gone from the map
+  auto it = blocks_.find(block);
+  if (it == blocks_.end() || !it->second.evictable_) return false;
+  BlockInfo &info = it->second;
+  // Writers wait for in-place readers to leave, so holding a read keeps the block from changing while we move it
+  if (!block->controller_.TryAcquireInPlaceRead()) return false;
+  byte *const start = reinterpret_cast<byte *>(block) + stub_size_;
+  const uint64_t size = common::Constants::BLOCK_SIZE - stub_size_;
+  // A block written out before may still have pages that follow its slot, so it only ever gives up a slot it just got
+  const bool new_slot = info.file_offset_ == -1;
+  if (new_slot && !free_slots_.empty()) {
+    info.file_offset_ = free_slots_.back();
+    free_slots_.pop_back();
+  } else if (new_slot) {
+    info.file_offset_ = file_size_;
+    file_size_ += static_cast<int64_t>(size);
+  }
+  const int64_t file_offset = info.file_offset_;
+
+  // Only this thread writes to the file, and the slot is ours until the block is freed, which waits for us. References
+  // to the elements of an unordered map stay valid while other elements come and go, so info can be used afterwards.
+  evicting_ = block;
+  lock->unlock();
+  bool written = true;
+  try {
+    PosixIoWrappers::PWriteFully(fd_, start, size, file_offset);
+  } catch (const std::runtime_error &e) {
+    STORAGE_LOG_ERROR("Failed to write out block: {}", e.what());
+    written = false;
+  }
+  // The file now holds the same bytes as the block, so concurrent transactional readers do not notice the swap. This
+  // fails without touching the block if it sits in a huge page.
+  void *const mapped =
+      written ? mmap(start, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd_, file_offset) : MAP_FAILED;
+  const int map_error = errno;
+  block->controller_.ReleaseInPlaceRead();
+  lock->lock();
+  evicting_ = nullptr;
+  eviction_done_.notify_all();
+
+  if (mapped == MAP_FAILED) {
+    if (written && map_error == EINVAL) {
+      // Huge pages can only be unmapped whole, so the block can never be evicted
+      STORAGE_LOG_INFO("Block {} sits in huge pages, and stays in memory", reinterpret_cast<void *>(block));
+      info.evictable_ = false;
+    } else if (written) {
+      STORAGE_LOG_WARN("Failed to map block to the block file: {}", strerror(map_error));
+    }
+    if (new_slot) {
+      free_slots_.push_back(file_offset);
+      info.file_offset_ = -1;
+    }
+    return false;
+  }
+  // Start writing the pages back, so that the kernel can drop them as soon as they are clean
+  posix_fadvise(fd_, file_offset, static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+  info.evicted_ = true;
+  num_evictions_++;
+  return true;
+}
+}  // namespace terrier::storage
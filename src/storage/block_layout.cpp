@@ -3,10 +3,18 @@
 #include <functional>
 #include <utility>
 #include <vector>
+#include "common/constants.h"
 #include "storage/arrow_block_metadata.h"
 #include "storage/storage_util.h"
 
 namespace terrier::storage {
+// A block must fit at least one slot of a table with MAX_COL columns of the largest attribute size, or ComputeNumSlots
+// underflows. Every column takes up a null count, an ArrowColumnInfo and an attribute offset in the header, and needs
+// padding around its bitmap and room for one value. Per-column metadata has to stay within this.
+static_assert(common::Constants::MAX_COL * (2 * sizeof(uint32_t) + sizeof(ArrowColumnInfo) + 3 * sizeof(uint64_t) + 1) <
+                  common::Constants::BLOCK_SIZE,
+              "per-column metadata in the block header is too large for MAX_COL columns");
+
 BlockLayout::BlockLayout(std::vector<uint8_t> attr_sizes)
     : attr_sizes_(std::move(attr_sizes)),
       tuple_size_(ComputeTupleSize()),
@@ -36,7 +44,9 @@ uint32_t BlockLayout::ComputeStaticHeaderSize() const {
   auto unpadded_size = static_cast<uint32_t>(
       sizeof(uintptr_t) + sizeof(uint16_t) + sizeof(layout_version_t) +  // datatable pointer, padding, layout_version
       sizeof(uint32_t)                                                   // insert_head
-      + sizeof(BlockAccessController) + ArrowBlockMetadata::Size(NumColumns())  // access controller and metadata
+      + sizeof(BlockAccessController) + sizeof(uint64_t)                        // access controller, versioned slots
+      + sizeof(BlockAccessStats)                                                // access stats
+      + ArrowBlockMetadata::Size(NumColumns())                                  // metadata
       + NumColumns() * sizeof(uint32_t));                                       // attr_offsets
   return StorageUtil::PadUpToSize(sizeof(uint64_t), unpadded_size);
 }
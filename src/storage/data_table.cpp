@@ -1,52 +1,90 @@
 #include "storage/data_table.h"
 #include <pthread.h>
+#include <algorithm>
 #include <cstring>
-#include <list>
+#include <stdexcept>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include "common/allocator.h"
+#include "common/constants.h"
 #include "storage/block_access_controller.h"
 #include "storage/storage_util.h"
+#include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_context.h"
 #include "transaction/transaction_util.h"
 
 namespace terrier::storage {
+namespace {
+// Source of DataTable::table_id_
+std::atomic<uint64_t> next_table_id{0};
+}  // namespace
+
+thread_local std::unordered_map<uint64_t, std::shared_ptr<DataTable::InsertionClaim>>
+    DataTable::claimed_insertion_blocks_;
+common::SharedLatch DataTable::release_listeners_latch_;
+std::vector<BlockReleaseListener *> DataTable::release_listeners_;
+
 DataTable::DataTable(BlockStore *const store, const BlockLayout &layout, const layout_version_t layout_version)
-    : block_store_(store), layout_version_(layout_version), accessor_(layout) {
+    : block_store_(store), layout_version_(layout_version), accessor_(layout), table_id_(next_table_id++) {
   TERRIER_ASSERT(layout.AttrSize(VERSION_POINTER_COLUMN_ID) == 8,
                  "First column must have size 8 for the version chain.");
   TERRIER_ASSERT(layout.NumColumns() > NUM_RESERVED_COLUMNS,
                  "First column is reserved for version info, second column is reserved for logical delete.");
-  if (block_store_ != nullptr) {
-    RawBlock *new_block = NewBlock();
-    // insert block
-    blocks_.push_back(new_block);
-  }
-  insertion_head_ = blocks_.begin();
+  if (block_store_ != nullptr) AppendBlock(NewBlock());
 }
 
 DataTable::~DataTable() {
-  common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-  for (RawBlock *block : blocks_) {
+  common::SharedLatch::ScopedSharedLatch guard(&release_listeners_latch_);
+  for (uint32_t block_idx = 0; block_idx < blocks_.Size(); block_idx++) {
+    RawBlock *block = BlockAt(block_idx);
     StorageUtil::DeallocateVarlens(block, accessor_);
-    for (col_id_t i : accessor_.GetBlockLayout().Varlens())
+    for (col_id_t i : accessor_.GetBlockLayout().AllColumns())
       accessor_.GetArrowBlockMetadata(block).GetColumnInfo(accessor_.GetBlockLayout(), i).Deallocate();
+    for (BlockReleaseListener *listener : release_listeners_) listener->ForgetBlock(block);
     block_store_->Release(block);
   }
+  // Let the threads that still hold claims on this table know that they can forget about them
+  for (auto &claim : claims_) claim->state_.store(InsertionClaim::REVOKED);
+}
+
+void DataTable::AddBlockReleaseListener(BlockReleaseListener *const listener) {
+  common::SharedLatch::ScopedExclusiveLatch guard(&release_listeners_latch_);
+  release_listeners_.push_back(listener);
+}
+
+void DataTable::RemoveBlockReleaseListener(BlockReleaseListener *const listener) {
+  common::SharedLatch::ScopedExclusiveLatch guard(&release_listeners_latch_);
+  release_listeners_.erase(std::remove(release_listeners_.begin(), release_listeners_.end(), listener),
+                           release_listeners_.end());
 }
 
 bool DataTable::Select(terrier::transaction::TransactionContext *txn, terrier::storage::TupleSlot slot,
                        terrier::storage::ProjectedRow *out_buffer) const {
   data_table_counter_.IncrementNumSelect(1);
+  slot.GetBlock()->MarkRead();
   return SelectIntoBuffer(txn, slot, out_buffer);
 }
 
 void DataTable::Scan(transaction::TransactionContext *const txn, SlotIterator *const start_pos,
-                     ProjectedColumns *const out_buffer) const {
-  // TODO(Tianyu): So far this is not that much better than tuple-at-a-time access,
-  // but can be improved if block is read-only, or if we implement version synopsis, to just use std::memcpy when it's
-  // safe
+                     const SlotIterator &end_pos, ProjectedColumns *const out_buffer) const {
   uint32_t filled = 0;
-  while (filled < out_buffer->MaxTuples() && *start_pos != end()) {
+  // A block whose version synopsis changed while we were reading it. We fall back to slot-by-slot visibility checks
+  // for the rest of it.
+  RawBlock *versioned_block = nullptr;
+  while (filled < out_buffer->MaxTuples() && *start_pos != end_pos) {
+    RawBlock *const block = (*start_pos)->GetBlock();
+    // A frozen block has no versions and no gaps, so every tuple in it is visible and we can copy whole column runs.
+    // The in-place read keeps transactions from heating the block up while we are copying out of it.
+    if (block->controller_.TryAcquireInPlaceRead()) {
+      filled += ScanFrozenBlock(start_pos, end_pos, out_buffer, filled);
+      block->controller_.ReleaseInPlaceRead();
+      continue;
+    }
+    // A hot block without versions only needs the cheap presence checks
+    if (block != versioned_block) {
+      if (ScanVersionFreeBlock(start_pos, end_pos, out_buffer, &filled)) continue;
+      versioned_block = block;
+    }
     ProjectedColumns::RowView row = out_buffer->InterpretAsRow(filled);
     const TupleSlot slot = **start_pos;
     // Only fill the buffer with valid, visible tuples
@@ -59,41 +97,222 @@ void DataTable::Scan(transaction::TransactionContext *const txn, SlotIterator *c
   out_buffer->SetNumTuples(filled);
 }
 
+uint32_t DataTable::ScanFrozenBlock(SlotIterator *const start_pos, const SlotIterator &end_pos,
+                                    ProjectedColumns *const out_buffer, const uint32_t filled) const {
+  const BlockLayout &layout = accessor_.GetBlockLayout();
+  RawBlock *const block = (*start_pos)->GetBlock();
+  const uint32_t start = (*start_pos)->GetOffset();
+  const uint32_t num_tuples = NumFrozenTuples(*start_pos, end_pos, out_buffer->MaxTuples() - filled);
+  block->MarkRead();
+
+  for (uint16_t i = 0; i < out_buffer->NumColumns(); i++) {
+    const col_id_t col_id = out_buffer->ColumnIds()[i];
+    TERRIER_ASSERT(col_id != VERSION_POINTER_COLUMN_ID, "Output buffer should not read the version pointer column.");
+    const uint8_t attr_size = layout.AttrSize(col_id);
+    // The encoded copy of the column cannot be taken away while we hold the in-place read
+    const ArrowEncodedColumn *const encoded = accessor_.EncodedColumn(block, col_id);
+    if (encoded != nullptr)
+      encoded->Decode(start, num_tuples, out_buffer->ColumnStart(i) + attr_size * filled);
+    else
+      std::memcpy(out_buffer->ColumnStart(i) + attr_size * filled,
+                  accessor_.ColumnStart(block, col_id) + attr_size * start, attr_size * num_tuples);
+
+    // Nobody writes to a frozen block while we hold an in-place read, so its bitmap can be read as a regular one
+    const auto *const in_nulls =
+        reinterpret_cast<const common::RawBitmap *>(accessor_.ColumnNullBitmap(block, col_id));
+    out_buffer->ColumnNullBitmap(i)->CopyFrom(filled, *in_nulls, start, num_tuples);
+  }
+
+  for (uint32_t j = 0; j < num_tuples; j++) out_buffer->TupleSlots()[filled + j] = TupleSlot(block, start + j);
+
+  AdvanceInFrozenBlock(start_pos, end_pos, num_tuples);
+  return num_tuples;
+}
+
+bool DataTable::ScanVersionFreeBlock(SlotIterator *const start_pos, const SlotIterator &end_pos,
+                                     ProjectedColumns *const out_buffer, uint32_t *const filled) const {
+  RawBlock *const block = (*start_pos)->GetBlock();
+  if (block->num_versioned_slots_.load() != 0) return false;
+  const SlotIterator saved_pos = *start_pos;
+  const uint32_t saved_filled = *filled;
+  const common::RawConcurrentBitmap *const allocated = accessor_.AllocationBitmap(block);
+  const common::RawConcurrentBitmap *const not_deleted = accessor_.ColumnNullBitmap(block, VERSION_POINTER_COLUMN_ID);
+  const bool ends_in_block = end_pos->GetBlock() == block;
+  const uint32_t end = ends_in_block ? end_pos->GetOffset() : accessor_.GetBlockLayout().NumSlots();
+  uint32_t offset = (*start_pos)->GetOffset();
+  // Same as checking Visible() on every slot, but 64 slots at a time, going straight from one visible slot to the next
+  while (offset < end && *filled < out_buffer->MaxTuples()) {
+    const uint32_t word_start = offset - offset % 64;
+    const uint32_t word_end = std::min(word_start + 64, end);
+    uint64_t visible = allocated->WordAt(word_start) & not_deleted->WordAt(word_start);
+    for (visible &= ~static_cast<uint64_t>(0) << (offset % 64); visible != 0 && *filled < out_buffer->MaxTuples();
+         visible &= visible - 1) {
+      const uint32_t slot_offset = word_start + __builtin_ctzll(visible);
+      if (slot_offset >= word_end) break;
+      const TupleSlot slot(block, slot_offset);
+      ProjectedColumns::RowView row = out_buffer->InterpretAsRow(*filled);
+      for (uint16_t i = 0; i < row.NumColumns(); i++) StorageUtil::CopyAttrIntoProjection(accessor_, slot, &row, i);
+      out_buffer->TupleSlots()[*filled] = slot;
+      (*filled)++;
+      offset = slot_offset + 1;
+    }
+    // Unless the buffer filled up, every slot left in the word was invisible
+    if (*filled < out_buffer->MaxTuples()) offset = word_end;
+  }
+  if (offset < end)
+    start_pos->current_slot_ = {block, offset};
+  else if (ends_in_block)
+    *start_pos = end_pos;
+  else
+    start_pos->AdvanceToNextBlock();
+  // Writers bump the synopsis before changing a slot in place, so if it is still 0 nothing we read can have changed
+  // under us. The GC never brings it back to 0 while we are running, because any version installed after we started
+  // belongs to a transaction that committed after we started, and is thus still visible to us.
+  if (block->num_versioned_slots_.load() == 0) return true;
+  *start_pos = saved_pos;
+  *filled = saved_filled;
+  return false;
+}
+
+RawBlock *DataTable::ScanInPlace(SlotIterator *const start_pos, const SlotIterator &end_pos,
+                                 const col_id_t *const col_ids, const uint16_t num_cols, const uint32_t max_tuples,
+                                 byte **const out_columns, const common::RawBitmap **const out_nulls,
+                                 uint32_t *const num_tuples, const uint32_t **const out_codes,
+                                 const ArrowVarlenColumn **const out_dictionaries,
+                                 ProjectedColumns *const decoded) const {
+  RawBlock *const block = (*start_pos)->GetBlock();
+  const uint32_t start = (*start_pos)->GetOffset();
+  // Null bitmaps can only be handed out from a byte boundary
+  if (block == nullptr || start % BYTE_SIZE != 0 || !block->controller_.TryAcquireInPlaceRead()) return nullptr;
+
+  const BlockLayout &layout = accessor_.GetBlockLayout();
+  // Decoded values have to fit into the decode buffer
+  const uint32_t num_exposed = NumFrozenTuples(
+      *start_pos, end_pos, decoded == nullptr ? max_tuples : std::min(max_tuples, decoded->MaxTuples()));
+  for (uint16_t i = 0; i < num_cols; i++) {
+    TERRIER_ASSERT(col_ids[i] != VERSION_POINTER_COLUMN_ID, "Should not read the version pointer column.");
+    // The encoded copy of the column cannot be taken away while we hold the in-place read, but the column in the
+    // block may have been released, so the values are decoded rather than pointed at
+    const ArrowEncodedColumn *const encoded = accessor_.EncodedColumn(block, col_ids[i]);
+    if (encoded != nullptr) {
+      if (decoded == nullptr) {
+        block->controller_.ReleaseInPlaceRead();
+        return nullptr;
+      }
+      TERRIER_ASSERT(decoded->ColumnIds()[i] == col_ids[i], "decode buffer should hold the given columns in order");
+      encoded->Decode(start, num_exposed, decoded->ColumnStart(i));
+      out_columns[i] = decoded->ColumnStart(i);
+    } else {
+      out_columns[i] = accessor_.ColumnStart(block, col_ids[i]) + layout.AttrSize(col_ids[i]) * start;
+    }
+    // The concurrent bitmap has the same bit layout as a regular one, it just accesses its bytes atomically. Nobody
+    // writes to a frozen block while we hold an in-place read, so plain reads are safe.
+    out_nulls[i] = reinterpret_cast<const common::RawBitmap *>(
+        reinterpret_cast<const uint8_t *>(accessor_.ColumnNullBitmap(block, col_ids[i])) + start / BYTE_SIZE);
+    if (out_codes == nullptr) continue;
+    // The compactor only builds dictionaries when freezing the block, so they stay put while we hold the read
+    const ArrowColumnInfo &col_info = accessor_.GetArrowBlockMetadata(block).GetColumnInfo(layout, col_ids[i]);
+    const bool dictionary_compressed =
+        layout.IsVarlen(col_ids[i]) && col_info.Type() == ArrowColumnType::DICTIONARY_COMPRESSED;
+    out_codes[i] = dictionary_compressed ? col_info.Indices() + start : nullptr;
+    out_dictionaries[i] = dictionary_compressed ? &col_info.VarlenColumn() : nullptr;
+  }
+  block->MarkRead();
+  *num_tuples = num_exposed;
+  AdvanceInFrozenBlock(start_pos, end_pos, *num_tuples);
+  return block;
+}
+
+bool DataTable::ReadZoneMap(const SlotIterator &pos, const col_id_t col_id, ColumnZoneMap *const zone_map,
+                            uint32_t *const num_values) const {
+  RawBlock *const block = pos->GetBlock();
+  TERRIER_ASSERT(!accessor_.GetBlockLayout().IsVarlen(col_id), "Zone maps are only kept for fixed-length columns.");
+  // The in-place read keeps the block from being modified, and thus the zone map from going stale, while we read it.
+  // Zone maps live in the block header, which stays in memory when the block is evicted, so this is not a block read.
+  if (block == nullptr || !block->controller_.TryAcquireInPlaceRead()) return false;
+  const ArrowBlockMetadata &metadata = accessor_.GetArrowBlockMetadata(block);
+  const ColumnZoneMap &block_zone_map = metadata.GetZoneMap(accessor_.GetBlockLayout(), col_id);
+  zone_map->Min() = block_zone_map.Min();
+  zone_map->Max() = block_zone_map.Max();
+  *num_values = metadata.NumRecords() - metadata.NullCount(col_id);
+  block->controller_.ReleaseInPlaceRead();
+  return true;
+}
+
+void DataTable::SkipBlock(SlotIterator *const pos, const SlotIterator &end_pos) const {
+  if (end_pos->GetBlock() == (*pos)->GetBlock()) {
+    *pos = end_pos;
+    return;
+  }
+  pos->AdvanceToNextBlock();
+}
+
+uint32_t DataTable::NumFrozenTuples(const SlotIterator &start_pos, const SlotIterator &end_pos,
+                                    const uint32_t max_tuples) const {
+  RawBlock *const block = start_pos->GetBlock();
+  const uint32_t start = start_pos->GetOffset();
+  // Tuples in a frozen block are contiguous from slot 0, and everything past them is empty.
+  uint32_t end = accessor_.GetArrowBlockMetadata(block).NumRecords();
+  if (end_pos->GetBlock() == block) end = std::min(end, end_pos->GetOffset());
+  return start < end ? std::min(end - start, max_tuples) : 0;
+}
+
+void DataTable::AdvanceInFrozenBlock(SlotIterator *const start_pos, const SlotIterator &end_pos,
+                                     const uint32_t num_tuples) const {
+  RawBlock *const block = (*start_pos)->GetBlock();
+  const uint32_t next = (*start_pos)->GetOffset() + num_tuples;
+  const bool ends_in_block = end_pos->GetBlock() == block;
+  uint32_t end = accessor_.GetArrowBlockMetadata(block).NumRecords();
+  if (ends_in_block) end = std::min(end, end_pos->GetOffset());
+  if (next < end) {
+    // Resume from the next tuple in this block
+    start_pos->current_slot_ = {block, next};
+  } else if (ends_in_block) {
+    *start_pos = end_pos;
+  } else {
+    // The rest of the block is empty, so jump straight to the next block
+    start_pos->AdvanceToNextBlock();
+  }
+}
+
 DataTable::SlotIterator &DataTable::SlotIterator::operator++() {
-  common::SpinLatch::ScopedSpinLatch guard(&table_->blocks_latch_);
   // Jump to the next block if already the last slot in the block.
   if (current_slot_.GetOffset() == table_->accessor_.GetBlockLayout().NumSlots() - 1) {
-    ++block_;
-    // Cannot dereference if the next block is end(), so just use nullptr to denote
-    current_slot_ = {block_ == table_->blocks_.end() ? nullptr : *block_, 0};
+    AdvanceToNextBlock();
   } else {
-    current_slot_ = {*block_, current_slot_.GetOffset() + 1};
+    current_slot_ = {current_slot_.GetBlock(), current_slot_.GetOffset() + 1};
   }
   return *this;
 }
 
 DataTable::SlotIterator DataTable::end() const {  // NOLINT for STL name compability
-  common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
   // TODO(Tianyu): Need to look in detail at how this interacts with compaction when that gets in.
 
   // The end iterator could either point to an unfilled slot in a block, or point to nothing if every block in the
-  // table is full. In the case that it points to nothing, we will use the end-iterator of the blocks list and
+  // table is full. In the case that it points to nothing, we will use the index one past the last block and
   // 0 to denote that this is the case. This solution makes increment logic simple and natural.
-  if (blocks_.empty()) return {this, blocks_.end(), 0};
-  auto last_block = --blocks_.end();
-  uint32_t insert_head = (*last_block)->GetInsertHead();
+  const uint32_t num_blocks = blocks_.Size();
+  if (num_blocks == 0) return {this, 0, 0};
+  const uint32_t last_block = num_blocks - 1;
+  uint32_t insert_head = BlockAt(last_block)->GetInsertHead();
   // Last block is full, return the default end iterator that doesn't point to anything
-  if (insert_head == accessor_.GetBlockLayout().NumSlots()) return {this, blocks_.end(), 0};
+  if (insert_head == accessor_.GetBlockLayout().NumSlots()) return {this, num_blocks, 0};
   // Otherwise, insert head points to the slot that will be inserted next, which would be exactly what we want.
   return {this, last_block, insert_head};
 }
 
+DataTable::SlotIterator DataTable::beginAt(const uint32_t block_idx) const {  // NOLINT for STL name compability
+  if (block_idx < blocks_.Size()) return {this, block_idx, 0};
+  return end();
+}
+
 bool DataTable::Update(transaction::TransactionContext *const txn, const TupleSlot slot, const ProjectedRow &redo) {
   TERRIER_ASSERT(redo.NumColumns() <= accessor_.GetBlockLayout().NumColumns() - NUM_RESERVED_COLUMNS,
                  "The input buffer cannot change the reserved columns, so it should have fewer attributes.");
   TERRIER_ASSERT(redo.NumColumns() > 0, "The input buffer should modify at least one attribute.");
   UndoRecord *const undo = txn->UndoRecordForUpdate(this, slot, redo);
   slot.GetBlock()->controller_.WaitUntilHot();
+  ThawColumns(txn, slot.GetBlock(), redo.ColumnIds(), redo.NumColumns());
   UndoRecord *version_ptr;
   do {
     version_ptr = AtomicallyReadVersionPtr(slot, accessor_);
@@ -114,6 +333,12 @@ bool DataTable::Update(transaction::TransactionContext *const txn, const TupleSl
     // Update the next pointer of the new head of the version chain
     undo->Next() = version_ptr;
   } while (!CompareAndSwapVersionPtr(slot, accessor_, version_ptr, undo));
+  // Must happen before changing the tuple in place, so scans relying on the version synopsis notice the change
+  if (version_ptr == nullptr) slot.GetBlock()->num_versioned_slots_++;
+  // We hold the tuple's write lock now, so cut off what no one can see anymore instead of leaving hot tuples with long
+  // version chains for readers to walk until the next GC pass
+  if (version_ptr != nullptr && txn->OldestActiveStartTime() != transaction::INITIAL_TXN_TIMESTAMP)
+    TruncateVersionChainTail(undo, txn->OldestActiveStartTime());
 
   // Update in place with the new value.
   for (uint16_t i = 0; i < redo.NumColumns(); i++) {
@@ -129,31 +354,142 @@ bool DataTable::Update(transaction::TransactionContext *const txn, const TupleSl
   return true;
 }
 
-void DataTable::CheckMoveHead(std::list<RawBlock *>::iterator block) {
-  // Assume block is full
-  common::SpinLatch::ScopedSpinLatch guard_head(&header_latch_);
-  if (block == insertion_head_) {
-    // If the header block is full, move the header to point to the next block
-    insertion_head_++;
+void DataTable::TruncateVersionChainTail(UndoRecord *const head, const transaction::timestamp_t oldest) const {
+  // Anything behind the head is our own, committed or aborted, and the GC is the only one that can cut the chain
+  // concurrently. Both of us only ever cut, so at worst we cut behind a record that is no longer in the chain.
+  UndoRecord *curr = head;
+  for (UndoRecord *next = curr->Next().load(); next != nullptr; curr = next, next = curr->Next().load()) {
+    // Every running transaction started after this record was written, so none of them can need it or anything
+    // older. Readers already past this point only go on to records that are deallocated later than the GC unlinks
+    // them, which is never before they are done.
+    if (transaction::TransactionUtil::NewerThan(oldest, next->EffectiveTimestamp())) {
+      curr->Next().store(nullptr);
+      return;
+    }
   }
+}
 
-  // If there are no more free blocks, create a new empty block and  point the insertion_head to it
-  if (insertion_head_ == blocks_.end()) {
-    RawBlock *new_block = NewBlock();
-    // take latch
-    common::SpinLatch::ScopedSpinLatch guard_block(&blocks_latch_);
-    // insert block
-    blocks_.push_back(new_block);
-    // set insertion header to --end()
-    insertion_head_ = --blocks_.end();
-  }
+void DataTable::CheckMoveHead(const uint32_t block_idx) {
+  // Assume block is full. If the header block is full, move the header to point to the next block
+  uint32_t expected = block_idx;
+  if (!insertion_head_.compare_exchange_strong(expected, block_idx + 1)) return;
+
+  // If there are no more free blocks, create a new empty block for the insertion head to point to
+  if (block_idx + 1 == blocks_.Size()) AppendBlock(NewBlock());
 }
 
 TupleSlot DataTable::Insert(transaction::TransactionContext *const txn, const ProjectedRow &redo) {
   TERRIER_ASSERT(redo.NumColumns() == accessor_.GetBlockLayout().NumColumns() - NUM_RESERVED_COLUMNS,
                  "The input buffer never changes the version pointer column, so it should have  exactly 1 fewer "
                  "attribute than the DataTable's layout.");
+  TupleSlot result;
+  AllocateSlots(1, &result);
+  InsertInto(txn, redo, result);
 
+  data_table_counter_.IncrementNumInsert(1);
+  return result;
+}
+
+void DataTable::InsertBatch(transaction::TransactionContext *const txn, const ProjectedColumns &redo,
+                            TupleSlot *const slots) {
+  TERRIER_ASSERT(redo.NumColumns() == accessor_.GetBlockLayout().NumColumns() - NUM_RESERVED_COLUMNS,
+                 "The input buffer never changes the version pointer column, so it should have  exactly 1 fewer "
+                 "attribute than the DataTable's layout.");
+  // Undo records of a run of slots are reserved together, so a run cannot be longer than a buffer segment can hold
+  constexpr uint32_t max_run = common::Constants::BUFFER_SEGMENT_SIZE / sizeof(UndoRecord);
+  for (uint32_t inserted = 0; inserted < redo.NumTuples();) {
+    TupleSlot first;
+    const uint32_t num_slots = AllocateSlots(std::min(max_run, redo.NumTuples() - inserted), &first);
+    RawBlock *const block = first.GetBlock();
+    TERRIER_ASSERT(block->controller_.GetBlockState()->load() == BlockState::HOT,
+                   "Should only be able to insert into hot blocks");
+    ThawColumns(txn, block, redo.ColumnIds(), redo.NumColumns());
+
+    // Same protocol as InsertInto, done for the whole run at once: install the undo records, bump the version synopsis
+    // before any of the tuples become present, then make them present and copy in the values
+    UndoRecord *const undos = txn->UndoRecordsForInsert(this, first, num_slots);
+    for (uint32_t i = 0; i < num_slots; i++) {
+      const TupleSlot slot(block, first.GetOffset() + i);
+      TERRIER_ASSERT(accessor_.IsNull(slot, VERSION_POINTER_COLUMN_ID),
+                     "The slot needs to be logically deleted to every running transaction");
+      AtomicallyWriteVersionPtr(slot, accessor_, undos + i);
+      slots[inserted + i] = slot;
+    }
+    block->num_versioned_slots_ += num_slots;
+    for (uint32_t i = 0; i < num_slots; i++)
+      accessor_.AccessForceNotNull({block, first.GetOffset() + i}, VERSION_POINTER_COLUMN_ID);
+
+    for (uint16_t col = 0; col < redo.NumColumns(); col++) {
+      const col_id_t col_id = redo.ColumnIds()[col];
+      TERRIER_ASSERT(col_id != VERSION_POINTER_COLUMN_ID,
+                     "Insert buffer should not change the version pointer column.");
+      const uint32_t attr_size = redo.AttrSizeForColumn(col);
+      // Both sides store the column contiguously, so the values of the whole run are copied at once
+      std::memcpy(accessor_.ColumnStart(block, col_id) + attr_size * first.GetOffset(),
+                  redo.ColumnStart(col) + attr_size * inserted, attr_size * num_slots);
+      const common::RawBitmap *nulls = redo.ColumnNullBitmap(col);
+      common::RawConcurrentBitmap *block_nulls = accessor_.ColumnNullBitmap(block, col_id);
+      for (uint32_t i = 0; i < num_slots; i++) {
+        const bool present = nulls->Test(inserted + i);
+        if (block_nulls->Test(first.GetOffset() + i) != present) block_nulls->Flip(first.GetOffset() + i, !present);
+      }
+    }
+    inserted += num_slots;
+  }
+
+  data_table_counter_.IncrementNumInsert(redo.NumTuples());
+}
+
+uint32_t DataTable::AllocateSlots(const uint32_t max_slots, TupleSlot *const first) {
+  // Single inserts fill the holes left by deleted tuples before taking fresh slots
+  if (max_slots == 1 && AllocateRecycledSlot(first)) return 1;
+  uint32_t num_slots;
+  if (thread_local_insertion_.load()) {
+    auto claimed = claimed_insertion_blocks_.find(table_id_);
+    if (claimed != claimed_insertion_blocks_.end()) {
+      InsertionClaim *const claim = claimed->second.get();
+      // We hold on to the busy bit of our claimed block, so nobody else can allocate in it and there is no need to
+      // flip the bit for every insert. Nobody else touches the claim unless they revoke it, so this does not contend.
+      uint8_t idle = InsertionClaim::IDLE;
+      if (claim->state_.compare_exchange_strong(idle, InsertionClaim::IN_USE)) {
+        num_slots = accessor_.AllocateRange(claim->block_, max_slots, first);
+        claim->state_.store(InsertionClaim::IDLE);
+        if (num_slots > 0) return num_slots;
+        // The claimed block is full, hand it back to the table
+        RevokeClaim(claim);
+      }
+      claimed_insertion_blocks_.erase(claimed);
+    }
+    const uint32_t block_idx = ClaimInsertionBlock(max_slots, first, &num_slots);
+    auto claim = std::make_shared<InsertionClaim>(first->GetBlock(), block_idx);
+    {
+      common::SpinLatch::ScopedSpinLatch guard(&claims_latch_);
+      if (!thread_local_insertion_.load()) {
+        // Thread-local insertion was turned off in the meantime, so our claim would never be revoked
+        accessor_.ClearBlockBusyStatus(first->GetBlock());
+        return num_slots;
+      }
+      claims_.erase(std::remove_if(claims_.begin(), claims_.end(),
+                                   [](const std::shared_ptr<InsertionClaim> &c) {
+                                     return c->state_.load() == InsertionClaim::REVOKED;
+                                   }),
+                    claims_.end());
+      claims_.push_back(claim);
+    }
+    // Forget about the claims of ours that were revoked, including those on tables that have been destroyed since
+    for (auto it = claimed_insertion_blocks_.begin(); it != claimed_insertion_blocks_.end();)
+      it = it->second->state_.load() == InsertionClaim::REVOKED ? claimed_insertion_blocks_.erase(it) : ++it;
+    claimed_insertion_blocks_[table_id_] = std::move(claim);
+    return num_slots;
+  }
+  ClaimInsertionBlock(max_slots, first, &num_slots);
+  // Do not need to wait unit finish inserting,
+  // can flip back the status bit once the thread gets the allocated tuple slots
+  accessor_.ClearBlockBusyStatus(first->GetBlock());
+  return num_slots;
+}
+
+uint32_t DataTable::ClaimInsertionBlock(const uint32_t max_slots, TupleSlot *const first, uint32_t *const num_slots) {
   // Insertion header points to the first block that has free tuple slots
   // Once a txn arrives, it will start from the insertion header to find the first
   // idle (no other txn is trying to get tuple slots in that block) and non-full block.
@@ -161,47 +497,88 @@ TupleSlot DataTable::Insert(transaction::TransactionContext *const txn, const Pr
   // Before the txn writes to the block, it will set block status to busy.
   // The first bit of block insert_head_ is used to indicate if the block is busy
   // If the first bit is 1, it indicates one txn is writing to the block.
-
-  TupleSlot result;
-  auto block = insertion_head_;
-  while (true) {
+  for (uint32_t block_idx = insertion_head_.load();; ++block_idx) {
     // No free block left
-    if (block == blocks_.end()) {
-      RawBlock *new_block = NewBlock();
-      TERRIER_ASSERT(accessor_.SetBlockBusyStatus(new_block), "Status of new block should not be busy");
+    if (block_idx >= blocks_.Size()) {
+      RawBlock *block = NewBlock();
+      // Not in an assert, as the busy bit has to be set in release builds too
+      bool UNUSED_ATTRIBUTE set_busy = accessor_.SetBlockBusyStatus(block);
+      TERRIER_ASSERT(set_busy, "Status of new block should not be busy");
       // No need to flip the busy status bit
-      accessor_.Allocate(new_block, &result);
-      // take latch
-      common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-      // insert block
-      blocks_.push_back(new_block);
-      block = --blocks_.end();
-      break;
+      *num_slots = accessor_.AllocateRange(block, max_slots, first);
+      return AppendBlock(block);
     }
 
-    if (accessor_.SetBlockBusyStatus(*block)) {
+    RawBlock *block = BlockAt(block_idx);
+    if (accessor_.SetBlockBusyStatus(block)) {
       // No one is inserting into this block
-      if (accessor_.Allocate(*block, &result)) {
+      *num_slots = accessor_.AllocateRange(block, max_slots, first);
+      if (*num_slots > 0) {
         // The block is not full, succeed
-        break;
+        return block_idx;
       }
       // Fail to insert into the block, flip back the status bit
-      accessor_.ClearBlockBusyStatus(*block);
+      accessor_.ClearBlockBusyStatus(block);
       // if the full block is the insertion_header, move the insertion_header
       // Next insert txn will search from the new insertion_header
-      CheckMoveHead(block);
+      CheckMoveHead(block_idx);
     }
     // The block is full or the block is being inserted by other txn, try next block
-    ++block;
   }
+}
 
-  // Do not need to wait unit finish inserting,
-  // can flip back the status bit once the thread gets the allocated tuple slot
-  accessor_.ClearBlockBusyStatus(*block);
-  InsertInto(txn, redo, result);
+void DataTable::SetThreadLocalInsertion(const bool enabled) {
+  common::SpinLatch::ScopedSpinLatch guard(&claims_latch_);
+  thread_local_insertion_ = enabled;
+  if (enabled) return;
+  // Hand back every claimed block, as their owners may never insert into this table again
+  for (auto &claim : claims_) RevokeClaim(claim.get());
+  claims_.clear();
+}
 
-  data_table_counter_.IncrementNumInsert(1);
-  return result;
+void DataTable::ReleaseThreadLocalBlock() {
+  auto claimed = claimed_insertion_blocks_.find(table_id_);
+  if (claimed == claimed_insertion_blocks_.end()) return;
+  RevokeClaim(claimed->second.get());
+  claimed_insertion_blocks_.erase(claimed);
+}
+
+void DataTable::RevokeClaim(InsertionClaim *const claim) {
+  uint8_t expected = InsertionClaim::IDLE;
+  while (!claim->state_.compare_exchange_weak(expected, InsertionClaim::REVOKED)) {
+    if (expected == InsertionClaim::REVOKED) return;
+    // The owner is allocating from the block, which does not take long
+    expected = InsertionClaim::IDLE;
+    std::this_thread::yield();
+  }
+  RawBlock *const block = claim->block_;
+  accessor_.ClearBlockBusyStatus(block);
+  if (block->GetInsertHead() == accessor_.GetBlockLayout().NumSlots()) CheckMoveHead(claim->block_idx_);
+}
+
+void DataTable::RecycleSlot(const TupleSlot slot) {
+  accessor_.Deallocate(slot);
+  // Slots in blocks that the compactor has started cooling since the delete are left for the compactor to fill, as in
+  // GarbageCollector::ReclaimSlotIfDeleted. Should the compactor start right after this check, AllocateRecycledSlot
+  // skips the slot instead.
+  if (slot.GetBlock()->controller_.GetBlockState()->load() != BlockState::HOT) return;
+  if (AtomicallyReadVersionPtr(slot, accessor_) != nullptr) return;
+  free_slots_.Enqueue(slot);
+}
+
+bool DataTable::AllocateRecycledSlot(TupleSlot *const slot) {
+  TupleSlot recycled;
+  while (free_slots_.Dequeue(&recycled)) {
+    RawBlock *block = recycled.GetBlock();
+    if (block->controller_.GetBlockState()->load() != BlockState::HOT) continue;
+    // Fails if the compactor has moved a tuple into the slot since it was put on the list
+    if (!accessor_.Reallocate(recycled)) continue;
+    // The compactor may have started cooling the block after we checked; take it back like any other writer would
+    block->controller_.WaitUntilHot();
+    *slot = recycled;
+    return true;
+  }
+  return false;
 }
 
 void DataTable::InsertInto(transaction::TransactionContext *txn, const ProjectedRow &redo, TupleSlot dest) {
@@ -213,7 +590,10 @@ void DataTable::InsertInto(transaction::TransactionContext *txn, const Projected
   UndoRecord *undo = txn->UndoRecordForInsert(this, dest);
   TERRIER_ASSERT(dest.GetBlock()->controller_.GetBlockState()->load() == BlockState::HOT,
                  "Should only be able to insert into hot blocks");
+  ThawColumns(txn, dest.GetBlock(), redo.ColumnIds(), redo.NumColumns());
   AtomicallyWriteVersionPtr(dest, accessor_, undo);
+  // Must happen before the tuple becomes present, so scans relying on the version synopsis notice the change
+  dest.GetBlock()->num_versioned_slots_++;
   // Set the logically deleted bit to present as the undo record is ready
   accessor_.AccessForceNotNull(dest, VERSION_POINTER_COLUMN_ID);
   // Update in place with the new value.
@@ -224,6 +604,24 @@ void DataTable::InsertInto(transaction::TransactionContext *txn, const Projected
   }
 }
 
+void DataTable::ThawColumns(transaction::TransactionContext *const txn, RawBlock *const block,
+                            const col_id_t *const col_ids, const uint16_t num_cols) const {
+  // Most blocks have never been frozen
+  if (accessor_.GetArrowBlockMetadata(block).NumEncodedColumns().load() == 0) return;
+  for (uint16_t i = 0; i < num_cols; i++) {
+    ArrowEncodedColumn *const encoded = accessor_.ThawColumn(block, col_ids[i]);
+    if (encoded == nullptr) continue;
+    // Readers that found the encoded copy before we took it away may still be decoding from it, so it is freed the
+    // same way as the varlens the compactor replaces
+    const transaction::TransactionEndAction free_encoded =
+        [encoded](transaction::DeferredActionManager *deferred_action_manager) {
+          deferred_action_manager->RegisterDeferredAction([encoded] { delete encoded; });
+        };
+    txn->RegisterCommitAction(free_encoded);
+    txn->RegisterAbortAction(free_encoded);
+  }
+}
+
 bool DataTable::Delete(transaction::TransactionContext *const txn, const TupleSlot slot) {
   data_table_counter_.IncrementNumDelete(1);
   UndoRecord *const undo = txn->UndoRecordForDelete(this, slot);
@@ -243,6 +641,12 @@ bool DataTable::Delete(transaction::TransactionContext *const txn, const TupleSl
     // Update the next pointer of the new head of the version chain
     undo->Next() = version_ptr;
   } while (!CompareAndSwapVersionPtr(slot, accessor_, version_ptr, undo));
+  // Must happen before changing the tuple in place, so scans relying on the version synopsis notice the change
+  if (version_ptr == nullptr) slot.GetBlock()->num_versioned_slots_++;
+  // We hold the tuple's write lock now, so cut off what no one can see anymore instead of leaving hot tuples with long
+  // version chains for readers to walk until the next GC pass
+  if (version_ptr != nullptr && txn->OldestActiveStartTime() != transaction::INITIAL_TXN_TIMESTAMP)
+    TruncateVersionChainTail(undo, txn->OldestActiveStartTime());
 
   // We have the write lock. Go ahead and flip the logically deleted bit to true
   accessor_.SetNull(slot, VERSION_POINTER_COLUMN_ID);
@@ -310,7 +714,7 @@ bool DataTable::SelectIntoBuffer(transaction::TransactionContext *const txn, con
 
   // Apply deltas until we reconstruct a version safe for us to read
   while (version_ptr != nullptr &&
-         transaction::TransactionUtil::NewerThan(version_ptr->Timestamp().load(), txn->StartTime())) {
+         transaction::TransactionUtil::NewerThan(version_ptr->EffectiveTimestamp(), txn->StartTime())) {
     switch (version_ptr->Type()) {
       case DeltaRecordType::UPDATE:
         // Normal delta to be applied. Does not modify the logical delete column.
@@ -358,7 +762,7 @@ bool DataTable::Visible(const TupleSlot slot, const TupleAccessStrategy &accesso
 
 bool DataTable::HasConflict(const transaction::TransactionContext &txn, UndoRecord *const version_ptr) const {
   if (version_ptr == nullptr) return false;  // Nobody owns this tuple's write lock, no older version visible
-  const transaction::timestamp_t version_timestamp = version_ptr->Timestamp().load();
+  const transaction::timestamp_t version_timestamp = version_ptr->EffectiveTimestamp();
   const transaction::timestamp_t txn_id = txn.FinishTime();
   const transaction::timestamp_t start_time = txn.StartTime();
   const bool owned_by_other_txn =
@@ -405,7 +809,7 @@ bool DataTable::IsVisible(const transaction::TransactionContext &txn, const Tupl
 
   // Apply deltas until we determine a version safe for us to read
   while (version_ptr != nullptr &&
-         transaction::TransactionUtil::NewerThan(version_ptr->Timestamp().load(), txn.StartTime())) {
+         transaction::TransactionUtil::NewerThan(version_ptr->EffectiveTimestamp(), txn.StartTime())) {
     switch (version_ptr->Type()) {
       case DeltaRecordType::UPDATE:
         // Normal delta to be applied. Does not modify the logical delete column.
@@ -1,8 +1,13 @@
 #include "storage/garbage_collector.h"
+#include <algorithm>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 #include "common/macros.h"
+#include "common/scoped_timer.h"
+#include "common/thread_context.h"
 #include "loggers/storage_logger.h"
+#include "metrics/metrics_store.h"
 #include "storage/data_table.h"
 #include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_context.h"
@@ -14,24 +19,61 @@ namespace terrier::storage {
 
 std::pair<uint32_t, uint32_t> GarbageCollector::PerformGarbageCollection() {
   if (observer_ != nullptr) observer_->ObserveGCInvocation();
-  timestamp_manager_->CheckOutTimestamp();
-  const transaction::timestamp_t oldest_txn = timestamp_manager_->OldestTransactionStartTime();
-  uint32_t txns_deallocated = ProcessDeallocateQueue(oldest_txn);
-  STORAGE_LOG_TRACE("GarbageCollector::PerformGarbageCollection(): txns_deallocated: {}", txns_deallocated);
-  uint32_t txns_unlinked = ProcessUnlinkQueue(oldest_txn);
-  STORAGE_LOG_TRACE("GarbageCollector::PerformGarbageCollection(): txns_unlinked: {}", txns_unlinked);
-  if (txns_unlinked > 0) {
-    // Only update this field if we actually unlinked anything, otherwise we're being too conservative about when it's
-    // safe to deallocate the transactions in our queue.
-    last_unlinked_ = timestamp_manager_->CheckOutTimestamp();
+  uint32_t txns_deallocated, txns_unlinked;
+  transaction::timestamp_t now, oldest_txn;
+  uint64_t elapsed_us;
+  {
+    common::ScopedTimer<std::chrono::microseconds> timer(&elapsed_us);
+    ResizeWorkers();
+    now = timestamp_manager_->CheckOutTimestamp();
+    oldest_txn = timestamp_manager_->OldestTransactionStartTime();
+    txns_deallocated = ProcessDeallocateQueue(oldest_txn);
+    STORAGE_LOG_TRACE("GarbageCollector::PerformGarbageCollection(): txns_deallocated: {}", txns_deallocated);
+    txns_unlinked = ProcessUnlinkQueue(oldest_txn);
+    STORAGE_LOG_TRACE("GarbageCollector::PerformGarbageCollection(): txns_unlinked: {}", txns_unlinked);
+    if (txns_unlinked > 0) {
+      // Only update this field if we actually unlinked anything, otherwise we're being too conservative about when
+      // it's safe to deallocate the transactions in our queue.
+      last_unlinked_ = timestamp_manager_->CheckOutTimestamp();
+    }
+    STORAGE_LOG_TRACE("GarbageCollector::PerformGarbageCollection(): last_unlinked_: {}",
+                      static_cast<uint64_t>(last_unlinked_));
+    ProcessDeferredActions(oldest_txn);
+    ProcessIndexes();
+  }
+
+  if (common::thread_context.metrics_store_ != nullptr &&
+      common::thread_context.metrics_store_->ComponentEnabled(metrics::MetricsComponent::GARBAGECOLLECTION)) {
+    // The oldest running transaction bounds what the pass could collect, so how far it trails the clock is how far
+    // behind the GC is bound to be, however fast it runs
+    const uint64_t lag = transaction::TransactionUtil::NewerThan(now, oldest_txn) ? !now - !oldest_txn : 0;
+    common::thread_context.metrics_store_->RecordGarbageCollectionData(
+        elapsed_us, workers_.NumWorkers() == 0 ? 1 : workers_.NumWorkers(), txns_deallocated, txns_unlinked,
+        static_cast<uint64_t>(std::distance(txns_to_unlink_.cbegin(), txns_to_unlink_.cend())),
+        static_cast<uint64_t>(std::distance(txns_to_deallocate_.cbegin(), txns_to_deallocate_.cend())), lag);
   }
-  STORAGE_LOG_TRACE("GarbageCollector::PerformGarbageCollection(): last_unlinked_: {}",
-                    static_cast<uint64_t>(last_unlinked_));
-  ProcessDeferredActions(oldest_txn);
-  ProcessIndexes();
   return std::make_pair(txns_deallocated, txns_unlinked);
 }
 
+void GarbageCollector::ResizeWorkers() {
+  const uint32_t num_workers = num_workers_.load();
+  // A single worker is the invoking thread itself
+  const uint32_t num_threads = num_workers == 1 ? 0 : num_workers;
+  if (workers_.NumWorkers() == num_threads) return;
+  workers_.Shutdown();
+  workers_.SetNumWorkers(num_threads);
+  workers_.Startup();
+}
+
+void GarbageCollector::RunOnWorkers(const std::vector<std::function<void()>> &tasks) {
+  if (workers_.NumWorkers() == 0) {
+    for (const auto &task : tasks) task();
+    return;
+  }
+  for (const auto &task : tasks) workers_.SubmitTask(task);
+  workers_.WaitUntilAllFinished();
+}
+
 uint32_t GarbageCollector::ProcessDeallocateQueue(transaction::timestamp_t oldest_txn) {
   uint32_t txns_processed = 0;
 
@@ -39,11 +81,20 @@ uint32_t GarbageCollector::ProcessDeallocateQueue(transaction::timestamp_t oldes
     // All of the transactions in my deallocation queue were unlinked before the oldest running txn in the system, and
     // have been serialized by the log manager. We are now safe to deallocate these txns because no running
     // transaction should hold a reference to them anymore
-    for (auto &txn : txns_to_deallocate_) {
-      delete txn;
-      txns_processed++;
-    }
+    std::vector<transaction::TransactionContext *> txns(txns_to_deallocate_.begin(), txns_to_deallocate_.end());
     txns_to_deallocate_.clear();
+    txns_processed = static_cast<uint32_t>(txns.size());
+    // Hand every worker an even share of the transactions
+    const uint32_t num_batches = std::max(workers_.NumWorkers(), 1U);
+    const uint64_t batch_size = (txns.size() + num_batches - 1) / num_batches;
+    std::vector<std::function<void()>> tasks;
+    for (uint64_t begin = 0; begin < txns.size(); begin += batch_size) {
+      const uint64_t end = std::min(begin + batch_size, static_cast<uint64_t>(txns.size()));
+      tasks.emplace_back([&txns, begin, end] {
+        for (uint64_t i = begin; i < end; i++) delete txns[i];
+      });
+    }
+    RunOnWorkers(tasks);
   }
   return txns_processed;
 }
@@ -53,6 +104,12 @@ uint32_t GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_tx
 
   // Get the completed transactions from the TransactionManager
   transaction::TransactionQueue completed_txns = txn_manager_->CompletedTransactionsForGC();
+  // Committing does not stamp the undo records, as readers can find the commit timestamp through the transaction.
+  // Truncation only looks at the records themselves though, so stamp them before any version chain is truncated.
+  for (transaction::TransactionContext *const completed : completed_txns) {
+    if (completed->Aborted()) continue;  // Aborts stamp their records themselves
+    for (auto &undo_record : completed->undo_buffer_) undo_record.Timestamp().store(completed->FinishTime());
+  }
   if (!completed_txns.empty()) {
     // Append to our local unlink queue
     txns_to_unlink_.splice_after(txns_to_unlink_.cbefore_begin(), std::move(completed_txns));
@@ -61,10 +118,11 @@ uint32_t GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_tx
   uint32_t txns_processed = 0;
   // Certain transactions might not be yet safe to gc. Need to requeue them
   transaction::TransactionQueue requeue;
-  // It is sufficient to truncate each version chain once in a GC invocation because we only read the maximal safe
-  // timestamp once, and the version chain is sorted by timestamp. Here we keep a set of slots to truncate to avoid
-  // wasteful traversals of the version chain.
-  std::unordered_set<TupleSlot> visited_slots;
+  // The records of the transactions that are safe to gc, grouped by table. No two workers ever touch the same version
+  // chain, so version chains can be truncated as if by a single-threaded GC.
+  std::unordered_map<DataTable *, UnlinkPartition> partitions;
+  // Accesses that have no table to be unlinked from
+  std::vector<RawBlock *> accessed_blocks;
 
   // Process every transaction in the unlink queue
   while (!txns_to_unlink_.empty()) {
@@ -79,18 +137,11 @@ uint32_t GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_tx
       // Safe to garbage collect.
       for (auto &undo_record : txn->undo_buffer_) {
         // It is possible for the table field to be null, for aborted transaction's last conflicting record
-        DataTable *&table = undo_record.Table();
-        // Each version chain needs to be traversed and truncated at most once every GC period. Check
-        // if we have already visited this tuple slot; if not, proceed to prune the version chain.
-        if (table != nullptr && visited_slots.insert(undo_record.Slot()).second)
-          TruncateVersionChain(table, undo_record.Slot(), oldest_txn);
-        // Regardless of the version chain we will need to reclaim deleted slots and any dangling pointers to varlens,
-        // unless the transaction is aborted, and the record holds a version that is still visible.
-        if (!txn->Aborted()) {
-          ReclaimSlotIfDeleted(&undo_record);
-          ReclaimBufferIfVarlen(txn, &undo_record);
-        }
-        if (observer_ != nullptr) observer_->ObserveWrite(undo_record.Slot().GetBlock());
+        DataTable *const table = undo_record.Table();
+        if (table == nullptr)
+          accessed_blocks.push_back(undo_record.Slot().GetBlock());
+        else
+          partitions[table].records_.emplace_back(txn, &undo_record);
       }
       txns_to_deallocate_.push_front(txn);
       txns_processed++;
@@ -100,12 +151,49 @@ uint32_t GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_tx
     }
   }
 
+  std::vector<std::function<void()>> tasks;
+  tasks.reserve(partitions.size());
+  for (auto &partition : partitions)
+    tasks.emplace_back([this, &partition, oldest_txn] { UnlinkTable(&partition.second, oldest_txn); });
+  RunOnWorkers(tasks);
+
+  // Neither the transactions nor the observer are thread-safe, so what the workers left for them is handed over here
+  for (auto &partition : partitions) {
+    for (auto &loose_ptr : partition.second.loose_ptrs_) loose_ptr.first->loose_ptrs_.push_back(loose_ptr.second);
+    if (observer_ != nullptr)
+      for (RawBlock *const block : partition.second.accessed_blocks_) observer_->ObserveWrite(block);
+  }
+  if (observer_ != nullptr)
+    for (RawBlock *const block : accessed_blocks) observer_->ObserveWrite(block);
+
   // Requeue any txns that we were still visible to running transactions
   txns_to_unlink_ = transaction::TransactionQueue(std::move(requeue));
 
   return txns_processed;
 }
 
+void GarbageCollector::UnlinkTable(UnlinkPartition *const partition, const transaction::timestamp_t oldest_txn) const {
+  // It is sufficient to truncate each version chain once in a GC invocation because we only read the maximal safe
+  // timestamp once, and the version chain is sorted by timestamp. Here we keep a set of slots to truncate to avoid
+  // wasteful traversals of the version chain.
+  std::unordered_set<TupleSlot> visited_slots;
+  for (const auto &record : partition->records_) {
+    transaction::TransactionContext *const txn = record.first;
+    UndoRecord *const undo_record = record.second;
+    // Each version chain needs to be traversed and truncated at most once every GC period. Check
+    // if we have already visited this tuple slot; if not, proceed to prune the version chain.
+    if (visited_slots.insert(undo_record->Slot()).second)
+      TruncateVersionChain(undo_record->Table(), undo_record->Slot(), oldest_txn);
+    // Regardless of the version chain we will need to reclaim deleted slots and any dangling pointers to varlens,
+    // unless the transaction is aborted, and the record holds a version that is still visible.
+    if (!txn->Aborted()) {
+      ReclaimSlotIfDeleted(undo_record);
+      ReclaimBufferIfVarlen(txn, undo_record, &partition->loose_ptrs_);
+    }
+    partition->accessed_blocks_.push_back(undo_record->Slot().GetBlock());
+  }
+}
+
 void GarbageCollector::ProcessDeferredActions(transaction::timestamp_t oldest_txn) {
   if (deferred_action_manager_ != DISABLED) {
     // TODO(Tianyu): Eventually we will remove the GC and implement version chain pruning with deferred actions
@@ -125,15 +213,19 @@ void GarbageCollector::TruncateVersionChain(DataTable *const table, const TupleS
   // here. Instead of a blind update we will need to CAS and prune the entire version chain if the head of the version
   // chain can be GCed.
   if (transaction::TransactionUtil::NewerThan(oldest, version_ptr->Timestamp().load())) {
-    if (!table->CompareAndSwapVersionPtr(slot, accessor, version_ptr, nullptr))
+    if (!table->CompareAndSwapVersionPtr(slot, accessor, version_ptr, nullptr)) {
       // Keep retrying while there are conflicts, since we only invoke truncate once per GC period for every
       // version chain.
       TruncateVersionChain(table, slot, oldest);
+      return;
+    }
+    // The slot no longer has any versions, which may let scans skip version chain checks on the whole block again
+    slot.GetBlock()->num_versioned_slots_--;
     return;
   }
 
-  // a version chain is guaranteed to not change when not at the head (assuming single-threaded GC), so we are safe
-  // to traverse and update pointers without CAS
+  // a version chain is guaranteed to not change when not at the head (assuming single-threaded GC), other than writers
+  // cutting off its tail the same way we do, so we are safe to traverse and update pointers without CAS
   UndoRecord *curr = version_ptr;
   UndoRecord *next;
   // Traverse until we find the earliest UndoRecord that can be unlinked.
@@ -156,11 +248,23 @@ void GarbageCollector::TruncateVersionChain(DataTable *const table, const TupleS
 }
 
 void GarbageCollector::ReclaimSlotIfDeleted(UndoRecord *const undo_record) const {
-  if (undo_record->Type() == DeltaRecordType::DELETE) undo_record->Table()->accessor_.Deallocate(undo_record->Slot());
+  if (undo_record->Type() != DeltaRecordType::DELETE) return;
+  DataTable *const table = undo_record->Table();
+  const TupleSlot slot = undo_record->Slot();
+  // Slots in blocks that the compactor has started cooling are left for the compactor to fill
+  if (deferred_action_manager_ == DISABLED || slot.GetBlock()->controller_.GetBlockState()->load() != BlockState::HOT) {
+    table->accessor_.Deallocate(slot);
+    return;
+  }
+  // Indexes remove the deleted tuple's entries in deferred actions registered when the delete committed. The slot
+  // cannot be handed out again before those have run, or they would remove the entries of the new tuple instead.
+  // Deferred actions run in order, so keeping the slot allocated until our own deferred action is enough.
+  deferred_action_manager_->RegisterDeferredAction([=]() { table->RecycleSlot(slot); });
 }
 
-void GarbageCollector::ReclaimBufferIfVarlen(transaction::TransactionContext *const txn,
-                                             UndoRecord *const undo_record) const {
+void GarbageCollector::ReclaimBufferIfVarlen(
+    transaction::TransactionContext *const txn, UndoRecord *const undo_record,
+    std::vector<std::pair<transaction::TransactionContext *, VarlenEntry>> *const loose_ptrs) const {
   const TupleAccessStrategy &accessor = undo_record->Table()->accessor_;
   const BlockLayout &layout = accessor.GetBlockLayout();
   switch (undo_record->Type()) {
@@ -173,7 +277,7 @@ void GarbageCollector::ReclaimBufferIfVarlen(transaction::TransactionContext *co
         // Okay to include version vector, as it is never varlen
         if (layout.IsVarlen(col_id)) {
           auto *varlen = reinterpret_cast<VarlenEntry *>(accessor.AccessWithNullCheck(undo_record->Slot(), col_id));
-          if (varlen != nullptr && varlen->NeedReclaim()) txn->loose_ptrs_.push_back(varlen->Content());
+          if (varlen != nullptr && varlen->NeedReclaim()) loose_ptrs->emplace_back(txn, *varlen);
         }
       }
       break;
@@ -183,7 +287,7 @@ void GarbageCollector::ReclaimBufferIfVarlen(transaction::TransactionContext *co
         col_id_t col_id = undo_record->Delta()->ColumnIds()[i];
         if (layout.IsVarlen(col_id)) {
           auto *varlen = reinterpret_cast<VarlenEntry *>(undo_record->Delta()->AccessWithNullCheck(i));
-          if (varlen != nullptr && varlen->NeedReclaim()) txn->loose_ptrs_.push_back(varlen->Content());
+          if (varlen != nullptr && varlen->NeedReclaim()) loose_ptrs->emplace_back(txn, *varlen);
         }
       }
       break;
@@ -208,7 +312,11 @@ void GarbageCollector::UnregisterIndexForGC(const common::ManagedPointer<index::
 
 void GarbageCollector::ProcessIndexes() {
   common::SharedLatch::ScopedSharedLatch guard(&indexes_latch_);
-  for (const auto &index : indexes_) index->PerformGarbageCollection();
+  // Indexes are independent of each other, so they are collected in parallel
+  std::vector<std::function<void()>> tasks;
+  tasks.reserve(indexes_.size());
+  for (const auto &index : indexes_) tasks.emplace_back([index] { index->PerformGarbageCollection(); });
+  RunOnWorkers(tasks);
 }
 
 }  // namespace terrier::storage
@@ -3,7 +3,13 @@
 namespace terrier::storage {
 GarbageCollectorThread::GarbageCollectorThread(terrier::storage::GarbageCollector *gc,
                                                std::chrono::milliseconds gc_period)
+    : GarbageCollectorThread(gc, gc_period, DISABLED) {}
+
+GarbageCollectorThread::GarbageCollectorThread(terrier::storage::GarbageCollector *gc,
+                                               std::chrono::milliseconds gc_period,
+                                               common::ManagedPointer<metrics::MetricsManager> metrics_manager)
     : gc_(gc),
+      metrics_manager_(metrics_manager),
       run_gc_(true),
       gc_paused_(false),
       gc_period_(gc_period),
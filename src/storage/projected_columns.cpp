@@ -5,7 +5,7 @@
 #include <utility>
 #include <vector>
 namespace terrier::storage {
-uint32_t ProjectedColumns::AttrSizeForColumn(const uint16_t projection_col_index) {
+uint32_t ProjectedColumns::AttrSizeForColumn(const uint16_t projection_col_index) const {
   TERRIER_ASSERT(projection_col_index < num_cols_, "Cannot get size for out-of-bounds column");
   uint8_t shift;
   for (shift = 0; shift < NUM_ATTR_BOUNDARIES; shift++) {
@@ -44,6 +44,7 @@ std::pair<LogRecord *, std::vector<byte *>> AbstractLogProvider::ReadNextRecord(
       auto database_oid = ReadValue<catalog::db_oid_t>();
       auto table_oid = ReadValue<catalog::table_oid_t>();
       auto tuple_slot = ReadValue<storage::TupleSlot>();
+      auto layout_version = ReadValue<storage::layout_version_t>();
 
       // TODO(Gus, PR #468): Future addition of checksums should validate these values in case of data corruption.
       auto num_cols = ReadValue<uint16_t>();
@@ -79,6 +80,7 @@ std::pair<LogRecord *, std::vector<byte *>> AbstractLogProvider::ReadNextRecord(
       auto *result = storage::RedoRecord::Initialize(buf, txn_begin, database_oid, table_oid, initializer);
       auto *record_body = result->GetUnderlyingRecordBodyAs<RedoRecord>();
       record_body->SetTupleSlot(tuple_slot);
+      record_body->SetLayoutVersion(layout_version);
       auto *delta = record_body->Delta();
       TERRIER_ASSERT(delta->NumColumns() == num_cols,
                      "ProjectedRow must have same number of columns as what was serialized.");
@@ -113,11 +115,11 @@ std::pair<LogRecord *, std::vector<byte *>> AbstractLogProvider::ReadNextRecord(
             varlen_entry = storage::VarlenEntry::CreateInline(varlen_attribute_content, varlen_attribute_size);
           } else {
             // Allocate a varlen buffer of this many bytes.
-            auto *varlen_attribute_content = common::AllocationUtil::AllocateAligned(varlen_attribute_size);
+            auto *varlen_attribute_content = varlen_arena_.Allocate(varlen_attribute_size);
             // Fill the entry with the next bytes from the log file.
             Read(varlen_attribute_content, varlen_attribute_size);
 
-            varlen_entry = storage::VarlenEntry::Create(varlen_attribute_content, varlen_attribute_size, true);
+            varlen_entry = storage::VarlenEntry::CreateFromArena(varlen_attribute_content, varlen_attribute_size);
             varlen_contents.push_back(varlen_attribute_content);
           }
           // The attribute value in the ProjectedRow will be a pointer to this varlen entry.
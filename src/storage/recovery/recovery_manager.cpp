@@ -108,7 +108,7 @@ void RecoveryManager::DeferRecordDeletes(terrier::transaction::timestamp_t txn_i
       delete[] reinterpret_cast<byte *>(buffered_pair.first);
       if (delete_varlens) {
         for (auto *varlen_entry : buffered_pair.second) {
-          delete[] varlen_entry;
+          VarlenArena::Free(varlen_entry);
         }
       }
     }
@@ -148,7 +148,7 @@ void RecoveryManager::ReplayRedoRecord(transaction::TransactionContext *txn, Log
     TERRIER_ASSERT(memcmp(redo_record->Delta(), staged_record->Delta(), redo_record->Delta()->Size()) == 0,
                    "ProjectedRow of original and staged records must be identical");
     // Insert will always succeed
-    auto new_tuple_slot = sql_table_ptr->Insert(txn, staged_record);
+    auto new_tuple_slot = sql_table_ptr->Insert(txn, staged_record, staged_record->GetLayoutVersion());
     UpdateIndexesOnTable(txn, staged_record->GetDatabaseOid(), staged_record->GetTableOid(), sql_table_ptr,
                          new_tuple_slot, staged_record->Delta(), true /* insert */);
     TERRIER_ASSERT(staged_record->GetTupleSlot() == new_tuple_slot,
@@ -161,7 +161,7 @@ void RecoveryManager::ReplayRedoRecord(transaction::TransactionContext *txn, Log
     // Stage the write. This way the recovery operation is logged if logging is enabled
     auto staged_record = txn->StageRecoveryWrite(record);
     TERRIER_ASSERT(staged_record->GetTupleSlot() == new_tuple_slot, "Staged record must have the mapped tuple slot");
-    bool result UNUSED_ATTRIBUTE = sql_table_ptr->Update(txn, staged_record);
+    bool result UNUSED_ATTRIBUTE = sql_table_ptr->Update(txn, staged_record, staged_record->GetLayoutVersion());
     TERRIER_ASSERT(result, "Buffered changes should always succeed during commit");
   }
 }
@@ -170,22 +170,19 @@ void RecoveryManager::ReplayDeleteRecord(transaction::TransactionContext *txn, L
   auto *delete_record = record->GetUnderlyingRecordBodyAs<DeleteRecord>();
   // Get tuple slot
   auto new_tuple_slot = GetTupleSlotMapping(delete_record->GetTupleSlot());
-  auto db_catalog_ptr = GetDatabaseCatalog(txn, delete_record->GetDatabaseOid());
-  auto sql_table_ptr = db_catalog_ptr->GetTable(txn, delete_record->GetTableOid());
-  const auto &schema = GetTableSchema(txn, db_catalog_ptr, delete_record->GetTableOid());
+  auto sql_table_ptr = GetSqlTable(txn, delete_record->GetDatabaseOid(), delete_record->GetTableOid());
 
   // Stage the delete. This way the recovery operation is logged if logging is enabled
   txn->StageDelete(delete_record->GetDatabaseOid(), delete_record->GetTableOid(), new_tuple_slot);
 
-  // Fetch all the values so we can construct index keys after deleting from the sql table
-  std::vector<catalog::col_oid_t> all_table_oids;
-  for (const auto &col : schema.GetColumns()) {
-    all_table_oids.push_back(col.Oid());
-  }
-  auto initializer = sql_table_ptr->InitializerForProjectedRow(all_table_oids);
+  // Fetch all the values so we can construct index keys after deleting from the sql table. The tuple has a value for
+  // every column of the layout version it is stored under.
+  const auto version = new_tuple_slot.GetBlock()->layout_version_;
+  const auto &layout = sql_table_ptr->Version(version).layout_;
+  auto initializer = ProjectedRowInitializer::Create(layout, layout.AllColumns());
   auto *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
   auto pr = initializer.InitializeRow(buffer);
-  sql_table_ptr->Select(txn, new_tuple_slot, pr);
+  sql_table_ptr->Select(txn, new_tuple_slot, pr, version);
 
   // Delete from the table
   bool result UNUSED_ATTRIBUTE = sql_table_ptr->Delete(txn, new_tuple_slot);
@@ -291,14 +288,12 @@ void RecoveryManager::UpdateIndexesOnTable(transaction::TransactionContext *txn,
   }
   auto *index_buffer = common::AllocationUtil::AllocateAligned(max_index_key_pr_size);
 
-  // Build a PR map for all columns in the table, as the table pr should have values for every column
-  const auto &table_schema = GetTableSchema(txn, db_catalog_ptr, table_oid);
-  std::vector<catalog::col_oid_t> all_table_oids;
-  for (const auto &col : table_schema.GetColumns()) {
-    all_table_oids.push_back(col.Oid());
-  }
-  auto pr_map = table_ptr->ProjectionMapForOids(all_table_oids);
-  TERRIER_ASSERT(pr_map.size() == table_pr->NumColumns(), "Projected row should contain all attributes");
+  // Build a PR map for the columns of the table pr, which has values for every column of the layout version the tuple
+  // is stored under. Columns that were added to the table after the tuple was written are null in the indexes.
+  const layout_version_t version = tuple_slot.GetBlock()->layout_version_;
+  ProjectionMap pr_map;
+  for (uint16_t i = 0; i < table_pr->NumColumns(); i++)
+    pr_map[table_ptr->OidForColId(table_pr->ColumnIds()[i], version)] = i;
 
   // TODO(Gus): We are going to assume no indexes on expressions below. Having indexes on expressions would require to
   // evaluate expressions and that's a nightmare
@@ -317,12 +312,13 @@ void RecoveryManager::UpdateIndexesOnTable(transaction::TransactionContext *txn,
       const auto &col = schema.GetColumn(col_idx);
       auto index_col_oid = col.Oid();
       const catalog::col_oid_t &table_col_oid = indexed_attributes[col_idx];
-      if (table_pr->IsNull(pr_map[table_col_oid])) {
+      const auto pr_it = pr_map.find(table_col_oid);
+      if (pr_it == pr_map.end() || table_pr->IsNull(pr_it->second)) {
         index_pr->SetNull(index->GetKeyOidToOffsetMap().at(index_col_oid));
       } else {
         auto size = col.AttrSize() & INT8_MAX;
         std::memcpy(index_pr->AccessForceNotNull(index->GetKeyOidToOffsetMap().at(index_col_oid)),
-                    table_pr->AccessWithNullCheck(pr_map[table_col_oid]), size);
+                    table_pr->AccessWithNullCheck(pr_it->second), size);
       }
     }
 
@@ -367,11 +363,12 @@ uint32_t RecoveryManager::ProcessSpecialCaseCatalogRecord(
       TERRIER_ASSERT(curr_record->RecordType() == LogRecordType::DELETE,
                      "Special case pg_attribute record must be a delete");
       // A delete into pg_attribute means we are deleting a column. There are two cases:
-      //  1. Drop column: This requires some additional processing to actually clean up the column
-      //  2. Cascading delete from drop table: In this case, we don't process the record because the DeleteTable catalog
-      //  function will clean up the columns
-      // We currently don't support Case 1
-      return 0;  // Case 2, no additional records processed
+      //  1. Drop column: We replay the delete, and the update to the layout version of the table that follows it in the
+      //  same transaction rebuilds the schema of the table without the column
+      //  2. Cascading delete from drop table (or index): In this case, we don't process the record because the
+      //  DeleteTable catalog function will clean up the columns
+      if (!IsCascadingColumnDelete(txn, *buffered_changes, start_idx)) ReplayDeleteRecord(txn, curr_record);  // Case 1
+      return 0;  // No additional records processed
     }
 
     case (!catalog::postgres::INDEX_TABLE_OID): {
@@ -527,12 +524,13 @@ uint32_t RecoveryManager::ProcessSpecialCasePGClassRecord(
     TERRIER_ASSERT(!IsInsertRecord(redo_record), "Special case pg_class record should only be updates");
     auto db_catalog = GetDatabaseCatalog(txn, redo_record->GetDatabaseOid());
 
-    // Updates to pg_class will happen in the following 3 cases:
+    // Updates to pg_class will happen in the following 4 cases:
     //  1. If we update the next col oid. In this case, we don't need to do anything special, just apply the update
-    //  2. If we update the schema column, we need to check if this a DDL change (add/drop column). We don't do
-    //  anything yet because we don't support DDL changes in the catalog
+    //  2. If we update the schema column. The schema object is rebuilt by case 3 or 4, which set the pointer again.
     //  3. If we update the ptr column, this means we've inserted a new object and we need to recreate the object, and
     //  set the pointer again.
+    //  4. If we update the layout version column, this is a DDL change (add/drop column), and we need to add the layout
+    //  version to the table and recreate its schema.
     auto pg_class_ptr = db_catalog->classes_;
     auto redo_record_oids = GetOidsForRedoRecord(pg_class_ptr, redo_record);
     TERRIER_ASSERT(redo_record_oids.size() == 1, "Updates to pg_class should only touch one column");
@@ -545,7 +543,33 @@ uint32_t RecoveryManager::ProcessSpecialCasePGClassRecord(
       }
 
       case (!catalog::postgres::REL_SCHEMA_COL_OID): {  // Case 2
-        // TODO(Gus): Add support for recovering DDL changes.
+        return 0;  // No additional logs processed
+      }
+
+      case (!catalog::postgres::REL_LAYOUT_VERSION_COL_OID): {  // Case 4
+        // The changes to pg_attribute made by the DDL change come before this record, so the columns of the table are
+        // already the ones of its new schema
+        // Step 1: Get the oid of the table whose schema changed
+        const auto class_slot = GetTupleSlotMapping(redo_record->GetTupleSlot());
+        std::vector<catalog::col_oid_t> col_oids = {catalog::postgres::RELOID_COL_OID};
+        auto pr_init = pg_class_ptr->InitializerForProjectedRow(col_oids);
+        auto *buffer = common::AllocationUtil::AllocateAligned(pr_init.ProjectedRowSize());
+        auto *pr = pr_init.InitializeRow(buffer);
+        pg_class_ptr->Select(txn, class_slot, pr);
+        const catalog::table_oid_t table_oid(*(reinterpret_cast<uint32_t *>(pr->AccessWithNullCheck(0))));
+        delete[] buffer;
+
+        // Step 2: Query pg_attribute for the columns of the table, and add the layout version for them to the table
+        auto *schema = new catalog::Schema(
+            db_catalog->GetColumns<catalog::Schema::Column, catalog::table_oid_t, catalog::col_oid_t>(txn, table_oid));
+        const auto version =
+            *(reinterpret_cast<layout_version_t *>(redo_record->Delta()->AccessWithNullCheck(0)));
+        GetSqlTable(txn, redo_record->GetDatabaseOid(), table_oid)->UpdateSchema(*schema, version);
+
+        // Step 3: Set the schema and layout version in the catalog
+        const catalog::Schema &old_schema = db_catalog->GetSchema(txn, table_oid);
+        bool result UNUSED_ATTRIBUTE = db_catalog->SetTableSchema(txn, class_slot, &old_schema, schema, version);
+        TERRIER_ASSERT(result, "Setting table schema should succeed, entry should be in pg_class already");
         return 0;  // No additional logs processed
       }
 
@@ -771,6 +795,41 @@ uint32_t RecoveryManager::ProcessSpecialCasePGClassRecord(
   return 0;  // No additional logs processed
 }
 
+bool RecoveryManager::IsCascadingColumnDelete(
+    transaction::TransactionContext *txn,
+    const std::vector<std::pair<LogRecord *, std::vector<byte *>>> &buffered_changes, const uint32_t start_idx) {
+  auto *delete_record = buffered_changes[start_idx].first->GetUnderlyingRecordBodyAs<DeleteRecord>();
+  auto db_catalog = GetDatabaseCatalog(txn, delete_record->GetDatabaseOid());
+
+  // Step 1: Get the oid of the class the column belongs to
+  std::vector<catalog::col_oid_t> col_oids = {catalog::postgres::ATTRELID_COL_OID};
+  auto pr_init = db_catalog->columns_->InitializerForProjectedRow(col_oids);
+  auto *buffer = common::AllocationUtil::AllocateAligned(pr_init.ProjectedRowSize());
+  auto *pr = pr_init.InitializeRow(buffer);
+  db_catalog->columns_->Select(txn, GetTupleSlotMapping(delete_record->GetTupleSlot()), pr);
+  const auto class_oid = *(reinterpret_cast<uint32_t *>(pr->AccessWithNullCheck(0)));
+  delete[] buffer;
+
+  // Step 2: Dropping a class deletes its entry in pg_class after its columns, in the same transaction
+  col_oids = {catalog::postgres::RELOID_COL_OID};
+  pr_init = db_catalog->classes_->InitializerForProjectedRow(col_oids);
+  buffer = common::AllocationUtil::AllocateAligned(pr_init.ProjectedRowSize());
+  bool cascading = false;
+  for (uint32_t idx = start_idx + 1; idx < buffered_changes.size() && !cascading; idx++) {
+    auto *record = buffered_changes[idx].first;
+    if (record->RecordType() != LogRecordType::DELETE) continue;
+    auto *class_delete_record = record->GetUnderlyingRecordBodyAs<DeleteRecord>();
+    if (class_delete_record->GetDatabaseOid() != delete_record->GetDatabaseOid() ||
+        class_delete_record->GetTableOid() != catalog::postgres::CLASS_TABLE_OID)
+      continue;
+    pr = pr_init.InitializeRow(buffer);
+    db_catalog->classes_->Select(txn, GetTupleSlotMapping(class_delete_record->GetTupleSlot()), pr);
+    cascading = *(reinterpret_cast<uint32_t *>(pr->AccessWithNullCheck(0))) == class_oid;
+  }
+  delete[] buffer;
+  return cascading;
+}
+
 common::ManagedPointer<storage::SqlTable> RecoveryManager::GetSqlTable(transaction::TransactionContext *txn,
                                                                        const catalog::db_oid_t db_oid,
                                                                        const catalog::table_oid_t table_oid) {
@@ -822,7 +881,7 @@ std::vector<catalog::col_oid_t> RecoveryManager::GetOidsForRedoRecord(storage::S
     col_id_t col_id = record->Delta()->ColumnIds()[i];
     // We should ingore the version pointer column, this is a hidden storage layer column
     if (col_id != VERSION_POINTER_COLUMN_ID) {
-      result.emplace_back(sql_table->OidForColId(col_id));
+      result.emplace_back(sql_table->OidForColId(col_id, record->GetLayoutVersion()));
     }
   }
   return result;
@@ -1,13 +1,80 @@
 #include "storage/sql_table.h"
+#include <algorithm>
 #include <map>
 #include <set>
+#include <string>
+#include <utility>
 #include <vector>
 #include "common/macros.h"
+#include "parser/expression/column_value_expression.h"
+#include "storage/arrow_ipc_writer.h"
+#include "storage/index/index.h"
 #include "storage/storage_util.h"
 
 namespace terrier::storage {
+namespace {
+// Space that tuples are read into while they are translated between layout versions. It is shared by every SqlTable
+// on the thread, and only ever grows.
+byte *TranslationBuffer(const uint32_t size) {
+  struct Buffer {
+    byte *bytes_ = nullptr;
+    uint32_t size_ = 0;
+    ~Buffer() { delete[] bytes_; }
+  };
+  thread_local Buffer buffer;
+  if (buffer.size_ < size) {
+    delete[] buffer.bytes_;
+    buffer.bytes_ = common::AllocationUtil::AllocateAligned(size);
+    buffer.size_ = size;
+  }
+  return buffer.bytes_;
+}
+}  // namespace
 
 SqlTable::SqlTable(BlockStore *const store, const catalog::Schema &schema) : block_store_(store) {
+  tables_[0] = CreateVersion(schema, layout_version_t(0));
+  num_versions_ = 1;
+}
+
+SqlTable::~SqlTable() {
+  for (uint16_t i = 0; i < num_versions_.load(); i++) {
+    delete tables_[i]->data_table_;
+    delete tables_[i];
+  }
+}
+
+layout_version_t SqlTable::UpdateSchema(const catalog::Schema &schema) {
+  common::SpinLatch::ScopedSpinLatch guard(&schema_latch_);
+  const uint16_t num_versions = num_versions_.load();
+  if (num_versions == MAX_NUM_VERSIONS) throw std::runtime_error("SqlTable has too many layout versions");
+  // Tuples are translated between versions column by column, which needs a column to keep its size
+  for (const auto &column : schema.GetColumns()) {
+    for (uint16_t i = 0; i < num_versions; i++) {
+      const auto it = tables_[i]->column_map_.find(column.Oid());
+      if (it != tables_[i]->column_map_.end() && tables_[i]->layout_.AttrSize(it->second) != column.AttrSize() &&
+          !(tables_[i]->layout_.IsVarlen(it->second) && column.AttrSize() == VARLEN_COLUMN))
+        throw std::runtime_error("Column cannot change its size across layout versions");
+    }
+  }
+  const layout_version_t version(num_versions);
+  tables_[num_versions] = CreateVersion(schema, version);
+  num_versions_.store(static_cast<uint16_t>(num_versions + 1));
+  return version;
+}
+
+void SqlTable::UpdateSchema(const catalog::Schema &schema, const layout_version_t version) {
+  TERRIER_ASSERT(GetLatestVersion() < version, "Layout versions can only be added after the existing ones");
+  while (GetLatestVersion() != version) UpdateSchema(schema);
+}
+
+void SqlTable::SetThreadLocalInsertion(const bool enabled) {
+  common::SpinLatch::ScopedSpinLatch guard(&schema_latch_);
+  thread_local_insertion_ = enabled;
+  for (uint16_t i = 0; i < num_versions_.load(); i++) tables_[i]->data_table_->SetThreadLocalInsertion(enabled);
+}
+
+SqlTable::DataTableVersion *SqlTable::CreateVersion(const catalog::Schema &schema,
+                                                    const layout_version_t version) const {
   // Begin with the NUM_RESERVED_COLUMNS in the attr_sizes
   std::vector<uint8_t> attr_sizes;
   attr_sizes.reserve(NUM_RESERVED_COLUMNS + schema.GetColumns().size());
@@ -49,27 +116,298 @@ SqlTable::SqlTable(BlockStore *const store, const catalog::Schema &schema) : blo
     }
   }
 
+  std::vector<catalog::col_oid_t> col_oids(attr_sizes.size());
+  for (const auto &oid_to_id : col_oid_to_id) col_oids[!oid_to_id.second] = oid_to_id.first;
+
   auto layout = storage::BlockLayout(attr_sizes);
-  table_ = {new DataTable(block_store_, layout, layout_version_t(0)), layout, col_oid_to_id};
+  auto *const data_table = new DataTable(block_store_, layout, version);
+  data_table->SetThreadLocalInsertion(thread_local_insertion_);
+  return new DataTableVersion{data_table, layout, col_oid_to_id, std::move(col_oids)};
 }
 
-std::vector<col_id_t> SqlTable::ColIdsForOids(const std::vector<catalog::col_oid_t> &col_oids) const {
+void SqlTable::Scan(transaction::TransactionContext *const txn, DataTable::SlotIterator *const start_pos,
+                    const DataTable::SlotIterator &end_pos, ProjectedColumns *const out_buffer,
+                    const layout_version_t version) const {
+  AdvanceToNextVersion(start_pos, end_pos);
+  const DataTable *const table = start_pos->GetTable();
+  const DataTable::SlotIterator table_end = EndInTable(*start_pos, end_pos);
+  const layout_version_t tuple_version = table->GetLayoutVersion();
+  if (tuple_version == version) {
+    table->Scan(txn, start_pos, table_end, out_buffer);
+    return;
+  }
+
+  // Scan the columns that exist in the version of the tuples, and translate them into the output buffer
+  const Translation &translation = GetTranslation(version, out_buffer->ColumnIds(), out_buffer->NumColumns(),
+                                                  tuple_version, out_buffer->MaxTuples());
+  const ProjectedColumnsInitializer &initializer = *translation.columns_initializer_;
+  ProjectedColumns *const columns = initializer.Initialize(TranslationBuffer(initializer.ProjectedColumnsSize()));
+  table->Scan(txn, start_pos, table_end, columns);
+
+  const uint32_t num_tuples = columns->NumTuples();
+  out_buffer->SetNumTuples(num_tuples);
+  std::memcpy(out_buffer->TupleSlots(), columns->TupleSlots(), num_tuples * sizeof(TupleSlot));
+  const BlockLayout &layout = Version(version).layout_;
+  for (uint16_t i = 0; i < out_buffer->NumColumns(); i++) {
+    if (translation.sources_[i] == -1) {
+      // The column was added after the tuples were written
+      out_buffer->ColumnNullBitmap(i)->Clear(num_tuples);
+      continue;
+    }
+    const auto index = static_cast<uint16_t>(translation.sources_[i]);
+    out_buffer->ColumnNullBitmap(i)->CopyFrom(0, *columns->ColumnNullBitmap(index), 0, num_tuples);
+    std::memcpy(out_buffer->ColumnStart(i), columns->ColumnStart(index),
+                num_tuples * layout.AttrSize(out_buffer->ColumnIds()[i]));
+  }
+}
+
+DataTable::SlotIterator SqlTable::beginAt(uint32_t block_idx) const {  // NOLINT for STL name compability
+  for (uint16_t i = 0; i < num_versions_.load(); i++) {
+    const uint32_t num_blocks = tables_[i]->data_table_->GetNumBlocks();
+    if (block_idx < num_blocks) return tables_[i]->data_table_->beginAt(block_idx);
+    block_idx -= num_blocks;
+  }
+  return end();
+}
+
+void SqlTable::AdvanceToNextVersion(DataTable::SlotIterator *const pos, const DataTable::SlotIterator &end_pos) const {
+  // Skipping past the last block of a DataTable leaves the iterator at no block at all, even if that is not the end
+  while (pos->GetTable() != end_pos.GetTable() &&
+         ((*pos)->GetBlock() == nullptr || *pos == pos->GetTable()->end())) {
+    const layout_version_t next_version = pos->GetTable()->GetLayoutVersion() + 1;
+    *pos = Version(next_version).data_table_->begin();
+  }
+}
+
+std::vector<col_id_t> SqlTable::TranslateColIds(const layout_version_t from, const col_id_t *const col_ids,
+                                                const uint16_t num_cols, const layout_version_t to) const {
+  std::vector<col_id_t> result;
+  for (uint16_t i = 0; i < num_cols; i++) {
+    const auto it = Version(to).column_map_.find(OidForColId(col_ids[i], from));
+    if (it != Version(to).column_map_.end()) result.push_back(it->second);
+  }
+  // Any column will do to tell whether the tuples are visible
+  if (result.empty()) result.emplace_back(NUM_RESERVED_COLUMNS);
+  return result;
+}
+
+const SqlTable::Translation &SqlTable::GetTranslation(const layout_version_t from, const col_id_t *const col_ids,
+                                                      const uint16_t num_cols, const layout_version_t to,
+                                                      const uint32_t max_tuples) const {
+  TranslationKey key(!from, !to, max_tuples, std::vector<col_id_t>(col_ids, col_ids + num_cols));
+  {
+    common::SharedLatch::ScopedSharedLatch guard(&translations_latch_);
+    const auto it = translations_.find(key);
+    if (it != translations_.end()) return *it->second;
+  }
+
+  auto translation = std::make_unique<Translation>();
+  const std::vector<col_id_t> translated_col_ids = TranslateColIds(from, col_ids, num_cols, to);
+  // The initializers order the columns by size, so the order of the translated projection is only known from them
+  std::vector<col_id_t> translated_order;
+  if (max_tuples == 0) {
+    translation->row_initializer_ = std::make_unique<ProjectedRowInitializer>(
+        ProjectedRowInitializer::Create(Version(to).layout_, translated_col_ids));
+    for (uint16_t i = 0; i < translation->row_initializer_->NumColumns(); i++)
+      translated_order.push_back(translation->row_initializer_->ColId(i));
+  } else {
+    translation->columns_initializer_ =
+        std::make_unique<ProjectedColumnsInitializer>(Version(to).layout_, translated_col_ids, max_tuples);
+    for (uint16_t i = 0; i < translation->columns_initializer_->NumColumns(); i++)
+      translated_order.push_back(translation->columns_initializer_->ColId(i));
+  }
+  for (uint16_t i = 0; i < num_cols; i++) {
+    const auto it = Version(to).column_map_.find(OidForColId(col_ids[i], from));
+    const auto match = it == Version(to).column_map_.end()
+                           ? translated_order.end()
+                           : std::find(translated_order.begin(), translated_order.end(), it->second);
+    translation->sources_.push_back(match == translated_order.end()
+                                        ? -1
+                                        : static_cast<int32_t>(match - translated_order.begin()));
+  }
+
+  common::SharedLatch::ScopedExclusiveLatch guard(&translations_latch_);
+  // Another thread may have gotten here first, in which case its translation is just as good
+  return *translations_.emplace(std::move(key), std::move(translation)).first->second;
+}
+
+bool SqlTable::SelectTranslated(transaction::TransactionContext *const txn, const TupleSlot slot,
+                                const layout_version_t tuple_version, ProjectedRow *const out_buffer,
+                                const layout_version_t version) const {
+  const Translation &translation =
+      GetTranslation(version, out_buffer->ColumnIds(), out_buffer->NumColumns(), tuple_version, 0);
+  const ProjectedRowInitializer &initializer = *translation.row_initializer_;
+  ProjectedRow *const row = initializer.InitializeRow(TranslationBuffer(initializer.ProjectedRowSize()));
+  if (!Version(tuple_version).data_table_->Select(txn, slot, row)) return false;
+  const BlockLayout &layout = Version(version).layout_;
+  for (uint16_t i = 0; i < out_buffer->NumColumns(); i++) {
+    if (translation.sources_[i] == -1) {
+      // The column was added after the tuple was written
+      out_buffer->SetNull(i);
+      continue;
+    }
+    StorageUtil::CopyWithNullCheck(row->AccessWithNullCheck(static_cast<uint16_t>(translation.sources_[i])),
+                                   out_buffer, layout.AttrSize(out_buffer->ColumnIds()[i]), i);
+  }
+  return true;
+}
+
+bool SqlTable::TranslateDelta(ProjectedRow *const delta, const layout_version_t from,
+                              const layout_version_t to) const {
+  std::vector<std::pair<col_id_t, uint16_t>> translated;
+  translated.reserve(delta->NumColumns());
+  for (uint16_t i = 0; i < delta->NumColumns(); i++) {
+    const auto it = Version(to).column_map_.find(OidForColId(delta->ColumnIds()[i], from));
+    if (it == Version(to).column_map_.end()) return false;
+    translated.emplace_back(it->second, i);
+  }
+  // Columns keep their size across versions, so sorting the columns by their col_ids in version to keeps them sorted by
+  // descending size, and every value stays at the same offset in the delta. Only the order of the values changes.
+  std::sort(translated.begin(), translated.end());
+  byte *const buffer = TranslationBuffer(delta->Size());
+  std::memcpy(buffer, delta, delta->Size());
+  const auto *const original = reinterpret_cast<const ProjectedRow *>(buffer);
+  const BlockLayout &layout = Version(to).layout_;
+  for (uint16_t i = 0; i < delta->NumColumns(); i++) {
+    delta->ColumnIds()[i] = translated[i].first;
+    StorageUtil::CopyWithNullCheck(original->AccessWithNullCheck(translated[i].second), delta,
+                                   layout.AttrSize(translated[i].first), i);
+  }
+  return true;
+}
+
+TupleSlot SqlTable::Update(transaction::TransactionContext *const txn, const catalog::db_oid_t db_oid,
+                           const catalog::table_oid_t table_oid, TupleSlot slot, const ProjectedRow &delta,
+                           const std::vector<common::ManagedPointer<index::Index>> &indexes,
+                           const layout_version_t version) {
+  std::vector<col_id_t> col_ids(delta.ColumnIds(), delta.ColumnIds() + delta.NumColumns());
+  std::vector<catalog::col_oid_t> col_oids;
+  col_oids.reserve(col_ids.size());
+  for (const col_id_t col_id : col_ids) col_oids.push_back(OidForColId(col_id, version));
+  if (NeedsMigration(slot, col_oids)) {
+    slot = Migrate(txn, db_oid, table_oid, slot, version, indexes);
+    if (slot == TupleSlot(nullptr, 0)) return slot;
+  }
+
+  const ProjectedRowInitializer initializer = ProjectedRowInitializer::Create(Version(version).layout_, col_ids);
+  TERRIER_ASSERT(initializer.ProjectedRowSize() == delta.Size(), "The delta should be laid out for the given version.");
+  RedoRecord *const redo = txn->StageWrite(db_oid, table_oid, initializer);
+  std::memcpy(redo->Delta(), &delta, delta.Size());
+  redo->SetTupleSlot(slot);
+  return Update(txn, redo, version) ? slot : TupleSlot(nullptr, 0);
+}
+
+TupleSlot SqlTable::Migrate(transaction::TransactionContext *const txn, const catalog::db_oid_t db_oid,
+                            const catalog::table_oid_t table_oid, const TupleSlot slot, const layout_version_t version,
+                            const std::vector<common::ManagedPointer<index::Index>> &indexes) {
+  for (const auto &index : indexes) {
+    for (const auto &key_col : index->GetKeySchema().GetColumns())
+      if (key_col.StoredExpression()->GetExpressionType() != parser::ExpressionType::COLUMN_VALUE)
+        throw std::runtime_error("Cannot move the index entries of a tuple in an index keyed on an expression");
+  }
+
+  // The index entries of the tuple are found with its image under its own version
+  const layout_version_t tuple_version = slot.GetBlock()->layout_version_;
+  const BlockLayout &old_layout = Version(tuple_version).layout_;
+  const ProjectedRowInitializer old_initializer = ProjectedRowInitializer::Create(old_layout, old_layout.AllColumns());
+  byte *const old_buffer = common::AllocationUtil::AllocateAligned(old_initializer.ProjectedRowSize());
+  ProjectedRow *const old_row = old_initializer.InitializeRow(old_buffer);
+  const BlockLayout &layout = Version(version).layout_;
+  const ProjectedRowInitializer initializer = ProjectedRowInitializer::Create(layout, layout.AllColumns());
+  byte *const buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+  ProjectedRow *const row = initializer.InitializeRow(buffer);
+  const bool visible = Select(txn, slot, old_row, tuple_version) && Select(txn, slot, row, version);
+  // Deleting the tuple checks for write-write conflicts just like updating it in place would
+  txn->StageDelete(db_oid, table_oid, slot);
+  if (!Delete(txn, slot)) {
+    delete[] old_buffer;
+    delete[] buffer;
+    return TupleSlot(nullptr, 0);
+  }
+  TERRIER_ASSERT(visible, "A tuple that could be deleted should have been visible.");
+
+  // The varlens of the deleted tuple are freed along with it, so the new tuple needs copies
+  RedoRecord *const redo = txn->StageWrite(db_oid, table_oid, initializer);
+  std::memcpy(redo->Delta(), row, initializer.ProjectedRowSize());
+  for (uint16_t i = 0; i < redo->Delta()->NumColumns(); i++) {
+    if (!layout.IsVarlen(redo->Delta()->ColumnIds()[i])) continue;
+    auto *const varlen = reinterpret_cast<VarlenEntry *>(redo->Delta()->AccessWithNullCheck(i));
+    if (varlen == nullptr || varlen->IsInlined()) continue;
+    byte *const content = txn->AllocateVarlen(varlen->Size());
+    std::memcpy(content, varlen->Content(), varlen->Size());
+    *varlen = VarlenEntry::CreateFromArena(content, varlen->Size());
+  }
+  delete[] buffer;
+  const TupleSlot new_slot = Insert(txn, redo, version);
+
+  for (const auto &index : indexes) {
+    const ProjectedRowInitializer &key_initializer = index->GetProjectedRowInitializer();
+    byte *const key_buffer = common::AllocationUtil::AllocateAligned(key_initializer.ProjectedRowSize());
+    ProjectedRow *const key = key_initializer.InitializeRow(key_buffer);
+    BuildIndexKey(*index, *old_row, tuple_version, key);
+    index->Delete(txn, *key, slot);
+    BuildIndexKey(*index, *redo->Delta(), version, key);
+    UNUSED_ATTRIBUTE const bool inserted = index->Insert(txn, *key, new_slot);
+    TERRIER_ASSERT(inserted, "The key of a moved tuple should always be inserted.");
+    delete[] key_buffer;
+  }
+  delete[] old_buffer;
+  return new_slot;
+}
+
+void SqlTable::BuildIndexKey(const index::Index &index, const ProjectedRow &image, const layout_version_t version,
+                             ProjectedRow *const key) const {
+  const BlockLayout &layout = Version(version).layout_;
+  const auto &key_offsets = index.GetKeyOidToOffsetMap();
+  for (const auto &key_col : index.GetKeySchema().GetColumns()) {
+    const uint16_t key_offset = key_offsets.at(key_col.Oid());
+    const catalog::col_oid_t col_oid =
+        key_col.StoredExpression().CastManagedPointerTo<const parser::ColumnValueExpression>()->GetColumnOid();
+    const auto it = Version(version).column_map_.find(col_oid);
+    const col_id_t *const match =
+        it == Version(version).column_map_.end()
+            ? image.ColumnIds() + image.NumColumns()
+            : std::find(image.ColumnIds(), image.ColumnIds() + image.NumColumns(), it->second);
+    if (match == image.ColumnIds() + image.NumColumns()) {
+      key->SetNull(key_offset);
+      continue;
+    }
+    StorageUtil::CopyWithNullCheck(image.AccessWithNullCheck(static_cast<uint16_t>(match - image.ColumnIds())), key,
+                                   layout.AttrSize(*match), key_offset);
+  }
+}
+
+std::vector<col_id_t> SqlTable::ColIdsForOids(const std::vector<catalog::col_oid_t> &col_oids,
+                                              const layout_version_t version) const {
   TERRIER_ASSERT(!col_oids.empty(), "Should be used to access at least one column.");
   std::vector<col_id_t> col_ids;
 
   // Build the input to the initializer constructor
   for (const catalog::col_oid_t col_oid : col_oids) {
-    TERRIER_ASSERT(table_.column_map_.count(col_oid) > 0, "Provided col_oid does not exist in the table.");
-    const col_id_t col_id = table_.column_map_.at(col_oid);
+    TERRIER_ASSERT(Version(version).column_map_.count(col_oid) > 0, "Provided col_oid does not exist in the table.");
+    const col_id_t col_id = Version(version).column_map_.at(col_oid);
     col_ids.push_back(col_id);
   }
 
   return col_ids;
 }
 
-ProjectionMap SqlTable::ProjectionMapForOids(const std::vector<catalog::col_oid_t> &col_oids) {
+void SqlTable::ExportToArrow(transaction::TransactionContext *const txn, const catalog::Schema &schema,
+                             const std::string &file_path) const {
+  // Frozen blocks are written out as they are, which only works if they all have the same layout
+  if (num_versions_.load() > 1) throw std::runtime_error("Cannot export a table with more than one layout version");
+  const DataTableVersion &table = Version(layout_version_t(0));
+  std::vector<ArrowIpcWriter::Field> fields;
+  fields.reserve(schema.GetColumns().size());
+  for (const auto &column : schema.GetColumns())
+    fields.push_back({column.Name(), column.Type(), column.Nullable(), table.column_map_.at(column.Oid())});
+  ArrowIpcWriter(table.data_table_, std::move(fields)).WriteFile(txn, file_path);
+}
+
+ProjectionMap SqlTable::ProjectionMapForOids(const std::vector<catalog::col_oid_t> &col_oids,
+                                             const layout_version_t version) {
   // Resolve OIDs to storage IDs
-  auto col_ids = ColIdsForOids(col_oids);
+  auto col_ids = ColIdsForOids(col_oids, version);
 
   // Use std::map to effectively sort OIDs by their corresponding ID
   std::map<col_id_t, catalog::col_oid_t> inverse_map;
@@ -82,10 +420,4 @@ ProjectionMap SqlTable::ProjectionMapForOids(const std::vector<catalog::col_oid_
 
   return projection_map;
 }
-
-catalog::col_oid_t SqlTable::OidForColId(const col_id_t col_id) const {
-  const auto oid_to_id = std::find_if(table_.column_map_.cbegin(), table_.column_map_.cend(),
-                                      [&](const auto &oid_to_id) -> bool { return oid_to_id.second == col_id; });
-  return oid_to_id->first;
-}
 }  // namespace terrier::storage
@@ -0,0 +1,104 @@
+#include "storage/storage_defs.h"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <new>
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+namespace terrier::storage {
+
+namespace {
+// NUMA node of the CPU the calling thread is running on, or 0 if that cannot be found out
+uint32_t CurrentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu, node;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return node;
+#endif
+  return 0;
+}
+
+// Asks the kernel to place the pages of the given arena on the given NUMA node. This is only a preference, so the
+// kernel is free to use another node if this one runs out of memory, and it is a no-op on machines without NUMA.
+void BindToNode(byte *const arena, const uint32_t node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  uint64_t node_mask = 1;
+  if (node >= sizeof(node_mask) * BYTE_SIZE) return;
+  node_mask <<= node;
+  // The kernel expects one more than the number of bits in the mask
+  syscall(SYS_mbind, arena, BlockAllocator::ARENA_SIZE, MPOL_PREFERRED, &node_mask, sizeof(node_mask) * BYTE_SIZE + 1,
+          0);
+#endif
+}
+
+// Maps a new arena aligned to its size, backed by huge pages if possible
+byte *MapArena() {
+  constexpr uint64_t arena_size = BlockAllocator::ARENA_SIZE;
+  void *arena = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  // Huge page mappings are always aligned to the huge page size
+  arena = mmap(nullptr, arena_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+  if (arena != MAP_FAILED) return reinterpret_cast<byte *>(arena);
+
+  // No huge pages are reserved on the system. Map twice the size so we can cut out an aligned arena, and hope for
+  // transparent huge pages.
+  void *mapped = mmap(nullptr, 2 * arena_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED) return nullptr;
+  const auto start = reinterpret_cast<uintptr_t>(mapped);
+  const uintptr_t aligned = (start + arena_size - 1) & ~(arena_size - 1);
+  if (aligned != start) munmap(mapped, aligned - start);
+  if (aligned + arena_size != start + 2 * arena_size)
+    munmap(reinterpret_cast<void *>(aligned + arena_size), start + arena_size - aligned);
+  arena = reinterpret_cast<void *>(aligned);
+#ifdef MADV_HUGEPAGE
+  madvise(arena, arena_size, MADV_HUGEPAGE);
+#endif
+  return reinterpret_cast<byte *>(arena);
+}
+}  // namespace
+
+BlockAllocator::~BlockAllocator() {
+  for (auto &entry : live_blocks_)
+    if (entry.second == 0) munmap(entry.first, ARENA_SIZE);
+}
+
+RawBlock *BlockAllocator::New() {
+  const uint32_t node = CurrentNumaNode();
+  if (node >= open_arenas_.size()) open_arenas_.resize(node + 1);
+  OpenArena &open = open_arenas_[node];
+  if (open.blocks_left_ == 0) {
+    byte *arena = MapArena();
+    if (arena == nullptr) return nullptr;
+    // Pages are only placed once they are first touched, which has not happened yet
+    BindToNode(arena, node);
+    live_blocks_[arena] = 0;
+    open.next_block_ = arena;
+    open.blocks_left_ = ARENA_SIZE / common::Constants::BLOCK_SIZE;
+  }
+  byte *block = open.next_block_;
+  open.next_block_ += common::Constants::BLOCK_SIZE;
+  open.blocks_left_--;
+  live_blocks_[ArenaOf(block)]++;
+  return new (block) RawBlock();
+}
+
+void BlockAllocator::Delete(RawBlock *const ptr) {
+  ptr->~RawBlock();
+  byte *arena = ArenaOf(ptr);
+  auto it = live_blocks_.find(arena);
+  TERRIER_ASSERT(it != live_blocks_.end() && it->second > 0, "block was not handed out by this allocator");
+  // Keep the arena around if blocks are still going to be carved out of it
+  if (--it->second > 0 || IsOpen(arena)) return;
+  live_blocks_.erase(it);
+  munmap(arena, ARENA_SIZE);
+}
+
+bool BlockAllocator::IsOpen(const byte *const arena) const {
+  for (const auto &open : open_arenas_)
+    if (open.blocks_left_ > 0 && ArenaOf(open.next_block_) == arena) return true;
+  return false;
+}
+
+}  // namespace terrier::storage
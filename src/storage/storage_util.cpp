@@ -7,6 +7,7 @@
 #include "storage/projected_columns.h"
 #include "storage/tuple_access_strategy.h"
 #include "storage/undo_record.h"
+#include "storage/varlen_arena.h"
 namespace terrier::storage {
 
 template <class RowType>
@@ -36,6 +37,13 @@ void StorageUtil::CopyAttrIntoProjection(const TupleAccessStrategy &accessor, co
   col_id_t col_id = to->ColumnIds()[projection_list_offset];
   uint8_t attr_size = accessor.GetBlockLayout().AttrSize(col_id);
   byte *stored_attr = accessor.AccessWithNullCheck(from, col_id);
+  const ArrowEncodedColumn *encoded =
+      stored_attr == nullptr ? nullptr : accessor.EncodedColumn(from.GetBlock(), col_id);
+  if (encoded != nullptr) {
+    // The column in the block may have been released
+    encoded->Decode(from.GetOffset(), 1, to->AccessForceNotNull(projection_list_offset));
+    return;
+  }
   CopyWithNullCheck(stored_attr, to, attr_size, projection_list_offset);
 }
 
@@ -200,7 +208,7 @@ void StorageUtil::DeallocateVarlens(RawBlock *block, const TupleAccessStrategy &
       if (!accessor.Allocated(slot)) continue;
       auto *entry = reinterpret_cast<VarlenEntry *>(accessor.AccessWithNullCheck(slot, col));
       // If entry is null here, the varlen entry is a null SQL value.
-      if (entry != nullptr && entry->NeedReclaim()) delete[] entry->Content();
+      if (entry != nullptr && entry->NeedReclaim()) VarlenArena::Free(*entry);
     }
   }
 }
@@ -1,4 +1,5 @@
 #include "storage/tuple_access_strategy.h"
+#include <algorithm>
 #include <utility>
 #include "common/container/concurrent_bitmap.h"
 
@@ -25,9 +26,12 @@ void TupleAccessStrategy::InitializeRawBlock(storage::DataTable *const data_tabl
                                              const layout_version_t layout_version) const {
   // Intentional unsafe cast
   raw->data_table_ = data_table;
+  raw->recently_read_ = 0;
   raw->layout_version_ = layout_version;
   raw->insert_head_ = 0;
   raw->controller_.Initialize();
+  raw->num_versioned_slots_ = 0;
+  raw->access_stats_ = BlockAccessStats();
   auto *result = reinterpret_cast<TupleAccessStrategy::Block *>(raw);
   result->GetArrowBlockMetadata().Initialize(GetBlockLayout().NumColumns());
   for (uint16_t i = 0; i < layout_.NumColumns(); i++) result->AttrOffsets(layout_)[i] = column_offsets_[i];
@@ -41,21 +45,35 @@ void TupleAccessStrategy::InitializeRawBlock(storage::DataTable *const data_tabl
   std::memset(ColumnStart(raw, VERSION_POINTER_COLUMN_ID), 0, sizeof(void *) * layout_.NumSlots());
 }
 
-bool TupleAccessStrategy::Allocate(RawBlock *const block, TupleSlot *const slot) const {
+ArrowEncodedColumn *TupleAccessStrategy::ThawColumn(RawBlock *const block, const col_id_t col_id) const {
+  if (layout_.IsVarlen(col_id)) return nullptr;
+  ArrowBlockMetadata &metadata = GetArrowBlockMetadata(block);
+  if (metadata.NumEncodedColumns().load() == 0) return nullptr;
+  ArrowEncodedColumn *encoded = metadata.GetColumnInfo(layout_, col_id).Thaw(ColumnStart(block, col_id));
+  // The count only drops once the values are back in the block, so readers that still see it go look for the copy
+  if (encoded != nullptr) metadata.NumEncodedColumns()--;
+  return encoded;
+}
+
+uint32_t TupleAccessStrategy::AllocateRange(RawBlock *const block, const uint32_t max_slots,
+                                            TupleSlot *const first) const {
   common::RawConcurrentBitmap *bitmap = reinterpret_cast<Block *>(block)->SlotAllocationBitmap(layout_);
   const uint32_t start = block->GetInsertHead();
 
   // We are not allowed to insert into this block any more
-  if (start == layout_.NumSlots()) return false;
+  if (start == layout_.NumSlots()) return 0;
 
-  uint32_t pos = start;
+  const uint32_t num_slots = std::min(max_slots, layout_.NumSlots() - start);
   // We do not support concurrent insertion to the same block anymore
   // Assumption: Different threads cannot insert into the same block at the same time
   // If the block is not full, the function should always succeed (Flip should always return true)
-  bool UNUSED_ATTRIBUTE flip_res = bitmap->Flip(pos, false);
-  TERRIER_ASSERT(flip_res, "Flip should always succeed");
-  *slot = TupleSlot(block, pos);
-  block->insert_head_++;
-  return true;
+  for (uint32_t pos = start; pos < start + num_slots; pos++) {
+    bool UNUSED_ATTRIBUTE flip_res = bitmap->Flip(pos, false);
+    TERRIER_ASSERT(flip_res, "Flip should always succeed");
+  }
+  *first = TupleSlot(block, start);
+  // Only the holder of the busy bit moves the insert head, so a plain store suffices and keeps the busy bit as is
+  block->insert_head_.store(block->insert_head_.load() + num_slots);
+  return num_slots;
 }
 }  // namespace terrier::storage
@@ -0,0 +1,63 @@
+#include "storage/varlen_arena.h"
+#include <cstdlib>
+#include <new>
+
+namespace terrier::storage {
+namespace {
+constexpr uint64_t CHUNK_TAG = 0x616E656C72617621;  // "!varlena"
+std::atomic<uint64_t> num_chunks = 0;
+}  // namespace
+
+VarlenArena::~VarlenArena() {
+  if (chunk_ != nullptr) Release(chunk_);
+}
+
+VarlenArena &VarlenArena::ThreadLocal() {
+  static thread_local VarlenArena arena;
+  return arena;
+}
+
+byte *VarlenArena::Allocate(const uint32_t size) {
+  if (size > MAX_SHARED_SIZE) {
+    // The chunk is only for this value, so it goes away as soon as the value does
+    ChunkHeader *const chunk = NewChunk(sizeof(ChunkHeader) + size);
+    return reinterpret_cast<byte *>(chunk + 1);
+  }
+  if (next_offset_ + size > CHUNK_SIZE) {
+    if (chunk_ != nullptr) Release(chunk_);
+    chunk_ = NewChunk(CHUNK_SIZE);
+    next_offset_ = sizeof(ChunkHeader);
+  }
+  chunk_->num_refs_.fetch_add(1);
+  byte *const result = reinterpret_cast<byte *>(chunk_) + next_offset_;
+  next_offset_ += size;
+  return result;
+}
+
+void VarlenArena::Free(const byte *const content) {
+  // Buffers start within the first CHUNK_SIZE bytes of their chunk, even the ones that have a chunk of their own
+  auto *const chunk =
+      reinterpret_cast<ChunkHeader *>(reinterpret_cast<uintptr_t>(content) & ~static_cast<uintptr_t>(CHUNK_SIZE - 1));
+  TERRIER_ASSERT(chunk->tag_ == CHUNK_TAG, "buffer was not allocated from an arena");
+  Release(chunk);
+}
+
+uint64_t VarlenArena::NumChunks() { return num_chunks.load(); }
+
+VarlenArena::ChunkHeader *VarlenArena::NewChunk(const uint64_t size) {
+  void *memory;
+  if (posix_memalign(&memory, CHUNK_SIZE, size) != 0) throw std::bad_alloc();
+  // A new chunk starts out with one reference, held by whoever asked for it
+  auto *const chunk = new (memory) ChunkHeader{CHUNK_TAG, {1}};
+  num_chunks++;
+  return chunk;
+}
+
+void VarlenArena::Release(ChunkHeader *const chunk) {
+  if (chunk->num_refs_.fetch_sub(1) != 1) return;
+  chunk->tag_ = 0;
+  chunk->~ChunkHeader();
+  std::free(chunk);
+  num_chunks--;
+}
+}  // namespace terrier::storage
@@ -1,5 +1,6 @@
 #include "storage/write_ahead_log/log_io.h"
 #include <algorithm>
+#include <climits>
 namespace terrier::storage {
 void PosixIoWrappers::Close(int fd) {
   while (true) {
@@ -38,6 +39,35 @@ void PosixIoWrappers::WriteFully(int fd, const void *buf, size_t nbyte) {
   }
 }
 
+void PosixIoWrappers::WriteVFully(int fd, struct iovec *iov, size_t iovcnt) {
+  while (iovcnt > 0) {
+    ssize_t ret = writev(fd, iov, static_cast<int>(std::min<size_t>(iovcnt, IOV_MAX)));
+    if (ret == -1) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error("Write to file failed with errno " + std::to_string(errno));
+    }
+    // Skip over the buffers that were written out entirely, and pick up where we left off in the last one
+    auto written = static_cast<size_t>(ret);
+    for (; iovcnt > 0 && written >= iov->iov_len; iov++, iovcnt--) written -= iov->iov_len;
+    if (iovcnt == 0) break;
+    iov->iov_base = reinterpret_cast<char *>(iov->iov_base) + written;
+    iov->iov_len -= written;
+  }
+}
+
+void PosixIoWrappers::PWriteFully(int fd, const void *buf, size_t nbyte, off_t offset) {
+  size_t written = 0;
+  while (written < nbyte) {
+    ssize_t ret = pwrite(fd, reinterpret_cast<const char *>(buf) + written, nbyte - written,
+                         offset + static_cast<off_t>(written));
+    if (ret == -1) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error("Write to file failed with errno " + std::to_string(errno));
+    }
+    written += static_cast<size_t>(ret);
+  }
+}
+
 bool BufferedLogReader::Read(void *dest, uint32_t size) {
   if (read_head_ + size <= filled_size_) {
     // bytes to read are already buffered.
@@ -75,8 +75,8 @@ bool LogSerializerTask::Process() {
     // Mark the last buffer that was written to as full
     if (filled_buffer_ != nullptr) HandFilledBufferToWriter();
 
-    // Bulk remove all the transactions we serialized. This prevents having to take the TimestampManager's latch once
-    // for each timestamp we remove.
+    // Bulk remove all the transactions we serialized. This prevents having to take a TimestampManager latch once for
+    // each timestamp we remove.
     for (const auto &txns : serialized_txns_) {
       txns.first->RemoveTransactions(txns.second);
     }
@@ -126,10 +126,14 @@ std::pair<uint64_t, uint64_t> LogSerializerTask::SerializeBuffer(
         // If a transaction is read-only, then the only record it generates is its commit record. This commit record is
         // necessary for the transaction's callback function to be invoked, but there is no need to serialize it, as
         // it corresponds to a transaction with nothing to redo.
-        if (!commit_record->IsReadOnly()) num_bytes += SerializeRecord(record);
+        // A read-only transaction has already left the active txn set at commit, and may have been deallocated.
+        if (!commit_record->IsReadOnly()) {
+          num_bytes += SerializeRecord(record);
+          // Once serialization is done, we notify the txn manager to let GC know this txn is ready to clean up
+          serialized_txns_[commit_record->TimestampManager()].emplace_back(
+              commit_record->Txn()->active_txn_slot_, record.TxnBegin());
+        }
         commits_in_buffer_.emplace_back(commit_record->CommitCallback(), commit_record->CommitCallbackArg());
-        // Once serialization is done, we notify the txn manager to let GC know this txn is ready to clean up
-        serialized_txns_[commit_record->TimestampManager()].push_back(record.TxnBegin());
         break;
       }
 
@@ -137,7 +141,8 @@ std::pair<uint64_t, uint64_t> LogSerializerTask::SerializeBuffer(
         // If an abort record shows up at all, the transaction cannot be read-only
         num_bytes += SerializeRecord(record);
         auto *abord_record = record.GetUnderlyingRecordBodyAs<AbortRecord>();
-        serialized_txns_[abord_record->TimestampManager()].push_back(record.TxnBegin());
+        serialized_txns_[abord_record->TimestampManager()].emplace_back(abord_record->Txn()->active_txn_slot_,
+                                                                         record.TxnBegin());
         break;
       }
 
@@ -152,6 +157,9 @@ std::pair<uint64_t, uint64_t> LogSerializerTask::SerializeBuffer(
 }
 
 uint64_t LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &record) {
+  // A batch of inserts has no serialized format of its own, every tuple in it is written out as a regular redo record
+  if (record.RecordType() == LogRecordType::BATCH_REDO) return SerializeBatchRedoRecord(record);
+
   uint64_t num_bytes = 0;
   // First, serialize out fields common across all LogRecordType's.
 
@@ -171,6 +179,8 @@ uint64_t LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &r
       num_bytes += WriteValue(record_body->GetDatabaseOid());
       num_bytes += WriteValue(record_body->GetTableOid());
       num_bytes += WriteValue(record_body->GetTupleSlot());
+      // The column ids are only meaningful within the layout version the tuple is stored under
+      num_bytes += WriteValue(record_body->GetTupleSlot().GetBlock()->layout_version_);
 
       auto *delta = record_body->Delta();
       // Write out which column ids this redo record is concerned with. On recovery, we can construct the appropriate
@@ -197,27 +207,7 @@ uint64_t LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &r
           // the relevant information.
           continue;
         }
-        // Get the column id of the current column in the ProjectedRow.
-        col_id_t col_id = delta->ColumnIds()[i];
-
-        if (block_layout.IsVarlen(col_id)) {
-          // Inline column value is a pointer to a VarlenEntry, so reinterpret as such.
-          const auto *varlen_entry = reinterpret_cast<const VarlenEntry *>(column_value_address);
-          // Serialize out length of the varlen entry.
-          num_bytes += WriteValue(varlen_entry->Size());
-          if (varlen_entry->IsInlined()) {
-            // Serialize out the prefix of the varlen entry.
-            num_bytes += WriteValue(varlen_entry->Prefix(), varlen_entry->Size());
-          } else {
-            // Serialize out the content field of the varlen entry.
-            num_bytes += WriteValue(varlen_entry->Content(), varlen_entry->Size());
-          }
-        } else {
-          // Inline column value is the actual data we want to serialize out.
-          // Note that by writing out AttrSize(col_id) bytes instead of just the difference between successive offsets
-          // of the delta record, we avoid serializing out any potential padding.
-          num_bytes += WriteValue(column_value_address, block_layout.AttrSize(col_id));
-        }
+        num_bytes += SerializeAttribute(block_layout, delta->ColumnIds()[i], column_value_address);
       }
       break;
     }
@@ -238,11 +228,84 @@ uint64_t LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &r
       // AbortRecord does not hold any additional metadata
       break;
     }
+    case LogRecordType::BATCH_REDO: {
+      // Handled above
+      break;
+    }
+  }
+
+  return num_bytes;
+}
+
+uint64_t LogSerializerTask::SerializeBatchRedoRecord(const LogRecord &record) {
+  uint64_t num_bytes = 0;
+  auto *record_body = record.GetUnderlyingRecordBodyAs<BatchRedoRecord>();
+  const ProjectedColumns *columns = record_body->Columns();
+  if (columns->NumTuples() == 0) return num_bytes;
+
+  // Everything but the tuple slot and the values is the same for every tuple in the batch, so compute it once
+  const uint16_t num_cols = columns->NumColumns();
+  const col_id_t *col_ids = columns->ColumnIds();
+  const auto &block_layout = columns->TupleSlots()[0].GetBlock()->data_table_->GetBlockLayout();
+  const layout_version_t layout_version = columns->TupleSlots()[0].GetBlock()->layout_version_;
+  // The record size written out is that of the RedoRecord recovery will read each tuple back into
+  const std::vector<col_id_t> col_id_list(col_ids, col_ids + num_cols);
+  const uint32_t redo_size = RedoRecord::Size(ProjectedRowInitializer::Create(block_layout, col_id_list));
+  uint16_t boundaries[NUM_ATTR_BOUNDARIES];
+  memset(boundaries, 0, sizeof(uint16_t) * NUM_ATTR_BOUNDARIES);
+  StorageUtil::ComputeAttributeSizeBoundaries(block_layout, col_ids, num_cols, boundaries);
+  common::RawBitmap *bitmap = common::RawBitmap::Allocate(num_cols);
+
+  for (uint32_t tuple = 0; tuple < columns->NumTuples(); tuple++) {
+    // Same format as a REDO record in SerializeRecord
+    num_bytes += WriteValue(redo_size);
+    num_bytes += WriteValue(LogRecordType::REDO);
+    num_bytes += WriteValue(record.TxnBegin());
+    num_bytes += WriteValue(record_body->GetDatabaseOid());
+    num_bytes += WriteValue(record_body->GetTableOid());
+    num_bytes += WriteValue(columns->TupleSlots()[tuple]);
+    num_bytes += WriteValue(layout_version);
+    num_bytes += WriteValue(num_cols);
+    num_bytes += WriteValue(col_ids, static_cast<uint32_t>(sizeof(col_id_t)) * num_cols);
+    WriteValue(boundaries, sizeof(uint16_t) * NUM_ATTR_BOUNDARIES);
+
+    for (uint16_t i = 0; i < num_cols; i++) bitmap->Set(i, columns->ColumnNullBitmap(i)->Test(tuple));
+    num_bytes += WriteValue(bitmap, common::RawBitmap::SizeInBytes(num_cols));
+
+    for (uint16_t i = 0; i < num_cols; i++) {
+      if (!bitmap->Test(i)) continue;
+      num_bytes += SerializeAttribute(block_layout, col_ids[i],
+                                      columns->ColumnStart(i) + columns->AttrSizeForColumn(i) * tuple);
+    }
   }
 
+  common::RawBitmap::Deallocate(bitmap);
   return num_bytes;
 }
 
+uint64_t LogSerializerTask::SerializeAttribute(const BlockLayout &block_layout, const col_id_t col_id,
+                                               const byte *const column_value_address) {
+  if (block_layout.IsVarlen(col_id)) {
+    uint64_t num_bytes = 0;
+    // Inline column value is a pointer to a VarlenEntry, so reinterpret as such.
+    const auto *varlen_entry = reinterpret_cast<const VarlenEntry *>(column_value_address);
+    // Serialize out length of the varlen entry.
+    num_bytes += WriteValue(varlen_entry->Size());
+    if (varlen_entry->IsInlined()) {
+      // Serialize out the prefix of the varlen entry.
+      num_bytes += WriteValue(varlen_entry->Prefix(), varlen_entry->Size());
+    } else {
+      // Serialize out the content field of the varlen entry.
+      num_bytes += WriteValue(varlen_entry->Content(), varlen_entry->Size());
+    }
+    return num_bytes;
+  }
+  // Inline column value is the actual data we want to serialize out.
+  // Note that by writing out AttrSize(col_id) bytes instead of just the difference between successive offsets
+  // of the delta record, we avoid serializing out any potential padding.
+  return WriteValue(column_value_address, block_layout.AttrSize(col_id));
+}
+
 uint32_t LogSerializerTask::WriteValue(const void *val, const uint32_t size) {
   // Serialize the value and copy it to the buffer
   BufferedLogWriter *out = GetCurrentWriteBuffer();
@@ -1,30 +1,83 @@
 #include "transaction/timestamp_manager.h"
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 namespace terrier::transaction {
 
+timestamp_t TimestampManager::BeginTransaction(uint32_t *const slot) {
+  *slot = SlotIndex();
+  Slot &current = slots_[*slot];
+  common::SpinLatch::ScopedSpinLatch guard(&current.latch_);
+  // There is a three-way race that needs to be prevented.  Specifically, we
+  // cannot allow both a transaction to commit and the GC to poll for the
+  // oldest running transaction in between this transaction acquiring its
+  // begin timestamp and getting inserted into the current running
+  // transactions list.  The GC reads the clock before it polls, so if we
+  // publish a lower bound on our start time before we read the clock, either
+  // the GC sees the bound, or our start time is no older than the clock the
+  // GC read, which bounds what it returns.
+  if (current.start_times_.empty()) current.oldest_.store(time_.load());
+  // Hand out the next start time in the slot's range of the current epoch. This only reads the clock, so begins do not
+  // contend with each other, or with commits, for its cache line.
+  timestamp_t epoch = time_.load();
+  if (epoch != current.epoch_) {
+    current.epoch_ = epoch;
+    current.next_offset_ = 0;
+  } else if (current.next_offset_ == SLOT_RANGE - 1) {
+    // The slot has used up its range of this epoch, so move the clock on the same way a commit would
+    epoch = CheckOutTimestamp() + 1;
+    current.epoch_ = epoch;
+    current.next_offset_ = 0;
+  }
+  const timestamp_t start_time = epoch + (*slot * SLOT_RANGE + current.next_offset_++);
+  current.start_times_.push_back(start_time);
+  PublishOldest(&current);
+  return start_time;
+}
+
 timestamp_t TimestampManager::OldestTransactionStartTime() {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  const auto &oldest_txn = std::min_element(curr_running_txns_.cbegin(), curr_running_txns_.cend());
-  timestamp_t result = (oldest_txn != curr_running_txns_.end()) ? *oldest_txn : time_.load();
+  // Reading the clock first means a transaction that begins in a slot after we have polled it gets a start time no
+  // older than the start of the epoch we read. Nothing is checked out, so polling does not contend with begins and
+  // commits.
+  timestamp_t result = time_.load();
+  for (auto &slot : slots_) result = std::min(result, slot.oldest_.load());
   cached_oldest_txn_start_time_.store(result);  // Cache the timestamp
   return result;
 }
 
 timestamp_t TimestampManager::CachedOldestTransactionStartTime() { return cached_oldest_txn_start_time_.load(); }
 
-void TimestampManager::RemoveTransaction(timestamp_t timestamp) {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  const size_t ret UNUSED_ATTRIBUTE = curr_running_txns_.erase(timestamp);
-  TERRIER_ASSERT(ret == 1, "erased timestamp did not exist");
+void TimestampManager::RemoveTransaction(const uint32_t slot, const timestamp_t timestamp) {
+  Slot &current = slots_[slot];
+  common::SpinLatch::ScopedSpinLatch guard(&current.latch_);
+  // Transactions mostly finish in the order they began, so this is usually the front
+  const auto it = std::lower_bound(current.start_times_.begin(), current.start_times_.end(), timestamp);
+  TERRIER_ASSERT(it != current.start_times_.end() && *it == timestamp, "erased timestamp did not exist");
+  current.start_times_.erase(it);
+  PublishOldest(&current);
 }
 
-void TimestampManager::RemoveTransactions(const std::vector<terrier::transaction::timestamp_t> &timestamps) {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  for (const auto &timestamp : timestamps) {
-    const size_t ret UNUSED_ATTRIBUTE = curr_running_txns_.erase(timestamp);
-    TERRIER_ASSERT(ret == 1, "erased timestamp did not exist");
+void TimestampManager::RemoveTransactions(const std::vector<std::pair<uint32_t, timestamp_t>> &txns) {
+  uint32_t latched = NUM_SLOTS;
+  for (const auto &txn : txns) {
+    // Transactions from the same thread tend to be serialized together, so only switch latches when the slot changes
+    if (txn.first != latched) {
+      if (latched != NUM_SLOTS) {
+        PublishOldest(&slots_[latched]);
+        slots_[latched].latch_.Unlock();
+      }
+      latched = txn.first;
+      slots_[latched].latch_.Lock();
+    }
+    std::deque<timestamp_t> &start_times = slots_[latched].start_times_;
+    const auto it = std::lower_bound(start_times.begin(), start_times.end(), txn.second);
+    TERRIER_ASSERT(it != start_times.end() && *it == txn.second, "erased timestamp did not exist");
+    start_times.erase(it);
+  }
+  if (latched != NUM_SLOTS) {
+    PublishOldest(&slots_[latched]);
+    slots_[latched].latch_.Unlock();
   }
 }
 
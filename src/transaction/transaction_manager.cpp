@@ -11,14 +11,14 @@ TransactionContext *TransactionManager::BeginTransaction() {
   timestamp_t start_time;
   TransactionContext *result;
   {
-    start_time = timestamp_manager_->BeginTransaction();
+    uint32_t slot;
+    start_time = timestamp_manager_->BeginTransaction(&slot);
     result = new TransactionContext(start_time, start_time + INT64_MIN, buffer_pool_, log_manager_);
-    // Ensure we do not return from this function if there are ongoing write commits
+    result->active_txn_slot_ = slot;
+    result->oldest_active_start_time_ = timestamp_manager_->CachedOldestTransactionStartTime();
     if (common::thread_context.metrics_store_ != nullptr &&
         common::thread_context.metrics_store_->ComponentEnabled(metrics::MetricsComponent::TRANSACTION))
       common::ScopedTimer<std::chrono::nanoseconds> timer(&elapsed_us);
-    // Ensure we do not return from this function if there are ongoing write commits
-    txn_gate_.Traverse();
   }
   if (elapsed_us > 0) {
     common::thread_context.metrics_store_->RecordBeginData(elapsed_us, start_time);
@@ -41,10 +41,14 @@ void TransactionManager::LogCommit(TransactionContext *const txn, const timestam
   } else {
     // Otherwise, logging is disabled. We should pretend to have serialized and flushed the record so the rest of the
     // system proceeds correctly
-    timestamp_manager_->RemoveTransaction(txn->StartTime());
     commit_callback(commit_callback_arg);
   }
+  // A read-only transaction has nothing for the GC to unlink, so it can leave the active txn set before its commit
+  // record is processed. The record still goes to the log manager, so that its callback runs after earlier commits.
+  // Any other txn is removed by the log serializer, and may be freed by the GC as soon as the buffer is finalized.
+  const bool serializer_removes = log_manager_ != DISABLED && !txn->IsReadOnly();
   txn->redo_buffer_.Finalize(true);
+  if (!serializer_removes) timestamp_manager_->RemoveTransaction(txn->active_txn_slot_, txn->StartTime());
 }
 
 timestamp_t TransactionManager::UpdatingCommitCriticalSection(TransactionContext *const txn) {
@@ -61,18 +65,21 @@ timestamp_t TransactionManager::UpdatingCommitCriticalSection(TransactionContext
   //  Transaction 2 will incorrectly read the original version of 'a' the first
   //  time because transaction 1 hasn't made its writes visible and then reads
   //  the correct version the second time, violating snapshot isolation.
-  //  Make sure you solve this problem before you remove this gate for whatever reason.
-  common::Gate::ScopedLock gate(&txn_gate_);
+  //  Undo records read the commit timestamp through the txn's finish time
+  //  until the GC stamps them, so storing it there commits every write at
+  //  once. Any transaction that begins after we check out the commit
+  //  timestamp must not see our writes as uncommitted, so we mark the txn as
+  //  committing first, and readers wait for the commit timestamp to land.
+  txn->finish_time_.store(COMMITTING_TXN_TIMESTAMP);
   const timestamp_t commit_time = timestamp_manager_->CheckOutTimestamp();
-
-  // flip all timestamps to be committed
-  for (auto &it : txn->undo_buffer_) it.Timestamp().store(commit_time);
+  txn->finish_time_.store(commit_time);
   return commit_time;
 }
 
 timestamp_t TransactionManager::Commit(TransactionContext *const txn, transaction::callback_fn callback,
                                        void *callback_arg) {
   uint64_t elapsed_us = 0;
+  const timestamp_t start_time = txn->StartTime();
   timestamp_t result;
   {
     if (common::thread_context.metrics_store_ != nullptr &&
@@ -98,20 +105,23 @@ timestamp_t TransactionManager::Commit(TransactionContext *const txn, transactio
       // added.
       oldest_active_txn = timestamp_manager_->CachedOldestTransactionStartTime();
     }
-    LogCommit(txn, result, callback, callback_arg, oldest_active_txn);
 
     // We hand off txn to GC, however, it won't be GC'd until the LogManager marks it as serialized
-    if (gc_enabled_) {
-      common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
-      // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
-      // the critical path there anyway
-      // Also note here that GC will figure out what varlen entries to GC, as opposed to in the abort case.
-      completed_txns_.push_front(txn);
-    }
+    // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
+    // the critical path there anyway
+    // Also note here that GC will figure out what varlen entries to GC, as opposed to in the abort case.
+    // The txn has to be handed off before it leaves the active txn set, which may happen as soon as LogCommit writes
+    // its commit record. A read-only txn has no records to unlink and is freed as soon as the GC sees it, so it is
+    // only handed off once LogCommit is done with it.
+    const bool read_only = txn->IsReadOnly();
+    if (gc_enabled_ && !read_only) completed_txns_.Enqueue(txn);
+    LogCommit(txn, result, callback, callback_arg, oldest_active_txn);
+    if (gc_enabled_ && read_only) completed_txns_.Enqueue(txn);
   }
 
+  // The GC may already have freed a read-only txn
   if (elapsed_us > 0) {
-    common::thread_context.metrics_store_->RecordCommitData(elapsed_us, txn->StartTime());
+    common::thread_context.metrics_store_->RecordCommitData(elapsed_us, start_time);
   }
   return result;
 }
@@ -137,7 +147,7 @@ void TransactionManager::LogAbort(TransactionContext *const txn) {
     // not yet logged out
     txn->redo_buffer_.Finalize(false);
     // Since there is nothing to log, we can mark it as processed
-    timestamp_manager_->RemoveTransaction(txn->StartTime());
+    timestamp_manager_->RemoveTransaction(txn->active_txn_slot_, txn->StartTime());
   }
 }
 
@@ -173,16 +183,14 @@ timestamp_t TransactionManager::Abort(TransactionContext *const txn) {
   // varlen entry whose memory content needs to be freed. We have to check for this case manually.
   GCLastUpdateOnAbort(txn);
 
+  // We hand off txn to GC, however, it won't be GC'd until the LogManager marks it as serialized. As on commit, it has
+  // to be handed off before it leaves the active txn set, unless it is read-only and the GC would free it right away.
+  // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
+  // the critical path there anyway
+  const bool read_only = txn->IsReadOnly();
+  if (gc_enabled_ && !read_only) completed_txns_.Enqueue(txn);
   LogAbort(txn);
-
-  // We hand off txn to GC, however, it won't be GC'd until the LogManager marks it as serialized
-  if (gc_enabled_) {
-    common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
-    // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
-    // the critical path there anyway
-    // Also note here that GC will figure out what varlen entries to GC, as opposed to in the abort case.
-    completed_txns_.push_front(txn);
-  }
+  if (gc_enabled_ && read_only) completed_txns_.Enqueue(txn);
 
   return abort_time;
 }
@@ -215,15 +223,17 @@ void TransactionManager::GCLastUpdateOnAbort(TransactionContext *const txn) {
       auto *varlen = reinterpret_cast<storage::VarlenEntry *>(redo->Delta()->AccessWithNullCheck(i));
       if (varlen != nullptr) {
         TERRIER_ASSERT(varlen->NeedReclaim() || varlen->IsInlined(), "Fresh updates cannot be compacted or compressed");
-        if (varlen->NeedReclaim()) txn->loose_ptrs_.push_back(varlen->Content());
+        if (varlen->NeedReclaim()) txn->loose_ptrs_.push_back(*varlen);
       }
     }
   }
 }
 
 TransactionQueue TransactionManager::CompletedTransactionsForGC() {
-  common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
-  return std::move(completed_txns_);
+  TransactionQueue result;
+  TransactionContext *txn;
+  while (completed_txns_.Dequeue(&txn)) result.push_front(txn);
+  return result;
 }
 
 void TransactionManager::Rollback(TransactionContext *txn, const storage::UndoRecord &record) const {
@@ -275,7 +285,7 @@ void TransactionManager::DeallocateColumnUpdateIfVarlen(TransactionContext *txn,
     auto *varlen = reinterpret_cast<storage::VarlenEntry *>(accessor.AccessWithNullCheck(undo->Slot(), col_id));
     if (varlen != nullptr) {
       TERRIER_ASSERT(varlen->NeedReclaim() || varlen->IsInlined(), "Fresh updates cannot be compacted or compressed");
-      if (varlen->NeedReclaim()) txn->loose_ptrs_.push_back(varlen->Content());
+      if (varlen->NeedReclaim()) txn->loose_ptrs_.push_back(*varlen);
     }
   }
 }
@@ -288,7 +298,7 @@ void TransactionManager::DeallocateInsertedTupleIfVarlen(TransactionContext *txn
     if (layout.IsVarlen(col_id)) {
       auto *varlen = reinterpret_cast<storage::VarlenEntry *>(accessor.AccessWithNullCheck(undo->Slot(), col_id));
       if (varlen != nullptr) {
-        if (varlen->NeedReclaim()) txn->loose_ptrs_.push_back(varlen->Content());
+        if (varlen->NeedReclaim()) txn->loose_ptrs_.push_back(*varlen);
       }
     }
   }
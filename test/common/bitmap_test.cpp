@@ -1,4 +1,5 @@
 #include "common/container/bitmap.h"
+#include <algorithm>
 #include <cstring>
 #include <random>
 #include <thread>  // NOLINT
@@ -131,4 +132,34 @@ TEST(BitmapTests, WordUnalignedCorrectnessTest) {
     delete[] allocated_buffer;
   }
 }
+
+// Tests that copying a range of bits between RawBitmaps gives the same result as copying it bit by bit, wherever the
+// ranges start
+// NOLINTNEXTLINE
+TEST(BitmapTests, CopyFromTest) {
+  std::default_random_engine generator;
+  const uint32_t num_elements = 1000;
+  common::RawBitmap *src = common::RawBitmap::Allocate(num_elements);
+  common::RawBitmap *dst = common::RawBitmap::Allocate(num_elements);
+  std::vector<bool> stl_bitmap(num_elements);
+  for (uint32_t i = 0; i < num_elements; ++i) {
+    stl_bitmap[i] = std::uniform_int_distribution(0, 1)(generator) == 1;
+    src->Set(i, stl_bitmap[i]);
+  }
+
+  for (uint32_t iter = 0; iter < 1000; ++iter) {
+    const auto src_pos = std::uniform_int_distribution(0U, num_elements - 1)(generator);
+    const auto pos = std::uniform_int_distribution(0U, num_elements - 1)(generator);
+    const auto num_bits = std::uniform_int_distribution(0U, num_elements - std::max(pos, src_pos))(generator);
+    const bool background = iter % 2 == 0;
+    std::memset(dst, background ? 0xFF : 0, common::RawBitmap::SizeInBytes(num_elements));
+    dst->CopyFrom(pos, *src, src_pos, num_bits);
+    // Bits outside of the range are left alone
+    for (uint32_t i = 0; i < num_elements; ++i)
+      EXPECT_EQ(i >= pos && i < pos + num_bits ? stl_bitmap[src_pos + i - pos] : background, dst->Test(i));
+  }
+
+  common::RawBitmap::Deallocate(src);
+  common::RawBitmap::Deallocate(dst);
+}
 }  // namespace terrier
@@ -68,6 +68,30 @@ TEST(ObjectPoolTests, ResetLimitTest) {
   }
 }
 
+// Objects released by one thread should be handed out to another thread before the pool runs into its size limit
+// NOLINTNEXTLINE
+TEST(ObjectPoolTests, CrossThreadReuseTest) {
+  const uint64_t size_limit = 100;
+  common::ObjectPool<uint32_t> tested(size_limit, size_limit);
+  std::unordered_set<uint32_t *> released_ptrs;
+
+  std::thread releaser([&] {
+    for (uint32_t i = 0; i < size_limit; ++i) released_ptrs.insert(tested.Get());
+    for (auto *ptr : released_ptrs) tested.Release(ptr);
+  });
+  releaser.join();
+
+  std::vector<uint32_t *> ptrs;
+  std::thread getter([&] {
+    // Every object is cached by the other thread, so none of these should throw
+    for (uint32_t i = 0; i < size_limit; ++i) ptrs.push_back(tested.Get());
+  });
+  getter.join();
+  for (auto *ptr : ptrs) EXPECT_FALSE(released_ptrs.find(ptr) == released_ptrs.end());
+  EXPECT_THROW(tested.Get(), common::NoMoreObjectException);
+  for (auto *ptr : ptrs) tested.Release(ptr);
+}
+
 class ObjectPoolTestType {
  public:
   ObjectPoolTestType *Use(uint32_t thread_id) {
@@ -1,7 +1,9 @@
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <numeric>
 #include <random>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -450,4 +452,141 @@ TEST_F(ProjectedColumnsIteratorTest, MultipleVectorizedFilterTest) {
   EXPECT_LE(count, 10u);
 }
 
+
+// NOLINTNEXTLINE
+TEST_F(ProjectedColumnsIteratorTest, NullFilterTest) {
+  //
+  // Check that IS NULL and IS NOT NULL split a column into its NULLs and the
+  // rest, both on their own and after another filter
+  //
+
+  ProjectedColumnsIterator iter(GetProjectedColumn());
+  SetSize(common::Constants::K_DEFAULT_VECTOR_SIZE);
+  const uint16_t col_b = GetColOffset(ColId::col_b);
+  const uint32_t num_nulls = ColumnData(ColId::col_b).num_nulls_;
+
+  for (const bool is_null : {true, false}) {
+    iter.SetProjectedColumn(GetProjectedColumn());
+    const uint32_t selected = is_null ? iter.FilterColIsNull(col_b) : iter.FilterColIsNotNull(col_b);
+    EXPECT_EQ(is_null ? num_nulls : NumTuples() - num_nulls, selected);
+    for (; iter.HasNextFiltered(); iter.AdvanceFiltered()) {
+      bool null = false;
+      iter.Get<int32_t, true>(col_b, &null);
+      EXPECT_EQ(is_null, null);
+    }
+
+    // Compute the expected result of col_c < 500 and the NULL filter on col_b
+    iter.SetProjectedColumn(GetProjectedColumn());
+    uint32_t expected = 0;
+    for (; iter.HasNext(); iter.Advance()) {
+      bool null = false;
+      iter.Get<int32_t, true>(col_b, &null);
+      expected += static_cast<uint32_t>(*iter.Get<int32_t, false>(GetColOffset(ColId::col_c), nullptr) < 500 &&
+                                        null == is_null);
+    }
+    iter.SetProjectedColumn(GetProjectedColumn());
+    iter.FilterColByVal<std::less>(GetColOffset(ColId::col_c), type::TypeId::INTEGER,
+                                   ProjectedColumnsIterator::FilterVal{.i_ = 500});
+    EXPECT_EQ(expected, is_null ? iter.FilterColIsNull(col_b) : iter.FilterColIsNotNull(col_b));
+  }
+
+  // A column without NULLs passes IS NOT NULL whole, and nothing passes IS NULL
+  const uint16_t col_a = GetColOffset(ColId::col_a);
+  for (uint32_t i = 0; i < NumTuples(); i++) GetProjectedColumn()->ColumnNullBitmap(col_a)->Set(i, true);
+  iter.SetProjectedColumn(GetProjectedColumn());
+  EXPECT_EQ(NumTuples(), iter.FilterColIsNotNull(col_a));
+  EXPECT_FALSE(iter.IsFiltered());
+  EXPECT_EQ(0, iter.FilterColIsNull(col_a));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ProjectedColumnsIteratorTest, DictionaryFilterTest) {
+  //
+  // Check that string filters on a dictionary-compressed column select the
+  // same tuples as on the same strings stored plainly, and that both match
+  // comparing the strings one at a time
+  //
+
+  const std::vector<std::string> words = {"ap",     "apple",  "apricot",
+                                          "banana", "cherry", "cherry pie with whipped cream"};
+  const uint32_t num_tuples = common::Constants::K_DEFAULT_VECTOR_SIZE;
+
+  // Build the sorted dictionary, the codes of every tuple, and the plain strings they stand for
+  uint32_t values_length = 0;
+  for (const auto &word : words) values_length += static_cast<uint32_t>(word.size());
+  storage::ArrowVarlenColumn dictionary(values_length, static_cast<uint32_t>(words.size() + 1));
+  for (uint32_t i = 0, offset = 0; i < words.size(); i++) {
+    dictionary.Offsets()[i] = offset;
+    std::memcpy(dictionary.Values() + offset, words[i].data(), words[i].size());
+    offset += static_cast<uint32_t>(words[i].size());
+  }
+  dictionary.Offsets()[words.size()] = values_length;
+
+  auto make_entry = [](const byte *content, uint32_t size) {
+    return size <= storage::VarlenEntry::InlineThreshold()
+               ? storage::VarlenEntry::CreateInline(content, size)
+               : storage::VarlenEntry::Create(const_cast<byte *>(content), size, false);
+  };
+
+  std::mt19937 generator;
+  std::uniform_int_distribution<uint32_t> word_dist(0, static_cast<uint32_t>(words.size() - 1));
+  std::vector<uint32_t> codes(num_tuples);
+  std::vector<storage::VarlenEntry> strings(num_tuples);
+  common::RawBitmap *nulls = common::RawBitmap::Allocate(num_tuples);
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    codes[i] = word_dist(generator);
+    // Every seventh value is NULL, with a code that would match every filter if it were not ignored
+    if (i % 7 == 0) continue;
+    nulls->Flip(i);
+    const byte *word = dictionary.Values() + dictionary.Offsets()[codes[i]];
+    strings[i] = make_entry(word, dictionary.Offsets()[codes[i] + 1] - dictionary.Offsets()[codes[i]]);
+  }
+
+  auto *col_data = reinterpret_cast<byte *>(strings.data());
+  const common::RawBitmap *col_nulls = nulls;
+  const uint32_t *col_codes = codes.data();
+  const storage::ArrowVarlenColumn *col_dictionary = &dictionary;
+
+  auto check = [&](const auto &filter, const auto &pred) {
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      if (nulls->Test(i) && pred(words[codes[i]])) expected++;
+    }
+    ProjectedColumnsIterator plain_iter, dictionary_iter;
+    plain_iter.SetColumns(1, &col_data, &col_nulls, num_tuples);
+    dictionary_iter.SetColumns(1, &col_data, &col_nulls, num_tuples, &col_codes, &col_dictionary);
+    EXPECT_FALSE(plain_iter.IsDictionaryCompressed(0));
+    EXPECT_TRUE(dictionary_iter.IsDictionaryCompressed(0));
+    EXPECT_EQ(expected, filter(&plain_iter));
+    EXPECT_EQ(expected, filter(&dictionary_iter));
+    for (; dictionary_iter.HasNextFiltered(); dictionary_iter.AdvanceFiltered()) {
+      bool null = true;
+      const auto *entry = dictionary_iter.Get<storage::VarlenEntry, true>(0, &null);
+      EXPECT_FALSE(null);
+      EXPECT_TRUE(pred(std::string(reinterpret_cast<const char *>(entry->Content()), entry->Size())));
+    }
+  };
+
+  // Probe with words in the dictionary, and with strings that fall between, before and after its words
+  for (const std::string probe : {"ap", "apricot", "apq", "a", "cherry", "cherry pie with whipped cream", "zebra"}) {
+    const auto val = make_entry(reinterpret_cast<const byte *>(probe.data()), static_cast<uint32_t>(probe.size()));
+    check([&](auto *iter) { return iter->template FilterStringColByVal<std::equal_to>(0, val); },
+          [&](const std::string &word) { return word == probe; });
+    check([&](auto *iter) { return iter->template FilterStringColByVal<std::not_equal_to>(0, val); },
+          [&](const std::string &word) { return word != probe; });
+    check([&](auto *iter) { return iter->template FilterStringColByVal<std::less>(0, val); },
+          [&](const std::string &word) { return word < probe; });
+    check([&](auto *iter) { return iter->template FilterStringColByVal<std::less_equal>(0, val); },
+          [&](const std::string &word) { return word <= probe; });
+    check([&](auto *iter) { return iter->template FilterStringColByVal<std::greater>(0, val); },
+          [&](const std::string &word) { return word > probe; });
+    check([&](auto *iter) { return iter->template FilterStringColByVal<std::greater_equal>(0, val); },
+          [&](const std::string &word) { return word >= probe; });
+    check([&](auto *iter) { return iter->FilterStringColByPrefix(0, val); },
+          [&](const std::string &word) { return word.compare(0, probe.size(), probe) == 0; });
+  }
+
+  common::RawBitmap::Deallocate(nulls);
+}
+
 }  // namespace terrier::execution::sql::test
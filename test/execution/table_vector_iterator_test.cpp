@@ -1,12 +1,19 @@
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "execution/sql_test.h"
 
 #include "catalog/catalog_defs.h"
 #include "execution/sql/table_vector_iterator.h"
+#include "execution/sql/thread_state_container.h"
 #include "execution/util/timer.h"
+#include "execution/vm/module.h"
+#include "execution/vm/module_compiler.h"
 
 namespace terrier::execution::sql::test {
 
@@ -23,11 +30,141 @@ class TableVectorIteratorTest : public SqlBasedTest {
     return parser::ConstantValueExpression(type::TransientValueFactory::GetInteger(0));
   }
 
+  /**
+   * Words that colC of the frozen table cycles through, in sorted order
+   */
+  static constexpr std::array<const char *, 4> WORDS{"apple", "banana", "cherry", "date"};
+
+  /**
+   * Creates the table "frozen_table" out of the given number of full blocks, and freezes it. Tuple i has colA = i,
+   * colB = 7 and colC = WORDS[i % WORDS.size()], and the tuples are laid out in the blocks in that order.
+   * @param num_blocks number of blocks to fill
+   * @param varlen_type how colC is laid out in the frozen blocks
+   * @return oid of the table
+   */
+  catalog::table_oid_t CreateFrozenTable(uint32_t num_blocks, storage::ArrowColumnType varlen_type) {
+    std::vector<catalog::Schema::Column> cols;
+    cols.emplace_back("colA", type::TypeId::INTEGER, false, DummyExpr());
+    cols.emplace_back("colB", type::TypeId::INTEGER, false, DummyExpr());
+    cols.emplace_back("colC", type::TypeId::VARCHAR, 16, false, DummyExpr());
+    auto *accessor = exec_ctx_->GetAccessor();
+    const catalog::table_oid_t table_oid = accessor->CreateTable(NSOid(), "frozen_table", catalog::Schema(cols));
+    const catalog::Schema &schema = accessor->GetSchema(table_oid);
+    accessor->SetTablePointer(table_oid, new storage::SqlTable(BlockStore(), schema));
+    auto table = accessor->GetTable(table_oid);
+
+    std::vector<catalog::col_oid_t> col_oids;
+    for (const auto &col : schema.GetColumns()) col_oids.push_back(col.Oid());
+    auto initializer = table->InitializerForProjectedRow(col_oids);
+    auto offsets = table->ProjectionMapForOids(col_oids);
+    // Until the first insert tells us how many tuples fit in a block
+    tuples_per_block_ = 1;
+    for (uint32_t i = 0; i < num_blocks * tuples_per_block_; i++) {
+      storage::RedoRecord *redo = exec_ctx_->GetTxn()->StageWrite(exec_ctx_->DBOid(), table_oid, initializer);
+      storage::ProjectedRow *row = redo->Delta();
+      *reinterpret_cast<int32_t *>(row->AccessForceNotNull(offsets[col_oids[0]])) = static_cast<int32_t>(i);
+      *reinterpret_cast<int32_t *>(row->AccessForceNotNull(offsets[col_oids[1]])) = 7;
+      const char *word = WORDS[i % WORDS.size()];
+      *reinterpret_cast<storage::VarlenEntry *>(row->AccessForceNotNull(offsets[col_oids[2]])) =
+          storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>(word),
+                                             static_cast<uint32_t>(std::strlen(word)));
+      const storage::TupleSlot slot = table->Insert(exec_ctx_->GetTxn(), redo);
+      if (i == 0) tuples_per_block_ = slot.GetBlock()->data_table_->GetBlockLayout().NumSlots();
+    }
+    EXPECT_EQ(num_blocks, FreezeTable(table, varlen_type));
+    // The old execution context belongs to the transaction that was committed to freeze the table
+    exec_ctx_ = MakeExecCtx();
+    return table_oid;
+  }
+
+  /**
+   * Scans colA and colB of the frozen table, skipping the blocks whose zone maps rule out "column Op val". Checks that
+   * every tuple of the expected blocks is read, and that the other blocks are skipped.
+   * @tparam Op The comparison operator
+   * @param table_oid oid of the frozen table
+   * @param col_name the column to compare, colA or colB
+   * @param val the value to compare the column to
+   * @param expected_blocks indexes of the blocks that cannot be skipped
+   */
+  template <template <typename> typename Op>
+  void CheckZoneMapScan(catalog::table_oid_t table_oid, const std::string &col_name, int64_t val,
+                        const std::vector<uint32_t> &expected_blocks) {
+    auto table = exec_ctx_->GetAccessor()->GetTable(table_oid);
+    const catalog::Schema &schema = exec_ctx_->GetAccessor()->GetSchema(table_oid);
+    const std::vector<catalog::col_oid_t> col_oids{schema.GetColumn("colA").Oid(), schema.GetColumn("colB").Oid()};
+    auto offsets = table->ProjectionMapForOids(col_oids);
+    std::array<uint32_t, 2> raw_col_oids{!col_oids[0], !col_oids[1]};
+    TableVectorIterator iter(exec_ctx_.get(), !table_oid, raw_col_oids.data(),
+                             static_cast<uint32_t>(raw_col_oids.size()));
+    iter.Init();
+    iter.AddZoneMapFilter<Op>(offsets[schema.GetColumn(col_name).Oid()], type::TypeId::INTEGER, val);
+    ProjectedColumnsIterator *pci = iter.GetProjectedColumnsIterator();
+
+    // colA tells which block a tuple is in
+    std::vector<uint32_t> num_read(table->GetNumBlocks(), 0);
+    while (iter.Advance()) {
+      for (; pci->HasNext(); pci->Advance()) {
+        num_read[*pci->Get<int32_t, false>(offsets[col_oids[0]], nullptr) / tuples_per_block_]++;
+      }
+      pci->Reset();
+    }
+    for (uint32_t block_idx = 0; block_idx < num_read.size(); block_idx++) {
+      const bool expected = std::count(expected_blocks.begin(), expected_blocks.end(), block_idx) != 0;
+      EXPECT_EQ(expected ? tuples_per_block_ : 0, num_read[block_idx]) << col_name << " " << val;
+    }
+    EXPECT_EQ(num_read.size() - expected_blocks.size(), iter.NumSkippedBlocks()) << col_name << " " << val;
+  }
+
+  /**
+   * Reads colC of the frozen table in place, and filters every vector of it with the given function
+   * @param table_oid oid of the frozen table
+   * @param filter filters the PCI and returns the number of tuples selected
+   * @return the total number of tuples selected
+   */
+  template <typename F>
+  uint32_t FilterFrozenStrings(catalog::table_oid_t table_oid, const F &filter) {
+    const catalog::Schema &schema = exec_ctx_->GetAccessor()->GetSchema(table_oid);
+    std::array<uint32_t, 1> col_oids{!schema.GetColumn("colC").Oid()};
+    TableVectorIterator iter(exec_ctx_.get(), !table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()));
+    iter.Init();
+    iter.SetInPlaceScan(true);
+    ProjectedColumnsIterator *pci = iter.GetProjectedColumnsIterator();
+    uint32_t num_selected = 0;
+    while (iter.Advance()) {
+      EXPECT_TRUE(pci->IsDictionaryCompressed(0));
+      num_selected += filter(pci);
+    }
+    return num_selected;
+  }
+
+  /**
+   * Checks that filtering colC of the frozen table by "colC Op val" selects the tuples that comparing the strings does
+   * @tparam Op The comparison operator
+   * @param table_oid oid of the frozen table
+   * @param num_tuples number of tuples in the table
+   * @param val the string to compare colC to
+   */
+  template <template <typename> typename Op>
+  void CheckStringFilter(catalog::table_oid_t table_oid, uint32_t num_tuples, const std::string &val) {
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < num_tuples; i++) expected += Op<std::string>()(WORDS[i % WORDS.size()], val) ? 1 : 0;
+    const auto entry = storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>(val.data()),
+                                                          static_cast<uint32_t>(val.size()));
+    EXPECT_EQ(expected, FilterFrozenStrings(table_oid, [&](ProjectedColumnsIterator *pci) {
+                return pci->FilterStringColByVal<Op>(0, entry);
+              })) << val;
+  }
+
  protected:
   /**
    * Execution context to use for the test
    */
   std::unique_ptr<exec::ExecutionContext> exec_ctx_;
+
+  /**
+   * Number of tuples in each block of the frozen table
+   */
+  uint32_t tuples_per_block_ = 0;
 };
 
 // NOLINTNEXTLINE
@@ -129,4 +266,167 @@ TEST_F(TableVectorIteratorTest, IteratorColOidsTest) {
   EXPECT_EQ(sql::TEST2_SIZE, num_tuples);
 }
 
+// NOLINTNEXTLINE
+TEST_F(TableVectorIteratorTest, InPlaceScanTest) {
+  //
+  // Ensure that frozen blocks are read in place, i.e. that the PCI points straight into the blocks
+  //
+
+  const uint32_t num_blocks = 2;
+  auto table_oid = CreateFrozenTable(num_blocks, storage::ArrowColumnType::GATHERED_VARLEN);
+  auto table = exec_ctx_->GetAccessor()->GetTable(table_oid);
+  const catalog::Schema &schema = exec_ctx_->GetAccessor()->GetSchema(table_oid);
+  std::array<uint32_t, 1> col_oids{!schema.GetColumn("colA").Oid()};
+  TableVectorIterator iter(exec_ctx_.get(), !table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()));
+  iter.Init();
+  // As with @tableIterInPlace, which can only come after the iterator is initialized
+  iter.SetInPlaceScan(true);
+  ProjectedColumnsIterator *pci = iter.GetProjectedColumnsIterator();
+
+  uint32_t num_tuples = 0;
+  while (iter.Advance()) {
+    for (; pci->HasNext(); pci->Advance()) {
+      auto *val = pci->Get<int32_t, false>(0, nullptr);
+      ASSERT_EQ(*val, static_cast<int32_t>(num_tuples));
+      // The value is read from the block the tuple is in, not from a copy
+      auto *block = reinterpret_cast<const byte *>(table->beginAt(num_tuples / tuples_per_block_)->GetBlock());
+      auto *value = reinterpret_cast<const byte *>(val);
+      EXPECT_TRUE(block <= value && value < block + common::Constants::BLOCK_SIZE);
+      num_tuples++;
+    }
+    pci->Reset();
+  }
+  EXPECT_EQ(num_blocks * tuples_per_block_, num_tuples);
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableVectorIteratorTest, ZoneMapTest) {
+  //
+  // Ensure that the frozen blocks whose zone maps rule out a predicate are skipped, and only those
+  //
+
+  auto table_oid = CreateFrozenTable(3, storage::ArrowColumnType::GATHERED_VARLEN);
+  // Block i holds the values [i * n, (i + 1) * n) of colA
+  const auto n = static_cast<int64_t>(tuples_per_block_);
+
+  // The bounds of a block are in its range
+  CheckZoneMapScan<std::equal_to>(table_oid, "colA", n - 1, {0});
+  CheckZoneMapScan<std::equal_to>(table_oid, "colA", n, {1});
+  CheckZoneMapScan<std::equal_to>(table_oid, "colA", 3 * n, {});
+  CheckZoneMapScan<std::less>(table_oid, "colA", n, {0});
+  CheckZoneMapScan<std::less>(table_oid, "colA", 0, {});
+  CheckZoneMapScan<std::less_equal>(table_oid, "colA", n, {0, 1});
+  CheckZoneMapScan<std::greater>(table_oid, "colA", 2 * n - 1, {2});
+  CheckZoneMapScan<std::greater>(table_oid, "colA", 3 * n - 1, {});
+  CheckZoneMapScan<std::greater_equal>(table_oid, "colA", 2 * n - 1, {1, 2});
+
+  // A block can only be ruled out by != if all of its values are the same. colB is always 7.
+  CheckZoneMapScan<std::not_equal_to>(table_oid, "colA", 0, {0, 1, 2});
+  CheckZoneMapScan<std::not_equal_to>(table_oid, "colB", 7, {});
+  CheckZoneMapScan<std::not_equal_to>(table_oid, "colB", 8, {0, 1, 2});
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableVectorIteratorTest, DictionaryFilterTest) {
+  //
+  // Ensure that string filters on the dictionary-compressed columns of frozen blocks, which compare dictionary codes
+  // instead of strings, select the right tuples
+  //
+
+  const uint32_t num_blocks = 2;
+  auto table_oid = CreateFrozenTable(num_blocks, storage::ArrowColumnType::DICTIONARY_COMPRESSED);
+  const uint32_t num_tuples = num_blocks * tuples_per_block_;
+
+  // Words in the dictionary, words in between them, and words before and after all of them
+  for (const std::string val : {"apple", "banana", "date", "a", "blueberry", "zucchini"}) {
+    CheckStringFilter<std::equal_to>(table_oid, num_tuples, val);
+    CheckStringFilter<std::not_equal_to>(table_oid, num_tuples, val);
+    CheckStringFilter<std::less>(table_oid, num_tuples, val);
+    CheckStringFilter<std::less_equal>(table_oid, num_tuples, val);
+    CheckStringFilter<std::greater>(table_oid, num_tuples, val);
+    CheckStringFilter<std::greater_equal>(table_oid, num_tuples, val);
+  }
+
+  for (const std::string prefix : {"", "b", "ch", "cherry", "cherryx", "e"}) {
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      const std::string word = WORDS[i % WORDS.size()];
+      expected += word.compare(0, prefix.size(), prefix) == 0 ? 1 : 0;
+    }
+    const auto entry = storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>(prefix.data()),
+                                                          static_cast<uint32_t>(prefix.size()));
+    EXPECT_EQ(expected, FilterFrozenStrings(table_oid, [&](ProjectedColumnsIterator *pci) {
+                return pci->FilterStringColByPrefix(0, entry);
+              })) << prefix;
+  }
+
+  // The filters are also reachable from TPL
+  const catalog::Schema &schema = exec_ctx_->GetAccessor()->GetSchema(table_oid);
+  const std::string src =
+      "fun main(execCtx: *ExecutionContext) -> int64 {\n"
+      "  var ret = 0\n"
+      "  var tvi: TableVectorIterator\n"
+      "  var oids: [1]uint32\n"
+      "  oids[0] = " + std::to_string(!schema.GetColumn("colC").Oid()) + "\n"
+      "  @tableIterInitBind(&tvi, execCtx, \"frozen_table\", oids)\n"
+      "  @tableIterInPlace(&tvi)\n"
+      "  for (@tableIterAdvance(&tvi)) {\n"
+      "    var pci = @tableIterGetPCI(&tvi)\n"
+      "    ret = ret + @filterStringLt(pci, 0, \"cherry\")\n"
+      "  }\n"
+      "  @tableIterClose(&tvi)\n"
+      "  return ret\n"
+      "}\n";
+  vm::test::ModuleCompiler compiler;
+  auto *ast = compiler.CompileToAst(src);
+  ASSERT_FALSE(compiler.HasErrors());
+  auto module = std::make_unique<vm::Module>(vm::BytecodeGenerator::Compile(ast, exec_ctx_.get(), "test"));
+  std::function<int64_t(exec::ExecutionContext *)> main;
+  ASSERT_TRUE(module->GetFunction("main", vm::ExecutionMode::Interpret, &main));
+  int64_t expected = 0;
+  for (uint32_t i = 0; i < num_tuples; i++) expected += std::string(WORDS[i % WORDS.size()]) < "cherry" ? 1 : 0;
+  EXPECT_EQ(expected, main(exec_ctx_.get()));
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableVectorIteratorTest, ParallelScanTest) {
+  //
+  // Simple test to ensure we iterate over the whole table in parallel
+  //
+
+  struct Counter {
+    uint32_t c_;
+  };
+
+  auto init_count = [](UNUSED_ATTRIBUTE void *ctx, void *tls) { reinterpret_cast<Counter *>(tls)->c_ = 0; };
+
+  // Scan function just counts all tuples it sees
+  auto scanner = [](UNUSED_ATTRIBUTE void *state, void *tls, TableVectorIterator *tvi) {
+    auto *counter = reinterpret_cast<Counter *>(tls);
+    while (tvi->Advance()) {
+      for (auto *pci = tvi->GetProjectedColumnsIterator(); pci->HasNext(); pci->Advance()) {
+        counter->c_++;
+      }
+    }
+  };
+
+  // Setup thread states
+  ThreadStateContainer thread_state_container(exec_ctx_->GetMemoryPool());
+  thread_state_container.Reset(sizeof(Counter),  // The type of each thread state structure
+                               init_count,       // The thread state initialization function
+                               nullptr,          // The thread state destruction function
+                               nullptr);         // Context passed to init/destroy functions
+
+  auto table_oid = exec_ctx_->GetAccessor()->GetTableOid(NSOid(), "test_1");
+  std::array<uint32_t, 1> col_oids{1};
+  ASSERT_TRUE(TableVectorIterator::ParallelScan(!table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()),
+                                                nullptr, &thread_state_container, exec_ctx_.get(), scanner));
+
+  // Count total aggregate tuple count seen by all threads
+  uint32_t aggregate_tuple_count = 0;
+  thread_state_container.ForEach<Counter>([&](Counter *counter) { aggregate_tuple_count += counter->c_; });
+
+  EXPECT_EQ(sql::TEST1_SIZE, aggregate_tuple_count);
+}
+
 }  // namespace terrier::execution::sql::test
@@ -500,4 +500,39 @@ TEST_F(VectorUtilTest, GatherTest) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(VectorUtilTest, BitVectorFilterTest) {
+  // Sizes that leave a partial word and a partial byte at the end, and bit vectors with few, some and all bits set
+  for (const uint32_t num_bits : {1u, 63u, 64u, 1000u, 2048u}) {
+    for (const uint32_t set_per_thousand : {0u, 10u, 500u, 1000u}) {
+      auto bits = AllocateArray<uint8_t>(num_bits / 8 + 1);
+      std::vector<bool> reference(num_bits);
+      std::mt19937 gen(num_bits + set_per_thousand);
+      for (uint32_t i = 0; i < num_bits; i++) {
+        reference[i] = gen() % 1000 < set_per_thousand;
+        if (reference[i]) bits[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+      }
+
+      const auto num_set = static_cast<uint32_t>(std::count(reference.begin(), reference.end(), true));
+      EXPECT_EQ(num_set, VectorUtil::CountBits(bits.Raw(), num_bits));
+
+      // Without a selection vector, and then with one that holds every other position
+      for (const uint32_t stride : {1u, 2u}) {
+        auto sel = AllocateArray<uint32_t>(num_bits);
+        uint32_t sel_count = 0;
+        for (uint32_t i = 0; i < num_bits; i += stride) sel[sel_count++] = i;
+        for (const bool val : {true, false}) {
+          std::vector<uint32_t> expected;
+          for (uint32_t i = 0; i < num_bits; i += stride)
+            if (reference[i] == val) expected.push_back(i);
+          auto out = AllocateArray<uint32_t>(num_bits);
+          const uint32_t *sel_vec = stride == 1 ? nullptr : sel.Raw();
+          const uint32_t count = VectorUtil::FilterBitVectorByVal(bits.Raw(), sel_count, val, out.Raw(), sel_vec);
+          EXPECT_EQ(expected, std::vector<uint32_t>(out.Raw(), out.Raw() + count));
+        }
+      }
+    }
+  }
+}
+
 }  // namespace terrier::execution::util::test
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -9,6 +10,7 @@
 
 #include "execution/exec/execution_context.h"
 #include "execution/table_generator/table_generator.h"
+#include "storage/block_compactor.h"
 #include "storage/garbage_collector.h"
 #include "transaction/deferred_action_manager.h"
 #include "transaction/timestamp_manager.h"
@@ -65,6 +67,48 @@ class SqlBasedTest : public TplTest {
     table_generator.GenerateTestTables();
   }
 
+  /**
+   * Freezes the full blocks of the given table, as the block compactor does once they go cold. The versions in the
+   * blocks can only be pruned once the test transaction is done with them, so the test transaction is committed and a
+   * new one is begun. Execution contexts made before this call must not be used after it.
+   * @param table the table to freeze
+   * @param varlen_type how the varlen columns of the table are laid out in the frozen blocks
+   * @return number of blocks frozen
+   */
+  uint32_t FreezeTable(common::ManagedPointer<storage::SqlTable> table, storage::ArrowColumnType varlen_type) {
+    txn_manager_->Commit(test_txn_, transaction::TransactionUtil::EmptyCallback, nullptr);
+    gc_->PerformGarbageCollection();
+    gc_->PerformGarbageCollection();
+
+    storage::BlockCompactor compactor;
+    std::vector<storage::RawBlock *> blocks;
+    for (uint32_t block_idx = 0; block_idx < table->GetNumBlocks(); block_idx++) {
+      storage::RawBlock *block = table->beginAt(block_idx)->GetBlock();
+      const storage::BlockLayout &layout = block->data_table_->GetBlockLayout();
+      // Only full blocks are compacted
+      if (block->GetInsertHead() != layout.NumSlots()) continue;
+      storage::TupleAccessStrategy accessor(layout);
+      storage::ArrowBlockMetadata &metadata = accessor.GetArrowBlockMetadata(block);
+      for (storage::col_id_t col_id : layout.AllColumns())
+        if (layout.IsVarlen(col_id)) metadata.GetColumnInfo(layout, col_id).Type() = varlen_type;
+      blocks.push_back(block);
+      compactor.PutInQueue(block);
+    }
+    compactor.ProcessCompactionQueue(da_manager_.get(), txn_manager_.get());  // compaction pass
+    gc_->PerformGarbageCollection();
+    gc_->PerformGarbageCollection();
+    for (storage::RawBlock *block : blocks) compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(da_manager_.get(), txn_manager_.get());  // gathering pass
+    gc_->PerformGarbageCollection();
+    gc_->PerformGarbageCollection();  // Second call to free the varlens the gathering pass replaced
+
+    uint32_t num_frozen = 0;
+    for (storage::RawBlock *block : blocks)
+      if (block->controller_.GetBlockState()->load() == storage::BlockState::FROZEN) num_frozen++;
+    test_txn_ = txn_manager_->BeginTransaction();
+    return num_frozen;
+  }
+
   parser::ConstantValueExpression DummyCVE() {
     return parser::ConstantValueExpression(type::TransientValueFactory::GetInteger(0));
   }
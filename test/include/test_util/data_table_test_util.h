@@ -289,6 +289,11 @@ class LargeDataTableTestObject {
    */
   const storage::BlockLayout &Layout() const { return layout_; }
 
+  /**
+   * @return start timestamp of the transaction that populated the table
+   */
+  transaction::timestamp_t InitialTxnBegin() const { return initial_txn_begin_; }
+
   /**
    * Checks the correctness of reads in the committed transactions. No committed transaction should have read some
    * version of the tuple outside of its version. The correct version is reconstructed using the last valid image of
@@ -324,6 +329,7 @@ class LargeDataTableTestObject {
   storage::DataTable table_;
   transaction::TransactionManager *txn_manager_;
   transaction::TransactionContext *initial_txn_ = nullptr;
+  transaction::timestamp_t initial_txn_begin_;
   bool gc_on_, wal_on_;
 
   // tuple content is meaningless if bookkeeping is off.
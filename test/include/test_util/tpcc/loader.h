@@ -156,7 +156,12 @@ struct Loader {
     }
     txn_manager->Commit(item_txn, TestCallbacks::EmptyCallback, nullptr);
 
-    // Populate the other tables in parallel
+    // Populate the other tables in parallel. Every thread fills blocks of its own rather than contending with the
+    // others over the same blocks.
+    const std::vector<common::ManagedPointer<storage::SqlTable>> warehouse_tables = {
+        db->warehouse_table_, db->stock_table_,     db->district_table_, db->customer_table_,
+        db->history_table_,   db->new_order_table_, db->order_table_,    db->order_line_table_};
+    for (const auto &table : warehouse_tables) table->SetThreadLocalInsertion(true);
     for (int8_t w_id = 0; w_id < num_warehouses; w_id++) {
       // copy the pr_map and pr_initializers by reference since they're on the stack in this scope, but the remaining
       // are pointers or integers so we'll copy by value
@@ -361,9 +366,11 @@ struct Loader {
         }
 
         txn_manager->Commit(txn, TestCallbacks::EmptyCallback, nullptr);
+        for (const auto &table : warehouse_tables) table->ReleaseThreadLocalBlock();
       });
     }
     thread_pool->WaitUntilAllFinished();
+    for (const auto &table : warehouse_tables) table->SetThreadLocalInsertion(false);
   }
 
   template <class Random>
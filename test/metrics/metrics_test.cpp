@@ -184,4 +184,60 @@ TEST_F(MetricsTests, TransactionCSVTest) {
 
   metrics_manager_->UnregisterThread();
 }
+
+/**
+ *  Testing that the compactor workers' pass statistics are aggregated and written out
+ */
+// NOLINTNEXTLINE
+TEST_F(MetricsTests, CompactionCSVTest) {
+  for (const auto &file : metrics::CompactionMetricRawData::FILES) unlink(std::string(file).c_str());
+  const settings::setter_callback_fn setter_callback = MetricsTests::EmptySetterCallback;
+  std::shared_ptr<common::ActionContext> action_context =
+      std::make_shared<common::ActionContext>(common::action_id_t(1));
+  settings_manager_->SetBool(settings::Param::metrics_compaction, true, action_context, setter_callback);
+
+  metrics_manager_->RegisterThread();
+
+  // Stand in for two passes of a compactor worker
+  common::thread_context.metrics_store_->RecordCompactionData(0, 100, 8, 0, 1);
+  common::thread_context.metrics_store_->RecordCompactionData(0, 200, 0, 7, 0);
+
+  metrics_manager_->Aggregate();
+  const auto aggregated_data = reinterpret_cast<CompactionMetricRawData *>(
+      metrics_manager_->AggregatedMetrics().at(static_cast<uint8_t>(MetricsComponent::COMPACTION)).get());
+  EXPECT_NE(aggregated_data, nullptr);
+  EXPECT_EQ(aggregated_data->worker_data_.size(), 2);  // 2 passes recorded
+  metrics_manager_->ToCSV();
+  EXPECT_EQ(aggregated_data->worker_data_.size(), 0);
+
+  metrics_manager_->UnregisterThread();
+}
+
+/**
+ *  Testing that the garbage collector's pass statistics are aggregated and written out
+ */
+// NOLINTNEXTLINE
+TEST_F(MetricsTests, GarbageCollectionCSVTest) {
+  for (const auto &file : metrics::GarbageCollectionMetricRawData::FILES) unlink(std::string(file).c_str());
+  const settings::setter_callback_fn setter_callback = MetricsTests::EmptySetterCallback;
+  std::shared_ptr<common::ActionContext> action_context =
+      std::make_shared<common::ActionContext>(common::action_id_t(1));
+  settings_manager_->SetBool(settings::Param::metrics_gc, true, action_context, setter_callback);
+
+  metrics_manager_->RegisterThread();
+
+  // Stand in for two GC passes
+  common::thread_context.metrics_store_->RecordGarbageCollectionData(100, 1, 0, 10, 2, 10, 5);
+  common::thread_context.metrics_store_->RecordGarbageCollectionData(200, 4, 10, 0, 0, 0, 1);
+
+  metrics_manager_->Aggregate();
+  const auto aggregated_data = reinterpret_cast<GarbageCollectionMetricRawData *>(
+      metrics_manager_->AggregatedMetrics().at(static_cast<uint8_t>(MetricsComponent::GARBAGECOLLECTION)).get());
+  EXPECT_NE(aggregated_data, nullptr);
+  EXPECT_EQ(aggregated_data->pass_data_.size(), 2);  // 2 passes recorded
+  metrics_manager_->ToCSV();
+  EXPECT_EQ(aggregated_data->pass_data_.size(), 0);
+
+  metrics_manager_->UnregisterThread();
+}
 }  // namespace terrier::metrics
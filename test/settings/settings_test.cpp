@@ -23,6 +23,9 @@ class SettingsTests : public TerrierTest {
   storage::LogManager *log_manager_;
   transaction::TransactionManager *txn_manager_;
   storage::RecordBufferSegmentPool *buffer_segment_pool_;
+  storage::BlockCompactor *block_compactor_;
+  storage::AccessObserver *access_observer_;
+  storage::BlockEvictor *block_evictor_;
 
   const uint64_t default_buffer_pool_size_ = 100000;
 
@@ -35,6 +38,9 @@ class SettingsTests : public TerrierTest {
     log_manager_ = db_main_->log_manager_;
     txn_manager_ = db_main_->txn_manager_;
     buffer_segment_pool_ = db_main_->buffer_segment_pool_;
+    block_compactor_ = db_main_->block_compactor_;
+    access_observer_ = db_main_->access_observer_;
+    block_evictor_ = db_main_->block_evictor_;
   }
 
   void TearDown() override { delete db_main_; }
@@ -210,4 +216,32 @@ TEST_F(SettingsTests, ConcurrentModifyTest) {
   EXPECT_EQ(buffer_pool_size_param, buffer_pool_size);
 }
 
+// Check that the block compactor and evictor are only started when they are turned on, and that the access observer
+// that feeds them uses the cold data threshold from the settings
+// NOLINTNEXTLINE
+TEST_F(SettingsTests, ColdDataSettingsTest) {
+  EXPECT_EQ(0, settings_manager_->GetInt(Param::compactor_num_workers));
+  EXPECT_EQ(nullptr, block_compactor_);
+  EXPECT_EQ(nullptr, access_observer_);
+  EXPECT_EQ(nullptr, block_evictor_);
+
+  // Restart with the values that would have been passed on the command line
+  TearDown();
+  FLAGS_compactor_num_workers = 1;
+  FLAGS_cold_data_epoch_threshold = 42;
+  FLAGS_block_evictor_idle_threshold = 5;
+  FLAGS_block_evictor_max_evictions_per_pass = 2;
+  SetUp();
+  FLAGS_compactor_num_workers = 0;
+  FLAGS_cold_data_epoch_threshold = 10;
+  FLAGS_block_evictor_idle_threshold = 0;
+  FLAGS_block_evictor_max_evictions_per_pass = 4;
+
+  EXPECT_NE(nullptr, block_compactor_);
+  ASSERT_NE(nullptr, access_observer_);
+  EXPECT_EQ(42, access_observer_->TableColdThreshold(nullptr));
+  ASSERT_NE(nullptr, block_evictor_);
+  EXPECT_EQ(2, block_evictor_->MaxEvictionsPerPass());
+}
+
 }  // namespace terrier::settings
@@ -57,6 +57,100 @@ TEST(AccessObserverTest, FilledBlocksObserved) {
   for (uint32_t i = 0; i <= COLD_DATA_EPOCH_THRESHOLD; i++) tested.ObserveGCInvocation();
   delete fake_block;
 }
+
+// Tests that the observer stops watching blocks of a table once the table is dropped
+// NOLINTNEXTLINE
+TEST(AccessObserverTest, FreedBlocksForgotten) {
+  std::default_random_engine generator;
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator);
+  storage::BlockStore block_store{1, 1};
+  auto *table = new storage::DataTable(&block_store, layout, storage::layout_version_t(0));
+  storage::RawBlock *block = table->begin()->GetBlock();
+
+  MockBlockCompactor mock_compactor;
+  EXPECT_CALL(mock_compactor, PutInQueue(::testing::_)).Times(0);
+  storage::AccessObserver tested(&mock_compactor);
+
+  block->insert_head_ = layout.NumSlots();
+  tested.ObserveWrite(block);
+  delete table;
+  for (uint32_t i = 0; i <= COLD_DATA_EPOCH_THRESHOLD; i++) tested.ObserveGCInvocation();
+}
+
+// Tests that a block that was written to heavily needs to stay idle for longer than the threshold before it is
+// considered cold
+// NOLINTNEXTLINE
+TEST(AccessObserverTest, HotBlocksCoolDownSlowly) {
+  std::default_random_engine generator;
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator);
+  storage::TupleAccessStrategy accessor(layout);
+  storage::DataTable table(nullptr, layout, storage::layout_version_t(0));
+  auto *fake_block = new storage::RawBlock;
+  accessor.InitializeRawBlock(&table, fake_block, storage::layout_version_t(0));
+  fake_block->insert_head_ = layout.NumSlots();
+
+  MockBlockCompactor mock_compactor;
+  storage::AccessObserver tested(&mock_compactor);
+  // 1024 writes take 10 half-lives to cool down
+  for (uint32_t i = 0; i < 1024; i++) tested.ObserveWrite(fake_block);
+  EXPECT_CALL(mock_compactor, PutInQueue(::testing::_)).Times(0);
+  for (uint32_t i = 0; i <= COLD_DATA_EPOCH_THRESHOLD; i++) tested.ObserveGCInvocation();
+  ::testing::Mock::VerifyAndClearExpectations(&mock_compactor);
+
+  // NOLINTNEXTLINE
+  EXPECT_CALL(mock_compactor, PutInQueue(fake_block)).Times(1);
+  for (uint32_t i = 0; i < 10 * storage::AccessObserver::HEAT_HALF_LIFE; i++) tested.ObserveGCInvocation();
+  delete fake_block;
+}
+
+// Tests that the cold threshold can be tuned per table, and that it backs off for a table whose blocks are written to
+// again after being sent to the compactor
+// NOLINTNEXTLINE
+TEST(AccessObserverTest, PerTableThreshold) {
+  std::default_random_engine generator;
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator);
+  storage::TupleAccessStrategy accessor(layout);
+  storage::DataTable table(nullptr, layout, storage::layout_version_t(0));
+  auto *fake_block = new storage::RawBlock;
+  accessor.InitializeRawBlock(&table, fake_block, storage::layout_version_t(0));
+  fake_block->insert_head_ = layout.NumSlots();
+
+  MockBlockCompactor mock_compactor;
+  storage::AccessObserver tested(&mock_compactor);
+  const uint32_t threshold = 2;
+  tested.SetTableColdThreshold(&table, threshold);
+  EXPECT_EQ(threshold, tested.TableColdThreshold(&table));
+
+  // NOLINTNEXTLINE
+  EXPECT_CALL(mock_compactor, PutInQueue(fake_block)).Times(1);
+  tested.ObserveWrite(fake_block);
+  for (uint32_t i = 0; i <= threshold; i++) tested.ObserveGCInvocation();
+  ::testing::Mock::VerifyAndClearExpectations(&mock_compactor);
+
+  // The block is still hot when it is written to again, so the freeze would have been wasted. The table now needs to
+  // stay idle for twice as long.
+  tested.ObserveWrite(fake_block);
+  EXPECT_EQ(2 * threshold, tested.TableColdThreshold(&table));
+  EXPECT_CALL(mock_compactor, PutInQueue(::testing::_)).Times(0);
+  for (uint32_t i = 0; i <= threshold; i++) tested.ObserveGCInvocation();
+  ::testing::Mock::VerifyAndClearExpectations(&mock_compactor);
+  // NOLINTNEXTLINE
+  EXPECT_CALL(mock_compactor, PutInQueue(fake_block)).Times(1);
+  for (uint32_t i = 0; i < threshold; i++) tested.ObserveGCInvocation();
+  ::testing::Mock::VerifyAndClearExpectations(&mock_compactor);
+
+  // Writes the compactor makes leave the block cooling, and are not counted against the table
+  fake_block->controller_.GetBlockState()->store(storage::BlockState::COOLING);
+  tested.ObserveWrite(fake_block);
+  EXPECT_EQ(2 * threshold, tested.TableColdThreshold(&table));
+
+  // The back-off wears off after the table has gone long enough without thrashing
+  // NOLINTNEXTLINE
+  EXPECT_CALL(mock_compactor, PutInQueue(fake_block)).Times(1);
+  for (uint32_t i = 0; i <= 4 * 2 * threshold; i++) tested.ObserveGCInvocation();
+  EXPECT_EQ(threshold, tested.TableColdThreshold(&table));
+  delete fake_block;
+}
 }  // namespace terrier
 
 int main(int argc, char **argv) {
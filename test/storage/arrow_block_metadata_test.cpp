@@ -0,0 +1,189 @@
+#include "storage/arrow_block_metadata.h"
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "test_util/test_harness.h"
+
+namespace terrier {
+
+class ArrowEncodedColumnTests : public TerrierTest {
+ public:
+  std::default_random_engine generator_;
+
+  // Encodes the column, checks that the encoded copy is what we expect and decodes back all the non-null values, both
+  // at once and in random ranges
+  template <class T>
+  void CheckRoundTrip(const std::vector<T> &values, const common::RawConcurrentBitmap *nulls,
+                      storage::ArrowColumnEncoding expected_encoding) {
+    const auto num_values = static_cast<uint32_t>(values.size());
+    storage::ArrowEncodedColumn *encoded = storage::ArrowEncodedColumn::Encode(
+        sizeof(T), reinterpret_cast<const byte *>(values.data()), nulls, num_values);
+    ASSERT_NE(nullptr, encoded);
+    EXPECT_EQ(expected_encoding, encoded->Encoding());
+    EXPECT_EQ(sizeof(T), encoded->AttrSize());
+    EXPECT_EQ(num_values, encoded->NumValues());
+    EXPECT_LT(encoded->DataLength(), num_values * sizeof(T));
+
+    std::vector<T> decoded(num_values);
+    encoded->Decode(0, num_values, reinterpret_cast<byte *>(decoded.data()));
+    for (uint32_t i = 0; i < num_values; i++) {
+      if (nulls->Test(i)) {
+        EXPECT_EQ(values[i], decoded[i]);
+      }
+    }
+
+    // Scans resume in the middle of a block, and Select decodes a single value
+    std::uniform_int_distribution<uint32_t> position(0, num_values);
+    for (uint32_t range = 0; range < 20; range++) {
+      uint32_t start = position(generator_), end = position(generator_);
+      if (start > end) std::swap(start, end);
+      if (range == 0) end = start + (start < num_values ? 1 : 0);
+      std::vector<T> decoded_range(end - start);
+      encoded->Decode(start, end - start, reinterpret_cast<byte *>(decoded_range.data()));
+      for (uint32_t i = start; i < end; i++) {
+        if (nulls->Test(i)) {
+          EXPECT_EQ(values[i], decoded_range[i - start]);
+        }
+      }
+    }
+    delete encoded;
+  }
+
+  // Makes sure the first two non-null values of the column are the given minimum and maximum
+  template <class T>
+  void SetRange(std::vector<T> *values, const common::RawConcurrentBitmap *nulls, const T min, const T max) {
+    uint32_t i = 0;
+    while (!nulls->Test(i)) i++;
+    (*values)[i++] = min;
+    while (!nulls->Test(i)) i++;
+    (*values)[i] = max;
+  }
+
+  // Marks every value non-null, except for roughly null_ratio of them
+  common::RawConcurrentBitmap *RandomNulls(const uint32_t num_values, const double null_ratio) {
+    common::RawConcurrentBitmap *nulls = common::RawConcurrentBitmap::Allocate(num_values);
+    std::bernoulli_distribution is_null(null_ratio);
+    for (uint32_t i = 0; i < num_values; i++)
+      if (!is_null(generator_)) nulls->Flip(i, false);
+    return nulls;
+  }
+};
+
+// Tests that a column of long runs of repeated values is run-length encoded
+// NOLINTNEXTLINE
+TEST_F(ArrowEncodedColumnTests, RunLengthTest) {
+  const uint32_t num_values = 1000;
+  common::RawConcurrentBitmap *nulls = RandomNulls(num_values, 0.1);
+  std::uniform_int_distribution<int64_t> run_value(INT64_MIN, INT64_MAX);
+  std::vector<int64_t> values(num_values);
+  for (uint32_t i = 0; i < num_values; i += 100) {
+    const int64_t value = run_value(generator_);
+    for (uint32_t j = i; j < i + 100; j++) values[j] = value;
+  }
+  // Garbage in null slots should not break up a run
+  for (uint32_t i = 0; i < num_values; i++)
+    if (!nulls->Test(i)) values[i] = run_value(generator_);
+  CheckRoundTrip(values, nulls, storage::ArrowColumnEncoding::RUN_LENGTH);
+  common::RawConcurrentBitmap::Deallocate(nulls);
+}
+
+// Tests that a column of large values within a narrow range is frame-of-reference encoded, including a column
+// that holds only one distinct value
+// NOLINTNEXTLINE
+TEST_F(ArrowEncodedColumnTests, FrameOfReferenceTest) {
+  const uint32_t num_values = 1000;
+  common::RawConcurrentBitmap *nulls = RandomNulls(num_values, 0.1);
+  std::uniform_int_distribution<int32_t> offset(-1000, 1000);
+  std::vector<int32_t> values(num_values);
+  for (auto &value : values) value = -1000000 + offset(generator_);
+  CheckRoundTrip(values, nulls, storage::ArrowColumnEncoding::FRAME_OF_REFERENCE);
+
+  for (auto &value : values) value = -42;
+  CheckRoundTrip(values, nulls, storage::ArrowColumnEncoding::FRAME_OF_REFERENCE);
+  common::RawConcurrentBitmap::Deallocate(nulls);
+}
+
+// Tests that a column of small non-negative values is bit-packed, for every width a value can be packed into
+// NOLINTNEXTLINE
+TEST_F(ArrowEncodedColumnTests, BitPackedTest) {
+  const uint32_t num_values = 999;
+  common::RawConcurrentBitmap *nulls = RandomNulls(num_values, 0.1);
+  std::vector<int64_t> values(num_values);
+  for (uint8_t bit_width = 1; bit_width < 64; bit_width++) {
+    const auto max = static_cast<int64_t>((1ULL << bit_width) - 1);
+    std::uniform_int_distribution<int64_t> value(0, max);
+    for (auto &v : values) v = value(generator_);
+    SetRange<int64_t>(&values, nulls, 0, max);
+    CheckRoundTrip(values, nulls, storage::ArrowColumnEncoding::BIT_PACKED);
+  }
+
+  std::vector<int8_t> small_values(num_values);
+  std::uniform_int_distribution<int16_t> small_value(0, 7);
+  for (auto &v : small_values) v = static_cast<int8_t>(small_value(generator_));
+  SetRange<int8_t>(&small_values, nulls, 0, 7);
+  CheckRoundTrip(small_values, nulls, storage::ArrowColumnEncoding::BIT_PACKED);
+  common::RawConcurrentBitmap::Deallocate(nulls);
+}
+
+// Tests that columns that do not compress are left alone, and that columns that are entirely null take up no space
+// NOLINTNEXTLINE
+TEST_F(ArrowEncodedColumnTests, UncompressibleTest) {
+  const uint32_t num_values = 1000;
+  common::RawConcurrentBitmap *nulls = RandomNulls(num_values, 0.1);
+  std::uniform_int_distribution<int16_t> value(INT16_MIN, INT16_MAX);
+  std::vector<int16_t> values(num_values);
+  for (auto &v : values) v = value(generator_);
+  // The extreme values spread the range over every bit
+  SetRange<int16_t>(&values, nulls, INT16_MIN, INT16_MAX);
+  EXPECT_EQ(nullptr, storage::ArrowEncodedColumn::Encode(sizeof(int16_t), reinterpret_cast<const byte *>(values.data()),
+                                                         nulls, num_values));
+  common::RawConcurrentBitmap::Deallocate(nulls);
+
+  // Nothing to store for a column of nulls
+  nulls = RandomNulls(num_values, 1.0);
+  CheckRoundTrip(values, nulls, storage::ArrowColumnEncoding::BIT_PACKED);
+  common::RawConcurrentBitmap::Deallocate(nulls);
+}
+
+// Tests that a column that hands out its memory once it has an encoded copy reads back zeros until it is thawed, and
+// that thawing puts the values back and takes the encoded copy away
+// NOLINTNEXTLINE
+TEST_F(ArrowEncodedColumnTests, ReleaseAndThawTest) {
+  const auto page_size = static_cast<uint32_t>(sysconf(_SC_PAGESIZE));
+  const uint32_t num_values = 4 * page_size / sizeof(int64_t);
+  common::RawConcurrentBitmap *nulls = RandomNulls(num_values, 0.0);
+  byte *column = common::AllocationUtil::AllocateAligned(num_values * sizeof(int64_t));
+  auto *values = reinterpret_cast<int64_t *>(column);
+  for (uint32_t i = 0; i < num_values; i++) values[i] = 1000 + i % 16;
+
+  storage::ArrowColumnInfo col_info;
+  col_info.Type() = storage::ArrowColumnType::FIXED_LENGTH;
+  EXPECT_EQ(nullptr, col_info.EncodedColumn());
+  EXPECT_EQ(nullptr, col_info.Thaw(column));
+  storage::ArrowEncodedColumn *encoded =
+      storage::ArrowEncodedColumn::Encode(sizeof(int64_t), column, nulls, num_values);
+  ASSERT_NE(nullptr, encoded);
+  col_info.SetEncodedColumn(encoded);
+  EXPECT_EQ(encoded, col_info.EncodedColumn());
+
+  // A copy the column no longer has does not release anything
+  col_info.ReleasePlainColumn(nullptr, column, num_values * sizeof(int64_t));
+  for (uint32_t i = 0; i < num_values; i++) EXPECT_EQ(static_cast<int64_t>(1000 + i % 16), values[i]);
+
+  // The whole pages inside the column are given back to the OS, and come back zeroed
+  col_info.ReleasePlainColumn(encoded, column, num_values * sizeof(int64_t));
+  EXPECT_EQ(encoded, col_info.EncodedColumn());
+  EXPECT_EQ(0, values[num_values - page_size / sizeof(int64_t) - 1]);
+
+  EXPECT_EQ(encoded, col_info.Thaw(column));
+  EXPECT_EQ(nullptr, col_info.EncodedColumn());
+  for (uint32_t i = 0; i < num_values; i++) EXPECT_EQ(static_cast<int64_t>(1000 + i % 16), values[i]);
+  delete encoded;
+
+  delete[] column;
+  common::RawConcurrentBitmap::Deallocate(nulls);
+}
+
+}  // namespace terrier
@@ -0,0 +1,245 @@
+#include "storage/arrow_ipc_writer.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "storage/block_compactor.h"
+#include "storage/garbage_collector.h"
+#include "storage/tuple_access_strategy.h"
+#include "test_util/storage_test_util.h"
+#include "test_util/test_harness.h"
+#include "transaction/deferred_action_manager.h"
+
+namespace terrier {
+
+// Just enough of a flatbuffer reader to find our way around the metadata of the file
+class FlatTable {
+ public:
+  explicit FlatTable(const uint8_t *table) : table_(table) {}
+
+  static FlatTable Root(const uint8_t *buffer) { return FlatTable(buffer + Read<uint32_t>(buffer)); }
+
+  template <class T>
+  T Scalar(const uint16_t slot) const {
+    const uint8_t *field = Field(slot);
+    return field == nullptr ? 0 : Read<T>(field);
+  }
+
+  FlatTable Table(const uint16_t slot) const {
+    const uint8_t *field = Field(slot);
+    return FlatTable(field + Read<uint32_t>(field));
+  }
+
+  // Returns the start of a vector of structs, and writes out the number of elements
+  const uint8_t *Vector(const uint16_t slot, uint32_t *const size) const {
+    const uint8_t *field = Field(slot);
+    const uint8_t *vector = field + Read<uint32_t>(field);
+    *size = Read<uint32_t>(vector);
+    return vector + sizeof(uint32_t);
+  }
+
+  template <class T>
+  static T Read(const uint8_t *const location) {
+    T result;
+    std::memcpy(&result, location, sizeof(T));
+    return result;
+  }
+
+ private:
+  const uint8_t *Field(const uint16_t slot) const {
+    const uint8_t *vtable = table_ - Read<int32_t>(table_);
+    const auto vtable_size = Read<uint16_t>(vtable);
+    if (sizeof(uint16_t) * (slot + 2) >= vtable_size) return nullptr;
+    const auto offset = Read<uint16_t>(vtable + sizeof(uint16_t) * (slot + 2));
+    return offset == 0 ? nullptr : table_ + offset;
+  }
+
+  const uint8_t *table_;
+};
+
+struct ArrowIpcWriterTests : public TerrierTest {
+  void SetUp() override {
+    TerrierTest::SetUp();
+    // Columns are numbered by size, largest first
+    layout_ = new storage::BlockLayout({8, VARLEN_COLUMN, 8, 8, 4, 1});
+    table_ = new storage::DataTable(&block_store_, *layout_, storage::layout_version_t(0));
+    fields_ = {{"id", type::TypeId::INTEGER, false, storage::col_id_t(4)},
+               {"amount", type::TypeId::BIGINT, true, storage::col_id_t(2)},
+               {"name", type::TypeId::VARCHAR, true, storage::col_id_t(1)},
+               {"flag", type::TypeId::BOOLEAN, false, storage::col_id_t(5)},
+               {"price", type::TypeId::DECIMAL, false, storage::col_id_t(3)}};
+  }
+
+  void TearDown() override {
+    delete table_;
+    delete layout_;
+    std::remove(FILE_NAME);
+    TerrierTest::TearDown();
+  }
+
+  static std::string Name(const uint32_t i) {
+    // Mix names that are inlined with ones that are not
+    return i % 2 == 0 ? "row " + std::to_string(i) : "a name too long to inline, for row " + std::to_string(i);
+  }
+
+  // Fills the table with the given number of rows. Every fifth amount and every seventh name is null.
+  void Populate(transaction::TransactionManager *const txn_manager, const uint32_t num_rows) {
+    std::vector<storage::col_id_t> col_ids;
+    for (const auto &field : fields_) col_ids.push_back(field.col_id_);
+    const auto initializer = storage::ProjectedRowInitializer::Create(*layout_, col_ids);
+    byte *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+    storage::ProjectedRow *row = initializer.InitializeRow(buffer);
+    // Projected rows order their columns by size, which is the order of the column ids
+    const uint16_t name = 0, amount = 1, price = 2, id = 3, flag = 4;
+
+    transaction::TransactionContext *txn = txn_manager->BeginTransaction();
+    for (uint32_t i = 0; i < num_rows; i++) {
+      *reinterpret_cast<int32_t *>(row->AccessForceNotNull(id)) = static_cast<int32_t>(i);
+      if (i % 5 == 0)
+        row->SetNull(amount);
+      else
+        *reinterpret_cast<int64_t *>(row->AccessForceNotNull(amount)) = i * 1000000007LL;
+      if (i % 7 == 0) {
+        row->SetNull(name);
+      } else {
+        const std::string value = Name(i);
+        const auto size = static_cast<uint32_t>(value.size());
+        if (size <= storage::VarlenEntry::InlineThreshold()) {
+          *reinterpret_cast<storage::VarlenEntry *>(row->AccessForceNotNull(name)) =
+              storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>(value.data()), size);
+        } else {
+          byte *content = common::AllocationUtil::AllocateAligned(size);
+          std::memcpy(content, value.data(), size);
+          *reinterpret_cast<storage::VarlenEntry *>(row->AccessForceNotNull(name)) =
+              storage::VarlenEntry::Create(content, size, true);
+        }
+      }
+      *reinterpret_cast<uint8_t *>(row->AccessForceNotNull(flag)) = static_cast<uint8_t>(i % 3 == 0);
+      *reinterpret_cast<double *>(row->AccessForceNotNull(price)) = i * 0.5;
+      table_->Insert(txn, *row);
+    }
+    txn_manager->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    delete[] buffer;
+  }
+
+  // Parses the file written out and checks that it holds the rows put in by Populate
+  void CheckFile(const uint32_t num_rows) {
+    std::ifstream in(FILE_NAME, std::ios::binary);
+    const std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ASSERT_GT(file.size(), 20);
+    EXPECT_EQ(0, std::memcmp(file.data(), "ARROW1", 6));
+    EXPECT_EQ(0, std::memcmp(file.data() + file.size() - 6, "ARROW1", 6));
+
+    const auto footer_length = FlatTable::Read<int32_t>(file.data() + file.size() - 10);
+    const FlatTable footer = FlatTable::Root(file.data() + file.size() - 10 - footer_length);
+    uint32_t num_fields;
+    footer.Table(1).Vector(1, &num_fields);
+    EXPECT_EQ(fields_.size(), num_fields);
+    uint32_t num_batches;
+    const uint8_t *batches = footer.Vector(3, &num_batches);
+    ASSERT_EQ(1, num_batches);
+
+    // Block structs are made up of the offset of the message, the length of its metadata and the length of its body
+    const auto offset = FlatTable::Read<int64_t>(batches);
+    const auto metadata_length = FlatTable::Read<int32_t>(batches + 8);
+    EXPECT_EQ(0, offset % 8);
+    EXPECT_EQ(UINT32_MAX, FlatTable::Read<uint32_t>(file.data() + offset));
+    const FlatTable message = FlatTable::Root(file.data() + offset + 8);
+    EXPECT_EQ(3, message.Scalar<uint8_t>(1));  // record batch
+    const FlatTable record_batch = message.Table(2);
+    EXPECT_EQ(num_rows, record_batch.Scalar<int64_t>(0));
+    const uint8_t *body = file.data() + offset + metadata_length;
+
+    // Each field node is a length followed by a null count, and each buffer an offset followed by a length
+    uint32_t num_nodes, num_buffers;
+    const uint8_t *nodes = record_batch.Vector(1, &num_nodes);
+    const uint8_t *buffers = record_batch.Vector(2, &num_buffers);
+    ASSERT_EQ(fields_.size(), num_nodes);
+    ASSERT_EQ(11, num_buffers);
+    auto buffer = [&](uint32_t i) { return body + FlatTable::Read<int64_t>(buffers + 16 * i); };
+    auto valid = [&](uint32_t buffer_idx, uint32_t row) { return (buffer(buffer_idx)[row / 8] >> (row % 8) & 1) != 0; };
+    EXPECT_EQ(0, FlatTable::Read<int64_t>(nodes + 8));
+    EXPECT_EQ((num_rows + 4) / 5, FlatTable::Read<int64_t>(nodes + 24));
+    EXPECT_EQ((num_rows + 6) / 7, FlatTable::Read<int64_t>(nodes + 40));
+
+    // Compaction does not move tuples around in a block without gaps, so the rows are in order
+    for (uint32_t i = 0; i < num_rows; i++) {
+      EXPECT_EQ(i, FlatTable::Read<int32_t>(buffer(1) + 4 * i));
+      EXPECT_EQ(i % 5 != 0, valid(2, i));
+      if (i % 5 != 0) EXPECT_EQ(i * 1000000007LL, FlatTable::Read<int64_t>(buffer(3) + 8 * i));
+      EXPECT_EQ(i % 7 != 0, valid(4, i));
+      const auto begin = FlatTable::Read<uint32_t>(buffer(5) + 4 * i);
+      const auto end = FlatTable::Read<uint32_t>(buffer(5) + 4 * (i + 1));
+      const std::string name(reinterpret_cast<const char *>(buffer(6)) + begin, end - begin);
+      EXPECT_EQ(i % 7 == 0 ? "" : Name(i), name);
+      EXPECT_EQ(i % 3 == 0, valid(8, i));
+      EXPECT_EQ(i * 0.5, FlatTable::Read<double>(buffer(10) + 8 * i));
+    }
+  }
+
+  static constexpr const char *FILE_NAME = "arrow_ipc_writer_test.arrow";
+
+  storage::BlockStore block_store_{100, 100};
+  storage::RecordBufferSegmentPool buffer_pool_{100000, 100000};
+  storage::BlockLayout *layout_ = nullptr;
+  storage::DataTable *table_ = nullptr;
+  std::vector<storage::ArrowIpcWriter::Field> fields_;
+};
+
+// Tests that a hot block is materialized into a file that holds the rows of the table, and that a frozen block is
+// written out in place into an equivalent file
+// NOLINTNEXTLINE
+TEST_F(ArrowIpcWriterTests, HotAndFrozenBlock) {
+  // Only full blocks are compacted
+  const uint32_t num_rows = layout_->NumSlots();
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+  Populate(&txn_manager, num_rows);
+  ASSERT_EQ(1, table_->GetNumBlocks());
+
+  storage::ArrowIpcWriter writer(table_, fields_);
+  transaction::TransactionContext *txn = txn_manager.BeginTransaction();
+  writer.WriteFile(txn, FILE_NAME);
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  EXPECT_EQ(0, writer.NumBlocksInPlace());
+  EXPECT_EQ(1, writer.NumBlocksMaterialized());
+  CheckFile(num_rows);
+
+  // Freeze the block
+  storage::RawBlock *block = table_->begin()->GetBlock();
+  storage::TupleAccessStrategy accessor(*layout_);
+  auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+  for (storage::col_id_t col_id : layout_->AllColumns())
+    arrow_metadata.GetColumnInfo(*layout_, col_id).Type() =
+        layout_->IsVarlen(col_id) ? storage::ArrowColumnType::GATHERED_VARLEN : storage::ArrowColumnType::FIXED_LENGTH;
+  storage::BlockCompactor compactor;
+  gc.PerformGarbageCollection();
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);
+  gc.PerformGarbageCollection();
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);
+  ASSERT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+  // None of the fixed-length columns uses up all of its bits, so they are all encoded, and released from the block
+  // once no transaction that may have read them is left. They are written out decoded.
+  EXPECT_EQ(4, arrow_metadata.NumEncodedColumns().load());
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();
+
+  txn = txn_manager.BeginTransaction();
+  writer.WriteFile(txn, FILE_NAME);
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  EXPECT_EQ(1, writer.NumBlocksInPlace());
+  EXPECT_EQ(0, writer.NumBlocksMaterialized());
+  CheckFile(num_rows);
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();
+}
+
+}  // namespace terrier
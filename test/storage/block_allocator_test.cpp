@@ -0,0 +1,59 @@
+#include <cstring>
+#include <unordered_set>
+#include <vector>
+#include "common/worker_pool.h"
+#include "storage/storage_defs.h"
+#include "test_util/multithread_test_util.h"
+#include "test_util/test_harness.h"
+
+namespace terrier {
+
+// Tests that blocks handed out are aligned, distinct and fully writable, and that they can be handed back in any order
+// NOLINTNEXTLINE
+TEST(BlockAllocatorTest, AllocateAndDelete) {
+  const uint32_t num_blocks = 33;
+  storage::BlockAllocator tested;
+  std::vector<storage::RawBlock *> blocks;
+  std::unordered_set<storage::RawBlock *> distinct;
+  for (uint32_t i = 0; i < num_blocks; i++) {
+    storage::RawBlock *block = tested.New();
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(block) % common::Constants::BLOCK_SIZE);
+    EXPECT_TRUE(distinct.insert(block).second);
+    std::memset(reinterpret_cast<void *>(block), static_cast<int>(i), common::Constants::BLOCK_SIZE);
+    blocks.push_back(block);
+  }
+  // Blocks must not overlap, so every block should still hold what was last written to it
+  for (uint32_t i = 0; i < num_blocks; i++) {
+    auto *bytes = reinterpret_cast<uint8_t *>(blocks[i]);
+    EXPECT_EQ(static_cast<uint8_t>(i), bytes[0]);
+    EXPECT_EQ(static_cast<uint8_t>(i), bytes[common::Constants::BLOCK_SIZE - 1]);
+  }
+  // Delete every other block first, so that arenas are unmapped while some of their neighbours are still live
+  for (uint32_t i = 0; i < num_blocks; i += 2) tested.Delete(blocks[i]);
+  for (uint32_t i = 1; i < num_blocks; i += 2) tested.Delete(blocks[i]);
+}
+
+// Tests that concurrent threads going through a block store each get distinct blocks
+// NOLINTNEXTLINE
+TEST(BlockAllocatorTest, ConcurrentBlockStore) {
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency();
+  const uint32_t blocks_per_thread = 16;
+  common::WorkerPool thread_pool(num_threads, {});
+  storage::BlockStore block_store{num_threads * blocks_per_thread, 0};
+  std::vector<std::vector<storage::RawBlock *>> blocks(num_threads);
+  auto workload = [&](uint32_t id) {
+    for (uint32_t i = 0; i < blocks_per_thread; i++) {
+      storage::RawBlock *block = block_store.Get();
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(block) % common::Constants::BLOCK_SIZE);
+      blocks[id].push_back(block);
+    }
+  };
+  MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+
+  std::unordered_set<storage::RawBlock *> distinct;
+  for (auto &thread_blocks : blocks)
+    for (storage::RawBlock *block : thread_blocks) EXPECT_TRUE(distinct.insert(block).second);
+  for (storage::RawBlock *block : distinct) block_store.Release(block);
+}
+}  // namespace terrier
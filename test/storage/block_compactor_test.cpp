@@ -1,6 +1,10 @@
 #include "storage/block_compactor.h"
+#include <algorithm>
+#include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
+#include "common/dedicated_thread_registry.h"
 #include "common/hash_util.h"
 #include "storage/block_access_controller.h"
 #include "storage/garbage_collector.h"
@@ -244,10 +248,9 @@ TEST_F(BlockCompactorTest, GatherTest) {
 
     gc.PerformGarbageCollection();
     gc.PerformGarbageCollection();  // Second call to deallocate.
-    // Deallocate all the leftover gathered varlens
+    // Deallocate all the leftover gathered varlens and encoded columns
     // No need to gather the ones still in the block because they are presumably all gathered
-    for (storage::col_id_t col_id : layout.AllColumns())
-      if (layout.IsVarlen(col_id)) arrow_metadata.GetColumnInfo(layout, col_id).Deallocate();
+    for (storage::col_id_t col_id : layout.AllColumns()) arrow_metadata.GetColumnInfo(layout, col_id).Deallocate();
     block_store_.Release(block);
   }
 }
@@ -363,12 +366,527 @@ TEST_F(BlockCompactorTest, DictionaryCompressionTest) {
 
     gc.PerformGarbageCollection();
     gc.PerformGarbageCollection();  // Second call to deallocate.
-    // Deallocate all the leftover gathered varlens
+    // Deallocate all the leftover gathered varlens and encoded columns
     // No need to gather the ones still in the block because they are presumably all gathered
-    for (storage::col_id_t col_id : layout.AllColumns())
-      if (layout.IsVarlen(col_id)) arrow_metadata.GetColumnInfo(layout, col_id).Deallocate();
+    for (storage::col_id_t col_id : layout.AllColumns()) arrow_metadata.GetColumnInfo(layout, col_id).Deallocate();
     block_store_.Release(block);
   }
 }
 
+// This tests generates random single blocks inside a table and freezes them. It then sequentially scans the table in
+// small batches, both by copying and in place, so that the scan resumes in the middle of the frozen block, and verifies
+// that every tuple is materialized exactly once and is identical to what a tuple-at-a-time Select returns.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, FrozenScanTest) {
+  uint32_t repeat = 10;
+  for (uint32_t iteration = 0; iteration < repeat; iteration++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutWithVarlens(100, &generator_);
+    storage::TupleAccessStrategy accessor(layout);
+    // Use the table's own first block this time, because we need the sequential scan to reach it
+    storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+    storage::RawBlock *block = table.begin()->GetBlock();
+
+    // Enable GC to cleanup transactions started by the block compactor
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+    auto tuples = StorageTestUtil::PopulateBlockRandomly(&table, block, percent_empty_, &generator_);
+    auto num_tuples = tuples.size();
+
+    // Manually populate the block header's arrow metadata for test initialization
+    auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+    for (storage::col_id_t col_id : layout.AllColumns()) {
+      if (layout.IsVarlen(col_id)) {
+        arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::GATHERED_VARLEN;
+      } else {
+        arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+      }
+    }
+
+    storage::BlockCompactor compactor;
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // compaction pass
+
+    // Need to prune the version chain in order to make sure that the second pass succeeds
+    gc.PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // gathering pass
+    EXPECT_EQ(block->controller_.GetBlockState()->load(), storage::BlockState::FROZEN);
+
+    std::vector<storage::col_id_t> all_cols = StorageTestUtil::ProjectionListAllColumns(layout);
+    // Deliberately not a multiple of 8, so that batches after the first one start at unaligned offsets in the block
+    const uint32_t batch_size = 100;
+    storage::ProjectedColumnsInitializer columns_initializer(layout, all_cols, batch_size);
+    byte *columns_buffer = common::AllocationUtil::AllocateAligned(columns_initializer.ProjectedColumnsSize());
+    storage::ProjectedColumns *columns = columns_initializer.Initialize(columns_buffer);
+    auto row_initializer = storage::ProjectedRowInitializer::Create(layout, all_cols);
+    byte *row_buffer = common::AllocationUtil::AllocateAligned(row_initializer.ProjectedRowSize());
+    auto *read_row = row_initializer.InitializeRow(row_buffer);
+
+    // This transaction is guaranteed to start after the compacting one commits
+    transaction::TransactionContext *txn = txn_manager.BeginTransaction();
+    uint32_t num_scanned = 0;
+    auto it = table.begin();
+    while (it != table.end()) {
+      table.Scan(txn, &it, columns);
+      for (uint32_t i = 0; i < columns->NumTuples(); i++) {
+        const storage::TupleSlot slot = columns->TupleSlots()[i];
+        EXPECT_EQ(slot, storage::TupleSlot(block, num_scanned + i));  // Frozen tuples are contiguous
+        EXPECT_TRUE(table.Select(txn, slot, read_row));
+        storage::ProjectedColumns::RowView stored = columns->InterpretAsRow(i);
+        EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(layout, &stored, read_row));
+      }
+      num_scanned += columns->NumTuples();
+    }
+    EXPECT_EQ(num_scanned, num_tuples);
+
+    // Now read the block in place, which hands out pointers into the block instead of copying tuples out
+    const uint16_t num_cols = read_row->NumColumns();
+    std::vector<byte *> in_place_columns(num_cols);
+    std::vector<const common::RawBitmap *> in_place_nulls(num_cols);
+    const uint32_t in_place_batch_size = 128;
+    // Columns the compactor encoded are decoded into here rather than pointed at
+    storage::ProjectedColumnsInitializer decoded_initializer(layout, all_cols, in_place_batch_size);
+    byte *decoded_buffer = common::AllocationUtil::AllocateAligned(decoded_initializer.ProjectedColumnsSize());
+    storage::ProjectedColumns *decoded = decoded_initializer.Initialize(decoded_buffer);
+    num_scanned = 0;
+    it = table.begin();
+    while (it != table.end()) {
+      uint32_t batch_tuples = 0;
+      storage::RawBlock *in_place_block =
+          table.ScanInPlace(&it, table.end(), read_row->ColumnIds(), num_cols, in_place_batch_size,
+                            in_place_columns.data(), in_place_nulls.data(), &batch_tuples, nullptr, nullptr, decoded);
+      ASSERT_EQ(in_place_block, block);
+      for (uint32_t i = 0; i < batch_tuples; i++) {
+        EXPECT_TRUE(table.Select(txn, storage::TupleSlot(block, num_scanned + i), read_row));
+        for (uint16_t col = 0; col < num_cols; col++) {
+          const byte *expected = read_row->AccessWithNullCheck(col);
+          EXPECT_EQ(expected == nullptr, !in_place_nulls[col]->Test(i));
+          if (expected == nullptr) continue;
+          const uint8_t attr_size = layout.AttrSize(read_row->ColumnIds()[col]);
+          EXPECT_EQ(std::memcmp(expected, in_place_columns[col] + attr_size * i, attr_size), 0);
+        }
+      }
+      in_place_block->controller_.ReleaseInPlaceRead();
+      num_scanned += batch_tuples;
+    }
+    EXPECT_EQ(num_scanned, num_tuples);
+
+    txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);  // Commit: will be cleaned up by GC
+    delete[] columns_buffer;
+    delete[] decoded_buffer;
+    delete[] row_buffer;
+
+    for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();  // Second call to deallocate.
+    // The table owns the block and releases it, along with its gathered varlens, when destructed
+  }
+}
+
+// This tests generates random single blocks and freezes them. It then verifies that the null counts and zone maps
+// computed by the compactor match the values originally inserted.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, ZoneMapTest) {
+  uint32_t repeat = 10;
+  for (uint32_t iteration = 0; iteration < repeat; iteration++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutWithVarlens(100, &generator_);
+    storage::TupleAccessStrategy accessor(layout);
+    // Technically, the block above is not "in" the table, but since we don't sequential scan that does not matter
+    storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+    storage::RawBlock *block = block_store_.Get();
+    accessor.InitializeRawBlock(&table, block, storage::layout_version_t(0));
+
+    // Enable GC to cleanup transactions started by the block compactor
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+    auto tuples = StorageTestUtil::PopulateBlockRandomly(&table, block, percent_empty_, &generator_);
+
+    // Compute the expected null counts and ranges from the inserted values
+    std::unordered_map<storage::col_id_t, uint32_t> null_counts;
+    std::unordered_map<storage::col_id_t, std::pair<int64_t, int64_t>> ranges;
+    for (auto &entry : tuples) {
+      storage::ProjectedRow *row = entry.second;
+      for (uint16_t i = 0; i < row->NumColumns(); i++) {
+        storage::col_id_t col_id = row->ColumnIds()[i];
+        if (layout.IsVarlen(col_id)) continue;
+        const byte *value = row->AccessWithNullCheck(i);
+        if (value == nullptr) {
+          null_counts[col_id]++;
+          continue;
+        }
+        int64_t int_value;
+        switch (layout.AttrSize(col_id)) {
+          case sizeof(int8_t):
+            int_value = *reinterpret_cast<const int8_t *>(value);
+            break;
+          case sizeof(int16_t):
+            int_value = *reinterpret_cast<const int16_t *>(value);
+            break;
+          case sizeof(int32_t):
+            int_value = *reinterpret_cast<const int32_t *>(value);
+            break;
+          default:
+            int_value = *reinterpret_cast<const int64_t *>(value);
+        }
+        auto it = ranges.find(col_id);
+        if (it == ranges.end()) {
+          ranges[col_id] = {int_value, int_value};
+        } else {
+          it->second.first = std::min(it->second.first, int_value);
+          it->second.second = std::max(it->second.second, int_value);
+        }
+      }
+    }
+
+    // Manually populate the block header's arrow metadata for test initialization
+    auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+    for (storage::col_id_t col_id : layout.AllColumns()) {
+      if (layout.IsVarlen(col_id)) {
+        arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::GATHERED_VARLEN;
+      } else {
+        arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+      }
+    }
+
+    storage::BlockCompactor compactor;
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // compaction pass
+
+    // Need to prune the version chain in order to make sure that the second pass succeeds
+    gc.PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // gathering pass
+    EXPECT_EQ(block->controller_.GetBlockState()->load(), storage::BlockState::FROZEN);
+    EXPECT_EQ(arrow_metadata.NumRecords(), tuples.size());
+
+    for (storage::col_id_t col_id : layout.AllColumns()) {
+      if (col_id == VERSION_POINTER_COLUMN_ID || layout.IsVarlen(col_id)) continue;
+      EXPECT_EQ(arrow_metadata.NullCount(col_id), null_counts[col_id]);
+      auto it = ranges.find(col_id);
+      // The range is undefined if every value in the column is null
+      if (it == ranges.end()) continue;
+      const storage::ColumnZoneMap &zone_map = arrow_metadata.GetZoneMap(layout, col_id);
+      EXPECT_EQ(zone_map.Min(), it->second.first);
+      EXPECT_EQ(zone_map.Max(), it->second.second);
+    }
+
+    for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();  // Second call to deallocate.
+    // Deallocate all the leftover gathered varlens and encoded columns
+    // No need to gather the ones still in the block because they are presumably all gathered
+    for (storage::col_id_t col_id : layout.AllColumns()) arrow_metadata.GetColumnInfo(layout, col_id).Deallocate();
+    block_store_.Release(block);
+  }
+}
+
+
+// This test freezes a block of columns that each suit a different encoding, and checks that the columns are encoded
+// and released, that Select, Scan and the in-place scan all read the values back from the encoded copies, and that
+// writing to the block puts the values back in place before the block is frozen again
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, EncodedColumnTest) {
+  // Columns 1 to 5 are run-length, frame-of-reference and bit-packed friendly, random, and small with nulls
+  storage::BlockLayout layout({8, 8, 8, 8, 4, 2});
+  storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+  storage::RawBlock *block = table.begin()->GetBlock();
+  storage::TupleAccessStrategy accessor(layout);
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+  const uint32_t num_tuples = layout.NumSlots();
+  std::vector<int32_t> random_values(num_tuples);
+  std::uniform_int_distribution<int32_t> random_value(INT32_MIN, INT32_MAX);
+  for (auto &value : random_values) value = random_value(generator_);
+  // Every third value of the last column is null, which comes back as a nullptr
+  auto expected = [&](const uint16_t col, const uint32_t i) -> int64_t {
+    switch (col) {
+      case 0:
+        return (i / 100) * 1000003LL;
+      case 1:
+        return 5000000000LL + i % 1000;
+      case 2:
+        return i;
+      case 3:
+        return random_values[i];
+      default:
+        return i % 7;
+    }
+  };
+  auto check_row = [&](const uint32_t i, const storage::ProjectedRow &row) {
+    EXPECT_EQ(expected(0, i), *reinterpret_cast<const int64_t *>(row.AccessWithNullCheck(0)));
+    EXPECT_EQ(expected(1, i), *reinterpret_cast<const int64_t *>(row.AccessWithNullCheck(1)));
+    EXPECT_EQ(expected(2, i), *reinterpret_cast<const int64_t *>(row.AccessWithNullCheck(2)));
+    EXPECT_EQ(expected(3, i), *reinterpret_cast<const int32_t *>(row.AccessWithNullCheck(3)));
+    const byte *small = row.AccessWithNullCheck(4);
+    EXPECT_EQ(i % 3 == 0, small == nullptr);
+    if (small != nullptr) EXPECT_EQ(expected(4, i), *reinterpret_cast<const int16_t *>(small));
+  };
+
+  std::vector<storage::col_id_t> all_cols = StorageTestUtil::ProjectionListAllColumns(layout);
+  auto row_initializer = storage::ProjectedRowInitializer::Create(layout, all_cols);
+  byte *row_buffer = common::AllocationUtil::AllocateAligned(row_initializer.ProjectedRowSize());
+  storage::ProjectedRow *row = row_initializer.InitializeRow(row_buffer);
+  transaction::TransactionContext *txn = txn_manager.BeginTransaction();
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    for (uint16_t col = 0; col < 3; col++)
+      *reinterpret_cast<int64_t *>(row->AccessForceNotNull(col)) = expected(col, i);
+    *reinterpret_cast<int32_t *>(row->AccessForceNotNull(3)) = random_values[i];
+    if (i % 3 == 0)
+      row->SetNull(4);
+    else
+      *reinterpret_cast<int16_t *>(row->AccessForceNotNull(4)) = static_cast<int16_t>(expected(4, i));
+    table.Insert(txn, *row);
+  }
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  ASSERT_EQ(1, table.GetNumBlocks());
+
+  storage::BlockCompactor compactor;
+  auto freeze = [&] {
+    gc.PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // compaction pass
+    gc.PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // gathering pass
+    ASSERT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+    // Once no transaction that may have read the block before it was encoded is left, the columns are released
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();
+  };
+  freeze();
+
+  auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+  EXPECT_EQ(4, arrow_metadata.NumEncodedColumns().load());
+  const storage::ArrowEncodedColumn *encoded[5];
+  for (uint16_t col = 0; col < 5; col++) encoded[col] = accessor.EncodedColumn(block, all_cols[col]);
+  ASSERT_NE(nullptr, encoded[0]);
+  EXPECT_EQ(storage::ArrowColumnEncoding::RUN_LENGTH, encoded[0]->Encoding());
+  ASSERT_NE(nullptr, encoded[1]);
+  EXPECT_EQ(storage::ArrowColumnEncoding::FRAME_OF_REFERENCE, encoded[1]->Encoding());
+  ASSERT_NE(nullptr, encoded[2]);
+  EXPECT_EQ(storage::ArrowColumnEncoding::BIT_PACKED, encoded[2]->Encoding());
+  EXPECT_EQ(nullptr, encoded[3]);
+  ASSERT_NE(nullptr, encoded[4]);
+  EXPECT_EQ(storage::ArrowColumnEncoding::BIT_PACKED, encoded[4]->Encoding());
+
+  // Zone maps are computed before the columns are encoded
+  storage::ColumnZoneMap zone_map;
+  uint32_t num_values;
+  ASSERT_TRUE(table.ReadZoneMap(table.begin(), all_cols[2], &zone_map, &num_values));
+  EXPECT_EQ(0, zone_map.Min());
+  EXPECT_EQ(num_tuples - 1, zone_map.Max());
+
+  txn = txn_manager.BeginTransaction();
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    EXPECT_TRUE(table.Select(txn, storage::TupleSlot(block, i), row));
+    check_row(i, *row);
+  }
+
+  // Deliberately not a multiple of 8, so that batches after the first one start in the middle of a run and a word
+  const uint32_t batch_size = 100;
+  storage::ProjectedColumnsInitializer columns_initializer(layout, all_cols, batch_size);
+  byte *columns_buffer = common::AllocationUtil::AllocateAligned(columns_initializer.ProjectedColumnsSize());
+  storage::ProjectedColumns *columns = columns_initializer.Initialize(columns_buffer);
+  uint32_t num_scanned = 0;
+  auto it = table.begin();
+  while (it != table.end()) {
+    table.Scan(txn, &it, columns);
+    for (uint32_t i = 0; i < columns->NumTuples(); i++) {
+      storage::ProjectedColumns::RowView stored = columns->InterpretAsRow(i);
+      for (uint16_t col = 0; col < stored.NumColumns(); col++) {
+        const byte *value = stored.AccessWithNullCheck(col);
+        if (value != nullptr)
+          std::memcpy(row->AccessForceNotNull(col), value, layout.AttrSize(all_cols[col]));
+        else
+          row->SetNull(col);
+      }
+      check_row(num_scanned + i, *row);
+    }
+    num_scanned += columns->NumTuples();
+  }
+  EXPECT_EQ(num_tuples, num_scanned);
+
+  // Without a buffer to decode into, the block cannot be read in place
+  const uint16_t num_cols = row->NumColumns();
+  std::vector<byte *> in_place_columns(num_cols);
+  std::vector<const common::RawBitmap *> in_place_nulls(num_cols);
+  uint32_t batch_tuples = 0;
+  it = table.begin();
+  EXPECT_EQ(nullptr, table.ScanInPlace(&it, table.end(), row->ColumnIds(), num_cols, batch_size,
+                                       in_place_columns.data(), in_place_nulls.data(), &batch_tuples));
+  EXPECT_TRUE(it == table.begin());
+  num_scanned = 0;
+  while (it != table.end()) {
+    storage::RawBlock *in_place_block =
+        table.ScanInPlace(&it, table.end(), row->ColumnIds(), num_cols, 2 * batch_size, in_place_columns.data(),
+                          in_place_nulls.data(), &batch_tuples, nullptr, nullptr, columns);
+    ASSERT_EQ(block, in_place_block);
+    // The decode buffer caps the batch
+    EXPECT_LE(batch_tuples, batch_size);
+    // The one column left as is is pointed at in the block
+    EXPECT_EQ(accessor.ColumnStart(block, all_cols[3]) + sizeof(int32_t) * num_scanned, in_place_columns[3]);
+    for (uint32_t i = 0; i < batch_tuples; i++) {
+      for (uint16_t col = 0; col < num_cols; col++) {
+        const uint8_t attr_size = layout.AttrSize(all_cols[col]);
+        if (in_place_nulls[col]->Test(i))
+          std::memcpy(row->AccessForceNotNull(col), in_place_columns[col] + attr_size * i, attr_size);
+        else
+          row->SetNull(col);
+      }
+      check_row(num_scanned + i, *row);
+    }
+    in_place_block->controller_.ReleaseInPlaceRead();
+    num_scanned += batch_tuples;
+  }
+  EXPECT_EQ(num_tuples, num_scanned);
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Writing to a column puts its values back in the block, and leaves the other columns encoded
+  txn = txn_manager.BeginTransaction();
+  auto update_initializer = storage::ProjectedRowInitializer::Create(layout, {all_cols[2]});
+  byte *update_buffer = common::AllocationUtil::AllocateAligned(update_initializer.ProjectedRowSize());
+  storage::ProjectedRow *update = update_initializer.InitializeRow(update_buffer);
+  *reinterpret_cast<int64_t *>(update->AccessForceNotNull(0)) = expected(2, 5);
+  EXPECT_TRUE(table.Update(txn, storage::TupleSlot(block, 5), *update));
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  delete[] update_buffer;
+  EXPECT_EQ(storage::BlockState::HOT, block->controller_.GetBlockState()->load());
+  EXPECT_EQ(3, arrow_metadata.NumEncodedColumns().load());
+  EXPECT_EQ(nullptr, accessor.EncodedColumn(block, all_cols[2]));
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    const byte *value = accessor.AccessWithNullCheck(storage::TupleSlot(block, i), all_cols[2]);
+    EXPECT_EQ(expected(2, i), *reinterpret_cast<const int64_t *>(value));
+  }
+  txn = txn_manager.BeginTransaction();
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    EXPECT_TRUE(table.Select(txn, storage::TupleSlot(block, i), row));
+    check_row(i, *row);
+  }
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Freezing the block again encodes every column anew
+  freeze();
+  EXPECT_EQ(4, arrow_metadata.NumEncodedColumns().load());
+  txn = txn_manager.BeginTransaction();
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    EXPECT_TRUE(table.Select(txn, storage::TupleSlot(block, i), row));
+    check_row(i, *row);
+  }
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  delete[] columns_buffer;
+  delete[] row_buffer;
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+  // The table owns the block and frees its encoded columns when destructed
+}
+
+// This test hands blocks of several tables to dedicated compactor workers, and checks that every block ends up frozen
+// with its contents unmodified
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, ParallelCompactionTest) {
+  const uint32_t num_tables = 4, blocks_per_table = 4, num_workers = 4;
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+  // The original rows share varlens with the blocks, which the GC frees once they are gathered while we wait for the
+  // workers. Stick to fixed-length columns so that the rows can be checked afterwards.
+  std::vector<storage::BlockLayout> layouts;
+  for (uint32_t i = 0; i < num_tables; i++) layouts.push_back(StorageTestUtil::RandomLayoutNoVarlen(100, &generator_));
+  std::vector<std::unique_ptr<storage::DataTable>> tables;
+  std::vector<storage::RawBlock *> blocks;
+  std::unordered_map<storage::RawBlock *, std::unordered_map<storage::TupleSlot, storage::ProjectedRow *>> tuples;
+  for (uint32_t i = 0; i < num_tables; i++) {
+    const storage::BlockLayout &layout = layouts[i];
+    storage::TupleAccessStrategy accessor(layout);
+    // Technically, the blocks are not "in" the table, but since we don't sequential scan that does not matter
+    tables.emplace_back(new storage::DataTable(&block_store_, layout, storage::layout_version_t(0)));
+    for (uint32_t j = 0; j < blocks_per_table; j++) {
+      storage::RawBlock *block = block_store_.Get();
+      accessor.InitializeRawBlock(tables.back().get(), block, storage::layout_version_t(0));
+      tuples[block] = StorageTestUtil::PopulateBlockRandomly(tables.back().get(), block, percent_empty_, &generator_);
+      auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+      for (storage::col_id_t col_id : layout.AllColumns())
+        arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+      blocks.push_back(block);
+    }
+  }
+
+  common::DedicatedThreadRegistry thread_registry(DISABLED);
+  storage::BlockCompactor compactor{common::ManagedPointer(&thread_registry)};
+  compactor.StartWorkers(num_workers, std::chrono::microseconds(100), &deferred_action_manager, &txn_manager);
+
+  // Wait for every block to reach the given state, running the GC to prune the versions left by compaction
+  auto wait_for = [&](storage::BlockState state) {
+    for (storage::RawBlock *block : blocks) {
+      while (block->controller_.GetBlockState()->load() != state) {
+        gc.PerformGarbageCollection();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  };
+  for (storage::RawBlock *block : blocks) compactor.PutInQueue(block);
+  wait_for(storage::BlockState::COOLING);  // compaction pass
+  for (storage::RawBlock *block : blocks) compactor.PutInQueue(block);
+  wait_for(storage::BlockState::FROZEN);  // gathering pass
+  compactor.StopWorkers();
+
+  for (uint32_t i = 0; i < num_tables; i++) {
+    const storage::BlockLayout &layout = layouts[i];
+    storage::TupleAccessStrategy accessor(layout);
+    auto initializer =
+        storage::ProjectedRowInitializer::Create(layout, StorageTestUtil::ProjectionListAllColumns(layout));
+    byte *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+    auto *read_row = initializer.InitializeRow(buffer);
+    transaction::TransactionContext *txn = txn_manager.BeginTransaction();
+    for (uint32_t j = 0; j < blocks_per_table; j++) {
+      storage::RawBlock *block = blocks[i * blocks_per_table + j];
+      auto tuple_set = GetTupleSet(layout, tuples[block]);
+      EXPECT_EQ(accessor.GetArrowBlockMetadata(block).NumRecords(), tuples[block].size());
+      for (uint32_t offset = 0; offset < tuples[block].size(); offset++) {
+        EXPECT_TRUE(tables[i]->Select(txn, storage::TupleSlot(block, offset), read_row));
+        auto entry = tuple_set.find(read_row);
+        EXPECT_NE(entry, tuple_set.end());  // Should be present in the original
+        if (entry != tuple_set.end()) {
+          EXPECT_GT(entry->second, 0);
+          entry->second--;
+        }
+      }
+      for (auto &entry : tuple_set) EXPECT_EQ(entry.second, 0);
+    }
+    txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    delete[] buffer;
+  }
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+  for (uint32_t i = 0; i < num_tables; i++) {
+    storage::TupleAccessStrategy accessor(layouts[i]);
+    for (uint32_t j = 0; j < blocks_per_table; j++) {
+      storage::RawBlock *block = blocks[i * blocks_per_table + j];
+      for (auto &entry : tuples[block]) delete[] reinterpret_cast<byte *>(entry.second);
+      for (storage::col_id_t col_id : layouts[i].AllColumns())
+        accessor.GetArrowBlockMetadata(block).GetColumnInfo(layouts[i], col_id).Deallocate();
+      block_store_.Release(block);
+    }
+  }
+}
+
 }  // namespace terrier
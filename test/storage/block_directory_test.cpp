@@ -0,0 +1,60 @@
+#include "storage/block_directory.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+#include "test_util/multithread_test_util.h"
+#include "test_util/test_harness.h"
+
+namespace terrier {
+
+// The directory never dereferences the blocks in it, so tests can make up block pointers that encode the appender
+static storage::RawBlock *FakeBlock(const uint32_t thread, const uint32_t i) {
+  return reinterpret_cast<storage::RawBlock *>((static_cast<uintptr_t>(thread) << 32) | (i + 1));
+}
+
+// Tests that blocks appended from many threads each get their own index, across many chunks of the directory, and
+// that readers never see a block before every block below it is published
+// NOLINTNEXTLINE
+TEST(BlockDirectoryTests, ConcurrentAppendAndRead) {
+  const uint32_t num_iterations = 5;
+  const uint32_t num_appends = 50000;
+  const uint32_t num_appenders = std::max(MultiThreadTestUtil::HardwareConcurrency(), 4U);
+  // One extra thread keeps reading while the others append
+  common::WorkerPool thread_pool(num_appenders + 1, {});
+  for (uint32_t iteration = 0; iteration < num_iterations; iteration++) {
+    storage::BlockDirectory tested;
+    std::vector<std::vector<uint32_t>> appended(num_appenders);
+    std::atomic<uint32_t> num_finished = 0;
+    auto workload = [&](uint32_t id) {
+      if (id == num_appenders) {
+        uint32_t num_read = 0;
+        while (num_finished.load() != num_appenders) {
+          const uint32_t size = tested.Size();
+          for (; num_read < size; num_read++) EXPECT_NE(nullptr, tested.At(num_read));
+          std::this_thread::yield();
+        }
+        return;
+      }
+      for (uint32_t i = 0; i < num_appends / num_appenders; i++)
+        appended[id].push_back(tested.Append(FakeBlock(id, i)));
+      num_finished++;
+    };
+    MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_appenders + 1, workload);
+
+    const uint32_t num_blocks = (num_appends / num_appenders) * num_appenders;
+    EXPECT_EQ(num_blocks, tested.Size());
+    std::vector<bool> seen(num_blocks, false);
+    for (uint32_t thread = 0; thread < num_appenders; thread++) {
+      for (uint32_t i = 0; i < appended[thread].size(); i++) {
+        const uint32_t block_idx = appended[thread][i];
+        ASSERT_LT(block_idx, num_blocks);
+        EXPECT_FALSE(seen[block_idx]);
+        seen[block_idx] = true;
+        EXPECT_EQ(FakeBlock(thread, i), tested.At(block_idx));
+      }
+    }
+    EXPECT_EQ(nullptr, tested.AtOrNull(num_blocks));
+  }
+}
+}  // namespace terrier
@@ -0,0 +1,251 @@
+#include "storage/block_evictor.h"
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "storage/block_compactor.h"
+#include "storage/data_table.h"
+#include "storage/garbage_collector.h"
+#include "storage/tuple_access_strategy.h"
+#include "test_util/storage_test_util.h"
+#include "test_util/test_harness.h"
+#include "transaction/deferred_action_manager.h"
+
+namespace terrier {
+
+struct BlockEvictorTests : public TerrierTest {
+  void SetUp() override {
+    TerrierTest::SetUp();
+    // Columns are numbered by size, largest first
+    layout_ = new storage::BlockLayout({8, 8, 4});
+    table_ = new storage::DataTable(&block_store_, *layout_, storage::layout_version_t(0));
+    initializer_ = new storage::ProjectedRowInitializer(
+        storage::ProjectedRowInitializer::Create(*layout_, {storage::col_id_t(1), storage::col_id_t(2)}));
+    buffer_ = common::AllocationUtil::AllocateAligned(initializer_->ProjectedRowSize());
+    row_ = initializer_->InitializeRow(buffer_);
+    gc_ = new storage::GarbageCollector(&timestamp_manager_, &deferred_action_manager_, &txn_manager_, DISABLED);
+  }
+
+  void TearDown() override {
+    gc_->PerformGarbageCollection();
+    gc_->PerformGarbageCollection();
+    delete gc_;
+    delete[] buffer_;
+    delete initializer_;
+    delete table_;
+    delete layout_;
+    TerrierTest::TearDown();
+  }
+
+  // Fills up a new block of the table and freezes it
+  storage::RawBlock *PopulateFrozenBlock() {
+    transaction::TransactionContext *txn = txn_manager_.BeginTransaction();
+    storage::RawBlock *block = nullptr;
+    for (uint32_t i = 0; i < layout_->NumSlots(); i++) {
+      *reinterpret_cast<int64_t *>(row_->AccessForceNotNull(0)) = i;
+      *reinterpret_cast<int32_t *>(row_->AccessForceNotNull(1)) = static_cast<int32_t>(2 * i);
+      block = table_->Insert(txn, *row_).GetBlock();
+    }
+    txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    storage::TupleAccessStrategy accessor(*layout_);
+    for (storage::col_id_t col_id : layout_->AllColumns())
+      accessor.GetArrowBlockMetadata(block).GetColumnInfo(*layout_, col_id).Type() =
+          storage::ArrowColumnType::FIXED_LENGTH;
+    storage::BlockCompactor compactor;
+    gc_->PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager_, &txn_manager_);
+    gc_->PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager_, &txn_manager_);
+    EXPECT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+    return block;
+  }
+
+  // Checks that every tuple of the block holds the values it was populated with, except for the given one
+  void CheckBlock(storage::RawBlock *block, uint32_t updated_offset = UINT32_MAX, int64_t updated_value = 0) {
+    transaction::TransactionContext *txn = txn_manager_.BeginTransaction();
+    for (uint32_t i = 0; i < layout_->NumSlots(); i++) {
+      ASSERT_TRUE(table_->Select(txn, storage::TupleSlot(block, i), row_));
+      EXPECT_EQ(i == updated_offset ? updated_value : i, *reinterpret_cast<int64_t *>(row_->AccessWithNullCheck(0)));
+      EXPECT_EQ(2 * i, *reinterpret_cast<int32_t *>(row_->AccessWithNullCheck(1)));
+    }
+    txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  }
+
+  // Updates the first column of the given tuple
+  void UpdateTuple(storage::TupleSlot slot, int64_t value) {
+    transaction::TransactionContext *txn = txn_manager_.BeginTransaction();
+    auto update_initializer = storage::ProjectedRowInitializer::Create(*layout_, {storage::col_id_t(1)});
+    byte *update_buffer = common::AllocationUtil::AllocateAligned(update_initializer.ProjectedRowSize());
+    storage::ProjectedRow *update = update_initializer.InitializeRow(update_buffer);
+    *reinterpret_cast<int64_t *>(update->AccessForceNotNull(0)) = value;
+    EXPECT_TRUE(table_->Update(txn, slot, *update));
+    txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    delete[] update_buffer;
+  }
+
+  // Whether the given address is in a mapping backed by reserved huge pages, as opposed to regular or transparent huge
+  // pages
+  static bool InHugeTlbPages(const void *address) {
+    const auto target = reinterpret_cast<uintptr_t>(address);
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool in_mapping = false;
+    while (std::getline(smaps, line)) {
+      uintptr_t start, end;
+      char dash;
+      std::istringstream range(line);
+      if (range >> std::hex >> start >> dash >> end && dash == '-') {
+        in_mapping = start <= target && target < end;
+      } else if (in_mapping && line.compare(0, 15, "KernelPageSize:") == 0) {
+        uint64_t page_kb;
+        std::istringstream(line.substr(15)) >> page_kb;
+        return page_kb * 1024 > static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+      }
+    }
+    return false;
+  }
+
+  static constexpr const char *FILE_NAME = "block_evictor_test.blocks";
+
+  storage::BlockStore block_store_{10, 10};
+  storage::RecordBufferSegmentPool buffer_pool_{10000, 10000};
+  transaction::TimestampManager timestamp_manager_;
+  transaction::DeferredActionManager deferred_action_manager_{&timestamp_manager_};
+  transaction::TransactionManager txn_manager_{&timestamp_manager_, &deferred_action_manager_, &buffer_pool_, true,
+                                               DISABLED};
+  storage::GarbageCollector *gc_ = nullptr;
+  storage::BlockLayout *layout_ = nullptr;
+  storage::DataTable *table_ = nullptr;
+  storage::ProjectedRowInitializer *initializer_ = nullptr;
+  byte *buffer_ = nullptr;
+  storage::ProjectedRow *row_ = nullptr;
+};
+
+// Tests that an evicted block is written out to the block file, can still be read, and can be written to after it is
+// thawed
+// NOLINTNEXTLINE
+TEST_F(BlockEvictorTests, EvictAndReadBack) {
+  storage::BlockEvictor evictor(FILE_NAME, 1);
+  storage::RawBlock *block = PopulateFrozenBlock();
+  ASSERT_TRUE(evictor.Evict(block));
+  EXPECT_EQ(1, evictor.NumEvictions());
+  struct stat file_stat;
+  ASSERT_EQ(0, stat(FILE_NAME, &file_stat));
+  EXPECT_EQ(common::Constants::BLOCK_SIZE - sysconf(_SC_PAGESIZE), file_stat.st_size);
+  CheckBlock(block);
+
+  // Writing to the block thaws it, and the write stays in memory
+  UpdateTuple(storage::TupleSlot(block, 42), -1);
+  EXPECT_EQ(storage::BlockState::HOT, block->controller_.GetBlockState()->load());
+  CheckBlock(block, 42, -1);
+}
+
+// Tests that watched blocks are only evicted once they have been frozen and unread for long enough
+// NOLINTNEXTLINE
+TEST_F(BlockEvictorTests, EvictIdleBlocks) {
+  const uint32_t idle_threshold = 3;
+  storage::BlockEvictor evictor(FILE_NAME, idle_threshold);
+  storage::RawBlock *block = PopulateFrozenBlock();
+  evictor.WatchBlock(block);
+  // Reading the block keeps it in memory
+  for (uint32_t i = 0; i < 2 * idle_threshold; i++) {
+    CheckBlock(block);
+    evictor.ObserveGCInvocation();
+  }
+  EXPECT_EQ(0, evictor.NumEvictions());
+
+  for (uint32_t i = 0; i < idle_threshold; i++) {
+    EXPECT_EQ(0, evictor.NumEvictions());
+    evictor.ObserveGCInvocation();
+  }
+  EXPECT_EQ(1, evictor.NumEvictions());
+  // Nothing is left to watch, so the block is not written out again
+  for (uint32_t i = 0; i < 2 * idle_threshold; i++) evictor.ObserveGCInvocation();
+  EXPECT_EQ(1, evictor.NumEvictions());
+  CheckBlock(block);
+}
+
+// Tests that the evictor writes out no more than the given number of blocks every time the GC runs, and gets to the
+// rest in the next invocations
+// NOLINTNEXTLINE
+TEST_F(BlockEvictorTests, CapEvictionsPerPass) {
+  const uint32_t num_blocks = 5;
+  storage::BlockEvictor evictor(FILE_NAME, 1, 2);
+  std::vector<storage::RawBlock *> blocks;
+  for (uint32_t i = 0; i < num_blocks; i++) {
+    blocks.push_back(PopulateFrozenBlock());
+    evictor.WatchBlock(blocks.back());
+  }
+  evictor.ObserveGCInvocation();
+  EXPECT_EQ(2, evictor.NumEvictions());
+  evictor.ObserveGCInvocation();
+  EXPECT_EQ(4, evictor.NumEvictions());
+  evictor.ObserveGCInvocation();
+  EXPECT_EQ(num_blocks, evictor.NumEvictions());
+  evictor.ObserveGCInvocation();
+  EXPECT_EQ(num_blocks, evictor.NumEvictions());
+  for (storage::RawBlock *block : blocks) CheckBlock(block);
+}
+
+// Tests that blocks are carved out of huge page arenas without getting in the way of eviction. A block backed by
+// reserved huge pages cannot be evicted, so the evictor gives up on it after one try, hands its slot in the file to
+// the next block, and leaves the block readable and writable. Without reserved huge pages, the arena is only advised
+// to use transparent huge pages, and the block is evicted without touching its neighbour in the same arena.
+// NOLINTNEXTLINE
+TEST_F(BlockEvictorTests, HugePageBlocks) {
+  storage::BlockEvictor evictor(FILE_NAME, 1);
+  storage::RawBlock *block = PopulateFrozenBlock();
+  storage::RawBlock *neighbour = PopulateFrozenBlock();
+  const auto arena_mask = ~(storage::BlockAllocator::ARENA_SIZE - 1);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(block) & arena_mask, reinterpret_cast<uintptr_t>(neighbour) & arena_mask);
+  const bool huge_pages = InHugeTlbPages(block);
+
+  evictor.WatchBlock(block);
+  for (uint32_t i = 0; i < 3; i++) evictor.ObserveGCInvocation();
+  EXPECT_EQ(huge_pages ? 0 : 1, evictor.NumEvictions());
+  // The neighbour goes to the slot the block gave up, if it did
+  evictor.Evict(neighbour);
+  EXPECT_EQ(huge_pages ? 0 : 2, evictor.NumEvictions());
+  struct stat file_stat;
+  ASSERT_EQ(0, stat(FILE_NAME, &file_stat));
+  EXPECT_EQ((huge_pages ? 1 : 2) * (common::Constants::BLOCK_SIZE - sysconf(_SC_PAGESIZE)), file_stat.st_size);
+  CheckBlock(block);
+  CheckBlock(neighbour);
+
+  UpdateTuple(storage::TupleSlot(block, 7), -1);
+  CheckBlock(block, 7, -1);
+  CheckBlock(neighbour);
+}
+
+// Tests that the evictor lets go of the blocks of a dropped table, and that the next block it evicts takes over the
+// slot in the file of a freed block
+// NOLINTNEXTLINE
+TEST_F(BlockEvictorTests, ReuseSlotsOfFreedBlocks) {
+  storage::BlockEvictor evictor(FILE_NAME, 1);
+  storage::RawBlock *block = PopulateFrozenBlock();
+  evictor.WatchBlock(block);
+  evictor.ObserveGCInvocation();
+  EXPECT_EQ(1, evictor.NumEvictions());
+  // Keep the block on the watch list
+  evictor.WatchBlock(block);
+
+  // Drop the table. The block store hands the same block out to the next table, which fills it up with its own tuples.
+  gc_->PerformGarbageCollection();
+  gc_->PerformGarbageCollection();
+  delete table_;
+  evictor.ObserveGCInvocation();
+  table_ = new storage::DataTable(&block_store_, *layout_, storage::layout_version_t(0));
+  EXPECT_EQ(block, PopulateFrozenBlock());
+  ASSERT_TRUE(evictor.Evict(block));
+  EXPECT_EQ(2, evictor.NumEvictions());
+  struct stat file_stat;
+  ASSERT_EQ(0, stat(FILE_NAME, &file_stat));
+  EXPECT_EQ(common::Constants::BLOCK_SIZE - sysconf(_SC_PAGESIZE), file_stat.st_size);
+  CheckBlock(block);
+}
+
+}  // namespace terrier
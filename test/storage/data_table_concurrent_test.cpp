@@ -1,5 +1,6 @@
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "storage/data_table.h"
 #include "test_util/multithread_test_util.h"
@@ -117,6 +118,112 @@ TEST_F(DataTableConcurrentTests, ConcurrentInsert) {
   }
 }
 
+// Same as ConcurrentInsert, but with every thread inserting into a block it claimed for itself. All inserts should
+// succeed, and the table should not end up with more than one partially filled block per thread.
+// NOLINTNEXTLINE
+TEST_F(DataTableConcurrentTests, ConcurrentThreadLocalInsert) {
+  const uint32_t num_iterations = 50;
+  const uint32_t num_inserts = 10000;
+  const uint16_t max_columns = 20;
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency();
+  common::WorkerPool thread_pool(num_threads, {});
+  for (uint32_t iteration = 0; iteration < num_iterations; iteration++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(max_columns, &generator_);
+    storage::DataTable tested(&block_store_, layout, storage::layout_version_t(0));
+    tested.SetThreadLocalInsertion(true);
+    std::vector<std::unique_ptr<FakeTransaction>> fake_txns;
+    for (uint32_t thread = 0; thread < num_threads; thread++)
+      // timestamps are irrelevant for inserts
+      fake_txns.emplace_back(std::make_unique<FakeTransaction>(layout, &tested, null_ratio_(generator_),
+                                                               transaction::timestamp_t(0), transaction::timestamp_t(0),
+                                                               &buffer_pool_));
+    auto workload = [&](uint32_t id) {
+      std::default_random_engine thread_generator(id);
+      for (uint32_t i = 0; i < num_inserts / num_threads; i++) fake_txns[id]->InsertRandomTuple(&thread_generator);
+      tested.ReleaseThreadLocalBlock();
+    };
+    MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+
+    std::unordered_set<storage::TupleSlot> inserted_slots;
+    storage::ProjectedRowInitializer select_initializer =
+        storage::ProjectedRowInitializer::Create(layout, StorageTestUtil::ProjectionListAllColumns(layout));
+    auto *select_buffer = common::AllocationUtil::AllocateAligned(select_initializer.ProjectedRowSize());
+    for (auto &fake_txn : fake_txns) {
+      for (auto slot : fake_txn->InsertedTuples()) {
+        EXPECT_TRUE(inserted_slots.insert(slot).second);
+        storage::ProjectedRow *select_row = select_initializer.InitializeRow(select_buffer);
+        tested.Select(fake_txn->GetTxn(), slot, select_row);
+        EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(layout, fake_txn->GetReferenceTuple(slot), select_row));
+      }
+    }
+    delete[] select_buffer;
+    // Blocks are only handed back once full, except for the last block of every thread, and the empty block appended
+    // whenever the insertion head runs past the last block
+    EXPECT_LE(tested.GetNumBlocks(), inserted_slots.size() / layout.NumSlots() + 2 * num_threads + 1);
+  }
+}
+
+// Spawns multiple transactions that insert with thread-local insertion turned on, and never hand back their blocks.
+// Turning thread-local insertion off should hand the blocks back, so that later inserts fill them up. Turning it back
+// on should have the threads claim blocks anew.
+// NOLINTNEXTLINE
+TEST_F(DataTableConcurrentTests, ThreadLocalInsertionToggle) {
+  const uint32_t num_iterations = 10;
+  const uint32_t num_inserts = 100;
+  const uint16_t max_columns = 20;
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency();
+  common::WorkerPool thread_pool(num_threads, {});
+  for (uint32_t iteration = 0; iteration < num_iterations; iteration++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(max_columns, &generator_);
+    storage::DataTable tested(&block_store_, layout, storage::layout_version_t(0));
+    std::vector<std::unique_ptr<FakeTransaction>> fake_txns;
+    for (uint32_t thread = 0; thread <= num_threads; thread++)
+      // timestamps are irrelevant for inserts
+      fake_txns.emplace_back(std::make_unique<FakeTransaction>(layout, &tested, null_ratio_(generator_),
+                                                               transaction::timestamp_t(0), transaction::timestamp_t(0),
+                                                               &buffer_pool_));
+    auto workload = [&](uint32_t id) {
+      std::default_random_engine thread_generator(id);
+      for (uint32_t i = 0; i < num_inserts; i++) fake_txns[id]->InsertRandomTuple(&thread_generator);
+    };
+    tested.SetThreadLocalInsertion(true);
+    MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+    tested.SetThreadLocalInsertion(false);
+
+    // Fill up the blocks that the threads had claimed, which should not need any new blocks
+    std::unordered_set<storage::RawBlock *> blocks;
+    for (auto it = tested.begin(); it != tested.end(); ++it) blocks.insert(it->GetBlock());
+    const uint32_t num_free_slots =
+        static_cast<uint32_t>(blocks.size()) * layout.NumSlots() - num_threads * num_inserts;
+    for (uint32_t i = 0; i < num_free_slots; i++) {
+      storage::TupleSlot slot = fake_txns[num_threads]->InsertRandomTuple(&generator_);
+      EXPECT_EQ(1, blocks.count(slot.GetBlock()));
+    }
+
+    // The threads' claims are gone, so they have to claim new blocks
+    tested.SetThreadLocalInsertion(true);
+    MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, [&](uint32_t id) {
+      workload(id);
+      tested.ReleaseThreadLocalBlock();
+    });
+    tested.SetThreadLocalInsertion(false);
+
+    std::unordered_set<storage::TupleSlot> inserted_slots;
+    storage::ProjectedRowInitializer select_initializer =
+        storage::ProjectedRowInitializer::Create(layout, StorageTestUtil::ProjectionListAllColumns(layout));
+    auto *select_buffer = common::AllocationUtil::AllocateAligned(select_initializer.ProjectedRowSize());
+    for (auto &fake_txn : fake_txns) {
+      for (auto slot : fake_txn->InsertedTuples()) {
+        EXPECT_TRUE(inserted_slots.insert(slot).second);
+        storage::ProjectedRow *select_row = select_initializer.InitializeRow(select_buffer);
+        tested.Select(fake_txn->GetTxn(), slot, select_row);
+        EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(layout, fake_txn->GetReferenceTuple(slot), select_row));
+      }
+    }
+    delete[] select_buffer;
+  }
+}
+
 // Spawns multiple transactions that all begin at the same time.
 // Each transaction attempts to update the same tuple.
 // Therefore only one transaction should win, which is what we test for.
@@ -4,9 +4,11 @@
 #include <utility>
 #include <vector>
 #include "common/object_pool.h"
+#include "storage/garbage_collector.h"
 #include "storage/storage_util.h"
 #include "test_util/storage_test_util.h"
 #include "test_util/test_harness.h"
+#include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_context.h"
 #include "transaction/transaction_util.h"
 
@@ -228,6 +230,54 @@ TEST_F(DataTableTests, SimpleSequentialScan) {
   }
 }
 
+// Inserts a batch of random tuples, spanning more than one block, with InsertBatch. Then, Selects the inserted
+// TupleSlots and compares the results to the original tuples in the batch.
+// NOLINTNEXTLINE
+TEST_F(DataTableTests, InsertBatchSelect) {
+  const uint32_t num_iterations = 10;
+  const uint16_t max_columns = 20;
+  for (uint32_t iteration = 0; iteration < num_iterations; ++iteration) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(max_columns, &generator_);
+    storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+    const uint32_t num_tuples = layout.NumSlots() + layout.NumSlots() / 2;
+    std::vector<storage::col_id_t> all_cols = StorageTestUtil::ProjectionListAllColumns(layout);
+
+    // Fill the batch with random rows
+    storage::ProjectedColumnsInitializer columns_initializer(layout, all_cols, num_tuples);
+    auto *columns_buffer = common::AllocationUtil::AllocateAligned(columns_initializer.ProjectedColumnsSize());
+    storage::ProjectedColumns *columns = columns_initializer.Initialize(columns_buffer);
+    columns->SetNumTuples(num_tuples);
+    storage::ProjectedRowInitializer row_initializer = storage::ProjectedRowInitializer::Create(layout, all_cols);
+    auto *row_buffer = common::AllocationUtil::AllocateAligned(row_initializer.ProjectedRowSize());
+    const double null_ratio = null_ratio_(generator_);
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      storage::ProjectedRow *row = row_initializer.InitializeRow(row_buffer);
+      StorageTestUtil::PopulateRandomRow(row, layout, null_ratio, &generator_);
+      storage::ProjectedColumns::RowView row_view = columns->InterpretAsRow(i);
+      storage::StorageUtil::ApplyDelta(layout, *row, &row_view);
+    }
+
+    auto *txn = new transaction::TransactionContext(transaction::timestamp_t(0), transaction::timestamp_t(0),
+                                                    &buffer_pool_, DISABLED);
+    std::vector<storage::TupleSlot> slots(num_tuples);
+    table.InsertBatch(txn, *columns, slots.data());
+    EXPECT_NE(slots.front().GetBlock(), slots.back().GetBlock());
+
+    auto *reader = new transaction::TransactionContext(transaction::timestamp_t(1), transaction::timestamp_t(1),
+                                                       &buffer_pool_, DISABLED);
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      storage::ProjectedRow *stored = row_initializer.InitializeRow(row_buffer);
+      EXPECT_TRUE(table.Select(reader, slots[i], stored));
+      storage::ProjectedColumns::RowView ref = columns->InterpretAsRow(i);
+      EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(layout, stored, &ref));
+    }
+    delete txn;
+    delete reader;
+    delete[] row_buffer;
+    delete[] columns_buffer;
+  }
+}
+
 // Generates a random table layout and coin flip bias for an attribute being null, inserts 1 random tuple into an empty
 // DataTable. Then, randomly updates the tuple num_updates times. Finally, Selects at each timestamp to verify that the
 // delta chain produces the correct tuple. Repeats for num_iterations.
@@ -314,4 +364,68 @@ TEST_F(DataTableTests, InsertNoWrap) {
     delete txn;
   }
 }
+
+// Deletes a random subset of the tuples in a table whose version chains have all been truncated, so that scans only
+// need to check whether slots are present, and scans it with an output buffer smaller than a block, so that the scan
+// stops and resumes in the middle of blocks. The scan should return exactly the tuples that were not deleted, in order.
+// NOLINTNEXTLINE
+TEST_F(DataTableTests, VersionFreeScan) {
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+  storage::BlockLayout layout({8, 8});
+  storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+  auto row_initializer = storage::ProjectedRowInitializer::Create(layout, {storage::col_id_t(1)});
+  byte *row_buffer = common::AllocationUtil::AllocateAligned(row_initializer.ProjectedRowSize());
+  storage::ProjectedRow *row = row_initializer.InitializeRow(row_buffer);
+
+  // Fill a block and a half, then delete about a third of the tuples
+  std::vector<storage::TupleSlot> slots;
+  auto *txn = txn_manager.BeginTransaction();
+  for (uint64_t i = 0; i < layout.NumSlots() * 3 / 2; i++) {
+    *reinterpret_cast<uint64_t *>(row->AccessForceNotNull(0)) = i;
+    slots.push_back(table.Insert(txn, *row));
+  }
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  std::vector<storage::TupleSlot> expected_slots;
+  std::vector<uint64_t> expected_values;
+  txn = txn_manager.BeginTransaction();
+  for (uint64_t i = 0; i < slots.size(); i++) {
+    if (std::uniform_int_distribution<uint32_t>(0, 2)(generator_) == 0) {
+      EXPECT_TRUE(table.Delete(txn, slots[i]));
+    } else {
+      expected_slots.push_back(slots[i]);
+      expected_values.push_back(i);
+    }
+  }
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();
+  EXPECT_EQ(0, slots.front().GetBlock()->num_versioned_slots_.load());
+  EXPECT_EQ(0, slots.back().GetBlock()->num_versioned_slots_.load());
+
+  storage::ProjectedColumnsInitializer initializer(layout, {storage::col_id_t(1)}, 100);
+  byte *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedColumnsSize());
+  storage::ProjectedColumns *columns = initializer.Initialize(buffer);
+  std::vector<storage::TupleSlot> scanned_slots;
+  std::vector<uint64_t> scanned_values;
+  txn = txn_manager.BeginTransaction();
+  for (auto it = table.begin(); it != table.end();) {
+    table.Scan(txn, &it, columns);
+    for (uint32_t i = 0; i < columns->NumTuples(); i++) {
+      scanned_slots.push_back(columns->TupleSlots()[i]);
+      scanned_values.push_back(*reinterpret_cast<uint64_t *>(columns->InterpretAsRow(i).AccessWithNullCheck(0)));
+    }
+  }
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  EXPECT_EQ(expected_slots, scanned_slots);
+  EXPECT_EQ(expected_values, scanned_values);
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();
+  delete[] buffer;
+  delete[] row_buffer;
+}
 }  // namespace terrier
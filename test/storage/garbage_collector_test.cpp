@@ -1,5 +1,6 @@
 #include "storage/garbage_collector.h"
 #include <cstring>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -9,6 +10,7 @@
 #include "test_util/data_table_test_util.h"
 #include "test_util/storage_test_util.h"
 #include "test_util/test_harness.h"
+#include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_context.h"
 #include "transaction/transaction_manager.h"
 
@@ -116,6 +118,172 @@ TEST_F(GarbageCollectorTests, SingleInsert) {
   }
 }
 
+// Run a txn that inserts a tuple and another one that updates it. Confirm that the block's version synopsis counts the
+// tuple as versioned until the GC truncates its version chain.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, VersionSynopsis) {
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    transaction::TimestampManager timestamp_manager;
+    transaction::TransactionManager txn_manager(&timestamp_manager, DISABLED, &buffer_pool_, true, DISABLED);
+    GarbageCollectorDataTableTestObject tested(&block_store_, max_columns_, &generator_);
+    storage::GarbageCollector gc(&timestamp_manager, DISABLED, &txn_manager, DISABLED);
+
+    auto *txn0 = txn_manager.BeginTransaction();
+    auto *insert_tuple = tested.GenerateRandomTuple(&generator_);
+    storage::TupleSlot slot = tested.table_.Insert(txn0, *insert_tuple);
+    storage::RawBlock *block = slot.GetBlock();
+    EXPECT_EQ(1, block->num_versioned_slots_.load());
+    txn_manager.Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // Unlinking the Insert's UndoRecord truncates the version chain
+    gc.PerformGarbageCollection();
+    EXPECT_EQ(0, block->num_versioned_slots_.load());
+    gc.PerformGarbageCollection();
+
+    auto *txn1 = txn_manager.BeginTransaction();
+    auto *update = tested.GenerateRandomUpdate(&generator_);
+    EXPECT_TRUE(tested.table_.Update(txn1, slot, *update));
+    EXPECT_EQ(1, block->num_versioned_slots_.load());
+    txn_manager.Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    gc.PerformGarbageCollection();
+    EXPECT_EQ(0, block->num_versioned_slots_.load());
+    gc.PerformGarbageCollection();
+  }
+}
+
+// Run a txn that updates a tuple in each of several tables, with the GC spread across several workers. Confirm that
+// every table's version chain is truncated, and the txn deallocated, in as many GC cycles as with one worker.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, MultipleWorkers) {
+  const uint32_t num_tables = 8;
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    transaction::TimestampManager timestamp_manager;
+    transaction::TransactionManager txn_manager(&timestamp_manager, DISABLED, &buffer_pool_, true, DISABLED);
+    std::vector<std::unique_ptr<GarbageCollectorDataTableTestObject>> tested;
+    for (uint32_t i = 0; i < num_tables; i++)
+      tested.emplace_back(
+          std::make_unique<GarbageCollectorDataTableTestObject>(&block_store_, max_columns_, &generator_));
+    storage::GarbageCollector gc(&timestamp_manager, DISABLED, &txn_manager, DISABLED);
+    gc.SetNumWorkers(4);
+
+    auto *txn0 = txn_manager.BeginTransaction();
+    std::vector<storage::TupleSlot> slots;
+    for (auto &table : tested) slots.push_back(table->table_.Insert(txn0, *table->GenerateRandomTuple(&generator_)));
+    txn_manager.Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+    EXPECT_EQ(std::make_pair(0U, 1U), gc.PerformGarbageCollection());
+    EXPECT_EQ(std::make_pair(1U, 0U), gc.PerformGarbageCollection());
+
+    auto *txn1 = txn_manager.BeginTransaction();
+    for (uint32_t i = 0; i < num_tables; i++)
+      EXPECT_TRUE(tested[i]->table_.Update(txn1, slots[i], *tested[i]->GenerateRandomUpdate(&generator_)));
+    for (const auto &slot : slots) EXPECT_EQ(1, slot.GetBlock()->num_versioned_slots_.load());
+    txn_manager.Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    EXPECT_EQ(std::make_pair(0U, 1U), gc.PerformGarbageCollection());
+    for (const auto &slot : slots) EXPECT_EQ(0, slot.GetBlock()->num_versioned_slots_.load());
+    EXPECT_EQ(std::make_pair(1U, 0U), gc.PerformGarbageCollection());
+  }
+}
+
+// Run txns that update the same tuple while a reader is running. Confirm that an update cuts the versions older than
+// the oldest running txn off the version chain without waiting for the GC, and that the reader still sees its snapshot.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, InlineTruncation) {
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    transaction::TimestampManager timestamp_manager;
+    transaction::TransactionManager txn_manager(&timestamp_manager, DISABLED, &buffer_pool_, true, DISABLED);
+    GarbageCollectorDataTableTestObject tested(&block_store_, max_columns_, &generator_);
+    storage::GarbageCollector gc(&timestamp_manager, DISABLED, &txn_manager, DISABLED);
+
+    auto *insert_tuple = tested.GenerateRandomTuple(&generator_);
+    auto *txn0 = txn_manager.BeginTransaction();
+    storage::TupleSlot slot = tested.table_.Insert(txn0, *insert_tuple);
+    txn_manager.Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+    EXPECT_EQ(std::make_pair(0U, 1U), gc.PerformGarbageCollection());
+    EXPECT_EQ(std::make_pair(1U, 0U), gc.PerformGarbageCollection());
+
+    auto *update1 = tested.GenerateRandomUpdate(&generator_);
+    auto *txn1 = txn_manager.BeginTransaction();
+    const transaction::timestamp_t before_update1 = txn1->StartTime();
+    EXPECT_TRUE(tested.table_.Update(txn1, slot, *update1));
+    txn_manager.Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+    auto *version1 = tested.GenerateVersionFromUpdate(*update1, *insert_tuple);
+
+    auto *reader = txn_manager.BeginTransaction();
+
+    auto *txn2 = txn_manager.BeginTransaction();
+    EXPECT_TRUE(tested.table_.Update(txn2, slot, *tested.GenerateRandomUpdate(&generator_)));
+    txn_manager.Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // Stand in for the GC polling the oldest running txn, which is the reader
+    EXPECT_EQ(reader->StartTime(), timestamp_manager.OldestTransactionStartTime());
+
+    auto *txn3 = txn_manager.BeginTransaction();
+    EXPECT_TRUE(tested.table_.Update(txn3, slot, *tested.GenerateRandomUpdate(&generator_)));
+    txn_manager.Commit(txn3, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    storage::ProjectedRow *select_tuple = tested.SelectIntoBuffer(reader, slot);
+    EXPECT_TRUE(tested.select_result_);
+    EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), select_tuple, version1));
+
+    // A snapshot older than any running txn is not supposed to exist. It shows that txn1's version is the oldest one
+    // left, as the record that takes the tuple back to its insert has been cut off.
+    transaction::TransactionContext old_snapshot(before_update1, before_update1 + INT64_MIN, &buffer_pool_, DISABLED);
+    select_tuple = tested.SelectIntoBuffer(&old_snapshot, slot);
+    EXPECT_TRUE(tested.select_result_);
+    EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), select_tuple, version1));
+
+    txn_manager.Commit(reader, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // The GC is unaffected by the records already being cut off
+    EXPECT_EQ(std::make_pair(0U, 4U), gc.PerformGarbageCollection());
+    EXPECT_EQ(std::make_pair(3U, 0U), gc.PerformGarbageCollection());
+  }
+}
+
+// Run a txn that inserts a tuple and another one that deletes it. Confirm that once the GC has processed the delete and
+// its deferred actions, the slot of the deleted tuple is reused by the next insert.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, RecycleDeletedSlot) {
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager(&timestamp_manager);
+    transaction::TransactionManager txn_manager(&timestamp_manager, DISABLED, &buffer_pool_, true, DISABLED);
+    GarbageCollectorDataTableTestObject tested(&block_store_, max_columns_, &generator_);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+    auto *txn0 = txn_manager.BeginTransaction();
+    storage::TupleSlot slot = tested.table_.Insert(txn0, *tested.GenerateRandomTuple(&generator_));
+    txn_manager.Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();
+
+    auto *txn1 = txn_manager.BeginTransaction();
+    EXPECT_TRUE(tested.table_.Delete(txn1, slot));
+    txn_manager.Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // Unlinking the delete only defers handing the slot back, so a new tuple still goes into a fresh slot
+    gc.PerformGarbageCollection();
+    auto *txn2 = txn_manager.BeginTransaction();
+    auto *insert_tuple = tested.GenerateRandomTuple(&generator_);
+    EXPECT_NE(slot, tested.table_.Insert(txn2, *insert_tuple));
+    txn_manager.Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // The deferred action has run, so the deleted slot is reused
+    gc.PerformGarbageCollection();
+    auto *txn3 = txn_manager.BeginTransaction();
+    EXPECT_EQ(slot, tested.table_.Insert(txn3, *insert_tuple));
+    storage::ProjectedRow *select_tuple = tested.SelectIntoBuffer(txn3, slot);
+    EXPECT_TRUE(tested.select_result_);
+    EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), select_tuple, insert_tuple));
+    txn_manager.Commit(txn3, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();
+  }
+}
+
 // Run a single read-only txn (empty UndoBuffer). Confirm that it takes 1 GC cycles to process this tuple.
 // NOLINTNEXTLINE
 TEST_F(GarbageCollectorTests, ReadOnly) {
@@ -10,7 +10,7 @@
 namespace terrier {
 class LargeGCTests : public TerrierTest {
  public:
-  void RunTest(const LargeDataTableTestConfiguration &config) {
+  void RunTest(const LargeDataTableTestConfiguration &config, const uint32_t num_gc_workers = 1) {
     for (uint32_t iteration = 0; iteration < config.NumIterations(); iteration++) {
       auto injector = di::make_injector<di::TestBindingPolicy>(
           di::storage_injector(), di::bind<storage::AccessObserver>().in(di::disabled),
@@ -30,6 +30,7 @@ class LargeGCTests : public TerrierTest {
               .to(std::chrono::milliseconds(10)));
       auto tested = injector.create<std::unique_ptr<LargeDataTableTestObject>>();
       auto gc_thread = injector.create<std::unique_ptr<storage::GarbageCollectorThread>>();
+      gc_thread->GetGarbageCollector().SetNumWorkers(num_gc_workers);
       for (uint32_t batch = 0; batch * config.BatchSize() < config.NumTxns(); batch++) {
         auto result = tested->SimulateOltp(config.BatchSize(), config.NumConcurrentTxns());
         gc_thread->PauseGC();
@@ -62,6 +63,23 @@ TEST_F(LargeGCTests, MixedReadWriteWithGC) {
   RunTest(config);
 }
 
+// This test duplicates the previous one with the GC spread across several workers.
+// NOLINTNEXTLINE
+TEST_F(LargeGCTests, MixedReadWriteWithParallelGC) {
+  auto config = LargeDataTableTestConfiguration::Builder()
+                    .SetNumIterations(10)
+                    .SetNumTxns(1000)
+                    .SetBatchSize(100)
+                    .SetNumConcurrentTxns(MultiThreadTestUtil::HardwareConcurrency())
+                    .SetUpdateSelectRatio({0.5, 0.5})
+                    .SetTxnLength(10)
+                    .SetInitialTableSize(1000)
+                    .SetMaxColumns(20)
+                    .SetVarlenAllowed(true)
+                    .Build();
+  RunTest(config, 4);
+}
+
 // Double the thread count to force more thread swapping and try to capture unexpected races
 // NOLINTNEXTLINE
 TEST_F(LargeGCTests, MixedReadWriteHighThreadWithGC) {
@@ -96,6 +96,7 @@ class WriteAheadLoggingTests : public TerrierTest {
 
     // If code path reaches here, we have a REDO record.
     TERRIER_ASSERT(record_type == storage::LogRecordType::REDO, "Unknown record type during test deserialization");
+    auto layout_version = in->ReadValue<storage::layout_version_t>();
 
     // Read in col_ids
     // IDs read individually since we can't guarantee memory layout of vector
@@ -125,6 +126,7 @@ class WriteAheadLoggingTests : public TerrierTest {
     auto *result = storage::RedoRecord::Initialize(buf, txn_begin, database_oid, table_oid, initializer);
     auto *record_body = result->GetUnderlyingRecordBodyAs<RedoRecord>();
     record_body->SetTupleSlot(tuple_slot);
+    record_body->SetLayoutVersion(layout_version);
     auto *delta = record_body->Delta();
 
     // Get an in memory copy of the record's null bitmap. Note: this is used to guide how the rest of the log file is
@@ -204,7 +206,7 @@ TEST_F(WriteAheadLoggingTests, LargeLogTest) {
   storage::BufferedLogReader in(LOG_FILE_NAME);
   while (in.HasMore()) {
     storage::LogRecord *log_record = ReadNextRecord(&in);
-    if (log_record->TxnBegin() == transaction::INITIAL_TXN_TIMESTAMP) {
+    if (log_record->TxnBegin() == tested->InitialTxnBegin()) {
       // TODO(Tianyu): This is hacky, but it will be a pain to extract the initial transaction. The LargeTransactionTest
       //  harness probably needs some refactor (later after wal is in).
       // This the initial setup transaction.
@@ -285,7 +287,7 @@ TEST_F(WriteAheadLoggingTests, ReadOnlyTransactionsGenerateNoLogTest) {
   storage::BufferedLogReader in(LOG_FILE_NAME);
   while (in.HasMore()) {
     storage::LogRecord *log_record = ReadNextRecord(&in);
-    if (log_record->TxnBegin() == transaction::INITIAL_TXN_TIMESTAMP) {
+    if (log_record->TxnBegin() == tested->InitialTxnBegin()) {
       // (TODO) Currently following pattern from LargeLogTest of skipping the initial transaction. When the transaction
       // testing framework changes, fix this.
       delete[] reinterpret_cast<byte *>(log_record);
@@ -189,8 +189,12 @@ class RecoveryTests : public TerrierTest {
 
   storage::RedoBuffer &GetRedoBuffer(transaction::TransactionContext *txn) { return txn->redo_buffer_; }
 
-  storage::BlockLayout &GetBlockLayout(common::ManagedPointer<storage::SqlTable> table) const {
-    return table->table_.layout_;
+  TupleSlot GetRecoveredTupleSlot(RecoveryManager *recovery_manager, const TupleSlot slot) const {
+    return recovery_manager->tuple_slot_map_[slot];
+  }
+
+  const storage::BlockLayout &GetBlockLayout(common::ManagedPointer<storage::SqlTable> table) const {
+    return table->Version(storage::layout_version_t(0)).layout_;
   }
 
   // Simulates the system shutting down and restarting
@@ -237,7 +241,7 @@ class RecoveryTests : public TerrierTest {
         EXPECT_TRUE(recovered_sql_table != nullptr);
 
         EXPECT_TRUE(StorageTestUtil::SqlTableEqualDeep(
-            original_sql_table->table_.layout_, original_sql_table, recovered_sql_table,
+            GetBlockLayout(original_sql_table), original_sql_table, recovered_sql_table,
             tested->GetTupleSlotsForTable(database_oid, table_oid), recovery_manager.tuple_slot_map_, txn_manager_,
             recovery_txn_manager_));
         txn_manager_->Commit(original_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
@@ -666,6 +670,192 @@ TEST_F(RecoveryTests, ConcurrentDDLChangesTest) {
   recovery_txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
 }
 
+// Inserts a batch of tuples with InsertBatch, and checks that every tuple of the batch is recovered, as batched redo
+// records are written out as one regular redo record per tuple
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, BatchInsertTest) {
+  std::string database_name = "testdb";
+  auto namespace_oid = catalog::postgres::NAMESPACE_DEFAULT_NAMESPACE_OID;
+  std::string table_name = "foo";
+  const uint32_t num_tuples = 100;
+
+  // Begin T0, create database, create table foo, and commit
+  auto *txn0 = txn_manager_->BeginTransaction();
+  auto db_oid = CreateDatabase(txn0, catalog_, database_name);
+  auto db_catalog = catalog_->GetDatabaseCatalog(txn0, db_oid);
+  auto table_oid = CreateTable(txn0, db_catalog, namespace_oid, table_name);
+  txn_manager_->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Begin T1, insert a batch of tuples into foo, and commit
+  auto *txn1 = txn_manager_->BeginTransaction();
+  db_catalog = catalog_->GetDatabaseCatalog(txn1, db_oid);
+  auto table_ptr = db_catalog->GetTable(txn1, table_oid);
+  const auto &schema = db_catalog->GetSchema(txn1, table_oid);
+  auto initializer = table_ptr->InitializerForProjectedColumns({schema.GetColumn(0).Oid()}, num_tuples);
+  auto *batch_record = txn1->StageBatchWrite(db_oid, table_oid, initializer);
+  auto *columns = batch_record->Columns();
+  columns->SetNumTuples(num_tuples);
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    auto row = columns->InterpretAsRow(i);
+    *reinterpret_cast<int32_t *>(row.AccessForceNotNull(0)) = static_cast<int32_t>(i);
+  }
+  table_ptr->InsertBatch(txn1, batch_record);
+  std::vector<TupleSlot> inserted_slots(columns->TupleSlots(), columns->TupleSlots() + num_tuples);
+  txn_manager_->Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  ShutdownAndRestartSystem();
+
+  // Instantiate recovery manager, and recover the table
+  DiskLogProvider log_provider(LOG_FILE_NAME);
+  RecoveryManager recovery_manager(&log_provider, common::ManagedPointer(recovery_catalog_), recovery_txn_manager_,
+                                   recovery_deferred_action_manager_, common::ManagedPointer(thread_registry_),
+                                   &block_store_);
+  recovery_manager.StartRecovery();
+  recovery_manager.WaitForRecoveryToFinish();
+
+  // Every tuple in the batch should be recovered with its value
+  auto *txn = recovery_txn_manager_->BeginTransaction();
+  auto recovered_db_catalog = recovery_catalog_->GetDatabaseCatalog(txn, db_oid);
+  EXPECT_TRUE(recovered_db_catalog != nullptr);
+  auto recovered_table = recovered_db_catalog->GetTable(txn, table_oid);
+  EXPECT_TRUE(recovered_table != nullptr);
+  auto row_initializer = recovered_table->InitializerForProjectedRow({schema.GetColumn(0).Oid()});
+  auto *buffer = common::AllocationUtil::AllocateAligned(row_initializer.ProjectedRowSize());
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    auto *row = row_initializer.InitializeRow(buffer);
+    EXPECT_TRUE(recovered_table->Select(txn, GetRecoveredTupleSlot(&recovery_manager, inserted_slots[i]), row));
+    EXPECT_EQ(static_cast<int32_t>(i), *reinterpret_cast<int32_t *>(row->AccessWithNullCheck(0)));
+  }
+  delete[] buffer;
+  recovery_txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+// Tests that a column added to a table is recovered, along with tuples updated in place across layout versions, and a
+// tuple moved to the new layout version whose index entry moved along with it
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, SchemaChangeTest) {
+  std::string database_name = "testdb";
+  auto namespace_oid = catalog::postgres::NAMESPACE_DEFAULT_NAMESPACE_OID;
+  std::string table_name = "foo";
+  std::string index_name = "fooindex";
+  const int32_t num_tuples = 10;
+
+  // Begin T0, create database, create table foo with an index on its first column, and commit
+  auto *txn0 = txn_manager_->BeginTransaction();
+  auto db_oid = CreateDatabase(txn0, catalog_, database_name);
+  auto db_catalog = catalog_->GetDatabaseCatalog(txn0, db_oid);
+  std::vector<catalog::Schema::Column> cols;
+  for (const std::string col_name : {"id", "value"}) {
+    cols.emplace_back(col_name, type::TypeId::INTEGER, false,
+                      parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
+  }
+  auto table_oid = db_catalog->CreateTable(txn0, namespace_oid, table_name, catalog::Schema(cols));
+  EXPECT_TRUE(db_catalog->SetTablePointer(
+      txn0, table_oid, new storage::SqlTable(&block_store_, db_catalog->GetSchema(txn0, table_oid))));
+  auto index_oid = CreateIndex(txn0, db_catalog, namespace_oid, table_oid, index_name);
+  txn_manager_->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Begin T1, insert tuples and their index entries, and commit
+  auto *txn1 = txn_manager_->BeginTransaction();
+  db_catalog = catalog_->GetDatabaseCatalog(txn1, db_oid);
+  auto table_ptr = db_catalog->GetTable(txn1, table_oid);
+  auto index_ptr = db_catalog->GetIndex(txn1, index_oid);
+  const auto id_oid = db_catalog->GetSchema(txn1, table_oid).GetColumn("id").Oid();
+  const auto value_oid = db_catalog->GetSchema(txn1, table_oid).GetColumn("value").Oid();
+  auto key_initializer = index_ptr->GetProjectedRowInitializer();
+  auto *key_buffer = common::AllocationUtil::AllocateAligned(key_initializer.ProjectedRowSize());
+  auto *key = key_initializer.InitializeRow(key_buffer);
+  auto insert_initializer = table_ptr->InitializerForProjectedRow({id_oid, value_oid});
+  auto insert_map = table_ptr->ProjectionMapForOids({id_oid, value_oid});
+  std::vector<TupleSlot> slots;
+  for (int32_t id = 0; id < num_tuples; id++) {
+    auto *redo = txn1->StageWrite(db_oid, table_oid, insert_initializer);
+    *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(insert_map[id_oid])) = id;
+    *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(insert_map[value_oid])) = id;
+    slots.push_back(table_ptr->Insert(txn1, redo));
+    *reinterpret_cast<int32_t *>(key->AccessForceNotNull(0)) = id;
+    EXPECT_TRUE(index_ptr->InsertUnique(txn1, *key, slots.back()));
+  }
+  txn_manager_->Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Begin T2, add a column to foo, and commit
+  auto *txn2 = txn_manager_->BeginTransaction();
+  db_catalog = catalog_->GetDatabaseCatalog(txn2, db_oid);
+  cols = db_catalog->GetSchema(txn2, table_oid).GetColumns();
+  cols.emplace_back("added", type::TypeId::INTEGER, true,
+                    parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
+  EXPECT_TRUE(db_catalog->UpdateSchema(txn2, table_oid, new catalog::Schema(cols)));
+  txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Begin T3, update a tuple in place, move another one to the new layout version to write the added column, and
+  // commit
+  auto *txn3 = txn_manager_->BeginTransaction();
+  db_catalog = catalog_->GetDatabaseCatalog(txn3, db_oid);
+  const auto version = db_catalog->GetLayoutVersion(txn3, table_oid);
+  EXPECT_EQ(layout_version_t(1), version);
+  const auto added_oid = db_catalog->GetSchema(txn3, table_oid).GetColumn("added").Oid();
+  auto *redo = txn3->StageWrite(db_oid, table_oid, table_ptr->InitializerForProjectedRow({value_oid}, version));
+  redo->SetTupleSlot(slots[2]);
+  *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(0)) = 20;
+  EXPECT_TRUE(table_ptr->Update(txn3, redo, version));
+  EXPECT_TRUE(table_ptr->NeedsMigration(slots[3], {added_oid}));
+  const TupleSlot migrated = table_ptr->Migrate(txn3, db_oid, table_oid, slots[3], version);
+  EXPECT_NE(TupleSlot(nullptr, 0), migrated);
+  *reinterpret_cast<int32_t *>(key->AccessForceNotNull(0)) = 3;
+  index_ptr->Delete(txn3, *key, slots[3]);
+  EXPECT_TRUE(index_ptr->InsertUnique(txn3, *key, migrated));
+  redo = txn3->StageWrite(db_oid, table_oid, table_ptr->InitializerForProjectedRow({added_oid}, version));
+  redo->SetTupleSlot(migrated);
+  *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(0)) = 42;
+  EXPECT_TRUE(table_ptr->Update(txn3, redo, version));
+  txn_manager_->Commit(txn3, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  ShutdownAndRestartSystem();
+
+  // Instantiate recovery manager, and recover the table
+  DiskLogProvider log_provider(LOG_FILE_NAME);
+  RecoveryManager recovery_manager(&log_provider, common::ManagedPointer(recovery_catalog_), recovery_txn_manager_,
+                                   recovery_deferred_action_manager_, common::ManagedPointer(thread_registry_),
+                                   &block_store_);
+  recovery_manager.StartRecovery();
+  recovery_manager.WaitForRecoveryToFinish();
+
+  // The recovered table has the added column, and every tuple is found through the index with its latest values
+  auto *txn = recovery_txn_manager_->BeginTransaction();
+  auto recovered_db_catalog = recovery_catalog_->GetDatabaseCatalog(txn, db_oid);
+  ASSERT_TRUE(recovered_db_catalog != nullptr);
+  EXPECT_EQ(version, recovered_db_catalog->GetLayoutVersion(txn, table_oid));
+  EXPECT_EQ(added_oid, recovered_db_catalog->GetSchema(txn, table_oid).GetColumn("added").Oid());
+  auto recovered_table = recovered_db_catalog->GetTable(txn, table_oid);
+  auto recovered_index = recovered_db_catalog->GetIndex(txn, index_oid);
+  ASSERT_TRUE(recovered_table != nullptr);
+  ASSERT_TRUE(recovered_index != nullptr);
+  EXPECT_EQ(version, recovered_table->GetLatestVersion());
+  const std::vector<catalog::col_oid_t> oids = {id_oid, value_oid, added_oid};
+  auto row_initializer = recovered_table->InitializerForProjectedRow(oids, version);
+  auto row_map = recovered_table->ProjectionMapForOids(oids, version);
+  auto *buffer = common::AllocationUtil::AllocateAligned(row_initializer.ProjectedRowSize());
+  for (int32_t id = 0; id < num_tuples; id++) {
+    *reinterpret_cast<int32_t *>(key->AccessForceNotNull(0)) = id;
+    std::vector<TupleSlot> results;
+    recovered_index->ScanKey(*txn, *key, &results);
+    ASSERT_EQ(1, results.size());
+    EXPECT_EQ(id == 3 ? version : layout_version_t(0), results[0].GetBlock()->layout_version_);
+    auto *row = row_initializer.InitializeRow(buffer);
+    ASSERT_TRUE(recovered_table->Select(txn, results[0], row, version));
+    EXPECT_EQ(id, *reinterpret_cast<int32_t *>(row->AccessWithNullCheck(row_map[id_oid])));
+    EXPECT_EQ(id == 2 ? 20 : id, *reinterpret_cast<int32_t *>(row->AccessWithNullCheck(row_map[value_oid])));
+    const byte *added = row->AccessWithNullCheck(row_map[added_oid]);
+    EXPECT_EQ(id != 3, added == nullptr);
+    if (added != nullptr) {
+      EXPECT_EQ(42, *reinterpret_cast<const int32_t *>(added));
+    }
+  }
+  delete[] buffer;
+  delete[] key_buffer;
+  recovery_txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
 // Tests that we can recover from a previous instance of recovery. We do this by recovering a workload, and then
 // recovering from the logs generated by the original workload's recovery.
 // NOLINTNEXTLINE
@@ -0,0 +1,352 @@
+#include "storage/sql_table.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "catalog/index_schema.h"
+#include "catalog/schema.h"
+#include "parser/expression/column_value_expression.h"
+#include "parser/expression/constant_value_expression.h"
+#include "storage/garbage_collector.h"
+#include "storage/index/index_builder.h"
+#include "test_util/catalog_test_util.h"
+#include "test_util/storage_test_util.h"
+#include "test_util/test_harness.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_manager.h"
+#include "type/transient_value_factory.h"
+
+namespace terrier {
+
+struct SqlTableTests : public TerrierTest {
+  void SetUp() override {
+    TerrierTest::SetUp();
+    // Version 0 has columns 1, 2 and 3. Version 1 drops column 3 and adds column 4.
+    auto id = MakeColumn("id", type::TypeId::BIGINT, 1);
+    auto name = catalog::Schema::Column(
+        "name", type::TypeId::VARCHAR, 100, true,
+        parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::VARCHAR)));
+    StorageTestUtil::ForceOid(&name, catalog::col_oid_t(2));
+    schema_v0_ = new catalog::Schema({id, name, MakeColumn("dropped", type::TypeId::INTEGER, 3)});
+    schema_v1_ = new catalog::Schema({id, name, MakeColumn("added", type::TypeId::INTEGER, 4)});
+    table_ = new storage::SqlTable(&block_store_, *schema_v0_);
+    gc_ = new storage::GarbageCollector(&timestamp_manager_, &deferred_action_manager_, &txn_manager_, DISABLED);
+  }
+
+  void TearDown() override {
+    gc_->PerformGarbageCollection();
+    gc_->PerformGarbageCollection();
+    delete gc_;
+    delete table_;
+    delete schema_v1_;
+    delete schema_v0_;
+    TerrierTest::TearDown();
+  }
+
+  static catalog::Schema::Column MakeColumn(const std::string &name, const type::TypeId type, const uint32_t oid) {
+    auto col = catalog::Schema::Column(name, type, true,
+                                       parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type)));
+    StorageTestUtil::ForceOid(&col, catalog::col_oid_t(oid));
+    return col;
+  }
+
+  // Inserts a tuple with the given id, and a name long enough not to be inlined, under the given layout version
+  storage::TupleSlot Insert(transaction::TransactionContext *txn, const int64_t id, const int32_t last,
+                            const storage::layout_version_t version) {
+    const std::vector<catalog::col_oid_t> oids = {catalog::col_oid_t(1), catalog::col_oid_t(2),
+                                                  catalog::col_oid_t(version == VERSION_0 ? 3 : 4)};
+    auto *const redo = txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                       table_->InitializerForProjectedRow(oids, version));
+    auto map = table_->ProjectionMapForOids(oids, version);
+    *reinterpret_cast<int64_t *>(redo->Delta()->AccessForceNotNull(map[oids[0]])) = id;
+    const std::string name = NameOf(id);
+    byte *const content = txn->AllocateVarlen(static_cast<uint32_t>(name.size()));
+    std::memcpy(content, name.data(), name.size());
+    *reinterpret_cast<storage::VarlenEntry *>(redo->Delta()->AccessForceNotNull(map[oids[1]])) =
+        storage::VarlenEntry::CreateFromArena(content, static_cast<uint32_t>(name.size()));
+    *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(map[oids[2]])) = last;
+    return table_->Insert(txn, redo, version);
+  }
+
+  static std::string NameOf(const int64_t id) { return "a name that is too long to be inlined #" + std::to_string(id); }
+
+  static constexpr storage::layout_version_t VERSION_0 = storage::layout_version_t(0);
+  static constexpr storage::layout_version_t VERSION_1 = storage::layout_version_t(1);
+
+  storage::BlockStore block_store_{10, 10};
+  storage::RecordBufferSegmentPool buffer_pool_{10000, 10000};
+  transaction::TimestampManager timestamp_manager_;
+  transaction::DeferredActionManager deferred_action_manager_{&timestamp_manager_};
+  transaction::TransactionManager txn_manager_{&timestamp_manager_, &deferred_action_manager_, &buffer_pool_, true,
+                                               DISABLED};
+  storage::GarbageCollector *gc_ = nullptr;
+  catalog::Schema *schema_v0_ = nullptr;
+  catalog::Schema *schema_v1_ = nullptr;
+  storage::SqlTable *table_ = nullptr;
+};
+
+// Tests that tuples written before a column is added and another is dropped read correctly under either layout version,
+// are updated in place under the new version, and are moved to the new version to write the added column
+// NOLINTNEXTLINE
+TEST_F(SqlTableTests, AddAndDropColumn) {
+  const std::vector<catalog::col_oid_t> oids_v0 = {catalog::col_oid_t(1), catalog::col_oid_t(2), catalog::col_oid_t(3)};
+  const std::vector<catalog::col_oid_t> oids_v1 = {catalog::col_oid_t(1), catalog::col_oid_t(2), catalog::col_oid_t(4)};
+  std::vector<storage::TupleSlot> slots;
+  transaction::TransactionContext *txn = txn_manager_.BeginTransaction();
+  for (int64_t id = 0; id < 10; id++) slots.push_back(Insert(txn, id, static_cast<int32_t>(-id), VERSION_0));
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  EXPECT_EQ(VERSION_1, table_->UpdateSchema(*schema_v1_));
+  EXPECT_EQ(VERSION_1, table_->GetLatestVersion());
+  txn = txn_manager_.BeginTransaction();
+  slots.push_back(Insert(txn, 10, 10, VERSION_1));
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  EXPECT_EQ(2, table_->GetNumBlocks());
+
+  // Columns that do not exist in the version a tuple was written in read as null
+  auto initializer_v0 = table_->InitializerForProjectedRow(oids_v0, VERSION_0);
+  auto map_v0 = table_->ProjectionMapForOids(oids_v0, VERSION_0);
+  auto initializer_v1 = table_->InitializerForProjectedRow(oids_v1, VERSION_1);
+  auto map_v1 = table_->ProjectionMapForOids(oids_v1, VERSION_1);
+  byte *buffer_v0 = common::AllocationUtil::AllocateAligned(initializer_v0.ProjectedRowSize());
+  byte *buffer_v1 = common::AllocationUtil::AllocateAligned(initializer_v1.ProjectedRowSize());
+  storage::ProjectedRow *row_v0 = initializer_v0.InitializeRow(buffer_v0);
+  storage::ProjectedRow *row_v1 = initializer_v1.InitializeRow(buffer_v1);
+  txn = txn_manager_.BeginTransaction();
+  for (int64_t id = 0; id <= 10; id++) {
+    ASSERT_TRUE(table_->Select(txn, slots[id], row_v0, VERSION_0));
+    ASSERT_TRUE(table_->Select(txn, slots[id], row_v1, VERSION_1));
+    for (auto [row, map] : {std::make_pair(row_v0, &map_v0), std::make_pair(row_v1, &map_v1)}) {
+      EXPECT_EQ(id, *reinterpret_cast<int64_t *>(row->AccessWithNullCheck((*map)[catalog::col_oid_t(1)])));
+      EXPECT_EQ(NameOf(id), reinterpret_cast<storage::VarlenEntry *>(
+                                row->AccessWithNullCheck((*map)[catalog::col_oid_t(2)]))
+                                ->StringView());
+    }
+    const byte *dropped = row_v0->AccessWithNullCheck(map_v0[catalog::col_oid_t(3)]);
+    const byte *added = row_v1->AccessWithNullCheck(map_v1[catalog::col_oid_t(4)]);
+    EXPECT_EQ(id == 10, dropped == nullptr);
+    EXPECT_EQ(id != 10, added == nullptr);
+    if (dropped != nullptr) {
+      EXPECT_EQ(-id, *reinterpret_cast<const int32_t *>(dropped));
+    }
+    if (added != nullptr) {
+      EXPECT_EQ(id, *reinterpret_cast<const int32_t *>(added));
+    }
+  }
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Updating an old tuple under the new version happens in place, as long as the tuple has every updated column
+  const std::vector<catalog::col_oid_t> id_oid = {catalog::col_oid_t(1)};
+  const std::vector<catalog::col_oid_t> added_oid = {catalog::col_oid_t(4)};
+  EXPECT_FALSE(table_->NeedsMigration(slots[2], id_oid));
+  EXPECT_TRUE(table_->NeedsMigration(slots[3], added_oid));
+  EXPECT_FALSE(table_->NeedsMigration(slots[10], added_oid));
+  txn = txn_manager_.BeginTransaction();
+  auto id_initializer = table_->InitializerForProjectedRow(id_oid, VERSION_1);
+  auto *redo = txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, id_initializer);
+  redo->SetTupleSlot(slots[2]);
+  *reinterpret_cast<int64_t *>(redo->Delta()->AccessForceNotNull(0)) = 20;
+  ASSERT_TRUE(table_->Update(txn, redo, VERSION_1));
+  EXPECT_EQ(slots[2], redo->GetTupleSlot());
+  EXPECT_EQ(VERSION_0, redo->GetLayoutVersion());
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // A column the tuple does not have can only be written once the tuple is moved over to the new version
+  txn = txn_manager_.BeginTransaction();
+  const storage::TupleSlot migrated =
+      table_->Migrate(txn, CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, slots[3], VERSION_1);
+  ASSERT_NE(storage::TupleSlot(nullptr, 0), migrated);
+  EXPECT_NE(slots[3], migrated);
+  EXPECT_EQ(VERSION_1, migrated.GetBlock()->layout_version_);
+  auto added_initializer = table_->InitializerForProjectedRow(added_oid, VERSION_1);
+  redo = txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, added_initializer);
+  redo->SetTupleSlot(migrated);
+  *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(0)) = 42;
+  ASSERT_TRUE(table_->Update(txn, redo, VERSION_1));
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  // The old tuple's name is freed with it, which the new tuple must not notice
+  gc_->PerformGarbageCollection();
+  gc_->PerformGarbageCollection();
+
+  txn = txn_manager_.BeginTransaction();
+  ASSERT_TRUE(table_->Select(txn, slots[2], row_v1, VERSION_1));
+  EXPECT_EQ(20, *reinterpret_cast<int64_t *>(row_v1->AccessWithNullCheck(map_v1[catalog::col_oid_t(1)])));
+  EXPECT_EQ(nullptr, row_v1->AccessWithNullCheck(map_v1[catalog::col_oid_t(4)]));
+  EXPECT_FALSE(table_->Select(txn, slots[3], row_v1, VERSION_1));
+  ASSERT_TRUE(table_->Select(txn, migrated, row_v1, VERSION_1));
+  EXPECT_EQ(3, *reinterpret_cast<int64_t *>(row_v1->AccessWithNullCheck(map_v1[catalog::col_oid_t(1)])));
+  EXPECT_EQ(NameOf(3),
+            reinterpret_cast<storage::VarlenEntry *>(row_v1->AccessWithNullCheck(map_v1[catalog::col_oid_t(2)]))
+                ->StringView());
+  EXPECT_EQ(42, *reinterpret_cast<int32_t *>(row_v1->AccessWithNullCheck(map_v1[catalog::col_oid_t(4)])));
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  delete[] buffer_v0;
+  delete[] buffer_v1;
+}
+
+// Tests that updating a column an old tuple does not have fails cleanly in place, and that the updates that take a
+// delta move the tuple over to the new version first, along with its index entries
+// NOLINTNEXTLINE
+TEST_F(SqlTableTests, UpdateMigrates) {
+  std::vector<storage::TupleSlot> slots;
+  transaction::TransactionContext *txn = txn_manager_.BeginTransaction();
+  for (int64_t id = 0; id < 10; id++) slots.push_back(Insert(txn, id, static_cast<int32_t>(-id), VERSION_0));
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  table_->UpdateSchema(*schema_v1_);
+
+  std::vector<catalog::IndexSchema::Column> keycols;
+  keycols.emplace_back("", type::TypeId::BIGINT, false,
+                       parser::ColumnValueExpression(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                                     catalog::col_oid_t(1)));
+  StorageTestUtil::ForceOid(&(keycols[0]), catalog::indexkeycol_oid_t(1));
+  const catalog::IndexSchema index_schema(keycols, storage::index::IndexType::BWTREE, true, true, false, true);
+  storage::index::Index *const index = storage::index::IndexBuilder().SetKeySchema(index_schema).Build();
+  const storage::ProjectedRowInitializer &key_initializer = index->GetProjectedRowInitializer();
+  byte *const key_buffer = common::AllocationUtil::AllocateAligned(key_initializer.ProjectedRowSize());
+  storage::ProjectedRow *const key = key_initializer.InitializeRow(key_buffer);
+  txn = txn_manager_.BeginTransaction();
+  for (int64_t id = 0; id < 10; id++) {
+    *reinterpret_cast<int64_t *>(key->AccessForceNotNull(0)) = id;
+    ASSERT_TRUE(index->InsertUnique(txn, *key, slots[id]));
+  }
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  const std::vector<catalog::col_oid_t> added_oid = {catalog::col_oid_t(4)};
+  auto added_initializer = table_->InitializerForProjectedRow(added_oid, VERSION_1);
+  txn = txn_manager_.BeginTransaction();
+  auto *redo = txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, added_initializer);
+  redo->SetTupleSlot(slots[4]);
+  *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(0)) = 42;
+  EXPECT_FALSE(table_->Update(txn, redo, VERSION_1));
+  txn_manager_.Abort(txn);
+
+  byte *const delta_buffer = common::AllocationUtil::AllocateAligned(added_initializer.ProjectedRowSize());
+  storage::ProjectedRow *const delta = added_initializer.InitializeRow(delta_buffer);
+  *reinterpret_cast<int32_t *>(delta->AccessForceNotNull(0)) = 42;
+  txn = txn_manager_.BeginTransaction();
+  const storage::TupleSlot migrated =
+      table_->Update(txn, CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, slots[4], *delta,
+                     {common::ManagedPointer(index)}, VERSION_1);
+  ASSERT_NE(storage::TupleSlot(nullptr, 0), migrated);
+  EXPECT_NE(slots[4], migrated);
+  EXPECT_EQ(VERSION_1, migrated.GetBlock()->layout_version_);
+  // A tuple that already has the column is updated in place
+  EXPECT_EQ(migrated, table_->Update(txn, CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, migrated,
+                                     *delta, {common::ManagedPointer(index)}, VERSION_1));
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  const std::vector<catalog::col_oid_t> oids_v1 = {catalog::col_oid_t(1), catalog::col_oid_t(4)};
+  auto initializer = table_->InitializerForProjectedRow(oids_v1, VERSION_1);
+  auto map = table_->ProjectionMapForOids(oids_v1, VERSION_1);
+  byte *const buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+  storage::ProjectedRow *const row = initializer.InitializeRow(buffer);
+  txn = txn_manager_.BeginTransaction();
+  ASSERT_TRUE(table_->Select(txn, migrated, row, VERSION_1));
+  EXPECT_EQ(4, *reinterpret_cast<int64_t *>(row->AccessWithNullCheck(map[catalog::col_oid_t(1)])));
+  EXPECT_EQ(42, *reinterpret_cast<int32_t *>(row->AccessWithNullCheck(map[catalog::col_oid_t(4)])));
+  std::vector<storage::TupleSlot> results;
+  *reinterpret_cast<int64_t *>(key->AccessForceNotNull(0)) = 4;
+  index->ScanKey(*txn, *key, &results);
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(migrated, results[0]);
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  gc_->PerformGarbageCollection();
+  gc_->PerformGarbageCollection();
+  delete[] buffer;
+  delete[] delta_buffer;
+  delete[] key_buffer;
+  delete index;
+}
+
+// Tests that a scan goes through the tuples of every layout version, translating them into the requested version
+// NOLINTNEXTLINE
+TEST_F(SqlTableTests, ScanAcrossVersions) {
+  transaction::TransactionContext *txn = txn_manager_.BeginTransaction();
+  for (int64_t id = 0; id < 100; id++) Insert(txn, id, static_cast<int32_t>(-id), VERSION_0);
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  table_->UpdateSchema(*schema_v1_);
+  txn = txn_manager_.BeginTransaction();
+  for (int64_t id = 100; id < 150; id++) Insert(txn, id, static_cast<int32_t>(id), VERSION_1);
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Scan in small batches, so that a batch never holds every tuple of a version
+  const std::vector<catalog::col_oid_t> oids = {catalog::col_oid_t(4), catalog::col_oid_t(1)};
+  auto initializer = table_->InitializerForProjectedColumns(oids, 7, VERSION_1);
+  auto map = table_->ProjectionMapForOids(oids, VERSION_1);
+  byte *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedColumnsSize());
+  storage::ProjectedColumns *columns = initializer.Initialize(buffer);
+  txn = txn_manager_.BeginTransaction();
+  int64_t expected_id = 0;
+  for (auto it = table_->begin(); it != table_->end();) {
+    table_->Scan(txn, &it, columns, VERSION_1);
+    for (uint32_t i = 0; i < columns->NumTuples(); i++, expected_id++) {
+      storage::ProjectedColumns::RowView row = columns->InterpretAsRow(i);
+      EXPECT_EQ(expected_id, *reinterpret_cast<int64_t *>(row.AccessWithNullCheck(map[catalog::col_oid_t(1)])));
+      const byte *added = row.AccessWithNullCheck(map[catalog::col_oid_t(4)]);
+      EXPECT_EQ(expected_id < 100, added == nullptr);
+      if (added != nullptr) {
+        EXPECT_EQ(expected_id, *reinterpret_cast<const int32_t *>(added));
+      }
+    }
+  }
+  EXPECT_EQ(150, expected_id);
+
+  // Blocks are numbered across versions
+  EXPECT_EQ(VERSION_1, table_->beginAt(1)->GetBlock()->layout_version_);
+  auto it = table_->beginAt(0);
+  table_->Scan(txn, &it, table_->endAt(1), columns, VERSION_1);
+  EXPECT_EQ(7, columns->NumTuples());
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  delete[] buffer;
+}
+
+// Tests that a bulk load split into batches sized by InitializerForBatchInsert fits every batch into a redo buffer
+// segment, and that a batch too large for one is rejected before it is staged
+// NOLINTNEXTLINE
+TEST_F(SqlTableTests, BatchInsert) {
+  const std::vector<catalog::col_oid_t> oids = {catalog::col_oid_t(1), catalog::col_oid_t(2), catalog::col_oid_t(3)};
+  auto initializer = table_->InitializerForBatchInsert(oids);
+  auto map = table_->ProjectionMapForOids(oids);
+  const uint32_t max_tuples = initializer.MaxTuples();
+  const uint32_t segment_size = common::Constants::BUFFER_SEGMENT_SIZE;
+  EXPECT_LE(storage::BatchRedoRecord::Size(initializer), segment_size);
+  auto oversized = table_->InitializerForProjectedColumns(oids, max_tuples + 1);
+  EXPECT_GT(storage::BatchRedoRecord::Size(oversized), segment_size);
+
+  transaction::TransactionContext *txn = txn_manager_.BeginTransaction();
+  EXPECT_THROW(txn->StageBatchWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, oversized),
+               std::runtime_error);
+  const uint32_t num_tuples = 5 * max_tuples + 3;
+  std::vector<storage::TupleSlot> slots;
+  for (uint32_t start = 0; start < num_tuples; start += max_tuples) {
+    auto *const redo = txn->StageBatchWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, initializer);
+    storage::ProjectedColumns *columns = redo->Columns();
+    columns->SetNumTuples(std::min(max_tuples, num_tuples - start));
+    for (uint32_t i = 0; i < columns->NumTuples(); i++) {
+      storage::ProjectedColumns::RowView row = columns->InterpretAsRow(i);
+      *reinterpret_cast<int64_t *>(row.AccessForceNotNull(map[catalog::col_oid_t(1)])) = start + i;
+      row.SetNull(map[catalog::col_oid_t(2)]);
+      row.SetNull(map[catalog::col_oid_t(3)]);
+    }
+    table_->InsertBatch(txn, redo);
+    slots.insert(slots.end(), columns->TupleSlots(), columns->TupleSlots() + columns->NumTuples());
+  }
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto row_initializer = table_->InitializerForProjectedRow(oids);
+  byte *buffer = common::AllocationUtil::AllocateAligned(row_initializer.ProjectedRowSize());
+  storage::ProjectedRow *row = row_initializer.InitializeRow(buffer);
+  txn = txn_manager_.BeginTransaction();
+  ASSERT_EQ(num_tuples, slots.size());
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(table_->Select(txn, slots[i], row));
+    const byte *id = row->AccessWithNullCheck(map[catalog::col_oid_t(1)]);
+    EXPECT_EQ(static_cast<int64_t>(i), *reinterpret_cast<const int64_t *>(id));
+    EXPECT_EQ(nullptr, row->AccessWithNullCheck(map[catalog::col_oid_t(2)]));
+    EXPECT_EQ(nullptr, row->AccessWithNullCheck(map[catalog::col_oid_t(3)]));
+  }
+  txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  delete[] buffer;
+}
+
+}  // namespace terrier
@@ -0,0 +1,131 @@
+#include "storage/varlen_arena.h"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "storage/data_table.h"
+#include "storage/garbage_collector.h"
+#include "storage/storage_util.h"
+#include "test_util/storage_test_util.h"
+#include "test_util/test_harness.h"
+#include "transaction/deferred_action_manager.h"
+
+namespace terrier {
+
+struct VarlenArenaTests : public TerrierTest {
+  std::default_random_engine generator_;
+};
+
+// Tests that buffers allocated from an arena hold their values independently of each other, and that chunks are freed
+// once all of their buffers are
+// NOLINTNEXTLINE
+TEST_F(VarlenArenaTests, AllocateAndFree) {
+  const uint64_t chunks_before = storage::VarlenArena::NumChunks();
+  std::uniform_int_distribution<uint32_t> size_dist(13, storage::VarlenArena::MAX_SHARED_SIZE);
+  std::vector<std::pair<byte *, uint32_t>> buffers;
+  {
+    storage::VarlenArena arena;
+    for (uint32_t i = 0; i < 1000; i++) {
+      const uint32_t size = size_dist(generator_);
+      byte *buffer = arena.Allocate(size);
+      std::memset(buffer, static_cast<int>(i % 256), size);
+      buffers.emplace_back(buffer, size);
+    }
+    // Values too large to share a chunk get one of their own, however large they are
+    for (uint32_t size : {storage::VarlenArena::MAX_SHARED_SIZE + 1, 3 * storage::VarlenArena::CHUNK_SIZE}) {
+      const uint64_t chunks_before_large = storage::VarlenArena::NumChunks();
+      byte *large = arena.Allocate(size);
+      EXPECT_EQ(chunks_before_large + 1, storage::VarlenArena::NumChunks());
+      std::memset(large, 0xFF, size);
+      buffers.emplace_back(large, size);
+    }
+  }
+  // The buffers outlive the arena
+  EXPECT_LT(chunks_before, storage::VarlenArena::NumChunks());
+  for (uint32_t i = 0; i < buffers.size(); i++) {
+    const auto expected = static_cast<byte>(i < 1000 ? i % 256 : 0xFF);
+    for (uint32_t j = 0; j < buffers[i].second; j++) EXPECT_EQ(expected, buffers[i].first[j]);
+  }
+
+  // A chunk goes away with the last of its values
+  for (auto &buffer : buffers) storage::VarlenArena::Free(buffer.first);
+  EXPECT_EQ(chunks_before, storage::VarlenArena::NumChunks());
+}
+
+// Tests that varlen entries free their buffers the way they were allocated
+// NOLINTNEXTLINE
+TEST_F(VarlenArenaTests, FreeEntry) {
+  const uint64_t chunks_before = storage::VarlenArena::NumChunks();
+  const std::string value = "a value that is too long to be inlined";
+  const auto size = static_cast<uint32_t>(value.size());
+  storage::VarlenEntry from_arena = storage::StorageUtil::CreateVarlen(value);
+  EXPECT_TRUE(from_arena.NeedReclaim());
+  EXPECT_TRUE(from_arena.FromArena());
+  EXPECT_EQ(value, from_arena.StringView());
+  auto *content = new byte[size];
+  std::memcpy(content, value.data(), size);
+  storage::VarlenEntry from_heap = storage::VarlenEntry::Create(content, size, true);
+  EXPECT_TRUE(from_heap.NeedReclaim());
+  EXPECT_FALSE(from_heap.FromArena());
+  EXPECT_EQ(value, from_heap.StringView());
+  EXPECT_FALSE(storage::VarlenEntry::Create(content, size, false).FromArena());
+
+  storage::VarlenArena::Free(from_arena);
+  storage::VarlenArena::Free(from_heap);
+  // The calling thread's arena keeps its current chunk around for the next value
+  EXPECT_GE(chunks_before + 1, storage::VarlenArena::NumChunks());
+}
+
+// Tests that the storage engine frees the varlens a transaction allocated from its arena
+// NOLINTNEXTLINE
+TEST_F(VarlenArenaTests, TransactionArena) {
+  const uint64_t chunks_before = storage::VarlenArena::NumChunks();
+  storage::BlockStore block_store{10, 10};
+  storage::RecordBufferSegmentPool buffer_pool{10000, 10000};
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+  transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool, true,
+                                              DISABLED);
+  storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+  storage::BlockLayout layout({8, VARLEN_COLUMN});
+  auto *table = new storage::DataTable(&block_store, layout, storage::layout_version_t(0));
+  auto initializer = storage::ProjectedRowInitializer::Create(layout, {storage::col_id_t(1)});
+  byte *row_buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+  storage::ProjectedRow *row = initializer.InitializeRow(row_buffer);
+
+  const std::string value = "a value that is too long to be inlined";
+  const auto size = static_cast<uint32_t>(value.size());
+  std::vector<storage::TupleSlot> slots;
+  for (bool commit : {true, false}) {
+    transaction::TransactionContext *txn = txn_manager.BeginTransaction();
+    for (uint32_t i = 0; i < 10000; i++) {
+      byte *content = txn->AllocateVarlen(size);
+      std::memcpy(content, value.data(), size);
+      *reinterpret_cast<storage::VarlenEntry *>(row->AccessForceNotNull(0)) =
+          storage::VarlenEntry::CreateFromArena(content, size);
+      slots.push_back(table->Insert(txn, *row));
+    }
+    if (commit)
+      txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    else
+      txn_manager.Abort(txn);
+  }
+  EXPECT_LT(chunks_before, storage::VarlenArena::NumChunks());
+
+  transaction::TransactionContext *txn = txn_manager.BeginTransaction();
+  for (uint32_t i = 0; i < slots.size(); i++) {
+    EXPECT_EQ(i < 10000, table->Select(txn, slots[i], row));
+    if (i >= 10000) continue;
+    EXPECT_EQ(value, reinterpret_cast<storage::VarlenEntry *>(row->AccessWithNullCheck(0))->StringView());
+  }
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // The aborted values are freed along with their transaction, and the rest along with the table
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();
+  delete table;
+  delete[] row_buffer;
+  EXPECT_EQ(chunks_before, storage::VarlenArena::NumChunks());
+}
+
+}  // namespace terrier
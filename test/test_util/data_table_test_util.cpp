@@ -156,6 +156,7 @@ void LargeDataTableTestObject::SimulateOneTransaction(terrier::RandomDataTableTr
 template <class Random>
 void LargeDataTableTestObject::PopulateInitialTable(uint32_t num_tuples, Random *generator) {
   initial_txn_ = txn_manager_->BeginTransaction();
+  initial_txn_begin_ = initial_txn_->StartTime();
   byte *redo_buffer = nullptr;
   for (uint32_t i = 0; i < num_tuples; i++) {
     // get a new redo buffer each insert so we log the values inserted.
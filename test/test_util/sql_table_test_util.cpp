@@ -21,7 +21,8 @@ void RandomSqlTableTransaction::RandomInsert(Random *generator) {
   // Generate random insert
   auto initializer = sql_table_ptr->InitializerForProjectedRow(sql_table_metadata->col_oids_);
   auto *const record = txn_->StageWrite(database_oid, table_oid, initializer);
-  StorageTestUtil::PopulateRandomRow(record->Delta(), sql_table_ptr->table_.layout_, 0.0, generator);
+  StorageTestUtil::PopulateRandomRow(record->Delta(), sql_table_ptr->Version(storage::layout_version_t(0)).layout_,
+                                     0.0, generator);
   record->SetTupleSlot(storage::TupleSlot(nullptr, 0));
   auto tuple_slot = sql_table_ptr->Insert(txn_, record);
 
@@ -53,7 +54,8 @@ void RandomSqlTableTransaction::RandomUpdate(Random *generator) {
       StorageTestUtil::RandomNonEmptySubset(sql_table_metadata->col_oids_, generator));
   auto *const record = txn_->StageWrite(database_oid, table_oid, initializer);
   record->SetTupleSlot(updated);
-  StorageTestUtil::PopulateRandomRow(record->Delta(), sql_table_ptr->table_.layout_, 0.0, generator);
+  StorageTestUtil::PopulateRandomRow(record->Delta(), sql_table_ptr->Version(storage::layout_version_t(0)).layout_,
+                                     0.0, generator);
   auto result = sql_table_ptr->Update(txn_, record);
   aborted_ = !result;
 }
@@ -244,7 +246,8 @@ void LargeSqlTableTestObject::PopulateInitialTables(uint16_t num_databases, uint
       std::vector<storage::TupleSlot> inserted_tuples;
       for (uint32_t i = 0; i < num_tuples; i++) {
         auto *const redo = initial_txn_->StageWrite(database_oid, table_oid, initializer);
-        StorageTestUtil::PopulateRandomRow(redo->Delta(), sql_table->table_.layout_, 0.0, generator);
+        StorageTestUtil::PopulateRandomRow(redo->Delta(), sql_table->Version(storage::layout_version_t(0)).layout_,
+                                           0.0, generator);
         const storage::TupleSlot inserted = sql_table->Insert(initial_txn_, redo);
         inserted_tuples.emplace_back(inserted);
       }
@@ -167,9 +167,9 @@ bool Payment::Execute(transaction::TransactionManager *const txn_manager, Databa
     new_c_data.append(std::to_string(args.h_amount_));
     new_c_data.append(c_data_str);
     const auto new_c_data_length = std::min(new_c_data.length(), static_cast<std::size_t>(500));
-    auto *const varlen = common::AllocationUtil::AllocateAligned(new_c_data_length);
+    auto *const varlen = txn->AllocateVarlen(static_cast<uint32_t>(new_c_data_length));
     std::memcpy(varlen, new_c_data.data(), new_c_data_length);
-    const auto varlen_entry = storage::VarlenEntry::Create(varlen, static_cast<uint32_t>(new_c_data_length), true);
+    const auto varlen_entry = storage::VarlenEntry::CreateFromArena(varlen, static_cast<uint32_t>(new_c_data_length));
 
     *reinterpret_cast<storage::VarlenEntry *>(c_data_update_redo->Delta()->AccessForceNotNull(0)) = varlen_entry;
 
@@ -182,9 +182,9 @@ bool Payment::Execute(transaction::TransactionManager *const txn_manager, Databa
   h_data_str.append("    ");
   h_data_str.append(d_name.StringView());
   const auto h_data_length = h_data_str.length();
-  auto *const varlen = common::AllocationUtil::AllocateAligned(h_data_length);
+  auto *const varlen = txn->AllocateVarlen(static_cast<uint32_t>(h_data_length));
   std::memcpy(varlen, h_data_str.data(), h_data_length);
-  const auto h_data = storage::VarlenEntry::Create(varlen, static_cast<uint32_t>(h_data_length), true);
+  const auto h_data = storage::VarlenEntry::CreateFromArena(varlen, static_cast<uint32_t>(h_data_length));
 
   // Insert in History table
   auto *const history_insert_redo =
@@ -0,0 +1,211 @@
+#include "transaction/timestamp_manager.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "common/allocator.h"
+#include "storage/data_table.h"
+#include "storage/garbage_collector.h"
+#include "test_util/multithread_test_util.h"
+#include "test_util/test_harness.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+
+namespace terrier {
+
+class TimestampManagerTests : public TerrierTest {
+ protected:
+  void TearDown() override {
+    gc_.PerformGarbageCollection();
+    gc_.PerformGarbageCollection();
+    TerrierTest::TearDown();
+  }
+
+  storage::BlockStore block_store_{10, 10};
+  storage::RecordBufferSegmentPool buffer_pool_{10000, 10000};
+  transaction::TimestampManager timestamp_manager_;
+  transaction::DeferredActionManager deferred_action_manager_{&timestamp_manager_};
+  transaction::TransactionManager txn_manager_{&timestamp_manager_, &deferred_action_manager_, &buffer_pool_, true,
+                                               DISABLED};
+  storage::GarbageCollector gc_{&timestamp_manager_, &deferred_action_manager_, &txn_manager_, DISABLED};
+};
+
+// Tests that the oldest active transaction follows transactions as they begin, commit and abort, that a transaction
+// that begins after a commit starts after it, and that one that begins after a poll starts no earlier than its result.
+// Until the clock moves on, transactions may still begin in the current epoch, so the poll may be older than them.
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, BeginCommitPollInterleaving) {
+  auto *txn1 = txn_manager_.BeginTransaction();
+  auto *txn2 = txn_manager_.BeginTransaction();
+  const transaction::timestamp_t start1 = txn1->StartTime(), start2 = txn2->StartTime();
+  EXPECT_LT(start1, start2);
+  const transaction::timestamp_t first_poll = timestamp_manager_.OldestTransactionStartTime();
+  EXPECT_LE(first_poll, start1);
+  EXPECT_EQ(first_poll, timestamp_manager_.CachedOldestTransactionStartTime());
+
+  const transaction::timestamp_t commit1 =
+      txn_manager_.Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+  EXPECT_LT(start2, commit1);
+  EXPECT_EQ(start2, timestamp_manager_.OldestTransactionStartTime());
+
+  auto *txn3 = txn_manager_.BeginTransaction();
+  const transaction::timestamp_t start3 = txn3->StartTime();
+  EXPECT_LT(commit1, start3);
+  EXPECT_EQ(start2, timestamp_manager_.OldestTransactionStartTime());
+
+  txn_manager_.Abort(txn2);
+  EXPECT_EQ(start3, timestamp_manager_.OldestTransactionStartTime());
+
+  const transaction::timestamp_t commit3 =
+      txn_manager_.Commit(txn3, transaction::TransactionUtil::EmptyCallback, nullptr);
+  // With nothing running, the poll is newer than every timestamp handed out so far, and does not advance the clock
+  const transaction::timestamp_t current_time = timestamp_manager_.CurrentTime();
+  const transaction::timestamp_t oldest = timestamp_manager_.OldestTransactionStartTime();
+  EXPECT_LT(commit3, oldest);
+  EXPECT_EQ(current_time, timestamp_manager_.CurrentTime());
+  EXPECT_EQ(oldest, timestamp_manager_.OldestTransactionStartTime());
+  EXPECT_EQ(oldest, timestamp_manager_.CachedOldestTransactionStartTime());
+
+  auto *txn4 = txn_manager_.BeginTransaction();
+  EXPECT_LE(oldest, txn4->StartTime());
+  EXPECT_LE(timestamp_manager_.OldestTransactionStartTime(), txn4->StartTime());
+  txn_manager_.Commit(txn4, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+// Tests that begins hand out increasing start times from the current epoch without advancing the clock, until the
+// slot runs out of start times in it, and that the clock only moves on when a timestamp is checked out
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, BeginWithinEpoch) {
+  const transaction::timestamp_t current_time = timestamp_manager_.CurrentTime();
+  std::vector<transaction::TransactionContext *> txns;
+  for (uint64_t i = 0; i < transaction::TimestampManager::SLOT_RANGE - 1; i++) {
+    txns.push_back(txn_manager_.BeginTransaction());
+    EXPECT_EQ(current_time, timestamp_manager_.CurrentTime());
+    EXPECT_LT(txns.back()->StartTime(), current_time);
+    if (txns.size() > 1) EXPECT_EQ(txns[txns.size() - 2]->StartTime() + 1, txns.back()->StartTime());
+  }
+
+  // The slot has used up its range of the epoch, so the next begin has to move the clock on
+  txns.push_back(txn_manager_.BeginTransaction());
+  EXPECT_EQ(current_time + transaction::TimestampManager::EPOCH_SIZE, timestamp_manager_.CurrentTime());
+  EXPECT_LT(current_time, txns.back()->StartTime());
+
+  // A commit closes the epoch, so a begin after it starts after the commit
+  const transaction::timestamp_t commit_time =
+      txn_manager_.Commit(txns.back(), transaction::TransactionUtil::EmptyCallback, nullptr);
+  txns.pop_back();
+  EXPECT_EQ(current_time + 2 * transaction::TimestampManager::EPOCH_SIZE, timestamp_manager_.CurrentTime());
+  auto *after_commit = txn_manager_.BeginTransaction();
+  EXPECT_LT(commit_time, after_commit->StartTime());
+  txns.push_back(after_commit);
+
+  for (auto *txn : txns) txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+// Tests that every start, commit and abort timestamp is handed out once, while transactions begin, commit and abort
+// on many threads at once, more than there are slots, so that slots are shared
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, ConcurrentUniqueTimestamps) {
+  const uint32_t num_txns = 500;
+  const uint32_t num_threads = 2 * transaction::TimestampManager::NUM_SLOTS;
+  common::WorkerPool thread_pool(num_threads, {});
+  std::vector<std::vector<transaction::timestamp_t>> timestamps(num_threads);
+  auto workload = [&](uint32_t id) {
+    for (uint32_t i = 0; i < num_txns; i++) {
+      auto *txn = txn_manager_.BeginTransaction();
+      timestamps[id].push_back(txn->StartTime());
+      if ((i + id) % 4 == 0)
+        timestamps[id].push_back(txn_manager_.Abort(txn));
+      else
+        timestamps[id].push_back(txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr));
+    }
+  };
+  MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+  gc_.PerformGarbageCollection();
+
+  std::vector<transaction::timestamp_t> all;
+  for (const auto &thread_timestamps : timestamps) {
+    // Every thread sees its own timestamps increase
+    EXPECT_TRUE(std::is_sorted(thread_timestamps.begin(), thread_timestamps.end()));
+    all.insert(all.end(), thread_timestamps.begin(), thread_timestamps.end());
+  }
+  std::sort(all.begin(), all.end());
+  EXPECT_TRUE(std::adjacent_find(all.begin(), all.end()) == all.end());
+}
+
+// Tests that a poll never returns a timestamp newer than a transaction that is still running, while transactions
+// begin, commit and abort on many threads at once
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, ConcurrentBeginCommitPoll) {
+  const uint32_t num_iterations = 10;
+  const uint32_t num_txns = 1000;
+  const uint32_t num_threads = std::max(MultiThreadTestUtil::HardwareConcurrency(), 4U);
+  common::WorkerPool thread_pool(num_threads, {});
+  for (uint32_t iteration = 0; iteration < num_iterations; iteration++) {
+    auto workload = [&](uint32_t id) {
+      for (uint32_t i = 0; i < num_txns; i++) {
+        auto *txn = txn_manager_.BeginTransaction();
+        EXPECT_LE(txn->OldestActiveStartTime(), txn->StartTime());
+        EXPECT_LE(timestamp_manager_.OldestTransactionStartTime(), txn->StartTime());
+        if ((i + id) % 4 == 0)
+          txn_manager_.Abort(txn);
+        else
+          txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      }
+    };
+    MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+    gc_.PerformGarbageCollection();
+  }
+}
+
+// Tests that a transaction that begins once another one's commit has returned sees its writes, while a writer commits
+// updates to a tuple on one thread and readers begin transactions on the others
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, BeginAfterCommitSeesWrites) {
+  const uint64_t num_updates = 2000;
+  const uint32_t num_threads = std::max(MultiThreadTestUtil::HardwareConcurrency(), 4U);
+  storage::BlockLayout layout({8, 8});
+  storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+  auto initializer = storage::ProjectedRowInitializer::Create(layout, {storage::col_id_t(1)});
+  std::vector<byte *> buffers;
+  for (uint32_t i = 0; i < num_threads; i++)
+    buffers.push_back(common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize()));
+
+  storage::ProjectedRow *initial = initializer.InitializeRow(buffers[0]);
+  *reinterpret_cast<uint64_t *>(initial->AccessForceNotNull(0)) = 0;
+  auto *insert_txn = txn_manager_.BeginTransaction();
+  const storage::TupleSlot slot = table.Insert(insert_txn, *initial);
+  txn_manager_.Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  std::atomic<uint64_t> committed = 0;
+  common::WorkerPool thread_pool(num_threads, {});
+  auto workload = [&](uint32_t id) {
+    storage::ProjectedRow *const row = initializer.InitializeRow(buffers[id]);
+    if (id == 0) {
+      for (uint64_t value = 1; value <= num_updates; value++) {
+        auto *const txn = txn_manager_.BeginTransaction();
+        *reinterpret_cast<uint64_t *>(row->AccessForceNotNull(0)) = value;
+        EXPECT_TRUE(table.Update(txn, slot, *row));
+        txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+        committed.store(value);
+        // Keep the version chain short. The GC is not thread-safe, so only this thread runs it.
+        if (value % 100 == 0) gc_.PerformGarbageCollection();
+      }
+      return;
+    }
+    for (uint64_t seen = 0; seen < num_updates;) {
+      const uint64_t expected = committed.load();
+      auto *const txn = txn_manager_.BeginTransaction();
+      EXPECT_TRUE(table.Select(txn, slot, row));
+      seen = *reinterpret_cast<uint64_t *>(row->AccessWithNullCheck(0));
+      EXPECT_LE(expected, seen);
+      txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    }
+  };
+  MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+  // The versions of the tuple need to be collected before the table goes away
+  gc_.PerformGarbageCollection();
+  gc_.PerformGarbageCollection();
+  for (auto *buffer : buffers) delete[] buffer;
+}
+}  // namespace terrier
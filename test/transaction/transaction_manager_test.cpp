@@ -0,0 +1,178 @@
+#include "transaction/transaction_manager.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>  // NOLINT
+#include <utility>
+#include "common/allocator.h"
+#include "storage/data_table.h"
+#include "storage/garbage_collector.h"
+#include "test_util/multithread_test_util.h"
+#include "test_util/test_harness.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_context.h"
+#include "transaction/timestamp_manager.h"
+
+namespace terrier {
+
+class TransactionManagerTests : public TerrierTest {
+ protected:
+  void TearDown() override {
+    gc_.PerformGarbageCollection();
+    gc_.PerformGarbageCollection();
+    TerrierTest::TearDown();
+  }
+
+  // Commits the txn with a callback that runs the given function. With logging disabled, the callback runs inside
+  // Commit, after the commit timestamp is checked out but before the txn leaves the active txn set.
+  transaction::timestamp_t CommitAndRun(transaction::TransactionContext *txn, std::function<void()> *in_commit) {
+    return txn_manager_.Commit(
+        txn, [](void *arg) { (*reinterpret_cast<std::function<void()> *>(arg))(); }, in_commit);
+  }
+
+  // Inserts a tuple with the given value into the table
+  void InsertValue(transaction::TransactionContext *txn, storage::DataTable *table, uint64_t value) {
+    auto initializer = storage::ProjectedRowInitializer::Create(layout_, {storage::col_id_t(1)});
+    byte *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+    storage::ProjectedRow *row = initializer.InitializeRow(buffer);
+    *reinterpret_cast<uint64_t *>(row->AccessForceNotNull(0)) = value;
+    table->Insert(txn, *row);
+    delete[] buffer;
+  }
+
+  storage::BlockLayout layout_{{8, 8}};
+  storage::BlockStore block_store_{100, 100};
+  storage::RecordBufferSegmentPool buffer_pool_{10000, 10000};
+  transaction::TimestampManager timestamp_manager_;
+  transaction::DeferredActionManager deferred_action_manager_{&timestamp_manager_};
+  transaction::TransactionManager txn_manager_{&timestamp_manager_, &deferred_action_manager_, &buffer_pool_, true,
+                                               DISABLED};
+  storage::GarbageCollector gc_{&timestamp_manager_, &deferred_action_manager_, &txn_manager_, DISABLED};
+};
+
+// Tests that a committing txn is handed to the GC before it leaves the active txn set, so that the GC keeps it queued
+// until then, and unlinks it on the first pass after
+// NOLINTNEXTLINE
+TEST_F(TransactionManagerTests, CommitHandsOffBeforeLeavingActiveSet) {
+  storage::DataTable table(&block_store_, layout_, storage::layout_version_t(0));
+  auto *txn = txn_manager_.BeginTransaction();
+  const transaction::timestamp_t start_time = txn->StartTime();
+  InsertValue(txn, &table, 42);
+
+  std::pair<uint32_t, uint32_t> in_commit_gc_result;
+  std::function<void()> in_commit = [&] {
+    EXPECT_EQ(start_time, timestamp_manager_.OldestTransactionStartTime());
+    in_commit_gc_result = gc_.PerformGarbageCollection();
+  };
+  CommitAndRun(txn, &in_commit);
+  // The GC already has the txn, but could not unlink it while it was still active
+  EXPECT_EQ(0, in_commit_gc_result.second);
+  EXPECT_TRUE(txn_manager_.CompletedTransactionsForGC().empty());
+  EXPECT_EQ(1, gc_.PerformGarbageCollection().second);
+  EXPECT_EQ(1, gc_.PerformGarbageCollection().first);
+}
+
+// Tests that aborted and read-only txns are handed to the GC too, which frees read-only ones right away
+// NOLINTNEXTLINE
+TEST_F(TransactionManagerTests, AbortAndReadOnlyHandOff) {
+  storage::DataTable table(&block_store_, layout_, storage::layout_version_t(0));
+  auto *aborting = txn_manager_.BeginTransaction();
+  InsertValue(aborting, &table, 42);
+  txn_manager_.Abort(aborting);
+  EXPECT_EQ(1, gc_.PerformGarbageCollection().second);
+
+  auto *read_only = txn_manager_.BeginTransaction();
+  txn_manager_.Commit(read_only, transaction::TransactionUtil::EmptyCallback, nullptr);
+  EXPECT_EQ(1, gc_.PerformGarbageCollection().second);
+
+  read_only = txn_manager_.BeginTransaction();
+  txn_manager_.Abort(read_only);
+  EXPECT_EQ(1, gc_.PerformGarbageCollection().second);
+}
+
+// Tests that a table dropped while another txn that wrote to it is between checking out its commit timestamp and
+// leaving the active txn set is not freed before the GC has unlinked that txn's records
+// NOLINTNEXTLINE
+TEST_F(TransactionManagerTests, DropTableWhileCommitting) {
+  auto *table = new storage::DataTable(&block_store_, layout_, storage::layout_version_t(0));
+  bool dropped = false;
+  auto *writer = txn_manager_.BeginTransaction();
+  InsertValue(writer, table, 42);
+
+  std::function<void()> in_commit = [&] {
+    // Drop the table the same way the catalog does, with one deferral for the txns that may still use it, one for the
+    // ones the GC has not unlinked yet, and one for the slots the GC hands back to the table when unlinking
+    auto *dropping = txn_manager_.BeginTransaction();
+    dropping->RegisterCommitAction([&, table](transaction::DeferredActionManager *deferred_action_manager) {
+      deferred_action_manager->RegisterDeferredAction([&, table, deferred_action_manager] {
+        deferred_action_manager->RegisterDeferredAction([&, table, deferred_action_manager] {
+          deferred_action_manager->RegisterDeferredAction([&, table] {
+            dropped = true;
+            delete table;
+          });
+        });
+      });
+    });
+    txn_manager_.Commit(dropping, transaction::TransactionUtil::EmptyCallback, nullptr);
+    // The writer is still active, so none of this can get to the table
+    for (uint32_t i = 0; i < 5; i++) gc_.PerformGarbageCollection();
+    EXPECT_FALSE(dropped);
+  };
+  CommitAndRun(writer, &in_commit);
+  EXPECT_FALSE(dropped);
+
+  // Unlinking the writer touches the table, and has to happen before the table is deleted
+  for (uint32_t i = 0; i < 5; i++) gc_.PerformGarbageCollection();
+  EXPECT_TRUE(dropped);
+}
+
+// Tests that no table is freed before the txns that wrote to it are unlinked, while txns write to a table and commit
+// or abort on many threads at once, one of the threads drops the table in the middle, and the GC runs all along
+// NOLINTNEXTLINE
+TEST_F(TransactionManagerTests, ConcurrentDropTable) {
+  const uint32_t num_iterations = 20;
+  const uint32_t num_txns = 200;
+  const uint32_t num_threads = std::max(MultiThreadTestUtil::HardwareConcurrency(), 4U);
+  common::WorkerPool thread_pool(num_threads, {});
+  for (uint32_t iteration = 0; iteration < num_iterations; iteration++) {
+    auto *table = new storage::DataTable(&block_store_, layout_, storage::layout_version_t(0));
+    std::atomic<bool> dropping = false, dropped = false;
+    auto workload = [&](uint32_t id) {
+      for (uint32_t i = 0; i < num_txns; i++) {
+        auto *txn = txn_manager_.BeginTransaction();
+        if (id == 0 && i == num_txns / 2) {
+          // A txn that sees the table as not dropped yet has begun before the drop commits, the same as a txn that
+          // found the table in the catalog
+          dropping = true;
+          txn->RegisterCommitAction([&, table](transaction::DeferredActionManager *deferred_action_manager) {
+            deferred_action_manager->RegisterDeferredAction([&, table, deferred_action_manager] {
+              deferred_action_manager->RegisterDeferredAction([&, table, deferred_action_manager] {
+                deferred_action_manager->RegisterDeferredAction([&, table] {
+                  dropped = true;
+                  delete table;
+                });
+              });
+            });
+          });
+          txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+          continue;
+        }
+        if (!dropping) InsertValue(txn, table, i);
+        if ((i + id) % 4 == 0)
+          txn_manager_.Abort(txn);
+        else
+          txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      }
+    };
+    // The GC is not thread-safe, so it only runs on this thread, concurrently with the writers
+    std::atomic<bool> done = false;
+    std::thread writers([&] {
+      MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+      done = true;
+    });
+    while (!done) gc_.PerformGarbageCollection();
+    writers.join();
+    while (!dropped) gc_.PerformGarbageCollection();
+  }
+}
+}  // namespace terrier
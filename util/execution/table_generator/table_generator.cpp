@@ -97,7 +97,8 @@ void TableGenerator::FillTable(catalog::table_oid_t table_oid, common::ManagedPo
   for (const auto &col : schema.GetColumns()) {
     table_cols.emplace_back(col.Oid());
   }
-  auto pri = table->InitializerForProjectedRow(table_cols);
+  // Tuples are bulk loaded in batches that each fit into a single redo record
+  auto pci = table->InitializerForBatchInsert(table_cols);
   auto offset_map = table->ProjectionMapForOids(table_cols);
   uint32_t vals_written = 0;
 
@@ -118,20 +119,25 @@ void TableGenerator::FillTable(catalog::table_oid_t table_oid, common::ManagedPo
     }
 
     // Insert into the table
-    for (uint32_t j = 0; j < num_vals; j++) {
-      auto *const redo = exec_ctx_->GetTxn()->StageWrite(exec_ctx_->DBOid(), table_oid, pri);
+    for (uint32_t start = 0; start < num_vals; start += pci.MaxTuples()) {
+      const uint32_t num_tuples = std::min(pci.MaxTuples(), num_vals - start);
+      auto *const redo = exec_ctx_->GetTxn()->StageBatchWrite(exec_ctx_->DBOid(), table_oid, pci);
+      storage::ProjectedColumns *columns = redo->Columns();
+      // Columns without generated data are left null
+      for (uint16_t col = 0; col < columns->NumColumns(); col++) columns->ColumnNullBitmap(col)->Clear(num_tuples);
       for (uint16_t k = 0; k < column_data.size(); k++) {
         auto offset = offsets[k];
-        if (table_meta.col_meta_[k].nullable_ && util::BitUtil::Test(column_data[k].second, j)) {
-          redo->Delta()->SetNull(offset);
-        } else {
-          byte *data = redo->Delta()->AccessForceNotNull(offset);
-          uint32_t elem_size = type::TypeUtil::GetTypeSize(table_meta.col_meta_[k].type_);
-          std::memcpy(data, column_data[k].first + j * elem_size, elem_size);
+        uint32_t elem_size = type::TypeUtil::GetTypeSize(table_meta.col_meta_[k].type_);
+        std::memcpy(columns->ColumnStart(offset), column_data[k].first + start * elem_size, num_tuples * elem_size);
+        const bool nullable = table_meta.col_meta_[k].nullable_;
+        for (uint32_t j = 0; j < num_tuples; j++) {
+          const bool is_null = nullable && util::BitUtil::Test(column_data[k].second, start + j);
+          columns->ColumnNullBitmap(offset)->Set(j, !is_null);
         }
       }
-      table->Insert(exec_ctx_->GetTxn(), redo);
-      vals_written++;
+      columns->SetNumTuples(num_tuples);
+      table->InsertBatch(exec_ctx_->GetTxn(), redo);
+      vals_written += num_tuples;
     }
 
     // Free allocated buffers